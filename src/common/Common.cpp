@@ -40,27 +40,31 @@ const std::string& Class::GetLocalName() const {
 }
 
 #ifdef DEBUG
-static uint64_t last_time = 0;
+static std::atomic< uint64_t > last_time = 0;
 #endif
 
-void Class::Log( const std::string& text ) const {
-	if ( g_engine != NULL ) {
+void Class::Log( const std::string& text, const logger::level_t level ) const {
+	if ( IsLogEnabled( level ) ) {
 #ifdef DEBUG
-		const auto time = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-		const auto duration = last_time
-			? time - last_time
+		const uint64_t time = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+		const uint64_t previous_time = last_time.exchange( time, std::memory_order_relaxed );
+		const auto duration = previous_time
+			? (int64_t)( time - previous_time ) // may be negative if other thread logged meanwhile
 			: 0;
-		last_time = time;
 #endif
 		g_engine->GetLogger()->Log(
 #ifdef DEBUG
 			"[+" + std::to_string( duration ) + "ns] " +
 #endif
-				"<" + GetName() + "> " + text
+				"<" + GetName() + "> " + text, level
 		);
 	}
 }
 
+const bool Class::IsLogEnabled( const logger::level_t level ) {
+	return g_engine != NULL && g_engine->GetLogger()->IsEnabled( level );
+}
+
 #ifdef DEBUG
 
 void Class::SetTesting( const bool testing ) {
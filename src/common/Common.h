@@ -9,6 +9,7 @@
 #include <string>
 
 #include "Assert.h"
+#include "logger/Types.h"
 
 #ifdef DEBUG
 #include "env/Debug.h"
@@ -76,7 +77,8 @@ protected:
 	std::string m_class_name = "";
 	std::string m_name = "";
 
-	void Log( const std::string& text ) const;
+	void Log( const std::string& text, const logger::level_t level = logger::LL_INFO ) const;
+	static const bool IsLogEnabled( const logger::level_t level );
 
 private:
 
@@ -86,6 +88,15 @@ private:
 
 };
 
+// unlike Log(), doesn't even evaluate text if level is disabled ( at compile time or at runtime ), use it for frequent lines
+// wrapped in do-while so that it's safe to use as single statement ( i.e. in if without braces )
+#define LOG( _level, _text ) do { \
+    if ( ( _level ) >= LOG_LEVEL_MIN && IsLogEnabled( _level ) ) { \
+        Log( _text, _level ); \
+    } \
+} while ( 0 )
+#define LOG_DEBUG( _text ) LOG( logger::LL_DEBUG, _text )
+
 #define CLASS_HEADER( _name, _parent ) \
 public: \
     virtual const std::string GetNamespace() const override { \
@@ -0,0 +1,239 @@
+#include <algorithm>
+
+#include "JobSystem.h"
+
+namespace common {
+
+static thread_local const JobSystem* s_job_system = nullptr;
+static thread_local size_t s_worker_index = JobSystem::NOT_A_WORKER;
+
+JobGroup::~JobGroup() {
+	// nothing can be done with jobs that still reference this group, so just wait for them
+	std::unique_lock< std::mutex > lock( m_mutex );
+	m_cv.wait(
+		lock, [ this ]() {
+			return !m_pending;
+		}
+	);
+}
+
+const bool JobGroup::IsFinished() const {
+	std::lock_guard< std::mutex > guard( m_mutex );
+	return !m_pending;
+}
+
+void JobGroup::Cancel() {
+	m_is_canceled = true;
+}
+
+const bool JobGroup::IsCanceled() const {
+	return m_is_canceled;
+}
+
+JobSystem::JobSystem( const size_t workers_count ) {
+	const size_t count = workers_count
+		? workers_count
+		: std::max< size_t >( 1, std::thread::hardware_concurrency() );
+	m_workers.reserve( count );
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		m_workers.push_back( std::make_unique< worker_t >() );
+	}
+	// start only after all queues exist because workers steal from each other
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		m_workers[ i ]->thread = std::thread( &JobSystem::WorkerLoop, this, i );
+	}
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard< std::mutex > guard( m_sleep_mutex );
+		m_is_stopping = true;
+	}
+	m_sleep_cv.notify_all();
+	for ( auto& worker : m_workers ) {
+		worker->thread.join();
+	}
+}
+
+const size_t JobSystem::GetWorkersCount() const {
+	return m_workers.size();
+}
+
+const size_t JobSystem::GetWorkerIndex() {
+	return s_worker_index;
+}
+
+void JobSystem::Run( JobGroup& group, const job_t& job, JobGroup* after ) {
+	{
+		std::lock_guard< std::mutex > guard( group.m_mutex );
+		group.m_pending++;
+	}
+	job_entry_t entry = {
+		job,
+		&group
+	};
+	if ( after ) {
+		std::lock_guard< std::mutex > guard( after->m_mutex );
+		if ( after->m_pending ) {
+			after->m_continuations.push_back( std::move( entry ) );
+			return;
+		}
+	}
+	Queue( std::move( entry ) );
+}
+
+void JobSystem::Wait( JobGroup& group ) {
+	if ( s_job_system == this ) {
+		while ( !group.IsFinished() ) {
+			if ( !RunNext( s_worker_index ) ) {
+				std::this_thread::yield();
+			}
+		}
+	}
+	else {
+		std::unique_lock< std::mutex > lock( group.m_mutex );
+		group.m_cv.wait(
+			lock, [ &group ]() {
+				return !group.m_pending;
+			}
+		);
+	}
+	std::exception_ptr error = nullptr;
+	{
+		std::lock_guard< std::mutex > guard( group.m_mutex );
+		std::swap( error, group.m_error );
+	}
+	if ( error ) {
+		std::rethrow_exception( error );
+	}
+}
+
+void JobSystem::ParallelFor( const size_t count, const size_t chunk_size, const std::function< void( const size_t begin, const size_t end ) >& f, MT_CANCELABLE ) {
+	ASSERT_NOLOG( chunk_size, "chunk size is zero" );
+	const size_t jobs_count = std::min( m_workers.size(), ( count + chunk_size - 1 ) / chunk_size );
+	if ( jobs_count < 2 ) {
+		if ( count && !MT_C ) {
+			f( 0, count );
+		}
+		return;
+	}
+	// chunks are picked dynamically so that slower chunks don't hold up whole job
+	std::atomic< size_t > next_chunk = 0;
+	JobGroup group;
+	for ( size_t i = 0 ; i < jobs_count ; i++ ) {
+		Run(
+			group, [ &f, &count, &chunk_size, &next_chunk, &group, &MT_C ]() -> void {
+				size_t begin;
+				while ( !MT_C && !group.IsCanceled() && ( begin = next_chunk.fetch_add( chunk_size ) ) < count ) {
+					f( begin, std::min( begin + chunk_size, count ) );
+				}
+			}
+		);
+	}
+	Wait( group );
+}
+
+void JobSystem::Queue( job_entry_t&& entry ) {
+	auto& worker = s_job_system == this
+		? m_workers[ s_worker_index ]
+		: m_workers[ m_next_worker++ % m_workers.size() ];
+	m_queued_count++; // before pushing so that it can't be stolen and counted down earlier
+	{
+		std::lock_guard< std::mutex > guard( worker->mutex );
+		worker->jobs.push_back( std::move( entry ) );
+	}
+	// either this sees sleeping worker or worker sees queued job before going to sleep
+	if ( m_sleeping_count ) {
+		{
+			std::lock_guard< std::mutex > guard( m_sleep_mutex );
+		}
+		m_sleep_cv.notify_one();
+	}
+}
+
+const bool JobSystem::RunNext( const size_t worker_index ) {
+	job_entry_t entry = {};
+	bool is_found = false;
+	{
+		// own jobs first, newest one is most likely to have its data in cache
+		auto& worker = m_workers[ worker_index ];
+		std::lock_guard< std::mutex > guard( worker->mutex );
+		if ( !worker->jobs.empty() ) {
+			entry = std::move( worker->jobs.back() );
+			worker->jobs.pop_back();
+			is_found = true;
+		}
+	}
+	for ( size_t i = 1 ; i < m_workers.size() && !is_found ; i++ ) {
+		// steal oldest job from someone else
+		auto& victim = m_workers[ ( worker_index + i ) % m_workers.size() ];
+		std::lock_guard< std::mutex > guard( victim->mutex );
+		if ( !victim->jobs.empty() ) {
+			entry = std::move( victim->jobs.front() );
+			victim->jobs.pop_front();
+			is_found = true;
+		}
+	}
+	if ( !is_found ) {
+		return false;
+	}
+	m_queued_count--;
+	Execute( entry );
+	return true;
+}
+
+void JobSystem::Execute( job_entry_t& entry ) {
+	auto* group = entry.group;
+	if ( !group->m_is_canceled ) {
+		try {
+			entry.job();
+		}
+		catch ( ... ) {
+			std::lock_guard< std::mutex > guard( group->m_mutex );
+			if ( !group->m_error ) {
+				group->m_error = std::current_exception();
+			}
+			// no point in running rest of jobs
+			group->m_is_canceled = true;
+		}
+	}
+	entry = {}; // job may hold captures that reference group
+	Finish( group );
+}
+
+void JobSystem::Finish( JobGroup* group ) {
+	std::vector< job_entry_t > continuations = {};
+	{
+		std::lock_guard< std::mutex > guard( group->m_mutex );
+		ASSERT_NOLOG( group->m_pending, "job group pending count underflow" );
+		if ( !--group->m_pending ) {
+			continuations.swap( group->m_continuations );
+			group->m_cv.notify_all();
+		}
+		// group may be destroyed by waiter as soon as lock is released
+	}
+	for ( auto& continuation : continuations ) {
+		Queue( std::move( continuation ) );
+	}
+}
+
+void JobSystem::WorkerLoop( const size_t worker_index ) {
+	s_job_system = this;
+	s_worker_index = worker_index;
+	while ( !m_is_stopping ) {
+		if ( !RunNext( worker_index ) ) {
+			std::unique_lock< std::mutex > lock( m_sleep_mutex );
+			m_sleeping_count++;
+			m_sleep_cv.wait(
+				lock, [ this ]() {
+					return m_is_stopping || m_queued_count;
+				}
+			);
+			m_sleeping_count--;
+		}
+	}
+	s_worker_index = NOT_A_WORKER;
+	s_job_system = nullptr;
+}
+
+}
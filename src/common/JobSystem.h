@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <functional>
+#include <exception>
+
+#include "Common.h"
+#include "MTTypes.h"
+
+namespace common {
+
+typedef std::function< void() > job_t;
+
+// jobs that are waited for and canceled together
+// must not be destroyed before all its jobs are finished ( see JobSystem::Wait() )
+CLASS( JobGroup, Class )
+
+	~JobGroup();
+
+	const bool IsFinished() const;
+
+	// jobs that didn't start yet are skipped, running ones can check IsCanceled()
+	void Cancel();
+	const bool IsCanceled() const;
+
+private:
+	friend class JobSystem;
+
+	struct job_entry_t {
+		job_t job;
+		JobGroup* group;
+	};
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cv;
+	size_t m_pending = 0;
+	mt_flag_t m_is_canceled = false;
+	std::exception_ptr m_error = nullptr; // first exception thrown by job
+	std::vector< job_entry_t > m_continuations = {}; // jobs to queue once group is finished
+};
+
+// pool of worker threads ( one per cpu core ) for splitting cpu-heavy work
+// every worker has own queue: it takes newest jobs from it and steals oldest ones from others when it's empty
+CLASS( JobSystem, Class )
+
+	JobSystem( const size_t workers_count = 0 ); // 0 means one per cpu core
+	~JobSystem();
+
+	const size_t GetWorkersCount() const;
+
+	// index of current worker ( 0 .. GetWorkersCount() - 1 ), or NOT_A_WORKER if called from other thread
+	// useful to keep per-worker state, as long as jobs don't wait for other jobs in the middle of using it
+	static const size_t NOT_A_WORKER = SIZE_MAX;
+	static const size_t GetWorkerIndex();
+
+	// queues job, it runs only after 'after' group is finished ( if specified ), this is enough to build task graphs
+	void Run( JobGroup& group, const job_t& job, JobGroup* after = nullptr );
+
+	// blocks until all jobs of group are finished, rethrows first exception from them
+	// worker threads run other jobs while waiting, so jobs may wait for their own subjobs
+	void Wait( JobGroup& group );
+
+	// calls f( begin, end ) for chunks of [ 0, count ) in parallel and waits for all of them
+	// stops picking new chunks once canceled
+	void ParallelFor( const size_t count, const size_t chunk_size, const std::function< void( const size_t begin, const size_t end ) >& f, MT_CANCELABLE );
+
+private:
+	typedef JobGroup::job_entry_t job_entry_t;
+
+	struct worker_t {
+		std::mutex mutex;
+		std::deque< job_entry_t > jobs = {};
+		std::thread thread;
+	};
+	std::vector< std::unique_ptr< worker_t > > m_workers = {};
+
+	std::atomic< size_t > m_queued_count = 0;
+	std::atomic< size_t > m_next_worker = 0; // for jobs queued from outside of workers
+	std::atomic< bool > m_is_stopping = false;
+
+	// for idle workers
+	std::mutex m_sleep_mutex;
+	std::condition_variable m_sleep_cv;
+	std::atomic< size_t > m_sleeping_count = 0;
+
+	void Queue( job_entry_t&& entry );
+	const bool RunNext( const size_t worker_index );
+	void Execute( job_entry_t& entry );
+	void Finish( JobGroup* group );
+	void WorkerLoop( const size_t worker_index );
+
+};
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace common {
+
+// bounded lock-free queue for any number of producer threads and one consumer thread
+// every cell has sequence number that tells whether it's free for writing or ready for reading at current position
+template< typename T, size_t SIZE >
+class MPSCQueue {
+public:
+
+	MPSCQueue() {
+		for ( size_t i = 0 ; i < SIZE ; i++ ) {
+			m_cells[ i ].sequence.store( i, std::memory_order_relaxed );
+		}
+	}
+
+	// any thread, returns false if queue is full
+	const bool Push( const T& value ) {
+		size_t pos = m_tail.load( std::memory_order_relaxed );
+		while ( true ) {
+			auto& cell = m_cells[ pos & MASK ];
+			const intptr_t diff = (intptr_t)cell.sequence.load( std::memory_order_acquire ) - (intptr_t)pos;
+			if ( diff == 0 ) {
+				if ( m_tail.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) ) {
+					cell.value = value;
+					cell.sequence.store( pos + 1, std::memory_order_release );
+					return true;
+				}
+			}
+			else if ( diff < 0 ) {
+				return false;
+			}
+			else {
+				// other producer took this position
+				pos = m_tail.load( std::memory_order_relaxed );
+			}
+		}
+	}
+
+	// consumer thread only, returns false if queue is empty
+	const bool Pop( T& value ) {
+		auto& cell = m_cells[ m_head & MASK ];
+		if ( cell.sequence.load( std::memory_order_acquire ) != m_head + 1 ) {
+			return false;
+		}
+		value = cell.value;
+		cell.sequence.store( m_head + SIZE, std::memory_order_release );
+		m_head++;
+		return true;
+	}
+
+	// consumer thread only
+	const bool IsEmpty() const {
+		return m_cells[ m_head & MASK ].sequence.load( std::memory_order_acquire ) != m_head + 1;
+	}
+
+private:
+	static_assert( SIZE && !( SIZE & ( SIZE - 1 ) ), "queue size must be power of 2" );
+	static const size_t MASK = SIZE - 1;
+
+	struct cell_t {
+		std::atomic< size_t > sequence;
+		T value;
+	};
+	cell_t m_cells[ SIZE ];
+
+	// on separate cache lines because they are written by different threads
+	alignas( 64 ) std::atomic< size_t > m_tail = 0;
+	alignas( 64 ) size_t m_head = 0;
+};
+
+}
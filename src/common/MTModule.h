@@ -2,105 +2,182 @@
 
 #include <mutex>
 #include <atomic>
-#include <functional>
-#include <map>
+#include <condition_variable>
+#include <chrono>
+#include <memory>
 #include <thread>
 
 #include "Module.h"
 #include "MTTypes.h"
+#include "MPSCQueue.h"
+#include "Thread.h"
 
 namespace common {
 
-static std::mutex s_next_mt_id_mutex;
-static mt_id_t s_next_mt_id = 0;
-
 // requests and responses should be structs that contain operation type and unions of variables for every op type
 // if you need to pass something non-trivial - use raw pointers
 // recommended way to use raw pointers here:
 //   create/malloc objects when creating request, delete/free in target thread when processing it
 //   for response it's opposite - create/malloc when creating response, delete/free in original thread when reading response
 
+// every request lives in its own slot until response is read or request is canceled
+// only ids of slots are passed through queue, so request creation and response polling don't need any locks
+// mutexes are only used to sleep ( target thread while there are no requests, other threads while waiting for response )
+// new request wakes up target thread and executed request wakes up thread that created it ( if they are wakeable )
+
 template< typename REQUEST_TYPE, typename RESPONSE_TYPE >
 class MTModule : public Module {
 public:
 
+	MTModule()
+		: m_mt_slots( new mt_slot_t[MT_SLOTS_COUNT] ) {}
+
 	virtual void Iterate() {
-		mt_request_map_t requests = MT_GetRequests();
-		if ( !requests.empty() ) {
-			//Log( "MT Processing " + to_string( requests.size() ) + " requests" );
-			mt_response_map_t responses = {};
-			for ( auto& request : requests ) {
-				ASSERT( !m_current_request_id, "m_current_request_id already set to something" );
-				m_mt_states_mutex.lock();
-				m_current_request_id = request.first;
-				m_is_canceled = false;
-				m_mt_states_mutex.unlock();
-				responses[ request.first ] = ProcessRequest( request.second, m_is_canceled );
-				m_current_request_id = 0;
+		mt_id_t mt_id = 0;
+		while ( m_mt_queue.Pop( mt_id ) ) {
+			auto& slot = GetSlot( mt_id );
+			auto state = GetState( mt_id, S_PENDING );
+			if ( !slot.state.compare_exchange_strong( state, GetState( mt_id, S_PROCESSING ) ) ) {
+				// was canceled before it could be processed
+				continue;
+			}
+			ASSERT( !m_current_request_id, "m_current_request_id already set to something" );
+			m_is_canceled = false;
+			m_current_request_id = mt_id;
+			slot.response = ProcessRequest( slot.request, m_is_canceled );
+			m_current_request_id = 0;
+			if ( !slot.is_response_needed ) {
+				// nobody will read it
+				DestroyRequest( slot.request );
+				DestroyResponse( slot.response );
+				FreeSlot( slot );
+				continue;
+			}
+			auto* const requester = slot.requester; // slot may be freed by requester right after state is changed
+			slot.state = GetState( mt_id, S_EXECUTED );
+			if ( requester ) {
+				requester->T_Wakeup();
+			}
+			if ( m_mt_response_waiters ) {
+				{
+					std::lock_guard< std::mutex > guard( m_mt_response_mutex );
+				}
+				m_mt_response_cv.notify_all();
+			}
+		}
+	}
+
+	// sleeps until there are requests to process or Wakeup() is called
+	virtual const bool Wait( const uint64_t max_ns ) {
+		std::unique_lock< std::mutex > lock( m_mt_request_mutex );
+		m_is_mt_request_waiting = true;
+		std::atomic_thread_fence( std::memory_order_seq_cst ); // pairs with one in Wakeup()
+		m_mt_request_cv.wait_for(
+			lock, std::chrono::nanoseconds( max_ns ), [ this ]() {
+				return m_is_woken || !m_mt_queue.IsEmpty();
 			}
-			MT_SetResponses( responses );
+		);
+		m_is_mt_request_waiting = false;
+		m_is_woken = false;
+		return true;
+	}
+
+	virtual void Wakeup() {
+		m_is_woken = true;
+		std::atomic_thread_fence( std::memory_order_seq_cst ); // either this sees waiting flag or Wait() sees wakeup
+		if ( m_is_mt_request_waiting ) {
+			{
+				std::lock_guard< std::mutex > guard( m_mt_request_mutex );
+			}
+			m_mt_request_cv.notify_one();
 		}
 	}
 
 	// use these to pass data from/to other threads
-	mt_id_t MT_CreateRequest( const REQUEST_TYPE& data ) {
-		mt_state_t state = {};
-		s_next_mt_id_mutex.lock();
-		mt_id_t mt_id = ++s_next_mt_id;
-		s_next_mt_id_mutex.unlock();
-		state.is_executed = false;
-		state.request = data;
-		m_mt_states_mutex.lock();
-		ASSERT( m_mt_states.find( mt_id ) == m_mt_states.end(), "duplicate mt_id" );
-		m_mt_states[ mt_id ] = state;
-		m_mt_states_mutex.unlock();
-		//Log( "MT Request " + to_string( mt_id ) + " created" );
-		return mt_id;
+	// if response isn't needed - request is freed right after processing and returned id must not be used
+	mt_id_t MT_CreateRequest( const REQUEST_TYPE& data, const bool is_response_needed = true ) {
+		const auto started_at = std::chrono::steady_clock::now();
+		while ( true ) {
+			for ( size_t attempt = 0 ; attempt < MT_SLOTS_COUNT ; attempt++ ) {
+				const mt_id_t mt_id = ++m_next_mt_id;
+				auto& slot = GetSlot( mt_id );
+				mt_slot_state_t state = 0;
+				if ( slot.state.compare_exchange_strong( state, GetState( mt_id, S_PENDING ) ) ) {
+					// nobody else knows this id yet so slot can be filled without locking
+					slot.request = data;
+					slot.is_response_needed = is_response_needed;
+					slot.requester = is_response_needed
+						? Thread::GetCurrent()
+						: nullptr;
+					while ( !m_mt_queue.Push( mt_id ) ) {
+						// only possible if many canceled requests are still in queue, target thread will skip them soon
+						std::this_thread::yield();
+					}
+					Wakeup();
+					//Log( "MT Request " + to_string( mt_id ) + " created" );
+					return mt_id;
+				}
+				// slot is still used by older request, try next one
+			}
+			// all slots are busy, give target thread some time to process them
+			if ( std::chrono::steady_clock::now() - started_at > MT_SLOTS_WAIT_TIMEOUT ) {
+				THROW( "too many pending MT requests" );
+			}
+			std::this_thread::yield();
+		}
 	}
 
+	// returns empty response if request wasn't executed yet
 	const RESPONSE_TYPE MT_GetResponse( const mt_id_t mt_id ) {
-		RESPONSE_TYPE response = {};
-		m_mt_states_mutex.lock();
-		auto it = m_mt_states.find( mt_id );
-		ASSERT( it != m_mt_states.end(), "GetResponse() mt_id not found" );
-		if ( it->second.is_executed ) {
-			response = it->second.response;
-			DestroyRequest( it->second.request );
-			m_mt_states.erase( it );
-			//Log( "MT Request " + to_string( mt_id ) + " result returned" );
+		auto& slot = GetSlot( mt_id );
+		const auto state = slot.state.load();
+		ASSERT( ( state >> STATE_BITS ) == mt_id, "GetResponse() mt_id not found" );
+		if ( state != GetState( mt_id, S_EXECUTED ) ) {
+			return {};
 		}
-		m_mt_states_mutex.unlock();
-
+		const RESPONSE_TYPE response = slot.response;
+		DestroyRequest( slot.request );
+		FreeSlot( slot );
+		//Log( "MT Request " + to_string( mt_id ) + " result returned" );
 		return response;
 	}
 
+	// blocks until request is executed
+	const RESPONSE_TYPE MT_WaitResponse( const mt_id_t mt_id ) {
+		WaitForState( GetSlot( mt_id ), GetState( mt_id, S_EXECUTED ) );
+		return MT_GetResponse( mt_id );
+	}
+
 	// TODO: better way?
 	void MT_DestroyResponse( const RESPONSE_TYPE& response ) {
 		DestroyResponse( response );
 	}
 
 	void MT_Cancel( const mt_id_t mt_id ) {
-		m_mt_states_mutex.lock();
-		auto it = m_mt_states.find( mt_id );
-		ASSERT( it != m_mt_states.end(), "MT_Cancel() mt_id not found" );
-		if ( mt_id == m_current_request_id ) {
-			m_is_canceled = true;
+		auto& slot = GetSlot( mt_id );
+		auto state = GetState( mt_id, S_PENDING );
+		if ( slot.state.compare_exchange_strong( state, GetState( mt_id, S_CANCELED ) ) ) {
+			// not processed yet, target thread will skip it
+			//Log( "MT Request " + to_string( mt_id ) + " canceled" );
+			DestroyRequest( slot.request );
+			FreeSlot( slot );
+			return;
 		}
-		if ( !it->second.is_executed ) {
-			if ( it->second.is_processing ) {
-				Log( "Waiting for MT Request " + std::to_string( mt_id ) + " to finish" );
-				while ( it->second.is_processing ) {
-					m_mt_states_mutex.unlock();
-					std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
-					m_mt_states_mutex.lock();
-				}
+		ASSERT( ( state >> STATE_BITS ) == mt_id, "MT_Cancel() mt_id not found" );
+		if ( ( state >> STATE_BITS ) != mt_id ) {
+			return;
+		}
+		if ( state == GetState( mt_id, S_PROCESSING ) ) {
+			if ( mt_id == m_current_request_id ) {
+				m_is_canceled = true;
 			}
-			//Log( "MT Request " + to_string( mt_id ) + " canceled" );
-			DestroyRequest( it->second.request );
-			DestroyResponse( it->second.response );
-			m_mt_states.erase( it );
+			Log( "Waiting for MT Request " + std::to_string( mt_id ) + " to finish" );
+			WaitForState( slot, GetState( mt_id, S_EXECUTED ) );
 		}
-		m_mt_states_mutex.unlock();
+		// executed but response was never read
+		DestroyRequest( slot.request );
+		DestroyResponse( slot.response );
+		FreeSlot( slot );
 	}
 
 protected:
@@ -112,47 +189,75 @@ protected:
 
 private:
 
-	struct mt_state_t {
+	// max requests that can exist at same time ( created but not yet read or canceled )
+	static const size_t MT_SLOTS_COUNT = 1024;
+	// if all slots stay busy for this long - responses are probably not being read
+	static constexpr std::chrono::seconds MT_SLOTS_WAIT_TIMEOUT{ 1 };
+
+	// id and state of request are stored together, so that slot can't be confused with next request that reuses it
+	typedef mt_id_t mt_slot_state_t;
+	static const uint8_t STATE_BITS = 2;
+	enum state_t : mt_slot_state_t {
+		S_CANCELED = 0, // with id 0 this means free slot
+		S_PENDING,
+		S_PROCESSING,
+		S_EXECUTED,
+	};
+	static const mt_slot_state_t GetState( const mt_id_t mt_id, const state_t state ) {
+		return ( mt_id << STATE_BITS ) | state;
+	}
+
+	struct mt_slot_t {
+		std::atomic< mt_slot_state_t > state = 0;
 		REQUEST_TYPE request = {};
-		bool is_processing = false;
-		bool is_executed = false;
 		RESPONSE_TYPE response = {};
+		bool is_response_needed = true;
+		Thread* requester = nullptr; // to wake up when response is ready
 	};
-	typedef std::map< mt_id_t, REQUEST_TYPE > mt_request_map_t;
-	typedef std::map< mt_id_t, RESPONSE_TYPE > mt_response_map_t;
-
-	mt_request_map_t MT_GetRequests() {
-		mt_request_map_t result = {};
-		m_mt_states_mutex.lock();
-		for ( auto& it : m_mt_states ) {
-			if ( !it.second.is_executed && !it.second.is_processing ) {
-				it.second.is_processing = true;
-				result[ it.first ] = it.second.request;
-			}
-		}
-		m_mt_states_mutex.unlock();
-		return result;
+	std::unique_ptr< mt_slot_t[] > m_mt_slots;
+	MPSCQueue< mt_id_t, MT_SLOTS_COUNT * 2 > m_mt_queue = {};
+	std::atomic< mt_id_t > m_next_mt_id = 0;
+
+	mt_slot_t& GetSlot( const mt_id_t mt_id ) {
+		ASSERT( mt_id, "invalid mt_id" );
+		return m_mt_slots[ mt_id % MT_SLOTS_COUNT ];
 	}
 
-	void MT_SetResponses( const mt_response_map_t& responses ) {
-		if ( !responses.empty() ) {
-			m_mt_states_mutex.lock();
-			for ( auto& response : responses ) {
-				auto it = m_mt_states.find( response.first );
-				ASSERT( it != m_mt_states.end(), "invalid response mt_id" );
-				ASSERT( it->second.is_processing, "setting response on non-processed request" );
-				it->second.response = response.second;
-				it->second.is_executed = true;
-				it->second.is_processing = false;
-				//Log( "MT Request " + to_string( response.first ) + " executed" );
-			}
-			m_mt_states_mutex.unlock();
+	void FreeSlot( mt_slot_t& slot ) {
+		slot.request = {};
+		slot.response = {};
+		slot.is_response_needed = true;
+		slot.requester = nullptr;
+		slot.state = 0;
+	}
+
+	void WaitForState( mt_slot_t& slot, const mt_slot_state_t state ) {
+		if ( slot.state == state ) {
+			return;
+		}
+		m_mt_response_waiters++;
+		{
+			std::unique_lock< std::mutex > lock( m_mt_response_mutex );
+			m_mt_response_cv.wait(
+				lock, [ &slot, state ]() {
+					return slot.state == state;
+				}
+			);
 		}
+		m_mt_response_waiters--;
 	}
 
-	typedef std::map< mt_id_t, mt_state_t > mt_states_t;
-	std::mutex m_mt_states_mutex;
-	mt_states_t m_mt_states = {};
+	// for waking up target thread
+	std::mutex m_mt_request_mutex;
+	std::condition_variable m_mt_request_cv;
+	std::atomic< bool > m_is_mt_request_waiting = false;
+	std::atomic< bool > m_is_woken = false;
+
+	// for waking up threads that wait for responses
+	std::mutex m_mt_response_mutex;
+	std::condition_variable m_mt_response_cv;
+	std::atomic< size_t > m_mt_response_waiters = 0;
+
 	mt_flag_t m_is_canceled = false;
 	std::atomic< mt_id_t > m_current_request_id = 0;
 };
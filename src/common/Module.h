@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <functional>
 #include <unordered_map>
@@ -15,6 +16,12 @@ public:
 	virtual void Start() {}
 	virtual void Stop() {}
 	virtual void Iterate() {}
+
+	// modules that can block on their own events (i.e. sockets) may wait here instead of thread sleeping for fixed time
+	// must return early when something needs processing, return false if not supported
+	virtual const bool Wait( const uint64_t max_ns ) { return false; }
+	// makes Wait() return early, can be called from any thread
+	virtual void Wakeup() {}
 };
 
 }
@@ -0,0 +1,155 @@
+#include <chrono>
+#include <algorithm>
+#include <cstdio>
+
+#include "Profiler.h"
+
+#include "util/FS.h"
+
+common::Profiler* g_profiler = nullptr;
+
+namespace common {
+
+Profiler::Section::Section( const std::string& name )
+	: m_name( name ) {
+	//
+}
+
+const std::string& Profiler::Section::GetName() const {
+	return m_name;
+}
+
+const bool Profiler::Section::Add( const uint64_t ns ) {
+	const auto count = m_count.load( std::memory_order_relaxed );
+	m_samples[ count % SAMPLES_COUNT ].store(
+		ns > UINT32_MAX
+			? UINT32_MAX
+			: ns, std::memory_order_relaxed
+	);
+	m_count.store( count + 1, std::memory_order_release );
+
+	// average needs some samples before it means anything
+	const bool is_spike = count >= AVERAGE_WINDOW && ns >= SPIKE_MIN_NS && ns > m_average_ns * SPIKE_FACTOR;
+	m_average_ns = count
+		? m_average_ns - m_average_ns / AVERAGE_WINDOW + ns / AVERAGE_WINDOW
+		: ns;
+	return is_spike;
+}
+
+const Profiler::stats_t Profiler::Section::GetStats() const {
+	stats_t stats = {};
+	stats.count = m_count.load( std::memory_order_acquire );
+	const size_t size = std::min( stats.count, (uint64_t)SAMPLES_COUNT );
+	if ( !size ) {
+		return stats;
+	}
+	// writer may overwrite some samples while they are copied, it's fine for stats
+	std::vector< uint32_t > samples( size );
+	uint64_t total = 0;
+	for ( size_t i = 0 ; i < size ; i++ ) {
+		samples[ i ] = m_samples[ i ].load( std::memory_order_relaxed );
+		total += samples[ i ];
+	}
+	std::sort( samples.begin(), samples.end() );
+	stats.avg_ns = total / size;
+	stats.p50_ns = samples[ size * 50 / 100 ];
+	stats.p95_ns = samples[ size * 95 / 100 ];
+	stats.p99_ns = samples[ size * 99 / 100 ];
+	stats.max_ns = samples.back();
+	return stats;
+}
+
+Profiler::Profiler()
+	: m_started_at_ms( GetTimeMs() ) {
+	//
+}
+
+Profiler::Section* Profiler::AddSection( const std::string& name ) {
+	std::lock_guard< std::mutex > guard( m_sections_mutex );
+	for ( const auto& section : m_sections ) {
+		if ( section->GetName() == name ) {
+			return section.get();
+		}
+	}
+	m_sections.push_back( std::make_unique< Section >( name ) );
+	return m_sections.back().get();
+}
+
+const std::vector< Profiler::Section* > Profiler::GetSections() const {
+	std::lock_guard< std::mutex > guard( m_sections_mutex );
+	std::vector< Section* > result = {};
+	result.reserve( m_sections.size() );
+	for ( const auto& section : m_sections ) {
+		result.push_back( section.get() );
+	}
+	return result;
+}
+
+void Profiler::AddSpike( spike_t&& spike ) {
+	spike.at_ms = GetTimeMs() - m_started_at_ms;
+	std::lock_guard< std::mutex > guard( m_spikes_mutex );
+	m_spikes.push_back( std::move( spike ) );
+	if ( m_spikes.size() > SPIKES_COUNT ) {
+		m_spikes.pop_front();
+	}
+}
+
+const std::vector< Profiler::spike_t > Profiler::GetSpikes() const {
+	std::lock_guard< std::mutex > guard( m_spikes_mutex );
+	return std::vector< spike_t >( m_spikes.begin(), m_spikes.end() );
+}
+
+const std::string Profiler::GetReport() const {
+	std::string result = "";
+	char line[ 256 ];
+	snprintf( line, sizeof( line ), "%-48s %10s %10s %10s %10s %10s %10s\n", "SECTION", "COUNT", "AVG", "P50", "P95", "P99", "MAX" );
+	result += line;
+	for ( const auto* section : GetSections() ) {
+		const auto stats = section->GetStats();
+		snprintf(
+			line, sizeof( line ), "%-48s %10llu %10s %10s %10s %10s %10s\n",
+			section->GetName().c_str(),
+			(unsigned long long)stats.count,
+			FormatDuration( stats.avg_ns ).c_str(),
+			FormatDuration( stats.p50_ns ).c_str(),
+			FormatDuration( stats.p95_ns ).c_str(),
+			FormatDuration( stats.p99_ns ).c_str(),
+			FormatDuration( stats.max_ns ).c_str()
+		);
+		result += line;
+	}
+	const auto spikes = GetSpikes();
+	if ( !spikes.empty() ) {
+		result += "\nSPIKES\n";
+		for ( const auto& spike : spikes ) {
+			result += std::to_string( spike.at_ms ) + "ms " + spike.name + " " + FormatDuration( spike.duration_ns ) + ":";
+			for ( const auto& part : spike.parts ) {
+				result += " " + part.first + "=" + FormatDuration( part.second );
+			}
+			result += "\n";
+		}
+	}
+	return result;
+}
+
+void Profiler::Dump( const std::string& path ) const {
+	Log( "Writing profile to " + path );
+	util::FS::WriteFile( path, GetReport() );
+}
+
+const std::string Profiler::FormatDuration( const uint64_t ns ) {
+	char result[ 32 ];
+	if ( ns < 1000000 ) {
+		snprintf( result, sizeof( result ), "%.1fus", (double)ns / 1000 );
+	}
+	else {
+		snprintf( result, sizeof( result ), "%.2fms", (double)ns / 1000000 );
+	}
+	return result;
+}
+
+const uint64_t Profiler::GetTimeMs() {
+	return std::chrono::duration_cast< std::chrono::milliseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+
+#include "Common.h"
+
+namespace common {
+
+// collects durations of thread iterations, modules and tasks ( enabled with --profile )
+// every section is written by one thread only and without locks, stats can be read from any thread
+CLASS( Profiler, Class )
+
+	// how many last durations are kept per section for percentiles
+	static const size_t SAMPLES_COUNT = 1024;
+
+	// iteration is considered spike if it's longer than SPIKE_MIN_NS and SPIKE_FACTOR times longer than average
+	static const uint64_t SPIKE_MIN_NS = 5000000;
+	static const uint8_t SPIKE_FACTOR = 4;
+	static const size_t SPIKES_COUNT = 32; // older spikes are forgotten
+
+	struct stats_t {
+		uint64_t count = 0; // all time
+		uint64_t avg_ns = 0; // this and below - of last SAMPLES_COUNT durations
+		uint64_t p50_ns = 0;
+		uint64_t p95_ns = 0;
+		uint64_t p99_ns = 0;
+		uint64_t max_ns = 0;
+	};
+
+	class Section {
+	public:
+		Section( const std::string& name );
+
+		const std::string& GetName() const;
+
+		// owner thread only, returns true if duration looks like spike
+		const bool Add( const uint64_t ns );
+
+		// any thread
+		const stats_t GetStats() const;
+
+	private:
+		const std::string m_name;
+		std::atomic< uint64_t > m_count = 0;
+		std::atomic< uint32_t > m_samples[SAMPLES_COUNT] = {}; // ring buffer, durations over ~4s are clamped
+		static const uint64_t AVERAGE_WINDOW = 64;
+		uint64_t m_average_ns = 0; // moving average for spike detection
+	};
+
+	struct spike_t {
+		std::string name; // of section
+		uint64_t at_ms = 0; // since profiler was created
+		uint64_t duration_ns = 0;
+		std::vector< std::pair< std::string, uint64_t > > parts = {}; // durations of modules/tasks within it
+	};
+
+	Profiler();
+
+	// returns existing section if there is one with same name, pointer stays valid while profiler exists
+	Section* AddSection( const std::string& name );
+	const std::vector< Section* > GetSections() const;
+
+	void AddSpike( spike_t&& spike );
+	const std::vector< spike_t > GetSpikes() const;
+
+	const std::string GetReport() const;
+	void Dump( const std::string& path ) const;
+
+	static const std::string FormatDuration( const uint64_t ns );
+
+private:
+	const uint64_t m_started_at_ms = 0;
+	static const uint64_t GetTimeMs();
+
+	mutable std::mutex m_sections_mutex;
+	std::vector< std::unique_ptr< Section > > m_sections = {};
+
+	mutable std::mutex m_spikes_mutex;
+	std::deque< spike_t > m_spikes = {};
+
+};
+
+}
+
+// nullptr if profiling is disabled
+extern common::Profiler* g_profiler;
@@ -5,9 +5,12 @@
 
 #include "Thread.h"
 #include "common/Module.h"
+#include "common/Profiler.h"
 
 namespace common {
 
+static thread_local Thread* s_current_thread = nullptr;
+
 Thread::Thread( const std::string& thread_name )
 	: m_thread_name( thread_name ) {
 	m_state = STATE_INACTIVE;
@@ -27,6 +30,10 @@ Thread::~Thread() {
 void Thread::SetIPS( const float ips ) {
 	m_ips = ips;
 }
+void Thread::SetWakeable( const uint32_t max_tick_ms ) {
+	ASSERT( max_tick_ms, "max tick can't be zero" );
+	m_max_tick_ms = max_tick_ms;
+}
 void Thread::AddModule( Module* module ) {
 	ASSERT( module, "null module added" );
 	m_modules.push_back( module );
@@ -46,6 +53,19 @@ void Thread::T_Stop() {
 	ASSERT( m_command == COMMAND_NONE, "thread command overlap" );
 	Log( "Sent STOP command" );
 	m_command = Thread::COMMAND_STOP;
+	T_Wakeup();
+}
+
+void Thread::T_Wakeup() {
+	if ( m_max_tick_ms ) {
+		for ( const auto& module : m_modules ) {
+			module->Wakeup();
+		}
+	}
+}
+
+Thread* Thread::GetCurrent() {
+	return s_current_thread;
 }
 
 void Thread::Run() {
@@ -54,6 +74,8 @@ void Thread::Run() {
 
 	Log( "Starting thread" );
 
+	s_current_thread = this;
+
 #ifdef DEBUG
 	m_icounter = 0;
 #endif
@@ -66,10 +88,15 @@ void Thread::Run() {
 	float step_len;
 	size_t step_len_rounded;
 
-#ifdef DEBUG
-	size_t modulensdiff[m_modules.size()];
-	memset( modulensdiff, 0, sizeof( modulensdiff ) );
-#endif
+	Profiler::Section* profile = nullptr;
+	std::vector< Profiler::Section* > module_profiles = {};
+	std::vector< uint64_t > module_ns( m_modules.size(), 0 );
+	if ( g_profiler ) {
+		profile = g_profiler->AddSection( m_thread_name );
+		for ( const auto& module : m_modules ) {
+			module_profiles.push_back( g_profiler->AddSection( m_thread_name + " " + module->GetClassName() ) );
+		}
+	}
 
 	m_state = STATE_ACTIVE;
 
@@ -81,34 +108,40 @@ void Thread::Run() {
 
 		auto start = std::chrono::high_resolution_clock::now();
 
-#ifdef DEBUG
 		auto mstart = start;
-#endif
 
 		for ( modules_t::iterator it = m_modules.begin() ; it < m_modules.end() ; ++it ) {
 			//Log( "Iterating [" + (*it)->GetName() + "]" );
 			( *it )->Iterate();
-#ifdef DEBUG
-			auto mfinish = std::chrono::high_resolution_clock::now();
-			modulensdiff[ it - m_modules.begin() ] = std::chrono::duration_cast< std::chrono::nanoseconds >( mfinish - mstart ).count();
-			mstart = mfinish;
-#endif
+			if ( profile ) {
+				const auto mfinish = std::chrono::high_resolution_clock::now();
+				const size_t i = it - m_modules.begin();
+				module_ns[ i ] = std::chrono::duration_cast< std::chrono::nanoseconds >( mfinish - mstart ).count();
+				module_profiles[ i ]->Add( module_ns[ i ] );
+				mstart = mfinish;
+			}
 		}
 
 		auto finish = std::chrono::high_resolution_clock::now();
 
 		auto nsdiff = std::chrono::duration_cast< std::chrono::nanoseconds >( finish - start ).count();
 
+		if ( profile && profile->Add( nsdiff ) ) {
+			Profiler::spike_t spike = {};
+			spike.name = m_thread_name;
+			spike.duration_ns = nsdiff;
+			for ( size_t i = 0 ; i < m_modules.size() ; i++ ) {
+				spike.parts.push_back( { m_modules[ i ]->GetClassName(), module_ns[ i ] } );
+			}
+			g_profiler->AddSpike( std::move( spike ) );
+		}
+
 		step_len = 1000000000 / m_ips - step_diff;
-		if ( nsdiff > step_len ) {
-#ifdef DEBUG
-/*	TODO: fix and add stats to debug overlay			
-				Log( "Thread lag detected!" );
-				for ( modules_t::iterator it = m_modules.begin() ; it != m_modules.end() ; ++it ) {
-					Log( (*it)->GetName() + " " + std::to_string( modulensdiff[ it - m_modules.begin() ] ) + "ns ( " + std::to_string( (float) modulensdiff[ it - m_modules.begin() ] * 100 / step_len ) + "%)");
-				}
-				*/
-#endif
+		if ( m_max_tick_ms ) {
+			// modules interrupt waiting when they have something to do
+			Wait( (uint64_t)m_max_tick_ms * 1000000 );
+		}
+		else if ( nsdiff > step_len ) {
 			step_diff = 0.0f;
 			// TODO: change ips?
 		}
@@ -119,13 +152,9 @@ void Thread::Run() {
 
 #ifdef DEBUG
 			m_icounter++;
-/*				Log( "frame " + std::to_string( m_icounter ) + ": sleeping " + std::to_string( step_len_rounded) + "ns (nsdiff: " + std::to_string( nsdiff ) + ", stepdiff: " + std::to_string( step_diff ) + ")" );
-				for ( modules_t::iterator it = m_modules.begin() ; it != m_modules.end() ; ++it ) {
-					Log( (*it)->GetName() + " " + std::to_string( modulensdiff[ it - m_modules.begin() ] ) + "ns ( " + std::to_string( (float) modulensdiff[ it - m_modules.begin() ] * 100 / step_len ) + "%)");
-				}*/
 #endif
 
-			std::this_thread::sleep_for( std::chrono::nanoseconds( step_len_rounded ) );
+			Wait( step_len_rounded );
 		}
 
 		switch ( m_command ) {
@@ -150,6 +179,8 @@ void Thread::Run() {
 
 	Log( "Thread stopped" );
 
+	s_current_thread = nullptr;
+
 	m_state = STATE_INACTIVE;
 
 /*	} catch ( runtime_error &e ) {
@@ -165,6 +196,16 @@ void Thread::Run() {
 	}*/
 }
 
+void Thread::Wait( const uint64_t max_ns ) {
+	bool is_waited = false;
+	for ( modules_t::iterator it = m_modules.begin() ; it < m_modules.end() && !is_waited ; ++it ) {
+		is_waited = ( *it )->Wait( max_ns );
+	}
+	if ( !is_waited ) {
+		std::this_thread::sleep_for( std::chrono::nanoseconds( max_ns ) );
+	}
+}
+
 const std::string& Thread::GetThreadName() const {
 	return m_thread_name;
 }
@@ -28,11 +28,18 @@ CLASS( Thread, Class )
 	~Thread();
 
 	void SetIPS( const float ips );
+	// iterate as soon as modules have something to do ( see Module::Wait() ), but at least once per max_tick_ms
+	// ips is ignored then, only first module that supports Wait() is waited on ( if none - thread just sleeps max_tick_ms )
+	void SetWakeable( const uint32_t max_tick_ms );
 	void AddModule( Module* module );
 
 	void T_Start();
 	bool T_IsRunning();
 	void T_Stop();
+	void T_Wakeup(); // interrupts waiting of modules so that next iteration starts immediately
+
+	// nullptr if called from thread that isn't run by Thread
+	static Thread* GetCurrent();
 
 	const std::string& GetThreadName() const;
 
@@ -40,12 +47,14 @@ protected:
 	const std::string m_thread_name = "";
 
 	void Run();
+	void Wait( const uint64_t max_ns ); // sleeps or lets modules wait for their events
 	std::thread* m_thread = nullptr;
 
 	std::atomic< thread_state_t > m_state = STATE_INACTIVE;
 	std::atomic< thread_command_t > m_command = COMMAND_NONE;
 	modules_t m_modules = {};
 	float m_ips = 10;
+	uint32_t m_max_tick_ms = 0; // not wakeable if 0
 
 #ifdef DEBUG
 
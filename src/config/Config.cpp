@@ -1,5 +1,6 @@
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
 
 #include "Config.h"
 
@@ -56,12 +57,100 @@ Config::Config( const int argc, const char* argv[] )
 			m_data_path = value;
 		}
 	);
+	m_parser->AddRule(
+		"download-window", "CHUNKS", "Number of snapshot chunks server may send ahead of acknowledgements when joining game (default: " + std::to_string( m_download_window ) + ")", AH( this ) {
+			try {
+				m_download_window = std::stoul( value );
+			}
+			catch ( std::logic_error& e ) {
+				m_download_window = 0;
+			}
+			if ( !m_download_window ) {
+				Error( "Invalid download window specified! Must be positive number." );
+			}
+		}
+	);
 	m_parser->AddRule(
 		"help", "Show this message", AH( this ) {
 			std::cout << m_parser->GetHelpString() << std::endl;
 			exit( EXIT_SUCCESS );
 		}
 	);
+	const std::string s_map_benchmark_argument_missing = "Map benchmark options can only be used after --map-benchmark argument!";
+	m_parser->AddRule(
+		"map-benchmark", "OUTPUT_FILE", "Generate maps without rendering and write timings to OUTPUT_FILE (json)", AH( this ) {
+			m_map_benchmark_output = value;
+			m_launch_flags |= LF_MAP_BENCHMARK;
+		}
+	);
+	m_parser->AddRule(
+		"map-benchmark-sizes", "SIZES", "Comma-separated map sizes for benchmark, for example: 40x80,64x128 (default: all standard sizes)", AH( this, s_map_benchmark_argument_missing ) {
+			if ( !HasLaunchFlag( LF_MAP_BENCHMARK ) ) {
+				Error( s_map_benchmark_argument_missing );
+			}
+			m_map_benchmark_sizes.clear();
+			size_t pos = 0;
+			while ( pos <= value.size() ) {
+				size_t end = value.find( ',', pos );
+				if ( end == std::string::npos ) {
+					end = value.size();
+				}
+				m_map_benchmark_sizes.push_back( ParseSize( value.substr( pos, end - pos ) ) );
+				pos = end + 1;
+			}
+		}
+	);
+	m_parser->AddRule(
+		"map-benchmark-seeds", "COUNT", "Number of seeds to generate per map size in benchmark (default: " + std::to_string( m_map_benchmark_seeds ) + ")", AH( this, s_map_benchmark_argument_missing ) {
+			if ( !HasLaunchFlag( LF_MAP_BENCHMARK ) ) {
+				Error( s_map_benchmark_argument_missing );
+			}
+			try {
+				m_map_benchmark_seeds = std::stoul( value );
+			}
+			catch ( std::logic_error& e ) {
+				m_map_benchmark_seeds = 0;
+			}
+			if ( !m_map_benchmark_seeds ) {
+				Error( "Invalid seeds count specified! Must be positive number." );
+			}
+		}
+	);
+	m_parser->AddRule(
+		"map-serial", "Process map tiles in single thread (slower, but useful for comparing results or if parallel generation misbehaves)", AH( this ) {
+			m_launch_flags |= LF_MAP_SERIAL;
+		}
+	);
+	m_parser->AddRule(
+		"mt-benchmark", "Measure latency and throughput of requests between threads and exit", AH( this ) {
+			m_launch_flags |= LF_MT_BENCHMARK;
+		}
+	);
+	m_parser->AddRule(
+		"network-buffer-limit", "MEGABYTES", "Max size of incoming packet per connection, larger packets cause disconnect (default: " + std::to_string( m_network_buffer_limit / 1024 / 1024 ) + ")", AH( this ) {
+			size_t megabytes = 0;
+			try {
+				megabytes = std::stoul( value );
+			}
+			catch ( std::logic_error& e ) {
+				megabytes = 0;
+			}
+			if ( !megabytes ) {
+				Error( "Invalid network buffer limit specified! Must be positive number." );
+			}
+			m_network_buffer_limit = megabytes * 1024 * 1024;
+		}
+	);
+	m_parser->AddRule(
+		"network-compression-threshold", "BYTES", "Compress network packets of this size or larger, 0 to disable compression (default: " + std::to_string( m_network_compression_threshold ) + ")", AH( this ) {
+			try {
+				m_network_compression_threshold = std::stoul( value );
+			}
+			catch ( std::logic_error& e ) {
+				Error( "Invalid network compression threshold specified! Must be non-negative number." );
+			}
+		}
+	);
 	m_parser->AddRule(
 		"nosound", "Start without sound", AH( this ) {
 			m_launch_flags |= LF_NOSOUND;
@@ -72,6 +161,17 @@ Config::Config( const int argc, const char* argv[] )
 			m_prefix = value + util::FS::PATH_SEPARATOR;
 		}
 	);
+	m_parser->AddRule(
+		"profile", "OUTPUT_FILE", "Measure iteration times of threads, modules and tasks, write them to OUTPUT_FILE on exit or on Ctrl+`", AH( this ) {
+			m_profile_output = value;
+			m_launch_flags |= LF_PROFILE;
+		}
+	);
+	m_parser->AddRule(
+		"self-tests", "Run engine self-tests (in any build type) and exit, exit code is nonzero if any test failed", AH( this ) {
+			m_launch_flags |= LF_SELF_TESTS;
+		}
+	);
 	m_parser->AddRule(
 		"skipintro", "Skip intro", AH( this ) {
 			m_launch_flags |= LF_SKIPINTRO;
@@ -119,6 +219,38 @@ Config::Config( const int argc, const char* argv[] )
 			m_debug_flags |= DF_GDB;
 		}
 	);
+	m_parser->AddRule(
+		"log-decode", "BINARY_LOG_FILE", "Print binary log file (see --log-file) as text and exit", AH( this ) {
+			m_debug_flags |= DF_LOG_DECODE;
+			m_log_decode_file = value;
+		}
+	);
+	m_parser->AddRule(
+		"log-file", "BINARY_LOG_FILE", "Also write logs to binary file", AH( this ) {
+			m_debug_flags |= DF_LOG_FILE;
+			m_log_file = value;
+		}
+	);
+	m_parser->AddRule(
+		"log-level", "LEVEL", "Skip logs below LEVEL (debug, info, warning, error; default: info)", AH( this ) {
+			const std::vector< std::string > levels = {
+				"debug",
+				"info",
+				"warning",
+				"error",
+			};
+			const auto it = std::find( levels.begin(), levels.end(), value );
+			if ( it == levels.end() ) {
+				Error( "Invalid --log-level value specified! Possible choices: debug info warning error" );
+			}
+			m_log_level = (logger::level_t)( it - levels.begin() );
+		}
+	);
+	m_parser->AddRule(
+		"log-sync", "Print logs immediately from thread that logged them (slower, but nothing is lost on crash)", AH( this ) {
+			m_debug_flags |= DF_LOG_SYNC;
+		}
+	);
 	m_parser->AddRule(
 		"mapdump", "Save map dump upon loading map", AH( this ) {
 			m_debug_flags |= DF_MAPDUMP;
@@ -338,6 +470,34 @@ const types::Vec2< size_t >& Config::GetWindowSize() const {
 	return m_window_size;
 }
 
+const std::string& Config::GetMapBenchmarkOutput() const {
+	return m_map_benchmark_output;
+}
+
+const std::vector< types::Vec2< size_t > >& Config::GetMapBenchmarkSizes() const {
+	return m_map_benchmark_sizes;
+}
+
+const size_t Config::GetMapBenchmarkSeeds() const {
+	return m_map_benchmark_seeds;
+}
+
+const size_t Config::GetDownloadWindow() const {
+	return m_download_window;
+}
+
+const size_t Config::GetNetworkBufferLimit() const {
+	return m_network_buffer_limit;
+}
+
+const size_t Config::GetNetworkCompressionThreshold() const {
+	return m_network_compression_threshold;
+}
+
+const std::string& Config::GetProfileOutput() const {
+	return m_profile_output;
+}
+
 #ifdef DEBUG
 
 const bool Config::HasDebugFlag( const debug_flag_t flag ) const {
@@ -380,6 +540,18 @@ const std::string& Config::GetGSETestsScript() const {
 	return m_gse_tests_script;
 }
 
+const std::string& Config::GetLogFile() const {
+	return m_log_file;
+}
+
+const std::string& Config::GetLogDecodeFile() const {
+	return m_log_decode_file;
+}
+
+const logger::level_t Config::GetLogLevel() const {
+	return m_log_level;
+}
+
 #endif
 
 }
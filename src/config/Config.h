@@ -1,12 +1,14 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "common/Module.h"
 
 #include "util/random/Types.h"
 #include "game/settings/Types.h"
 #include "types/Vec2.h"
+#include "logger/Types.h"
 
 namespace util {
 class ArgParser;
@@ -20,14 +22,19 @@ CLASS( Config, common::Module )
 
 	void Init();
 
-	enum launch_flag_t : uint8_t {
+	enum launch_flag_t : uint16_t {
 		LF_NONE = 0,
 		LF_BENCHMARK = 1 << 0,
 		LF_SHOWFPS = 1 << 1,
 		LF_NOSOUND = 1 << 2,
 		LF_SKIPINTRO = 1 << 3,
 		LF_WINDOWED = 1 << 4,
-		LF_WINDOW_SIZE = 1 << 5
+		LF_WINDOW_SIZE = 1 << 5,
+		LF_MAP_BENCHMARK = 1 << 6,
+		LF_MT_BENCHMARK = 1 << 7,
+		LF_PROFILE = 1 << 8,
+		LF_MAP_SERIAL = 1 << 9,
+		LF_SELF_TESTS = 1 << 10,
 	};
 
 #ifdef DEBUG
@@ -51,6 +58,9 @@ CLASS( Config, common::Module )
 		DF_GSE_TESTS_SCRIPT = 1 << 15,
 		DF_GSE_PROMPT_JS = 1 << 16,
 		DF_NOPINGS = 1 << 17,
+		DF_LOG_FILE = 1 << 18,
+		DF_LOG_DECODE = 1 << 19,
+		DF_LOG_SYNC = 1 << 20,
 	};
 #endif
 
@@ -67,6 +77,13 @@ CLASS( Config, common::Module )
 
 	const bool HasLaunchFlag( const launch_flag_t flag ) const;
 	const types::Vec2< size_t >& GetWindowSize() const;
+	const std::string& GetMapBenchmarkOutput() const;
+	const std::vector< types::Vec2< size_t > >& GetMapBenchmarkSizes() const;
+	const size_t GetMapBenchmarkSeeds() const;
+	const size_t GetDownloadWindow() const;
+	const size_t GetNetworkBufferLimit() const;
+	const size_t GetNetworkCompressionThreshold() const;
+	const std::string& GetProfileOutput() const;
 
 #ifdef DEBUG
 
@@ -80,6 +97,9 @@ CLASS( Config, common::Module )
 	const game::settings::map_config_value_t GetQuickstartMapLifeforms() const;
 	const game::settings::map_config_value_t GetQuickstartMapClouds() const;
 	const std::string& GetGSETestsScript() const;
+	const std::string& GetLogFile() const;
+	const std::string& GetLogDecodeFile() const;
+	const logger::level_t GetLogLevel() const;
 
 #endif
 
@@ -103,8 +123,15 @@ private:
 	std::string m_data_path;
 	std::string m_smac_path;
 
-	uint8_t m_launch_flags = LF_NONE;
+	uint16_t m_launch_flags = LF_NONE;
 	types::Vec2< size_t > m_window_size = {};
+	std::string m_map_benchmark_output = "";
+	std::vector< types::Vec2< size_t > > m_map_benchmark_sizes = {};
+	size_t m_map_benchmark_seeds = 3;
+	size_t m_download_window = 16;
+	size_t m_network_buffer_limit = 64 * 1024 * 1024;
+	size_t m_network_compression_threshold = 512;
+	std::string m_profile_output = "";
 
 #ifdef DEBUG
 
@@ -120,6 +147,10 @@ private:
 
 	std::string m_gse_tests_script = "";
 
+	std::string m_log_file = "";
+	std::string m_log_decode_file = "";
+	logger::level_t m_log_level = logger::LL_INFO;
+
 #endif
 };
 
@@ -1,5 +1,7 @@
 #ifdef DEBUG
 
+#include <algorithm>
+
 #include "DebugOverlay.h"
 
 #include "engine/Engine.h"
@@ -10,6 +12,7 @@
 #include "ui/event/Types.h"
 #include "ui/object/Label.h"
 #include "ui/object/Surface.h"
+#include "common/Profiler.h"
 
 namespace debug {
 
@@ -19,6 +22,7 @@ void DebugOverlay::Start() {
 
 	m_font_size = 16;
 	m_memory_stats_lines = 10;
+	m_profiler_lines = 20;
 
 	m_stats_font = g_engine->GetFontLoader()->LoadFont( resource::TTF_ARIALN, m_font_size );
 
@@ -98,6 +102,25 @@ void DebugOverlay::Show() {
 			g_engine->GetUI()->AddObject( m_background_middle );
 		}
 
+		if ( g_profiler ) {
+			for ( int i = 0 ; i < m_profiler_lines ; i++ ) {
+				NEWV( label, ui::object::Label );
+				ActivateLabel( label, 680, i * ( m_font_size + 1 ) );
+				m_profiler_labels.push_back( label );
+			}
+
+			NEW( m_background_right, ui::object::Surface );
+			m_background_right->SetAlign( ui::ALIGN_TOP | ui::ALIGN_LEFT );
+			m_background_right->SetLeft( 680 );
+			m_background_right->SetRight( 0 );
+			m_background_right->SetTop( 0 );
+			m_background_right->SetHeight( m_profiler_lines * 18 );
+			m_background_right->SetWidth( 560 );
+			m_background_right->SetZIndex( 0.9 );
+			m_background_right->SetTexture( m_background_texture );
+			g_engine->GetUI()->AddObject( m_background_right );
+		}
+
 		m_stats_timer.SetInterval( 1000 ); // track stats/second
 
 		m_is_visible = true;
@@ -125,6 +148,15 @@ void DebugOverlay::Hide() {
 		}
 		m_memory_stats_labels.clear();
 
+		if ( m_background_right ) {
+			for ( auto& it : m_profiler_labels ) {
+				g_engine->GetUI()->RemoveObject( it );
+			}
+			m_profiler_labels.clear();
+			g_engine->GetUI()->RemoveObject( m_background_right );
+			m_background_right = nullptr;
+		}
+
 #define D( _stat ) \
             g_engine->GetUI()->RemoveObject( m_##_stats_label_##_stat );
 		DEBUG_STATS;
@@ -177,11 +209,66 @@ void DebugOverlay::Refresh() {
 			m_memory_stats_labels[ i ]->SetText( size + "  " + count + "  " + stats[ i ].key );
 		}
 
+		if ( !m_profiler_labels.empty() ) {
+			RefreshProfiler();
+		}
+
 		DEBUG_STATS_SET_RW();
 
 	}
 }
 
+// slowest sections first, last spike at the bottom
+void DebugOverlay::RefreshProfiler() {
+	std::vector< std::pair< common::Profiler::stats_t, std::string > > sections = {};
+	for ( const auto* section : g_profiler->GetSections() ) {
+		sections.push_back(
+			{
+				section->GetStats(),
+				section->GetName()
+			}
+		);
+	}
+	std::sort(
+		sections.begin(), sections.end(), []( const auto& a, const auto& b ) {
+			return a.first.p99_ns > b.first.p99_ns;
+		}
+	);
+
+	const auto& f_duration = []( const uint64_t ns ) {
+		std::string result = common::Profiler::FormatDuration( ns );
+		result.insert( result.begin(), 10 - std::min< size_t >( result.length(), 10 ), ' ' );
+		return result;
+	};
+
+	size_t line = 0;
+	m_profiler_labels[ line++ ]->SetText( "p50 / p95 / p99 / max" );
+	for ( const auto& it : sections ) {
+		if ( line >= m_profiler_lines - 1 ) {
+			break;
+		}
+		m_profiler_labels[ line++ ]->SetText( f_duration( it.first.p50_ns ) + f_duration( it.first.p95_ns ) + f_duration( it.first.p99_ns ) + f_duration( it.first.max_ns ) + "  " + it.second );
+	}
+	while ( line < m_profiler_lines - 1 ) {
+		m_profiler_labels[ line++ ]->SetText( "" );
+	}
+
+	const auto spikes = g_profiler->GetSpikes();
+	if ( !spikes.empty() ) {
+		const auto& spike = spikes.back();
+		std::string text = "last spike: " + spike.name + " " + common::Profiler::FormatDuration( spike.duration_ns ) + " at " + std::to_string( spike.at_ms / 1000 ) + "s";
+		const auto slowest = std::max_element(
+			spike.parts.begin(), spike.parts.end(), []( const auto& a, const auto& b ) {
+				return a.second < b.second;
+			}
+		);
+		if ( slowest != spike.parts.end() ) {
+			text += " ( " + slowest->first + " " + common::Profiler::FormatDuration( slowest->second ) + " )";
+		}
+		m_profiler_labels[ line ]->SetText( text );
+	}
+}
+
 void DebugOverlay::ClearStats() {
 	// common statistics
 #define D( _stat ) \
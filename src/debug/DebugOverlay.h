@@ -45,6 +45,7 @@ protected:
 	types::texture::Texture* m_background_texture = nullptr;
 	ui::object::Surface* m_background_left = nullptr;
 	ui::object::Surface* m_background_middle = nullptr;
+	ui::object::Surface* m_background_right = nullptr;
 
 	size_t m_memory_stats_lines = 0;
 	size_t m_font_size = 0;
@@ -55,6 +56,11 @@ protected:
 #undef D
 
 	std::vector< ui::object::Label* > m_memory_stats_labels = {};
+
+	size_t m_profiler_lines = 0;
+	std::vector< ui::object::Label* > m_profiler_labels = {};
+	void RefreshProfiler();
+
 	void ActivateLabel( ui::object::Label* label, const size_t left, const size_t top );
 
 private:
@@ -4,6 +4,7 @@
 #include "Engine.h"
 #include "config/Config.h"
 #include "common/Thread.h"
+#include "common/JobSystem.h"
 #include "error_handler/ErrorHandler.h"
 #include "logger/Logger.h"
 #include "resource/ResourceManager.h"
@@ -21,6 +22,8 @@
 
 // TODO: move to config
 const size_t g_max_fps = 500;
+// threads that don't render sleep until they have something to do, but not longer than this
+static const uint32_t s_max_tick_ms = 100;
 
 engine::Engine* g_engine = NULL;
 
@@ -63,6 +66,8 @@ Engine::Engine(
 
 	g_engine = this;
 
+	NEW( m_job_system, common::JobSystem );
+
 	NEWV( t_main, common::Thread, "MAIN" );
 	if ( m_config->HasLaunchFlag( config::Config::LF_BENCHMARK ) ) {
 		t_main->SetIPS( 999999.9f );
@@ -76,10 +81,7 @@ Engine::Engine(
 	t_main->AddModule( m_texture_loader );
 	t_main->AddModule( m_sound_loader );
 	t_main->AddModule( m_logger );
-#ifdef DEBUG
-	if ( !m_config->HasDebugFlag( config::Config::DF_GSE_ONLY ) )
-#endif
-	{
+	if ( m_resource_manager ) {
 		m_resource_manager->Init( m_config->GetPossibleSMACPaths() );
 		t_main->AddModule( m_resource_manager );
 	}
@@ -92,12 +94,14 @@ Engine::Engine(
 
 	NEWV( t_network, common::Thread, "NETWORK" );
 	t_network->SetIPS( 100 );
+	t_network->SetWakeable( s_max_tick_ms );
 	t_network->AddModule( m_network );
 	m_threads.push_back( t_network );
 
 	if ( m_game ) {
 		NEWV( t_game, common::Thread, "GAME" );
 		t_game->SetIPS( g_max_fps );
+		t_game->SetWakeable( s_max_tick_ms );
 		t_game->AddModule( m_game );
 		m_threads.push_back( t_game );
 	}
@@ -113,6 +117,7 @@ Engine::~Engine() {
 			DELETE( thread );
 		}
 	}
+	DELETE( m_job_system );
 }
 
 int Engine::Run() {
@@ -125,13 +130,16 @@ int Engine::Run() {
 	}
 
 	try {
-		while ( !m_is_shutting_down ) {
-			for ( auto& thread : m_threads ) {
-				// ?
-			}
-			std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+		{
+			std::unique_lock< std::mutex > lock( m_shutdown_mutex );
+			m_shutdown_cv.wait(
+				lock, [ this ]() {
+					return m_is_shutting_down.load();
+				}
+			);
 		}
 		Log( "Shutting down" );
+		result = m_shutdown_result.load();
 
 		for ( auto& thread : m_threads ) {
 			thread->T_Stop();
@@ -174,9 +182,13 @@ int Engine::Run() {
 	return result;
 }
 
-void Engine::ShutDown() {
-
-	m_is_shutting_down = true;
+void Engine::ShutDown( const int result ) {
+	m_shutdown_result = result;
+	{
+		std::lock_guard< std::mutex > guard( m_shutdown_mutex );
+		m_is_shutting_down = true;
+	}
+	m_shutdown_cv.notify_all();
 }
 
 }
@@ -3,6 +3,9 @@
 #include <vector>
 #include <unordered_map>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <cstdlib>
 
 #include "common/Common.h"
 
@@ -11,6 +14,7 @@ extern const size_t g_max_fps;
 
 namespace common {
 class Thread;
+class JobSystem;
 }
 
 namespace config {
@@ -96,7 +100,8 @@ CLASS( Engine, common::Class );
 
 	~Engine();
 	int Run();
-	void ShutDown();
+	// result is returned by Run(), unless shutdown was caused by error
+	void ShutDown( const int result = EXIT_SUCCESS );
 
 	config::Config* GetConfig() const { return m_config; }
 	logger::Logger* GetLogger() const { return m_logger; }
@@ -112,12 +117,17 @@ CLASS( Engine, common::Class );
 	scheduler::Scheduler* GetScheduler() const { return m_scheduler; }
 	ui::UI* GetUI() const { return m_ui; }
 	game::Game* GetGame() const { return m_game; }
+	common::JobSystem* GetJobSystem() const { return m_job_system; }
 
 protected:
 
 	std::atomic< bool > m_is_shutting_down = false;
+	std::atomic< int > m_shutdown_result = EXIT_SUCCESS;
+	std::mutex m_shutdown_mutex;
+	std::condition_variable m_shutdown_cv;
 
 	std::vector< common::Thread* > m_threads = {};
+	common::JobSystem* m_job_system = nullptr; // for cpu-heavy work of any module
 
 	config::Config* const m_config = nullptr;
 	error_handler::ErrorHandler* m_error_handler = nullptr;
@@ -3,6 +3,7 @@
 #ifdef DEBUG
 
 #include <mutex>
+#include <atomic>
 
 #include "debug/MemoryWatcher.h"
 
@@ -39,7 +40,7 @@
 
 struct debug_stats_t {
 	std::mutex _mutex; \
-        bool _readonly = false;
+        std::atomic< bool > _readonly = false; // atomic so that loggers can check it without locking
 	DEBUG_STATS
 };
 
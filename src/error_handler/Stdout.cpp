@@ -1,8 +1,14 @@
 #include "Stdout.h"
 
+#include "engine/Engine.h"
+#include "logger/Logger.h"
+
 namespace error_handler {
 
 void Stdout::HandleError( const std::runtime_error& e ) const {
+	if ( g_engine ) {
+		g_engine->GetLogger()->Flush(); // so that error is printed after everything that was logged before it
+	}
 	printf( "FATAL ERROR: %s\n", e.what() );
 	//exit( EXIT_FAILURE );
 	throw e;
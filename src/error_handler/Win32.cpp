@@ -2,10 +2,16 @@
 
 #include <iostream>
 
+#include "engine/Engine.h"
+#include "logger/Logger.h"
+
 namespace error_handler {
 
 void Win32::HandleError( const std::runtime_error& e ) const {
 #ifdef _WIN32
+	if ( g_engine ) {
+		g_engine->GetLogger()->Flush();
+	}
 	std::cout << e.what() << std::endl;
 	MessageBoxA( NULL, e.what() , "Application error", MB_OK );
 	exit( EXIT_FAILURE );
@@ -30,8 +30,8 @@
 #include "ui/UI.h"
 #include "map/tile/Tiles.h"
 #include "map/MapState.h"
+#include "map/TerrainTexture.h"
 #include "bindings/Bindings.h"
-#include "graphics/Graphics.h"
 #include "animation/Def.h"
 #include "unit/Def.h"
 #include "unit/Unit.h"
@@ -126,11 +126,11 @@ common::mt_id_t Game::MT_SendBackendRequests( const std::vector< BackendRequest
 	return MT_CreateRequest( request );
 }
 
-common::mt_id_t Game::MT_AddEvent( const event::Event* event ) {
+void Game::MT_AddEvent( const event::Event* event ) {
 	MT_Request request = {};
 	request.op = OP_ADD_EVENT;
 	NEW( request.data.add_event.serialized_event, std::string, event::Event::Serialize( event ).ToString() );
-	return MT_CreateRequest( request );
+	MT_CreateRequest( request, false );
 }
 
 #ifdef DEBUG
@@ -517,16 +517,12 @@ const MT_Response Game::ProcessRequest( const MT_Request& request, MT_CANCELABLE
 			const auto tiles_to_reload = m_map_editor->Draw( m_map->GetTile( request.data.edit_map.tile_x, request.data.edit_map.tile_y ), request.data.edit_map.draw_mode );
 
 			if ( !tiles_to_reload.empty() ) {
-				auto* graphics = g_engine->GetGraphics();
-
 				m_map->m_sprite_actors_to_add.clear();
 				m_map->m_sprite_instances_to_remove.clear();
 				m_map->m_sprite_instances_to_add.clear();
 
-				graphics->Lock(); // needed to avoid tearing artifacts
-				m_map->LoadTiles( tiles_to_reload, MT_C );
-				m_map->FixNormals( tiles_to_reload, MT_C );
-				graphics->Unlock();
+				m_map->ReloadTiles( tiles_to_reload, MT_C );
+				InvalidateSnapshot();
 
 				typedef std::unordered_map< std::string, map::sprite_actor_t > t1; // can't use comma in macro below
 				NEW( response.data.edit_map.sprites.actors_to_add, t1 );
@@ -595,6 +591,8 @@ const MT_Response Game::ProcessRequest( const MT_Request& request, MT_CANCELABLE
 						const auto on_complete = it->second;
 						m_running_animations_callbacks.erase( it );
 						on_complete();
+						// callbacks change world outside of events ( i.e. unit arrives to destination tile )
+						InvalidateSnapshot();
 						break;
 					}
 					default:
@@ -778,6 +776,8 @@ void Game::DefineAnimation( animation::Def* def ) {
 
 	ASSERT( m_animation_defs.find( def->m_id ) == m_animation_defs.end(), "Animation definition '" + def->m_id + "' already exists" );
 
+	InvalidateSnapshot();
+
 	// backend doesn't need any animation details, just keep track of it's existence for validations
 	m_animation_defs.insert(
 		{
@@ -823,6 +823,8 @@ void Game::DefineMoraleSet( unit::MoraleSet* moraleset ) {
 
 	ASSERT( m_unit_moralesets.find( moraleset->m_id ) == m_unit_moralesets.end(), "Unit moraleset '" + moraleset->m_id + "' already exists" );
 
+	InvalidateSnapshot();
+
 	m_unit_moralesets.insert(
 		{
 			moraleset->m_id,
@@ -836,6 +838,8 @@ void Game::DefineUnit( unit::Def* def ) {
 
 	ASSERT( m_unit_defs.find( def->m_id ) == m_unit_defs.end(), "Unit definition '" + def->m_id + "' already exists" );
 
+	InvalidateSnapshot();
+
 	m_unit_defs.insert(
 		{
 			def->m_id,
@@ -854,6 +858,8 @@ void Game::SpawnUnit( unit::Unit* unit ) {
 		return;
 	}
 
+	InvalidateSnapshot();
+
 	auto* tile = unit->GetTile();
 
 	Log( "Spawning unit #" + std::to_string( unit->m_id ) + " (" + unit->m_def->m_id + ") at " + tile->ToString() );
@@ -893,15 +899,18 @@ void Game::DespawnUnit( const size_t unit_id ) {
 	ASSERT( it != m_units.end(), "unit id not found" );
 	auto* unit = it->second;
 
+	InvalidateSnapshot();
+
 	Log( "Despawning unit #" + std::to_string( unit->m_id ) + " (" + unit->m_def->m_id + ") at " + unit->GetTile()->ToString() );
 
 	QueueUnitUpdate( unit, UUO_DESPAWN );
 
 	auto* tile = unit->GetTile();
 	ASSERT( tile, "unit tile not set" );
-	const auto& tile_it = tile->units.find( unit->m_id );
-	ASSERT( tile_it != tile->units.end(), "unit id not found in tile" );
-	tile->units.erase( tile_it );
+	auto& tile_units = tile->GetUnits();
+	const auto& tile_it = tile_units.find( unit->m_id );
+	ASSERT( tile_it != tile_units.end(), "unit id not found in tile" );
+	tile_units.erase( tile_it );
 
 	m_units.erase( it );
 
@@ -925,13 +934,15 @@ void Game::SpawnBase( base::Base* base ) {
 		return;
 	}
 
+	InvalidateSnapshot();
+
 	auto* tile = base->GetTile();
 
 	// validate and fix name if needed (or assign if empty)
 	std::vector< std::string > names_to_try = {};
 	if ( base->m_data.name.empty() ) {
 		const auto& names = base->m_owner->GetPlayer()->GetFaction()->m_base_names;
-		names_to_try = tile->is_water_tile
+		names_to_try = tile->IsWater()
 			? names.water
 			: names.land;
 	}
@@ -1027,12 +1038,12 @@ const gse::Value Game::MoveUnitResolve( unit::Unit* unit, map::tile::Tile* dst_t
 void Game::MoveUnitApply( unit::Unit* unit, map::tile::Tile* dst_tile, const gse::Value resolutions ) {
 	ASSERT( dst_tile, "dst tile not set" );
 
-	Log( "Moving unit #" + std::to_string( unit->m_id ) + " to " + dst_tile->coord.ToString() );
+	Log( "Moving unit #" + std::to_string( unit->m_id ) + " to " + dst_tile->GetCoords().ToString() );
 
 	auto* src_tile = unit->GetTile();
 	ASSERT( src_tile, "src tile not set" );
-	ASSERT( src_tile->units.find( unit->m_id ) != src_tile->units.end(), "src tile does not contain this unit" );
-	ASSERT( dst_tile->units.find( unit->m_id ) == dst_tile->units.end(), "dst tile already contains this unit" );
+	ASSERT( src_tile->GetUnits().find( unit->m_id ) != src_tile->GetUnits().end(), "src tile does not contain this unit" );
+	ASSERT( dst_tile->GetUnits().find( unit->m_id ) == dst_tile->GetUnits().end(), "dst tile already contains this unit" );
 
 	const auto result = m_state->m_bindings->Call(
 		bindings::Bindings::CS_ON_UNIT_MOVE_APPLY, {
@@ -1080,8 +1091,8 @@ const std::string* Game::MoveUnitToTile( unit::Unit* unit, map::tile::Tile* dst_
 	auto fr = FrontendRequest( FrontendRequest::FR_UNIT_MOVE );
 	fr.data.unit_move.unit_id = unit->m_id;
 	fr.data.unit_move.dst_tile_coords = {
-		dst_tile->coord.x,
-		dst_tile->coord.y
+		dst_tile->GetCoords().x,
+		dst_tile->GetCoords().y
 	};
 	fr.data.unit_move.running_animation_id = running_animation_id;
 	AddFrontendRequest( fr );
@@ -1229,10 +1240,20 @@ void Game::UncompleteTurn( const size_t slot_num ) {
 }
 
 void Game::FinalizeTurn() {
-	m_turn_checksum = m_current_turn.FinalizeAndChecksum();
+	m_turn_checksum = GetStateChecksum( m_current_turn.FinalizeAndChecksum() );
 	AddEvent( new event::TurnFinalized( m_slot_num, m_turn_checksum ) );
 }
 
+const util::crc32::crc_t Game::GetStateChecksum( util::crc32::crc_t crc ) const {
+	for ( const auto& it : m_units ) {
+		crc = util::crc32::CRC32::CalculateFromBuffer( unit::Unit::Serialize( it.second ), crc );
+	}
+	for ( const auto& it : m_bases ) {
+		crc = util::crc32::CRC32::CalculateFromBuffer( base::Base::Serialize( it.second ), crc );
+	}
+	return crc;
+}
+
 void Game::AdvanceTurn( const size_t turn_id ) {
 	m_current_turn.AdvanceTurn( turn_id );
 	m_is_turn_complete = false;
@@ -1426,13 +1447,14 @@ const gse::Value Game::ProcessEvent( event::Event* event ) {
 	}
 
 	m_current_turn.AddEvent( event );
+	InvalidateSnapshot();
 	return event->Apply( this );
 }
 
 const types::Vec3 Game::GetTileRenderCoords( const map::tile::Tile* tile ) {
 	const auto* ts = m_map->GetTileState( tile );
 	ASSERT( ts, "ts not set" );
-	const auto l = tile->is_water_tile
+	const auto l = tile->IsWater()
 		? map::tile::LAYER_WATER
 		: map::tile::LAYER_LAND;
 	const auto& layer = ts->layers[ l ];
@@ -1450,21 +1472,21 @@ void Game::SerializeUnits( types::Buffer& buf ) const {
 	buf.WriteInt( m_unit_moralesets.size() );
 	for ( const auto& it : m_unit_moralesets ) {
 		buf.WriteString( it.first );
-		buf.WriteString( unit::MoraleSet::Serialize( it.second ).ToString() );
+		buf.WriteString( unit::MoraleSet::Serialize( it.second ).ToStringView() );
 	}
 
 	Log( "Serializing " + std::to_string( m_unit_defs.size() ) + " unit defs" );
 	buf.WriteInt( m_unit_defs.size() );
 	for ( const auto& it : m_unit_defs ) {
 		buf.WriteString( it.first );
-		buf.WriteString( unit::Def::Serialize( it.second ).ToString() );
+		buf.WriteString( unit::Def::Serialize( it.second ).ToStringView() );
 	}
 
 	Log( "Serializing " + std::to_string( m_units.size() ) + " units" );
 	buf.WriteInt( m_units.size() );
 	for ( const auto& it : m_units ) {
 		buf.WriteInt( it.first );
-		buf.WriteString( unit::Unit::Serialize( it.second ).ToString() );
+		buf.WriteString( unit::Unit::Serialize( it.second ).ToStringView() );
 	}
 	buf.WriteInt( unit::Unit::GetNextId() );
 
@@ -1480,7 +1502,7 @@ void Game::UnserializeUnits( types::Buffer& buf ) {
 	Log( "Unserializing " + std::to_string( sz ) + " unit moralesets" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto name = buf.ReadString();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = types::Buffer( buf.ReadStringView() );
 		DefineMoraleSet( unit::MoraleSet::Unserialize( b ) );
 	}
 
@@ -1488,7 +1510,7 @@ void Game::UnserializeUnits( types::Buffer& buf ) {
 	Log( "Unserializing " + std::to_string( sz ) + " unit defs" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto name = buf.ReadString();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = types::Buffer( buf.ReadStringView() );
 		DefineUnit( unit::Def::Unserialize( b ) );
 	}
 
@@ -1497,7 +1519,7 @@ void Game::UnserializeUnits( types::Buffer& buf ) {
 	ASSERT( m_unprocessed_units.empty(), "unprocessed units not empty" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto unit_id = buf.ReadInt();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = types::Buffer( buf.ReadStringView() );
 		SpawnUnit( unit::Unit::Unserialize( b, this ) );
 	}
 
@@ -1511,7 +1533,7 @@ void Game::SerializeBases( types::Buffer& buf ) const {
 	buf.WriteInt( m_bases.size() );
 	for ( const auto& it : m_bases ) {
 		buf.WriteInt( it.first );
-		buf.WriteString( base::Base::Serialize( it.second ).ToString() );
+		buf.WriteString( base::Base::Serialize( it.second ).ToStringView() );
 	}
 	buf.WriteInt( base::Base::GetNextId() );
 
@@ -1526,7 +1548,7 @@ void Game::UnserializeBases( types::Buffer& buf ) {
 	ASSERT( m_unprocessed_bases.empty(), "unprocessed bases not empty" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto base_id = buf.ReadInt();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = types::Buffer( buf.ReadStringView() );
 		SpawnBase( base::Base::Unserialize( b, this ) );
 	}
 
@@ -1539,7 +1561,7 @@ void Game::SerializeAnimations( types::Buffer& buf ) const {
 	buf.WriteInt( m_animation_defs.size() );
 	for ( const auto& it : m_animation_defs ) {
 		buf.WriteString( it.first );
-		buf.WriteString( animation::Def::Serialize( it.second ).ToString() );
+		buf.WriteString( animation::Def::Serialize( it.second ).ToStringView() );
 	}
 }
 
@@ -1548,11 +1570,68 @@ void Game::UnserializeAnimations( types::Buffer& buf ) {
 	Log( "Unserializing " + std::to_string( sz ) + " animation defs" );
 	for ( size_t i = 0 ; i < sz ; i++ ) {
 		const auto name = buf.ReadString();
-		auto b = types::Buffer( buf.ReadString() );
+		auto b = types::Buffer( buf.ReadStringView() );
 		DefineAnimation( animation::Def::Unserialize( b ) );
 	}
 }
 
+const std::shared_ptr< const std::string > Game::GetSnapshot() {
+	if ( !m_map ) {
+		// map not generated yet
+		return nullptr;
+	}
+	if ( m_snapshot ) {
+		Log( "Reusing cached snapshot for download" );
+#ifdef DEBUG
+		// if this fails - something changed world without invalidating snapshot
+		ASSERT( *m_snapshot == BuildSnapshot(), "cached snapshot differs from current world" );
+#endif
+		return m_snapshot;
+	}
+	Log( "Preparing snapshot for download" );
+	m_snapshot = std::make_shared< const std::string >( BuildSnapshot() );
+	return m_snapshot;
+}
+
+const std::string Game::BuildSnapshot() {
+	types::Buffer buf;
+
+	// map
+	m_map->SaveToBuffer( buf );
+
+	// units
+	buf.WriteNested(
+		[ this ]( types::Buffer& b ) {
+			SerializeUnits( b );
+		}
+	);
+
+	// bases
+	buf.WriteNested(
+		[ this ]( types::Buffer& b ) {
+			SerializeBases( b );
+		}
+	);
+
+	// animations
+	buf.WriteNested(
+		[ this ]( types::Buffer& b ) {
+			SerializeAnimations( b );
+		}
+	);
+
+	// send turn info
+	Log( "Sending turn ID: " + std::to_string( s_turn_id ) );
+	buf.WriteInt( s_turn_id );
+
+	return buf.ToString();
+}
+
+void Game::InvalidateSnapshot() {
+	// downloads in progress keep their reference, so this only affects new ones
+	m_snapshot = nullptr;
+}
+
 void Game::AddFrontendRequest( const FrontendRequest& request ) {
 	//Log( "Sending frontend request (type=" + std::to_string( request.type ) + ")" ); // spammy
 	m_pending_frontend_requests->push_back( request );
@@ -1635,43 +1714,8 @@ void Game::InitGame( MT_Response& response, MT_CANCELABLE ) {
 					}
 				};
 
-				connection->m_on_download_request = [ this ]() -> const std::string {
-					if ( !m_map ) {
-						// map not generated yet
-						return "";
-					}
-					Log( "Preparing snapshot for download" );
-					types::Buffer buf;
-
-					// map
-					m_map->SaveToBuffer( buf );
-
-					// units
-					{
-						types::Buffer b;
-						SerializeUnits( b );
-						buf.WriteString( b.ToString() );
-					}
-
-					// bases
-					{
-						types::Buffer b;
-						SerializeBases( b );
-						buf.WriteString( b.ToString() );
-					}
-
-					// animations
-					{
-						types::Buffer b;
-						SerializeAnimations( b );
-						buf.WriteString( b.ToString() );
-					}
-
-					// send turn info
-					Log( "Sending turn ID: " + std::to_string( s_turn_id ) );
-					buf.WriteInt( s_turn_id );
-
-					return buf.ToString();
+				connection->m_on_download_request = [ this ]() -> const std::shared_ptr< const std::string > {
+					return GetSnapshot();
 				};
 
 				connection->SetGameState( connection::Connection::GS_INITIALIZING );
@@ -1831,26 +1875,26 @@ void Game::InitGame( MT_Response& response, MT_CANCELABLE ) {
 						auto buf = types::Buffer( serialized_snapshot );
 
 						// map
-						auto b = types::Buffer( buf.ReadString() );
+						auto b = buf.ReadNested();
 						NEW( m_map, map::Map, this );
 						const auto ec = m_map->LoadFromBuffer( b );
 						if ( ec == map::Map::EC_NONE ) {
 
 							// units
 							{
-								auto ub = types::Buffer( buf.ReadString() );
+								auto ub = buf.ReadNested();
 								UnserializeUnits( ub );
 							}
 
 							// bases
 							{
-								auto bb = types::Buffer( buf.ReadString() );
+								auto bb = buf.ReadNested();
 								UnserializeBases( bb );
 							}
 
 							// animations
 							{
-								auto ab = types::Buffer( buf.ReadString() );
+								auto ab = buf.ReadNested();
 								UnserializeAnimations( ab );
 							}
 
@@ -1893,6 +1937,8 @@ void Game::InitGame( MT_Response& response, MT_CANCELABLE ) {
 
 void Game::ResetGame() {
 
+	InvalidateSnapshot();
+
 	if ( m_game_state != GS_NONE ) {
 		// TODO: do something?
 		m_game_state = GS_NONE;
@@ -2063,8 +2109,8 @@ void Game::PushUnitUpdates() {
 				fr.data.unit_spawn.slot_index = unit->m_owner->GetIndex();
 				const auto* tile = unit->GetTile();
 				fr.data.unit_spawn.tile_coords = {
-					tile->coord.x,
-					tile->coord.y
+					tile->GetCoords().x,
+					tile->GetCoords().y
 				};
 				const auto c = unit->GetRenderCoords();
 				fr.data.unit_spawn.render_coords = {
@@ -2086,8 +2132,8 @@ void Game::PushUnitUpdates() {
 				fr.data.unit_update.health = unit->m_health;
 				const auto* tile = unit->GetTile();
 				fr.data.unit_update.tile_coords = {
-					tile->coord.x,
-					tile->coord.y
+					tile->GetCoords().x,
+					tile->GetCoords().y
 				};
 				const auto c = unit->GetRenderCoords();
 				fr.data.unit_update.render_coords = {
@@ -2120,8 +2166,8 @@ void Game::PushBaseUpdates() {
 				fr.data.base_spawn.slot_index = base->m_owner->GetIndex();
 				const auto* tile = base->GetTile();
 				fr.data.base_spawn.tile_coords = {
-					tile->coord.x,
-					tile->coord.y
+					tile->GetCoords().x,
+					tile->GetCoords().y
 				};
 				const auto c = base->GetRenderCoords();
 				fr.data.base_spawn.render_coords = {
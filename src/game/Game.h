@@ -4,6 +4,7 @@
 #include <unordered_set>
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 
 #include "common/MTModule.h"
@@ -288,7 +289,7 @@ CLASS( Game, MTModule )
 	common::mt_id_t MT_SendBackendRequests( const std::vector< BackendRequest >& requests );
 
 	// send event
-	common::mt_id_t MT_AddEvent( const event::Event* event );
+	void MT_AddEvent( const event::Event* event );
 
 #ifdef DEBUG
 
@@ -384,6 +385,12 @@ private:
 	void SerializeAnimations( types::Buffer& buf ) const;
 	void UnserializeAnimations( types::Buffer& buf );
 
+	// serialized world for joining players, built on first request and shared by all downloads until something changes
+	std::shared_ptr< const std::string > m_snapshot = nullptr;
+	const std::shared_ptr< const std::string > GetSnapshot();
+	const std::string BuildSnapshot();
+	void InvalidateSnapshot();
+
 	enum game_state_t {
 		GS_NONE,
 		GS_PREPARING_MAP,
@@ -401,6 +408,8 @@ private:
 	response_map_data_t* m_response_map_data = nullptr;
 
 	util::crc32::crc_t m_turn_checksum = 0;
+	// continues turn checksum over state that must be same for everyone after turn, one object at a time
+	const util::crc32::crc_t GetStateChecksum( util::crc32::crc_t crc ) const;
 	std::unordered_set< size_t > m_verified_turn_checksum_slots = {};
 
 	std::vector< FrontendRequest >* m_pending_frontend_requests = nullptr;
@@ -22,7 +22,7 @@ const types::Vec3 MapObject::GetRenderCoords() const {
 	const auto* ts = m_map->GetTileState( m_tile );
 	ASSERT_NOLOG( ts, "ts not found" );
 	const auto c = ts->layers[
-		m_tile->is_water_tile
+		m_tile->IsWater()
 			? map::tile::LAYER_WATER
 			: map::tile::LAYER_LAND
 	].coords.center;
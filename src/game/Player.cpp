@@ -94,9 +94,9 @@ const types::Buffer Player::Serialize() const {
 	buf.WriteInt( m_role );
 	buf.WriteBool( m_faction.has_value() );
 	if ( m_faction.has_value() ) {
-		buf.WriteString( m_faction->Serialize().ToString() );
+		buf.WriteString( m_faction->Serialize().ToStringView() );
 	}
-	buf.WriteString( m_difficulty_level.Serialize().ToString() );
+	buf.WriteString( m_difficulty_level.Serialize().ToStringView() );
 
 	return buf;
 }
@@ -36,8 +36,8 @@ Base::Base(
 	if ( next_id <= id ) {
 		next_id = id + 1;
 	}
-	ASSERT_NOLOG( !tile->base, "tile already has base" );
-	tile->base = this;
+	ASSERT_NOLOG( !tile->GetBase(), "tile already has base" );
+	tile->SetBase( this );
 	m_tile = tile;
 }
 
@@ -45,8 +45,8 @@ const types::Buffer Base::Serialize( const Base* base ) {
 	types::Buffer buf;
 	buf.WriteInt( base->m_id );
 	buf.WriteInt( base->m_owner->GetIndex() );
-	buf.WriteInt( base->m_tile->coord.x );
-	buf.WriteInt( base->m_tile->coord.y );
+	buf.WriteInt( base->m_tile->GetCoords().x );
+	buf.WriteInt( base->m_tile->GetCoords().y );
 	base->m_data.Serialize( buf );
 	return buf;
 }
@@ -33,8 +33,8 @@ BINDING_IMPL( bases ) {
 				game->AddEvent( new event::SpawnBase(
 					game->GetSlotNum(),
 					owner->GetIndex(),
-					tile->coord.x,
-					tile->coord.y,
+					tile->GetCoords().x,
+					tile->GetCoords().y,
 					base::BaseData( name, population )
 				) );
 				return VALUE( gse::type::Undefined );
@@ -26,7 +26,7 @@ BINDING_IMPL( tiles ) {
 				tile_positions.reserve( tiles.size() );
 				for ( const auto& tileobj : tiles ) {
 					N_UNWRAP( tile, tileobj, map::tile::Tile );
-					tile_positions.push_back( tile->coord );
+					tile_positions.push_back( tile->GetCoords() );
 				}
 
 				GAME->SendTileLockRequest( tile_positions, [ this, on_complete, tile_positions, ctx, call_si ]() {
@@ -154,8 +154,8 @@ BINDING_IMPL( units ) {
 					game->GetSlotNum(),
 					def_name,
 					owner->GetIndex(),
-					tile->coord.x,
-					tile->coord.y,
+					tile->GetCoords().x,
+					tile->GetCoords().y,
 					GetMorale( morale, ctx, call_si ),
 					GetHealth( health, ctx, call_si )
 				) );
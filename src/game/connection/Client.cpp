@@ -7,6 +7,8 @@
 #include "game/event/Event.h"
 #include "types/Packet.h"
 #include "network/Network.h"
+#include "engine/Engine.h"
+#include "config/Config.h"
 
 namespace game {
 namespace connection {
@@ -175,65 +177,98 @@ void Client::ProcessEvent( const network::Event& event ) {
 							if ( !m_download_state.is_downloading ) {
 								Error( "download response received while not downloading" );
 							}
-							if ( packet.data.num == 0 ) {
+							else if ( packet.data.num == 0 ) {
 								Log( "No download response received from server" );
 								Disconnect( "No download response received from server" );
 							}
+							else if ( m_download_state.total_size && packet.data.num != m_download_state.total_size ) {
+								Error( "snapshot size changed during download ( " + std::to_string( packet.data.num ) + " != " + std::to_string( m_download_state.total_size ) + " )" );
+							}
+							else if ( !packet.udata.download.size ) {
+								Error( "invalid download chunk size" );
+							}
 							else {
-								m_download_state.total_size = packet.data.num;
-								Log( "Allocating download buffer (" + std::to_string( m_download_state.total_size ) + " bytes)" );
-								m_download_state.buffer.reserve( m_download_state.total_size );
-								DownloadNextChunk();
+								if ( !m_download_state.total_size ) {
+									m_download_state.total_size = packet.data.num;
+									Log( "Allocating download buffer (" + std::to_string( m_download_state.total_size ) + " bytes)" );
+									m_download_state.buffer.reserve( m_download_state.total_size );
+								}
+								m_download_state.chunk_size = packet.udata.download.size;
+								m_download_state.stall_timer.SetTimeout( DOWNLOAD_STALL_TIMEOUT_MS );
 							}
 							break;
 						}
 						case types::Packet::PT_DOWNLOAD_NEXT_CHUNK_RESPONSE: {
-							Log( "Downloaded next chunk ( offset=" + std::to_string( packet.udata.download.offset ) + " size=" + std::to_string( packet.udata.download.size ) + " )" );
-							const size_t end = packet.udata.download.offset + packet.udata.download.size;
+							LOG_DEBUG( "Downloaded next chunk ( offset=" + std::to_string( packet.udata.download.offset ) + " size=" + std::to_string( packet.udata.download.size ) + " )" );
+							const size_t offset = packet.udata.download.offset;
+							const size_t end = offset + packet.udata.download.size;
 							if ( !m_download_state.is_downloading ) {
 								Error( "chunk received while not downloading" );
 							}
+							else if ( !m_download_state.total_size ) {
+								Error( "chunk received before download response" );
+							}
 							else if ( end > m_download_state.total_size ) {
-								Error( "chunk overflow ( " + std::to_string( packet.udata.download.offset ) + " + " + std::to_string( packet.udata.download.size ) + " >= " + std::to_string( m_download_state.total_size ) + " )" );
+								Error( "chunk overflow ( " + std::to_string( offset ) + " + " + std::to_string( packet.udata.download.size ) + " >= " + std::to_string( m_download_state.total_size ) + " )" );
 							}
-							else if ( packet.udata.download.offset != m_download_state.downloaded_size ) {
-								Error( "inconsistent chunk offset ( " + std::to_string( packet.udata.download.offset ) + " != " + std::to_string( m_download_state.downloaded_size ) + " )" );
+							else if ( offset % m_download_state.chunk_size ) {
+								Error( "unaligned chunk offset ( " + std::to_string( offset ) + " )" );
 							}
 							else if (
-								packet.udata.download.size != DOWNLOAD_CHUNK_SIZE &&
+								packet.udata.download.size != m_download_state.chunk_size &&
 									end != m_download_state.total_size // last chunk can be smaller
 								) {
-								Error( "inconsistent map chunk size ( " );
+								Error( "inconsistent map chunk size ( " + std::to_string( packet.udata.download.size ) + " != " + std::to_string( m_download_state.chunk_size ) + " )" );
+							}
+							else if ( packet.data.str.size() != packet.udata.download.size ) {
+								Error( "download buffer size mismatch" );
 							}
 							else {
-								ASSERT( packet.data.str.size() == packet.udata.download.size, "download buffer size mismatch" );
-								m_download_state.buffer.append( packet.data.str );
-								if ( end < m_download_state.total_size ) {
-									if ( m_on_download_progress ) {
-										m_on_download_progress( (float)m_download_state.downloaded_size / m_download_state.total_size );
-									}
+								m_download_state.stall_timer.SetTimeout( DOWNLOAD_STALL_TIMEOUT_MS );
+								if ( offset == m_download_state.downloaded_size ) {
+									m_download_state.buffer.append( packet.data.str );
 									m_download_state.downloaded_size = end;
-									DownloadNextChunk();
-								}
-								else {
-									Log( "Download completed successfully" );
-									if ( m_on_download_complete ) {
-										m_on_download_complete( m_download_state.buffer );
+									// gap is filled, append everything that is contiguous now
+									auto& chunks = m_download_state.out_of_order_chunks;
+									for ( auto it = chunks.find( m_download_state.downloaded_size ) ; it != chunks.end() ; it = chunks.find( m_download_state.downloaded_size ) ) {
+										m_download_state.buffer.append( it->second );
+										m_download_state.downloaded_size += it->second.size();
+										chunks.erase( it );
 									}
-									m_download_state.buffer.clear();
-									m_download_state.is_downloading = false;
+									if ( m_download_state.downloaded_size < m_download_state.total_size ) {
+										if ( m_on_download_progress ) {
+											m_on_download_progress( (float)m_download_state.downloaded_size / m_download_state.total_size );
+										}
+										AcknowledgeDownload();
+									}
+									else {
+										Log( "Download completed successfully" );
+										AcknowledgeDownload(); // let server free snapshot
+										m_download_state.stall_timer.Stop();
+										m_download_state.out_of_order_chunks.clear();
+										m_download_state.total_size = 0;
+										m_download_state.is_downloading = false;
+										if ( m_on_download_complete ) {
+											m_on_download_complete( m_download_state.buffer );
+										}
+										m_download_state.buffer.clear();
+									}
+								}
+								else if ( offset > m_download_state.downloaded_size ) {
+									m_download_state.out_of_order_chunks.emplace( offset, packet.data.str );
 								}
+								// else it's duplicate of already received chunk (i.e. sent again after resume), ignore
 							}
 							break;
 						}
 						case types::Packet::PT_GAME_EVENTS: {
-							Log( "Got game events packet" );
+							LOG_DEBUG( "Got game events packet" );
 							if ( m_on_game_event_validate && m_on_game_event_apply ) {
 								auto buf = types::Buffer( packet.data.str );
 								std::vector< game::event::Event* > game_events = {};
 								game::event::Event::UnserializeMultiple( buf, game_events );
 								for ( const auto& game_event : game_events ) {
-									Log( "Got game event: " + game_event->ToString() );
+									LOG_DEBUG( "Got game event: " + game_event->ToString() );
 									m_on_game_event_validate( game_event );
 									m_on_game_event_apply( game_event );
 								}
@@ -262,6 +297,11 @@ void Client::ProcessEvent( const network::Event& event ) {
 			Disconnect( "Connection to server lost." );
 			break;
 		}
+		case network::Event::ET_BACKPRESSURE_ON:
+		case network::Event::ET_BACKPRESSURE_OFF: {
+			// tracked by Connection, client has nothing to hold back
+			break;
+		}
 		default: {
 			Log( "WARNING: invalid event type from server: " + std::to_string( event.type ) );
 		}
@@ -269,7 +309,7 @@ void Client::ProcessEvent( const network::Event& event ) {
 }
 
 void Client::SendGameEvents( const game_events_t& game_events ) {
-	Log( "Sending " + std::to_string( game_events.size() ) + " game events" );
+	LOG_DEBUG( "Sending " + std::to_string( game_events.size() ) + " game events" );
 	types::Packet p( types::Packet::PT_GAME_EVENTS );
 	p.data.str = game::event::Event::SerializeMultiple( game_events ).ToString();
 	m_network->MT_SendPacket( &p );
@@ -308,8 +348,11 @@ void Client::RequestDownload() {
 	ASSERT( !m_download_state.is_downloading, "download already started" );
 	ASSERT( m_on_download_complete, "download requested but m_on_download_complete is not set" );
 	m_download_state.is_downloading = true;
-	types::Packet p( types::Packet::PT_DOWNLOAD_REQUEST );
-	m_network->MT_SendPacket( &p );
+	m_download_state.total_size = 0;
+	m_download_state.downloaded_size = 0;
+	m_download_state.buffer.clear();
+	m_download_state.out_of_order_chunks.clear();
+	SendDownloadRequest( 0 );
 }
 
 void Client::ResetHandlers() {
@@ -320,20 +363,39 @@ void Client::ResetHandlers() {
 	m_on_download_complete = nullptr;
 }
 
+void Client::Iterate() {
+	if ( m_is_connected && m_download_state.is_downloading && m_download_state.stall_timer.HasTicked() ) {
+		Log( "Download stalled, resuming from offset " + std::to_string( m_download_state.downloaded_size ) );
+		if ( !m_download_state.downloaded_size ) {
+			m_download_state.total_size = 0; // server will prepare new snapshot
+		}
+		m_download_state.out_of_order_chunks.clear(); // will be sent again
+		SendDownloadRequest( m_download_state.downloaded_size );
+	}
+	Connection::Iterate(); // keep it last because it may delete this
+}
+
 void Client::Error( const std::string& reason ) {
 	Log( "Network protocol error: " + reason );
 	Disconnect( "Network protocol error" );
 }
 
-void Client::DownloadNextChunk() {
+void Client::SendDownloadRequest( const size_t offset ) {
+	ASSERT( m_download_state.is_downloading, "download not initialized" );
+	ASSERT( m_download_state.buffer.size() == offset, "download buffer size mismatch" );
+	types::Packet p( types::Packet::PT_DOWNLOAD_REQUEST );
+	p.udata.download.offset = offset;
+	p.udata.download.size = g_engine->GetConfig()->GetDownloadWindow();
+	m_network->MT_SendPacket( &p );
+	m_download_state.stall_timer.SetTimeout( DOWNLOAD_STALL_TIMEOUT_MS );
+}
+
+void Client::AcknowledgeDownload() {
 	ASSERT( m_download_state.is_downloading, "download not initialized" );
 	ASSERT( m_download_state.buffer.size() == m_download_state.downloaded_size, "download buffer size mismatch" );
-	ASSERT( m_download_state.downloaded_size < m_download_state.total_size, "download already finished" );
-	const size_t size = std::min( DOWNLOAD_CHUNK_SIZE, m_download_state.total_size - m_download_state.downloaded_size );
-	Log( "Requesting next chunk ( offset=" + std::to_string( m_download_state.downloaded_size ) + " size=" + std::to_string( size ) + " )" );
 	types::Packet p( types::Packet::PT_DOWNLOAD_NEXT_CHUNK_REQUEST );
 	p.udata.download.offset = m_download_state.downloaded_size;
-	p.udata.download.size = size;
+	p.udata.download.size = 0;
 	m_network->MT_SendPacket( &p );
 }
 
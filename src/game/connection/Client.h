@@ -1,7 +1,11 @@
 #pragma once
 
+#include <map>
+
 #include "Connection.h"
 
+#include "util/Timer.h"
+
 namespace game {
 namespace connection {
 
@@ -22,6 +26,8 @@ CLASS( Client, Connection )
 
 	void ResetHandlers() override;
 
+	void Iterate() override;
+
 protected:
 	void ProcessEvent( const network::Event& event ) override;
 	void SendGameEvents( const game_events_t& game_events ) override;
@@ -31,13 +37,20 @@ private:
 
 	void Error( const std::string& reason );
 
+	// server pushes chunks ahead of acknowledgements, if nothing arrives for this long - ask to resend from last complete offset
+	const size_t DOWNLOAD_STALL_TIMEOUT_MS = 3000;
+
 	struct {
 		bool is_downloading = false;
-		int total_size = 0;
-		int downloaded_size = 0;
+		size_t total_size = 0;
+		size_t chunk_size = 0;
+		size_t downloaded_size = 0; // everything before this offset is in buffer
 		std::string buffer = "";
+		std::map< size_t, std::string > out_of_order_chunks = {}; // offset -> chunk, waiting for gap before them to be filled
+		util::Timer stall_timer;
 	} m_download_state = {};
-	void DownloadNextChunk();
+	void SendDownloadRequest( const size_t offset );
+	void AcknowledgeDownload();
 };
 
 }
@@ -148,7 +148,9 @@ void Connection::Iterate() {
 	}
 	else if ( m_is_connected ) {
 		if ( !m_mt_ids.events ) {
-			m_mt_ids.events = m_network->MT_GetEvents();
+			if ( m_network->HasEvents() ) {
+				m_mt_ids.events = m_network->MT_GetEvents();
+			}
 		}
 		else {
 			auto result = m_network->MT_GetResult( m_mt_ids.events );
@@ -165,7 +167,7 @@ void Connection::Iterate() {
 				}
 				else if ( result.result == network::R_SUCCESS ) {
 					if ( !result.events.empty() ) {
-						Log( "got " + std::to_string( result.events.size() ) + " event(s)" );
+						LOG_DEBUG( "got " + std::to_string( result.events.size() ) + " event(s)" );
 						for ( auto& event : result.events ) {
 							ProcessEvent( event );
 						}
@@ -227,8 +229,28 @@ const Player* Connection::GetPlayer() const {
 	return m_player;
 }
 
+const bool Connection::IsCongested( const network::cid_t cid ) const {
+	return m_congested_cids.find( cid ) != m_congested_cids.end();
+}
+
 void Connection::ProcessEvent( const network::Event& event ) {
 	ASSERT( m_state, "connection state not set" );
+
+	switch ( event.type ) {
+		case network::Event::ET_BACKPRESSURE_ON: {
+			m_congested_cids.insert( event.cid );
+			break;
+		}
+		case network::Event::ET_BACKPRESSURE_OFF:
+		case network::Event::ET_CLIENT_DISCONNECT:
+		case network::Event::ET_DISCONNECT: {
+			m_congested_cids.erase( event.cid );
+			break;
+		}
+		default: {
+			// nothing
+		}
+	}
 }
 
 void Connection::Disconnect( const std::string& reason ) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_set>
 #include <vector>
 
 #include "common/Module.h"
@@ -85,11 +86,15 @@ CLASS( Connection, common::Module )
 	const size_t GetSlotNum() const;
 	const Player* GetPlayer() const;
 
+	// true if too much data is waiting to be sent to this peer ( cid 0 is server ), non-essential packets should be held back
+	const bool IsCongested( const network::cid_t cid = 0 ) const;
+
 	virtual void UpdateSlot( const size_t slot_num, slot::Slot* slot, const bool only_flags = false ) = 0;
 	virtual void SendMessage( const std::string& message ) = 0;
 
 protected:
-	const int DOWNLOAD_CHUNK_SIZE = 16384;
+	const size_t DOWNLOAD_CHUNK_SIZE = 65536;
+	const size_t DOWNLOAD_MAX_WINDOW = 64; // in chunks, server won't keep more than this in flight regardless of what client asks
 
 	network::Network* const m_network;
 
@@ -109,6 +114,8 @@ protected:
 	size_t m_slot = 0;
 	::game::Player* m_player = nullptr;
 
+	std::unordered_set< network::cid_t > m_congested_cids = {};
+
 	virtual void SendGameEvents( const game_events_t& game_events ) = 0;
 
 private:
@@ -1,5 +1,7 @@
 #include "Server.h"
 
+#include <algorithm>
+
 #include "engine/Engine.h"
 #include "types/Packet.h"
 #include "network/Network.h"
@@ -276,53 +278,73 @@ void Server::ProcessEvent( const network::Event& event ) {
 						break;
 					}
 					case types::Packet::PT_DOWNLOAD_REQUEST: {
-						Log( "Got download request from " + std::to_string( event.cid ) );
+						LOG_DEBUG( "Got download request from " + std::to_string( event.cid ) + " ( offset=" + std::to_string( packet.udata.download.offset ) + " window=" + std::to_string( packet.udata.download.size ) + " )" );
+						const size_t window = std::max< size_t >( 1, std::min( packet.udata.download.size, DOWNLOAD_MAX_WINDOW ) );
 						types::Packet p( types::Packet::PT_DOWNLOAD_RESPONSE );
-						if ( m_on_download_request ) {
-							m_download_data[ event.cid ] = download_data_t{ // override previous request
-								0,
-								m_on_download_request()
-							};
-							p.data.num = m_download_data.at( event.cid ).serialized_snapshot.size();
+						p.udata.download.size = DOWNLOAD_CHUNK_SIZE;
+						download_data_t* download_data = nullptr;
+						if ( packet.udata.download.offset ) {
+							// client didn't get anything for a while, resend everything after what it has
+							const auto& it = m_download_data.find( event.cid );
+							if ( it == m_download_data.end() ) {
+								Error( event.cid, "download not initialized" );
+								break;
+							}
+							if (
+								packet.udata.download.offset < it->second.acked_offset ||
+									packet.udata.download.offset > it->second.sent_offset
+								) {
+								Error( event.cid, "inconsistent resume offset ( " + std::to_string( packet.udata.download.offset ) + " not in " + std::to_string( it->second.acked_offset ) + "-" + std::to_string( it->second.sent_offset ) + " )" );
+								break;
+							}
+							Log( "Resuming download for " + std::to_string( event.cid ) );
+							download_data = &it->second;
+							download_data->acked_offset = download_data->sent_offset = packet.udata.download.offset;
+							download_data->window = window;
+							p.data.num = download_data->serialized_snapshot->size();
 						}
 						else {
-							// no handler set - no data to return
-							Log( "WARNING: download requested but no download handler was set, sending empty header" );
-							p.data.num = 0;
+							const auto snapshot = m_on_download_request
+								? m_on_download_request()
+								: nullptr;
+							if ( snapshot && !snapshot->empty() ) {
+								download_data = &( m_download_data[ event.cid ] = download_data_t{ // override previous request
+									snapshot,
+									0,
+									0,
+									window
+								} );
+								p.data.num = snapshot->size();
+							}
+							else {
+								// no handler set or nothing to download
+								Log( "WARNING: download requested but no snapshot is available, sending empty header" );
+								m_download_data.erase( event.cid );
+								p.data.num = 0;
+							}
 						}
 						m_network->MT_SendPacket( &p, event.cid );
+						if ( download_data ) {
+							SendDownloadChunks( event.cid, *download_data );
+						}
 						break;
 					}
 					case types::Packet::PT_DOWNLOAD_NEXT_CHUNK_REQUEST: {
-						Log( "Got next chunk request from " + std::to_string( event.cid ) + " ( offset=" + std::to_string( packet.udata.download.offset ) + " size=" + std::to_string( packet.udata.download.size ) + " )" );
+						LOG_DEBUG( "Got download acknowledgement from " + std::to_string( event.cid ) + " ( offset=" + std::to_string( packet.udata.download.offset ) + " )" );
 						const auto& it = m_download_data.find( event.cid );
-						const size_t end = packet.udata.download.offset + packet.udata.download.size;
 						if ( it == m_download_data.end() ) {
 							Error( event.cid, "download not initialized" );
 						}
-						else if ( end > it->second.serialized_snapshot.size() ) {
-							Error( event.cid, "download offset overflow ( " + std::to_string( packet.udata.download.offset ) + " + " + std::to_string( packet.udata.download.size ) + " >= " + std::to_string( it->second.serialized_snapshot.size() ) + " )" );
-						}
-						else if ( packet.udata.download.offset != it->second.next_expected_offset ) {
-							Error( event.cid, "inconsistent download offset ( " + std::to_string( packet.udata.download.offset ) + " != " + std::to_string( it->second.next_expected_offset ) + " )" );
+						else if ( packet.udata.download.offset > it->second.sent_offset ) {
+							Error( event.cid, "acknowledged more than was sent ( " + std::to_string( packet.udata.download.offset ) + " > " + std::to_string( it->second.sent_offset ) + " )" );
 						}
-						else if (
-							packet.udata.download.size != DOWNLOAD_CHUNK_SIZE &&
-								end != it->second.serialized_snapshot.size() // last chunk can be smaller
-							) {
-							Error( event.cid, "inconsistent download size ( " );
-						}
-						else {
-							types::Packet p( types::Packet::PT_DOWNLOAD_NEXT_CHUNK_RESPONSE );
-							p.udata.download.offset = packet.udata.download.offset;
-							p.udata.download.size = packet.udata.download.size;
-							p.data.str = it->second.serialized_snapshot.substr( packet.udata.download.offset, packet.udata.download.size );
-							m_network->MT_SendPacket( &p, event.cid );
-							if ( end < it->second.serialized_snapshot.size() ) {
-								it->second.next_expected_offset = end;
+						else if ( packet.udata.download.offset > it->second.acked_offset ) { // older acknowledgements may arrive after resume, they are harmless
+							it->second.acked_offset = packet.udata.download.offset;
+							if ( it->second.acked_offset < it->second.serialized_snapshot->size() ) {
+								SendDownloadChunks( event.cid, it->second );
 							}
 							else {
-								// snapshot was sent fully, can free memory now
+								// snapshot was received fully, can free memory now
 								Log( "Snapshot was sent successfully to " + std::to_string( event.cid ) + ", cleaning up" );
 								m_download_data.erase( it );
 							}
@@ -330,7 +352,7 @@ void Server::ProcessEvent( const network::Event& event ) {
 						break;
 					}
 					case types::Packet::PT_GAME_EVENTS: {
-						Log( "Got game events packet" );
+						LOG_DEBUG( "Got game events packet" );
 						ASSERT( m_on_game_event_validate, "m_on_game_event_validate is not set" );
 						ASSERT( m_on_game_event_apply, "m_on_game_event_apply is not set" );
 						auto buf = types::Buffer( packet.data.str );
@@ -386,6 +408,19 @@ void Server::ProcessEvent( const network::Event& event ) {
 			Error( event.cid, event.data.packet_data );
 			break;
 		}
+		case network::Event::ET_BACKPRESSURE_ON: {
+			Log( "Client " + std::to_string( event.cid ) + " can't keep up, holding back non-essential data" );
+			break;
+		}
+		case network::Event::ET_BACKPRESSURE_OFF: {
+			Log( "Client " + std::to_string( event.cid ) + " caught up" );
+			// continue download if it was held back
+			const auto& it = m_download_data.find( event.cid );
+			if ( it != m_download_data.end() ) {
+				SendDownloadChunks( event.cid, it->second );
+			}
+			break;
+		}
 		default: {
 			Log( "WARNING: invalid event type from client " + std::to_string( event.cid ) + " : " + std::to_string( event.type ) );
 		}
@@ -585,6 +620,20 @@ void Server::SendGameEventsTo( const std::string& serialized_events, const netwo
 	m_network->MT_SendPacket( &p, cid );
 }
 
+void Server::SendDownloadChunks( const network::cid_t cid, download_data_t& download_data ) {
+	const std::string& snapshot = *download_data.serialized_snapshot;
+	const size_t total_size = snapshot.size();
+	const size_t limit = std::min( total_size, download_data.acked_offset + download_data.window * DOWNLOAD_CHUNK_SIZE );
+	while ( download_data.sent_offset < limit && !IsCongested( cid ) ) {
+		types::Packet p( types::Packet::PT_DOWNLOAD_NEXT_CHUNK_RESPONSE );
+		p.udata.download.offset = download_data.sent_offset;
+		p.udata.download.size = std::min( DOWNLOAD_CHUNK_SIZE, total_size - download_data.sent_offset );
+		p.data.str_view = std::string_view( snapshot ).substr( p.udata.download.offset, p.udata.download.size ); // packet is serialized immediately, no need to copy
+		m_network->MT_SendPacket( &p, cid );
+		download_data.sent_offset += p.udata.download.size;
+	}
+}
+
 void Server::ClearReadyFlags() {
 	ASSERT( m_game_state, "unexpected game state" );
 	// clear readyness of everyone when new player joins or leaves
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <unordered_map>
 #include <string>
 
@@ -18,7 +19,8 @@ CLASS( Server, Connection )
 	Server( settings::LocalSettings* const settings );
 
 	std::function< void() > m_on_listen = nullptr;
-	std::function< const std::string() > m_on_download_request = nullptr; // return serialized snapshot of world
+	typedef std::shared_ptr< const std::string > snapshot_t;
+	std::function< const snapshot_t() > m_on_download_request = nullptr; // return serialized snapshot of world ( can be shared between downloads, so must not be changed afterwards )
 
 	void UpdateSlot( const size_t slot_num, slot::Slot* slot, const bool only_flags = false ) override;
 	void SendMessage( const std::string& message ) override;
@@ -51,10 +53,13 @@ private:
 	void SendGameEventsTo( const std::string& serialized_events, const network::cid_t cid );
 
 	struct download_data_t {
-		size_t next_expected_offset = 0; // for extra consistency checks
-		std::string serialized_snapshot = "";
+		snapshot_t serialized_snapshot = nullptr;
+		size_t acked_offset = 0; // client has everything before this offset
+		size_t sent_offset = 0; // everything before this offset was sent
+		size_t window = 1; // max chunks in flight
 	};
 	std::unordered_map< network::cid_t, download_data_t > m_download_data = {}; // cid -> serialized snapshot of world
+	void SendDownloadChunks( const network::cid_t cid, download_data_t& download_data );
 
 	void ClearReadyFlags();
 };
@@ -67,16 +67,18 @@ TS_END()
 void AttackUnit::Serialize( types::Buffer& buf, const AttackUnit* event ) {
 	buf.WriteInt( event->m_attacker_unit_id );
 	buf.WriteInt( event->m_defender_unit_id );
-	types::Buffer b = {};
-	gse::Value::Serialize( &b, event->m_resolutions );
-	buf.WriteString( b.ToString() );
+	buf.WriteNested(
+		[ event ]( types::Buffer& b ) {
+			gse::Value::Serialize( &b, event->m_resolutions );
+		}
+	);
 }
 
 AttackUnit* AttackUnit::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
 	const auto attacker_unit_id = buf.ReadInt();
 	const auto defender_unit_id = buf.ReadInt();
 	auto* result = new AttackUnit( initiator_slot, attacker_unit_id, defender_unit_id );
-	types::Buffer b( buf.ReadString() );
+	auto b = buf.ReadNested();
 	result->m_resolutions = gse::Value::Unserialize( &b );
 	return result;
 }
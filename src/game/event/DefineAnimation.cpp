@@ -38,11 +38,11 @@ TS_BEGIN( DefineAnimation )
 TS_END()
 
 void DefineAnimation::Serialize( types::Buffer& buf, const DefineAnimation* event ) {
-	buf.WriteString( animation::Def::Serialize( event->m_def ).ToString() );
+	buf.WriteString( animation::Def::Serialize( event->m_def ).ToStringView() );
 }
 
 DefineAnimation* DefineAnimation::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
-	auto b = types::Buffer( buf.ReadString() );
+	auto b = types::Buffer( buf.ReadStringView() );
 	return new DefineAnimation( initiator_slot, animation::Def::Unserialize( b ) );
 }
 
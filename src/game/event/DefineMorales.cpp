@@ -33,11 +33,11 @@ TS_BEGIN( DefineMorales )
 TS_END()
 
 void DefineMorales::Serialize( types::Buffer& buf, const DefineMorales* event ) {
-	buf.WriteString( unit::MoraleSet::Serialize( event->m_moraleset ).ToString() );
+	buf.WriteString( unit::MoraleSet::Serialize( event->m_moraleset ).ToStringView() );
 }
 
 DefineMorales* DefineMorales::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
-	auto b = types::Buffer( buf.ReadString() );
+	auto b = types::Buffer( buf.ReadStringView() );
 	return new DefineMorales( initiator_slot, unit::MoraleSet::Unserialize( b ) );
 }
 
@@ -31,11 +31,11 @@ TS_BEGIN( DefineUnit )
 TS_END()
 
 void DefineUnit::Serialize( types::Buffer& buf, const DefineUnit* event ) {
-	buf.WriteString( unit::Def::Serialize( event->m_def ).ToString() );
+	buf.WriteString( unit::Def::Serialize( event->m_def ).ToStringView() );
 }
 
 DefineUnit* DefineUnit::Unserialize( types::Buffer& buf, const size_t initiator_slot ) {
-	auto b = types::Buffer( buf.ReadString() );
+	auto b = types::Buffer( buf.ReadStringView() );
 	return new DefineUnit( initiator_slot, unit::Def::Unserialize( b ) );
 }
 
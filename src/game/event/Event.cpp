@@ -28,8 +28,13 @@ Event::Event( const size_t initiator_slot, const event_type_t type )
 	//
 }
 
-const types::Buffer Event::Serialize( const Event* event ) {
-	types::Buffer buf;
+const types::Buffer Event::Serialize( const Event* event, const types::Buffer::encoding_t encoding ) {
+	types::Buffer buf( encoding );
+	Serialize( buf, event );
+	return buf;
+}
+
+void Event::Serialize( types::Buffer& buf, const Event* event ) {
 	buf.WriteInt( event->m_initiator_slot );
 	buf.WriteInt( event->m_type );
 #define SERIALIZE( _type, _class ) \
@@ -60,7 +65,6 @@ const types::Buffer Event::Serialize( const Event* event ) {
 			THROW( "unknown event type on write: " + std::to_string( event->m_type ) );
 	}
 #undef SERIALIZE
-	return buf;
 }
 
 Event* Event::Unserialize( types::Buffer& buf ) {
@@ -98,20 +102,23 @@ Event* Event::Unserialize( types::Buffer& buf ) {
 	return result;
 }
 
-const types::Buffer Event::SerializeMultiple( const std::vector< Event* >& events ) {
-	types::Buffer buf;
+const types::Buffer Event::SerializeMultiple( const std::vector< Event* >& events, const types::Buffer::encoding_t encoding ) {
+	types::Buffer buf( encoding );
 	buf.WriteInt( events.size() );
 	for ( const auto& event : events ) {
-		buf.WriteString( game::event::Event::Serialize( event ).ToString() );
+		buf.WriteNested(
+			[ event ]( types::Buffer& b ) {
+				game::event::Event::Serialize( b, event );
+			}
+		);
 	}
-	const auto serialized_events = buf.ToString();
 	return buf;
 }
 
 void Event::UnserializeMultiple( types::Buffer& buf, std::vector< Event* >& events_out ) {
 	const auto count = buf.ReadInt();
 	for ( auto i = 0 ; i < count ; i++ ) {
-		auto event_buf = types::Buffer( buf.ReadString() );
+		auto event_buf = buf.ReadNested();
 		events_out.push_back( game::event::Event::Unserialize( event_buf ) );
 	}
 }
@@ -36,10 +36,12 @@ public:
 	Event( const size_t initiator_slot, const event_type_t type );
 	virtual ~Event() = default;
 
-	static const types::Buffer Serialize( const Event* event );
+	// unserializing detects encoding automatically
+	static const types::Buffer Serialize( const Event* event, const types::Buffer::encoding_t encoding = types::Buffer::E_COMPACT );
+	static void Serialize( types::Buffer& buf, const Event* event );
 	static Event* Unserialize( types::Buffer& buf );
 
-	static const types::Buffer SerializeMultiple( const std::vector< Event* >& events );
+	static const types::Buffer SerializeMultiple( const std::vector< Event* >& events, const types::Buffer::encoding_t encoding = types::Buffer::E_COMPACT );
 	static void UnserializeMultiple( types::Buffer& buf, std::vector< Event* >& events_out );
 
 	static const bool IsBroadcastable( const event_type_t type );
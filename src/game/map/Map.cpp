@@ -1,12 +1,20 @@
 #include "Map.h"
 
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <unordered_set>
+
 #include "game/Game.h"
 #include "game/settings/Settings.h"
 #include "generator/SimplePerlin.h"
 #include "engine/Engine.h"
+#include "common/JobSystem.h"
 #include "config/Config.h"
 #include "util/random/Random.h"
 #include "util/FS.h"
+#include "util/MappedFile.h"
 #include "ui/UI.h"
 #include "loader/texture/TextureLoader.h"
 #include "module/Prepare.h"
@@ -23,8 +31,10 @@
 #include "types/texture/Texture.h"
 #include "types/mesh/Render.h"
 #include "types/mesh/Data.h"
+#include "types/mesh/Mesh.h"
 #include "game/State.h"
 #include "game/map/MapState.h"
+#include "game/map/TerrainTexture.h"
 #include "game/map/tile/Tiles.h"
 #include "Consts.h"
 
@@ -37,6 +47,12 @@
 namespace game {
 namespace map {
 
+thread_local Map::tile_context_t* Map::s_tile_context = nullptr;
+
+static inline uint64_t GetElapsedNs( const std::chrono::steady_clock::time_point& since ) {
+	return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - since ).count();
+}
+
 #define B( x ) S_to_binary_(#x)
 
 static inline unsigned char S_to_binary_( const char* s ) {
@@ -49,7 +65,20 @@ static inline unsigned char S_to_binary_( const char* s ) {
 }
 
 Map::Map( Game* game )
-	: m_game( game ) {
+	: Map( game, nullptr ) {
+	//
+}
+
+Map::Map( util::random::Random* random )
+	: Map( nullptr, random ) {
+	//
+}
+
+Map::Map( Game* game, util::random::Random* random )
+	: m_game( game )
+	, m_random( random ) {
+	ASSERT( !m_game != !m_random, "map needs either game or random" );
+
 	// add texture variant bitmap maps
 	CalculateTextureVariants(
 		TVT_TILES, {
@@ -155,10 +184,20 @@ Map::Map( Game* game )
 		module_pass.clear();
 		NEW( m, module::WaterSurfacePP, this );
 		module_pass.push_back( m );
+		m_modules_deferred.push_back( module_pass );
+	}
+	{ // separate pass because it can't run in parallel, unlike previous one
+		module_pass.clear();
 		NEW( m, module::Sprites, this );
 		module_pass.push_back( m );
 		m_modules_deferred.push_back( module_pass );
 	}
+
+	// one context per job system worker
+	m_tile_contexts.resize( g_engine->GetJobSystem()->GetWorkersCount() );
+	for ( auto& context : m_tile_contexts ) {
+		NEW( context.random, util::random::Random );
+	}
 }
 
 Map::~Map() {
@@ -178,23 +217,31 @@ Map::~Map() {
 	if ( m_map_state ) {
 		DELETE( m_map_state );
 	}
+	for ( auto& context : m_tile_contexts ) {
+		DELETE( context.random );
+	}
 }
 
 const types::Buffer Map::Serialize() const {
 
 	types::Buffer buf;
 
-	buf.WriteString( m_tiles->Serialize().ToString() );
-	buf.WriteString( m_map_state->Serialize().ToString() );
+	m_tiles->SerializeNested( buf, types::Buffer::E_COMPACT );
+	buf.WriteNested(
+		[ this ]( types::Buffer& b ) {
+			m_map_state->SerializeTo( b );
+		}
+	);
 
-	buf.WriteString( m_meshes.terrain->Serialize().ToString() );
-	buf.WriteString( m_meshes.terrain_data->Serialize().ToString() );
+	buf.WriteString( m_meshes.terrain->Serialize().ToStringView() );
+	buf.WriteString( m_meshes.terrain_data->Serialize().ToStringView() );
 
-	buf.WriteString( m_textures.terrain->Serialize().ToString() );
+	// pixels aren't serialized, only operations to draw them
+	m_textures.terrain->SerializeNested( buf, types::Buffer::E_COMPACT );
 
 	buf.WriteInt( m_sprite_actors.size() );
 	for ( auto& it : m_sprite_actors ) {
-		buf.WriteString( SerializeSpriteActor( it.second ).ToString() );
+		buf.WriteString( SerializeSpriteActor( it.second ).ToStringView() );
 		buf.WriteString( it.first );
 	}
 	buf.WriteInt( m_sprite_instances.size() );
@@ -212,16 +259,16 @@ void Map::Unserialize( types::Buffer buf ) {
 
 	ASSERT( !m_tiles, "tiles already set" );
 	NEW( m_tiles, tile::Tiles );
-	m_tiles->Unserialize( buf.ReadString() );
+	m_tiles->Unserialize( buf.ReadNested() );
 
 	ASSERT( !m_map_state, "map state already set" );
 	NEW( m_map_state, MapState );
-	m_map_state->Unserialize( buf.ReadString() );
+	m_map_state->Unserialize( buf.ReadNested() );
 
 	InitTextureAndMesh();
-	m_meshes.terrain->Unserialize( buf.ReadString() );
-	m_meshes.terrain_data->Unserialize( buf.ReadString() );
-	m_textures.terrain->Unserialize( buf.ReadString() );
+	m_meshes.terrain->Unserialize( buf.ReadNested() );
+	m_meshes.terrain_data->Unserialize( buf.ReadNested() );
+	m_textures.terrain->Unserialize( buf.ReadNested() );
 
 	size_t sz = buf.ReadInt();
 	m_sprite_actors.clear();
@@ -271,7 +318,8 @@ tile::TileState* Map::GetTileState( const size_t x, const size_t y ) const {
 
 tile::TileState* Map::GetTileState( const tile::Tile* tile ) const {
 	// TODO: link by pointer?
-	return GetTileState( tile->coord.x, tile->coord.y );
+	const auto c = tile->GetCoords();
+	return GetTileState( c.x, c.y );
 }
 
 const MapState* Map::GetMapState() const {
@@ -279,63 +327,56 @@ const MapState* Map::GetMapState() const {
 	return m_map_state;
 }
 
+const size_t Map::GetTileTextureX( const size_t x ) {
+	return x / 2 * s_consts.tc.texture_pcx.dimensions.x;
+}
+
+const size_t Map::GetTileTextureY( const size_t y ) {
+	return y * s_consts.tc.texture_pcx.dimensions.y;
+}
+
 void Map::ClearTexture() {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "ClearTexture called outside of tile generation" );
-	for ( auto lt = 0 ; lt < tile::LAYER_MAX ; lt++ ) {
-		m_textures.terrain->Erase(
-			m_current_ts->tex_coord.x1,
-			lt * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + m_current_ts->tex_coord.y1,
-			m_current_ts->tex_coord.x2 - 1,
-			lt * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + m_current_ts->tex_coord.y2 - 1
-		);
-	}
+	ASSERT( s_tile_context, "ClearTexture called outside of tile generation" );
+	m_textures.terrain->ClearCells( s_tile_context->ts->tex_coord.x1, s_tile_context->ts->tex_coord.y1 );
 }
 
 void Map::AddTexture( const tile::tile_layer_type_t tile_layer, const pcx_texture_coordinates_t& tc, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha, util::Perlin* perlin ) {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "AddTexture called outside of tile generation" );
-	m_textures.terrain->AddFrom(
-		m_textures.source.texture_pcx,
+	ASSERT( s_tile_context, "AddTexture called outside of tile generation" );
+	m_textures.terrain->AddOperation(
+		m_textures.terrain->GetCell( tile_layer, s_tile_context->ts->tex_coord.x1, s_tile_context->ts->tex_coord.y1 ),
+		TerrainTexture::S_TEXTURE_PCX,
+		tc,
 		mode,
-		tc.x,
-		tc.y,
-		tc.x + s_consts.tc.texture_pcx.dimensions.x - 1,
-		tc.y + s_consts.tc.texture_pcx.dimensions.y - 1,
-		m_current_ts->tex_coord.x1,
-		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + m_current_ts->tex_coord.y1,
 		rotate,
 		alpha,
-		GetRandom(),
+		GetRandom()->GetUInt(),
 		perlin
 	);
 };
 
 void Map::CopyTextureFromLayer( const tile::tile_layer_type_t tile_layer_from, const size_t tx_from, const size_t ty_from, const tile::tile_layer_type_t tile_layer, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha, util::Perlin* perlin ) {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "CopyTextureFromLayer called outside of tile generation" );
-	m_textures.terrain->AddFrom(
-		m_textures.terrain,
+	ASSERT( s_tile_context, "CopyTextureFromLayer called outside of tile generation" );
+	m_textures.terrain->AddOperation(
+		m_textures.terrain->GetCell( tile_layer, s_tile_context->ts->tex_coord.x1, s_tile_context->ts->tex_coord.y1 ),
+		TerrainTexture::S_CELL,
+		m_textures.terrain->GetCell( tile_layer_from, tx_from, ty_from ),
 		mode,
-		tx_from,
-		tile_layer_from * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from,
-		tx_from + s_consts.tc.texture_pcx.dimensions.x - 1,
-		tile_layer_from * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from + s_consts.tc.texture_pcx.dimensions.y - 1,
-		m_current_ts->tex_coord.x1,
-		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + m_current_ts->tex_coord.y1,
 		rotate,
 		alpha,
-		GetRandom(),
+		GetRandom()->GetUInt(),
 		perlin
 	);
 };
 
 void Map::CopyTexture( const tile::tile_layer_type_t tile_layer_from, const tile::tile_layer_type_t tile_layer, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha, util::Perlin* perlin ) {
-	ASSERT( m_current_ts, "CopyTexture called outside of tile generation" );
+	ASSERT( s_tile_context, "CopyTexture called outside of tile generation" );
 	CopyTextureFromLayer(
 		tile_layer_from,
-		m_current_ts->tex_coord.x1,
-		m_current_ts->tex_coord.y1,
+		s_tile_context->ts->tex_coord.x1,
+		s_tile_context->ts->tex_coord.y1,
 		tile_layer,
 		mode,
 		rotate,
@@ -346,25 +387,22 @@ void Map::CopyTexture( const tile::tile_layer_type_t tile_layer_from, const tile
 
 void Map::CopyTextureDeferred( const tile::tile_layer_type_t tile_layer_from, const size_t tx_from, const size_t ty_from, const tile::tile_layer_type_t tile_layer, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha, util::Perlin* perlin ) {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "CopyTextureDeferred called outside of tile generation" );
-	m_map_state->copy_from_after.push_back(
+	ASSERT( s_tile_context, "CopyTextureDeferred called outside of tile generation" );
+	s_tile_context->copy_from_after.push_back(
 		{
 			mode,
-			tx_from,
-			tile_layer_from * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from,
-			tx_from + s_consts.tc.texture_pcx.dimensions.x - 1,
-			tile_layer_from * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from + s_consts.tc.texture_pcx.dimensions.y - 1,
-			(size_t)m_current_ts->tex_coord.x1,
-			tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + (size_t)m_current_ts->tex_coord.y1,
+			m_textures.terrain->GetCell( tile_layer_from, tx_from, ty_from ),
+			m_textures.terrain->GetCell( tile_layer, s_tile_context->ts->tex_coord.x1, s_tile_context->ts->tex_coord.y1 ),
 			rotate,
 			alpha,
-			perlin
+			perlin,
+			s_tile_context->order
 		}
 	);
 };
 
 void Map::GetTexture( types::texture::Texture* dest_texture, const pcx_texture_coordinates_t& tc, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha ) {
-	ASSERT( m_current_ts, "GetTexture called outside of tile generation" );
+	ASSERT( s_tile_context, "GetTexture called outside of tile generation" );
 	ASSERT( dest_texture->m_width == s_consts.tc.texture_pcx.dimensions.x, "tile dest texture width mismatch" );
 	ASSERT( dest_texture->m_height == s_consts.tc.texture_pcx.dimensions.y, "tile dest texture height mismatch" );
 	dest_texture->AddFrom(
@@ -386,69 +424,91 @@ void Map::GetTextureFromLayer( types::texture::Texture* dest_texture, const tile
 	ASSERT( m_map_state, "map state not set" );
 	ASSERT( dest_texture->m_width == s_consts.tc.texture_pcx.dimensions.x, "tile dest texture width mismatch" );
 	ASSERT( dest_texture->m_height == s_consts.tc.texture_pcx.dimensions.y, "tile dest texture height mismatch" );
+	// terrain texture has no pixels, so cell needs to be composited first
+	NEWV( cell, types::texture::Texture, "TerrainCell", s_consts.tc.texture_pcx.dimensions.x, s_consts.tc.texture_pcx.dimensions.y );
+	m_textures.terrain->CompositeCell( m_textures.terrain->GetCell( tile_layer, tx_from, ty_from ), cell );
 	dest_texture->AddFrom(
-		m_textures.terrain,
+		cell,
 		mode,
-		tx_from,
-		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from,
-		tx_from + s_consts.tc.texture_pcx.dimensions.x - 1,
-		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ty_from + s_consts.tc.texture_pcx.dimensions.y - 1,
+		0,
+		0,
+		s_consts.tc.texture_pcx.dimensions.x - 1,
+		s_consts.tc.texture_pcx.dimensions.y - 1,
 		0,
 		0,
 		rotate,
 		alpha,
 		GetRandom()
 	);
+	DELETE( cell );
 }
 
 void Map::SetTexture( const tile::tile_layer_type_t tile_layer, tile::TileState* ts, types::texture::Texture* src_texture, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha ) {
 	ASSERT( m_map_state, "map state not set" );
-	ASSERT( m_current_ts, "SetTexture called outside of tile generation" );
+	ASSERT( s_tile_context, "SetTexture called outside of tile generation" );
 	ASSERT( src_texture->m_width == s_consts.tc.texture_pcx.dimensions.x, "tile src texture width mismatch" );
 	ASSERT( src_texture->m_height == s_consts.tc.texture_pcx.dimensions.y, "tile src texture height mismatch" );
-	m_textures.terrain->AddFrom(
-		src_texture,
-		mode,
-		0,
-		0,
-		s_consts.tc.texture_pcx.dimensions.x - 1,
-		s_consts.tc.texture_pcx.dimensions.x - 1,
-		ts->tex_coord.x1,
-		tile_layer * m_map_state->dimensions.y * s_consts.tc.texture_pcx.dimensions.y + ts->tex_coord.y1,
-		rotate,
-		alpha,
-		GetRandom()
-	);
+
+	// operation refers to tile that owns source texture instead of pointer, so that it can be replayed after unserializing
+	// modules only read textures of current tile and its neighbours
+	for ( const auto* source_ts : {
+		s_tile_context->ts,
+		ts,
+		ts->W,
+		ts->NW,
+		ts->N,
+		ts->NE,
+		ts->E,
+		ts->SE,
+		ts->S,
+		ts->SW
+	} ) {
+		if ( src_texture == source_ts->moisture_original || src_texture == source_ts->river_original ) {
+			m_textures.terrain->AddOperation(
+				m_textures.terrain->GetCell( tile_layer, ts->tex_coord.x1, ts->tex_coord.y1 ),
+				src_texture == source_ts->moisture_original
+					? TerrainTexture::S_MOISTURE_ORIGINAL
+					: TerrainTexture::S_RIVER_ORIGINAL,
+				m_textures.terrain->GetCell( tile::LAYER_LAND, source_ts->tex_coord.x1, source_ts->tex_coord.y1 ),
+				mode,
+				rotate,
+				alpha,
+				GetRandom()->GetUInt()
+			);
+			return;
+		}
+	}
+	THROW( "source texture is not owned by tile or its neighbours" );
 }
 
 void Map::SetTexture( const tile::tile_layer_type_t tile_layer, types::texture::Texture* src_texture, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha ) {
-	SetTexture( tile_layer, m_current_ts, src_texture, mode, rotate, alpha );
+	SetTexture( tile_layer, s_tile_context->ts, src_texture, mode, rotate, alpha );
 }
 
 const Map::tile_texture_info_t Map::GetTileTextureInfo( const texture_variants_type_t type, const tile::Tile* tile, const tile_grouping_criteria_t criteria, const uint16_t value ) const {
-	ASSERT( m_current_ts, "GetTileTextureInfo called outside of tile generation" );
+	ASSERT( s_tile_context, "GetTileTextureInfo called outside of tile generation" );
 	Map::tile_texture_info_t info;
 
 	bool matches[16];
 	uint8_t idx = 0;
 	for ( uint8_t i = 0 ; i < 2 ; i++ ) {
-		for ( auto& t : tile->neighbours ) {
+		for ( auto& t : tile->GetNeighbours() ) {
 			switch ( criteria ) {
 				case TG_MOISTURE: {
-					matches[ idx++ ] = t->moisture >= tile->moisture;
+					matches[ idx++ ] = *t->GetMoisture() >= *tile->GetMoisture();
 					break;
 				}
 				case TG_FEATURE: {
 					matches[ idx++ ] = (
-						( t->features & value ) == ( tile->features & value ) ||
-							( type == TVT_RIVERS_FORESTS && !tile->is_water_tile && t->is_water_tile ) // rivers end in oceans
+						( *t->GetFeatures() & value ) == ( *tile->GetFeatures() & value ) ||
+							( type == TVT_RIVERS_FORESTS && !tile->IsWater() && t->IsWater() ) // rivers end in oceans
 					);
 					break;
 				}
 				case TG_TERRAFORMING: {
 					matches[ idx++ ] = (
-						( t->terraforming & value ) == ( tile->terraforming & value ) &&
-							t->is_water_tile == tile->is_water_tile // terraforming doesn't continue into water
+						( *t->GetTerraforming() & value ) == ( *tile->GetTerraforming() & value ) &&
+							t->IsWater() == tile->IsWater() // terraforming doesn't continue into water
 					);
 					break;
 				}
@@ -512,7 +572,21 @@ const Map::tile_texture_info_t Map::GetTileTextureInfo( const texture_variants_t
 }
 
 util::random::Random* Map::GetRandom() const {
-	return m_game->GetRandom();
+	if ( s_tile_context ) {
+		// inside tile processing
+		return s_tile_context->random;
+	}
+	return m_game
+		? m_game->GetRandom()
+		: m_random;
+}
+
+void Map::EnableProfiling() {
+	m_is_profiling_enabled = true;
+}
+
+const Map::profile_t& Map::GetProfile() const {
+	return m_profile;
 }
 
 const size_t Map::GetWidth() const {
@@ -607,7 +681,7 @@ void Map::RemoveTerrainSpriteActorInstance( const std::string& key, const size_t
 }
 
 const Map::error_code_t Map::Generate( settings::MapSettings* map_settings, MT_CANCELABLE ) {
-	auto* random = m_game->GetRandom();
+	auto* random = GetRandom();
 	generator::SimplePerlin generator( random );
 	types::Vec2< size_t > size = map_settings->size == settings::MAP_CONFIG_CUSTOM
 		? map_settings->custom_size
@@ -649,7 +723,7 @@ const Map::error_code_t Map::Generate( settings::MapSettings* map_settings, MT_C
 	// if crash happens - it's handy to have a map file to reproduce it
 	if ( !c->HasDebugFlag( config::Config::DF_QUICKSTART_MAP_FILE ) ) { // no point saving if we just loaded it
 		Log( (std::string)"Saving map to " + c->GetDebugPath() + s_consts.debug.lastmap_filename );
-		util::FS::WriteFile( c->GetDebugPath() + s_consts.debug.lastmap_filename, m_tiles->Serialize().ToString() );
+		util::FS::WriteFile( c->GetDebugPath() + s_consts.debug.lastmap_filename, m_tiles->SerializeCompact() );
 	}
 #endif
 
@@ -677,17 +751,38 @@ const Map::error_code_t Map::LoadFromFile( const std::string& path ) {
 	ASSERT( util::FS::FileExists( path ), "map file \"" + path + "\" not found" );
 
 	Log( "Loading map from " + path );
-	auto b = types::Buffer( util::FS::ReadFile( path ) );
-	return LoadFromBuffer( b );
+	try {
+		const util::MappedFile file( path );
+		if ( !tile::Tiles::IsCompactFormat( file.GetData(), file.GetSize() ) ) {
+			// old format, convert through legacy unserializer
+			Log( "Converting map from legacy format" );
+			auto b = types::Buffer( std::string( (const char*)file.GetData(), file.GetSize() ) );
+			return LoadFromBuffer( b );
+		}
+		if ( m_tiles ) {
+			DELETE( m_tiles );
+		}
+		NEW( m_tiles, tile::Tiles );
+		m_tiles->UnserializeCompact( file.GetData(), file.GetSize() );
+		return EC_NONE;
+	}
+	catch ( std::runtime_error& e ) {
+		Log( e.what() );
+		if ( m_tiles ) {
+			DELETE( m_tiles );
+			m_tiles = nullptr;
+		}
+		return EC_MAPFILE_FORMAT_ERROR;
+	}
 }
 
 void Map::SaveToBuffer( types::Buffer& buffer ) const {
-	buffer.WriteString( m_tiles->Serialize().ToString() );
+	m_tiles->SerializeNested( buffer, types::Buffer::E_COMPACT );
 }
 
 const Map::error_code_t Map::SaveToFile( const std::string& path ) const {
 	try {
-		util::FS::WriteFile( path, m_tiles->Serialize().ToString() );
+		util::FS::WriteFile( path, m_tiles->SerializeCompact() );
 		return EC_NONE;
 	}
 	catch ( std::runtime_error& e ) {
@@ -702,6 +797,8 @@ const Map::error_code_t Map::Initialize( MT_CANCELABLE ) {
 
 	Log( "Initializing map" );
 
+	m_profile = {};
+
 	if ( m_map_state ) {
 		DELETE( m_map_state );
 	}
@@ -716,7 +813,7 @@ const Map::error_code_t Map::Initialize( MT_CANCELABLE ) {
 		-( s_consts.tile.scale.y * ( m_map_state->dimensions.y + 1 ) / 4 - s_consts.tile.radius.y )
 	};
 	m_map_state->variables.texture_scaling = {
-		1.0f / s_consts.tc.texture_pcx.dimensions.x / ( m_map_state->dimensions.x + 1 ), // + 1 for overdraw column
+		1.0f / s_consts.tc.texture_pcx.dimensions.x / GetTerrainTextureColumns(),
 		1.0f / s_consts.tc.texture_pcx.dimensions.y / m_map_state->dimensions.y / tile::LAYER_MAX
 	};
 
@@ -732,22 +829,27 @@ const Map::error_code_t Map::Initialize( MT_CANCELABLE ) {
 	const auto tiles = m_tiles->GetVector( MT_C );
 	MT_RETIFV( EC_ABORTED );
 
-	LoadTiles( tiles, MT_C );
+	LoadTiles( tiles, tiles.size(), MT_C );
 	MT_RETIFV( EC_ABORTED );
 
+	auto started_at = std::chrono::steady_clock::now();
 	m_meshes.terrain->Finalize();
 	MT_RETIFV( EC_ABORTED );
 	m_meshes.terrain_data->Finalize();
 	MT_RETIFV( EC_ABORTED );
+	if ( m_is_profiling_enabled ) {
+		m_profile.meshes_finalize_ns = GetElapsedNs( started_at );
+		started_at = std::chrono::steady_clock::now();
+	}
 
 	FixNormals( tiles, MT_C );
 	MT_RETIFV( EC_ABORTED );
+	if ( m_is_profiling_enabled ) {
+		m_profile.fix_normals_ns = GetElapsedNs( started_at );
+	}
 
 	m_map_state->first_run = false;
 
-	m_current_tile = nullptr;
-	m_current_ts = nullptr;
-
 	return EC_NONE;
 }
 
@@ -756,10 +858,9 @@ void Map::InitTextureAndMesh() {
 	if ( m_textures.terrain ) {
 		DELETE( m_textures.terrain );
 	}
-	NEW( m_textures.terrain, types::texture::Texture, "TerrainTexture",
-		( m_map_state->dimensions.x + 1 ) * s_consts.tc.texture_pcx.dimensions.x, // + 1 for overdraw_column
-		( m_map_state->dimensions.y * tile::LAYER_MAX ) * s_consts.tc.texture_pcx.dimensions.y
-	);
+	// only operations that draw tiles are kept, pages of texture are composited by renderer when it needs them
+	NEW( m_textures.terrain, TerrainTexture, m_map_state, m_textures.source.texture_pcx, GetTerrainTextureColumns() );
+	Log( "Terrain texture: " + std::to_string( m_textures.terrain->m_width ) + "x" + std::to_string( m_textures.terrain->m_height ) + " ( " + std::to_string( m_textures.terrain->GetPagesCount() ) + " pages )" );
 
 	// not deleting meshes because if they exist - it means they are already linked to actor and are deleted together when needed
 	NEW( m_meshes.terrain, types::mesh::Render,
@@ -776,8 +877,31 @@ void Map::InitTextureAndMesh() {
 	m_map_state->ter1_pcx = m_textures.source.ter1_pcx;
 }
 
-void Map::ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, MT_CANCELABLE ) {
+const size_t Map::GetTerrainTextureColumns() const {
+	return ( m_map_state->dimensions.x + 1 ) / 2 + 1; // + 1 for overdraw column
+}
+
+const bool Map::CanProcessInParallel( const module_pass_t& module_pass ) const {
+	for ( const auto& m : module_pass ) {
+		if ( m->GetNeighbourAccess() & module::Module::NA_WRITE ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+const bool Map::AccessesNeighbours( const module_pass_t& module_pass ) const {
+	for ( const auto& m : module_pass ) {
+		if ( m->GetNeighbourAccess() != module::Module::NA_NONE ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void Map::ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, const size_t ring_begin, bool& is_ring_joined, MT_CANCELABLE ) {
 	ASSERT( m_map_state, "map state not set" );
+	ASSERT( ring_begin <= tiles.size(), "ring begin out of range" );
 
 	auto* ui = g_engine->GetUI();
 
@@ -787,154 +911,420 @@ void Map::ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, MT
 	std::string loading_text = "Processing tiles (" + sp + "%)";
 	const size_t percent_pos = loading_text.size() - 2 - sp.size();
 
-	size_t tile_i = 0;
+	// number of tiles to process in pass, also joins ring tiles when it's time
+	const auto f_get_pass_tiles_count = [ this, &tiles, &ring_begin ]( const module_pass_t& module_pass, bool& is_joined ) -> size_t {
+		if ( !is_joined && AccessesNeighbours( module_pass ) ) {
+			is_joined = true;
+		}
+		return ( is_joined || &module_pass == &m_modules.front() )
+			? tiles.size()
+			: ring_begin;
+	};
+
+	std::atomic< size_t > tile_i = 0;
 	size_t total = 0;
-	for ( auto& module_pass : module_passes ) {
-		total += module_pass.size();
+	{
+		bool is_joined = is_ring_joined;
+		for ( auto& module_pass : module_passes ) {
+			total += module_pass.size() * f_get_pass_tiles_count( module_pass, is_joined );
+		}
 	}
-	total *= tiles.size();
 
 	uint8_t percent = 0, last_percent = 0;
 
+	const auto f_update_loader_text = [ &ui, &tile_i, &total, &percent, &last_percent, &sp, &percent_len, &loading_text, &percent_pos ]() -> void {
+		if ( !tile_i ) {
+			return;
+		}
+		percent = (uint8_t)ceil( ( (float)tile_i * 100.0f / total ) ) - 1;
+		if ( percent != last_percent ) {
+			last_percent = percent;
+			sp = std::to_string( percent );
+			if ( sp.size() < percent_len ) {
+				sp = std::string( percent_len - sp.size(), ' ' ) + sp;
+			}
+			loading_text.replace( percent_pos, sp.size(), sp.c_str() );
+			ui->SetLoaderText( loading_text );
+		}
+	};
+
+	const size_t max_threads_count = g_engine->GetConfig()->HasLaunchFlag( config::Config::LF_MAP_SERIAL )
+		? 1
+		: m_tile_contexts.size();
+
 	size_t state_iterate_eta = ITERATE_STATE_EVERY_N_TILES;
 
 	for ( auto& module_pass : module_passes ) {
-		for ( const auto& tile : tiles ) {
-			m_current_tile = tile;
-			m_current_ts = GetTileState( tile->coord.x, tile->coord.y );
 
-			for ( auto& m : module_pass ) {
+		const size_t tiles_count = f_get_pass_tiles_count( module_pass, is_ring_joined );
+		const size_t threads_count = std::min< size_t >( max_threads_count, std::max< size_t >( 1, tiles_count / TILES_PER_CHUNK ) );
 
-				m->GenerateTile( m_current_tile, m_current_ts, m_map_state );
+		// every tile gets own random stream forked from pass stream by tile coordinates
+		// this way results are identical regardless of how many threads are used and in what order tiles are processed
+		const util::random::value_t pass_stream_id = GetRandom()->GetUInt(); // also advances map random, so every pass forks differently
+		const auto pass_random = GetRandom()->Fork( pass_stream_id );
 
-				tile_i++;
-				percent = (uint8_t)ceil( ( (float)tile_i * 100.0f / total ) ) - 1;
+		const auto pass_started_at = std::chrono::steady_clock::now();
+		for ( auto& context : m_tile_contexts ) {
+			context.copy_from_after.clear();
+			if ( m_is_profiling_enabled ) {
+				context.modules_ns.assign( module_pass.size(), 0 );
+			}
+		}
 
-				if ( percent != last_percent ) {
-					last_percent = percent;
-					sp = std::to_string( percent );
-					if ( sp.size() < percent_len ) {
-						sp = std::string( percent_len - sp.size(), ' ' ) + sp;
+		const auto f_process_tile = [ this, &module_pass, &tiles, &tile_i, &pass_random ]( tile_context_t& context, const size_t order ) -> void {
+			context.tile = tiles[ order ];
+			context.ts = GetTileState( context.tile );
+			context.order = order;
+			const auto c = context.tile->GetCoords();
+			*context.random = pass_random.Fork( c.y * m_map_state->dimensions.x + c.x );
+			if ( m_is_profiling_enabled ) {
+				for ( size_t i = 0 ; i < module_pass.size() ; i++ ) {
+					const auto started_at = std::chrono::steady_clock::now();
+					module_pass[ i ]->GenerateTile( context.tile, context.ts, m_map_state );
+					context.modules_ns[ i ] += GetElapsedNs( started_at );
+					tile_i++;
+				}
+			}
+			else {
+				for ( auto& m : module_pass ) {
+					m->GenerateTile( context.tile, context.ts, m_map_state );
+					tile_i++;
+				}
+			}
+		};
+
+		if ( threads_count < 2 || !CanProcessInParallel( module_pass ) ) {
+			s_tile_context = &m_tile_contexts.front();
+			for ( size_t order = 0 ; order < tiles_count ; order++ ) {
+				f_process_tile( *s_tile_context, order );
+				f_update_loader_text();
+				if ( canceled ) {
+					break;
+				}
+				if ( !--state_iterate_eta ) {
+					// keep processing state (i.e. network events) while loading
+					if ( m_game ) {
+						m_game->GetState()->Iterate();
 					}
-					loading_text.replace( percent_pos, sp.size(), sp.c_str() );
-					ui->SetLoaderText( loading_text );
+					state_iterate_eta = ITERATE_STATE_EVERY_N_TILES;
 				}
+			}
+			s_tile_context = nullptr;
+		}
+		else {
+			auto* job_system = g_engine->GetJobSystem();
+			std::atomic< size_t > next_chunk = 0;
+			common::JobGroup group;
+			for ( size_t i = 0 ; i < threads_count ; i++ ) {
+				job_system->Run(
+					group, [ this, &f_process_tile, &tiles_count, &next_chunk, &group, &canceled ]() -> void {
+						// job runs on one worker from start to end, so worker's context can't be used by anything else meanwhile
+						s_tile_context = &m_tile_contexts.at( common::JobSystem::GetWorkerIndex() );
+						try {
+							size_t begin;
+							while ( !canceled && !group.IsCanceled() && ( begin = next_chunk.fetch_add( TILES_PER_CHUNK ) ) < tiles_count ) {
+								const size_t end = std::min( begin + TILES_PER_CHUNK, tiles_count );
+								for ( size_t order = begin ; order < end ; order++ ) {
+									f_process_tile( *s_tile_context, order );
+								}
+							}
+						}
+						catch ( ... ) {
+							s_tile_context = nullptr;
+							throw;
+						}
+						s_tile_context = nullptr;
+					}
+				);
+			}
+			while ( !group.IsFinished() ) {
+				std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+				f_update_loader_text();
+			}
+			job_system->Wait( group ); // rethrows errors of tile generation
+			// state isn't processed while workers run because handlers may change game or map state
+			if ( m_game ) {
+				m_game->GetState()->Iterate();
+			}
+		}
 
-				MT_RETIF();
+		// deferred copies must be replayed in same order as if tiles were processed serially
+		// every tile is processed by one worker, so copies of same tile are already in order within its context
+		auto& copy_from_after = m_map_state->copy_from_after;
+		const size_t pass_copies_begin = copy_from_after.size();
+		for ( auto& context : m_tile_contexts ) {
+			copy_from_after.insert( copy_from_after.end(), context.copy_from_after.begin(), context.copy_from_after.end() );
+			context.copy_from_after.clear();
+		}
+		std::stable_sort(
+			copy_from_after.begin() + pass_copies_begin, copy_from_after.end(), []( const MapState::copy_from_after_t& a, const MapState::copy_from_after_t& b ) -> bool {
+				return a.tile_order < b.tile_order;
 			}
+		);
 
-			if ( !--state_iterate_eta ) {
-				// keep processing state (i.e. network events) while loading
-				m_game->GetState()->Iterate();
-				state_iterate_eta = ITERATE_STATE_EVERY_N_TILES;
+		if ( m_is_profiling_enabled ) {
+			profile_t::pass_t pass = {};
+			pass.wall_ns = GetElapsedNs( pass_started_at );
+			for ( size_t i = 0 ; i < module_pass.size() ; i++ ) {
+				uint64_t ns = 0;
+				for ( const auto& context : m_tile_contexts ) {
+					ns += context.modules_ns[ i ];
+				}
+				pass.modules_ns.push_back(
+					{
+						module_pass[ i ]->GetClassName(),
+						ns
+					}
+				);
 			}
+			m_profile.passes.push_back( pass );
 		}
+
+		MT_RETIF();
 	}
 }
 
-void Map::LoadTiles( const tiles_t& tiles, MT_CANCELABLE ) {
+void Map::LoadTiles( const tiles_t& tiles, const size_t ring_begin, MT_CANCELABLE ) {
 
-	Log( "Loading " + std::to_string( tiles.size() ) + " tiles" );
+	Log( "Loading " + std::to_string( ring_begin ) + " tiles" + ( ring_begin < tiles.size()
+		? " ( and " + std::to_string( tiles.size() - ring_begin ) + " neighbours )"
+		: ""
+	) );
 
-	ProcessTiles( m_modules, tiles, MT_C );
+	bool is_ring_joined = false;
+	ProcessTiles( m_modules, tiles, ring_begin, is_ring_joined, MT_C );
 	MT_RETIF();
 
+	const auto started_at = std::chrono::steady_clock::now();
 	for ( auto& c : m_map_state->copy_from_after ) {
-		m_textures.terrain->AddFrom( m_textures.terrain, c.mode, c.tx1_from, c.ty1_from, c.tx2_from, c.ty2_from, c.tx_to, c.ty_to, c.rotate, c.alpha, GetRandom(), c.perlin );
+		m_textures.terrain->AddOperation( c.cell_to, TerrainTexture::S_CELL, c.cell_from, c.mode, c.rotate, c.alpha, GetRandom()->GetUInt(), c.perlin );
 	}
 	m_map_state->copy_from_after.clear();
+	if ( m_is_profiling_enabled ) {
+		m_profile.copy_from_after_ns = GetElapsedNs( started_at );
+	}
 	MT_RETIF();
 
-	ProcessTiles( m_modules_deferred, tiles, MT_C );
+	ProcessTiles( m_modules_deferred, tiles, ring_begin, is_ring_joined, MT_C );
 	MT_RETIF();
 }
 
-void Map::FixNormals( const tiles_t& tiles, MT_CANCELABLE ) {
-	Log( "Fixing normals" );
-
-	g_engine->GetUI()->SetLoaderText( "Fixing normals" );
-
-	std::vector< types::mesh::surface_id_t > surfaces = {};
+void Map::ReloadTiles( const tiles_t& tiles, MT_CANCELABLE ) {
+	ASSERT( !m_map_state->first_run, "tiles can only be reloaded after map was loaded" );
 
-	// avoiding reallocations is more important than saving memory
-	// worst case scenario: 4 surfaces per tile, 4 layers + overdraw column (only land layer)
-	surfaces.reserve( tiles.size() * 4 * 5 );
+	// neighbours of reloaded tiles that aren't reloaded themselves, these only rerun modules that may see changes of reloaded tiles
+	tiles_t tiles_and_ring = tiles;
+	std::unordered_set< const tile::Tile* > seen_tiles( tiles.begin(), tiles.end() );
+	for ( const auto& tile : tiles ) {
+		for ( const auto& n : tile->GetNeighbours() ) {
+			if ( seen_tiles.insert( n ).second ) {
+				tiles_and_ring.push_back( n );
+			}
+		}
+	}
 
-	for ( auto& tile : tiles ) {
-		auto* ts = GetTileState( tile->coord.x, tile->coord.y );
-#define x( _layer ) \
-            surfaces.push_back( _layer.surfaces.left_top ); \
-            surfaces.push_back( _layer.surfaces.top_right ); \
-            surfaces.push_back( _layer.surfaces.right_bottom ); \
-            surfaces.push_back( _layer.surfaces.bottom_left )
-		x( ts->layers[ tile::LAYER_LAND ] );
-		if ( ts->has_water ) {
-			x( ts->layers[ tile::LAYER_WATER ] );
-			x( ts->layers[ tile::LAYER_WATER_SURFACE ] );
-			x( ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ] );
-		}
-		if ( tile->coord.x == 0 ) {
-			// also update overdraw column
-			x( ts->overdraw_column );
+	// vertex indices don't change after first run, so ranges can be collected before anything is locked
+	// vertices of neighbours of ring are touched too when combining normals
+	std::vector< types::mesh::index_t > indices = {}, data_indices = {};
+	indices.reserve( tiles_and_ring.size() * 7 * ( tile::LAYER_MAX + 1 ) * 5 );
+	data_indices.reserve( tiles_and_ring.size() * 7 * 5 );
+#define x( _indices, _ti ) \
+        _indices.push_back( _ti.center ); \
+        _indices.push_back( _ti.left ); \
+        _indices.push_back( _ti.top ); \
+        _indices.push_back( _ti.right ); \
+        _indices.push_back( _ti.bottom )
+	const auto f_add_tile_indices = [ this, &indices, &data_indices ]( const tile::Tile* tile ) -> void {
+		const auto* ts = GetTileState( tile );
+		for ( const auto& layer : ts->layers ) {
+			x( indices, layer.indices );
 		}
+		if ( tile->GetCoords().x == 0 ) {
+			x( indices, ts->overdraw_column.indices );
+		}
+		x( data_indices, ts->data_mesh.indices );
+	};
 #undef x
-		MT_RETIF();
+	for ( const auto& tile : tiles_and_ring ) {
+		f_add_tile_indices( tile );
+		for ( const auto& n : tile->GetNeighbours() ) {
+			f_add_tile_indices( n );
+		}
 	}
-	m_meshes.terrain->UpdateNormals( surfaces );
+	const auto updated_ranges = GetUpdatedRanges( indices );
+	const auto updated_data_ranges = GetUpdatedRanges( data_indices );
+
+	// changes are published once everything is regenerated, so renderer never picks up half-drawn tiles
+	// published vertex ranges are copies, so renderer doesn't wait for next edit and doesn't read what it writes
+	// renderer doesn't composite texture pages meanwhile, it keeps showing outdated ones until update is finished
+	// partial updates must end on every path ( including exceptions rethrown from tile jobs ), otherwise renderer would wait for them forever
+	struct partial_update_t {
+		partial_update_t( Map* const map, const types::mesh::Mesh::updated_ranges_t& updated_ranges, const types::mesh::Mesh::updated_ranges_t& updated_data_ranges )
+			: m_map( map )
+			, m_updated_ranges( updated_ranges )
+			, m_updated_data_ranges( updated_data_ranges ) {
+			m_map->m_textures.terrain->BeginPartialUpdate();
+			m_map->m_meshes.terrain->BeginPartialUpdate();
+			m_map->m_meshes.terrain_data->BeginPartialUpdate();
+		}
+		~partial_update_t() {
+			m_map->m_meshes.terrain->EndPartialUpdate( m_updated_ranges );
+			m_map->m_meshes.terrain_data->EndPartialUpdate( m_updated_data_ranges );
+			m_map->m_textures.terrain->EndPartialUpdate();
+		}
+	private:
+		Map* const m_map;
+		const types::mesh::Mesh::updated_ranges_t& m_updated_ranges;
+		const types::mesh::Mesh::updated_ranges_t& m_updated_data_ranges;
+	};
+	const partial_update_t partial_update( this, updated_ranges, updated_data_ranges );
 
-	std::vector< types::mesh::index_t > v, vtmp;
+	LoadTiles( tiles_and_ring, tiles.size(), MT_C );
+	MT_RETIF();
 
-	// to prevent reallocations
-	vtmp.reserve( 4 );
-	v.reserve( 8 );
+	FixNormals( tiles_and_ring, MT_C );
+}
 
-	// normals will be combined at left vertex of tile
-	const auto f_combine_normals_at_left_vertex = [ this, &v, &vtmp ]( const tile::Tile* tile ) -> void {
-		auto* ts = GetTileState( tile->coord.x, tile->coord.y );
-#define x( _lt ) { \
-            ts->layers[ _lt ].indices.left, \
-            ts->NW->layers[ _lt ].indices.bottom, \
-            ts->W->layers[ _lt ].indices.right, \
-            ts->SW->layers[ _lt ].indices.top, \
-        }
-		v = x( tile::LAYER_LAND );
-		if ( tile->is_water_tile || tile->W->is_water_tile || tile->NW->is_water_tile ) {
-			vtmp = x( tile::LAYER_WATER );
-			v.insert( v.end(), vtmp.begin(), vtmp.end() );
+const types::mesh::Mesh::updated_ranges_t Map::GetUpdatedRanges( std::vector< types::mesh::index_t >& indices ) {
+	// vertices of each tile are close to each other, and it's cheaper to reload small gaps than to issue separate reloads
+	const types::mesh::index_t max_gap = 32;
+	types::mesh::Mesh::updated_ranges_t result = {};
+	std::sort( indices.begin(), indices.end() );
+	for ( const auto& index : indices ) {
+		if ( !result.empty() && index <= result.back().to + max_gap ) {
+			result.back().to = std::max( result.back().to, index + 1 );
 		}
+		else {
+			result.push_back(
+				{
+					index,
+					index + 1
+				}
+			);
+		}
+	}
+	return result;
+}
+
+void Map::FixNormals( const tiles_t& tiles, MT_CANCELABLE ) {
+	Log( "Fixing normals" );
+
+	g_engine->GetUI()->SetLoaderText( "Fixing normals" );
+
+	auto* mesh = m_meshes.terrain;
+
+	// every tile has own vertices in every layer, so tiles can be processed in parallel and results don't depend on order
+	ProcessInParallel(
+		tiles.size(), [ this, &tiles, &mesh ]( const size_t begin, const size_t end ) -> void {
+			for ( size_t i = begin ; i < end ; i++ ) {
+				const auto* tile = tiles[ i ];
+				const auto* ts = GetTileState( tile );
+#define x( _layer ) \
+            mesh->UpdateSurfaceNormal( _layer.surfaces.left_top ); \
+            mesh->UpdateSurfaceNormal( _layer.surfaces.top_right ); \
+            mesh->UpdateSurfaceNormal( _layer.surfaces.right_bottom ); \
+            mesh->UpdateSurfaceNormal( _layer.surfaces.bottom_left )
+				x( ts->layers[ tile::LAYER_LAND ] );
+				if ( ts->has_water ) {
+					x( ts->layers[ tile::LAYER_WATER ] );
+					x( ts->layers[ tile::LAYER_WATER_SURFACE ] );
+					x( ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ] );
+				}
+				if ( tile->GetCoords().x == 0 ) {
+					// also update overdraw column
+					x( ts->overdraw_column );
+				}
 #undef x
+			}
+		}, MT_C
+	);
+	MT_RETIF();
 
-		m_meshes.terrain->CombineNormals( v );
-	};
-	std::unordered_set< const tile::Tile* > processed_tiles = {}; // to prevent duplicate combining
-	processed_tiles.reserve( tiles.size() * 4 ); // minimizing reallocations is more important than saving memory
-	const auto f_combine_normals_maybe = [ &f_combine_normals_at_left_vertex, &processed_tiles ]( const tile::Tile* tile ) -> void {
-		if ( processed_tiles.find( tile ) == processed_tiles.end() ) {
-			f_combine_normals_at_left_vertex( tile );
-			processed_tiles.insert( tile );
+	// normals will be combined at left vertex of tile, together with adjactent vertices of W, NW and SW tiles
+	// every vertex belongs to exactly one such group, so groups can be combined in parallel too
+	const size_t width = m_map_state->dimensions.x;
+	if ( m_normals_combine_visited.size() != width * m_map_state->dimensions.y ) {
+		m_normals_combine_visited.assign( width * m_map_state->dimensions.y, false );
+	}
+	m_normals_combine_tiles.clear();
+	const auto f_add_combine_tile = [ this, &width ]( const tile::Tile* tile ) -> void {
+		const auto c = tile->GetCoords();
+		auto bit = m_normals_combine_visited[ c.y * width + c.x ];
+		if ( !bit ) {
+			bit = true;
+			m_normals_combine_tiles.push_back( tile );
 		}
 	};
-
 	for ( const auto& tile : tiles ) {
-		f_combine_normals_maybe( tile );
-		f_combine_normals_maybe( tile->NE );
-		f_combine_normals_maybe( tile->E );
-		f_combine_normals_maybe( tile->SE );
+		f_add_combine_tile( tile );
+		f_add_combine_tile( tile->NE() );
+		f_add_combine_tile( tile->E() );
+		f_add_combine_tile( tile->SE() );
+	}
+	for ( const auto& tile : m_normals_combine_tiles ) {
+		const auto c = tile->GetCoords();
+		m_normals_combine_visited[ c.y * width + c.x ] = false;
 	}
 
+	ProcessInParallel(
+		m_normals_combine_tiles.size(), [ this, &mesh ]( const size_t begin, const size_t end ) -> void {
+			types::mesh::index_t v[ 8 ];
+			size_t count;
+			for ( size_t i = begin ; i < end ; i++ ) {
+				const auto* tile = m_normals_combine_tiles[ i ];
+				const auto* ts = GetTileState( tile );
+#define x( _lt ) \
+            v[ count++ ] = ts->layers[ _lt ].indices.left; \
+            v[ count++ ] = ts->NW->layers[ _lt ].indices.bottom; \
+            v[ count++ ] = ts->W->layers[ _lt ].indices.right; \
+            v[ count++ ] = ts->SW->layers[ _lt ].indices.top
+				count = 0;
+				x( tile::LAYER_LAND );
+				if ( tile->IsWater() || tile->W()->IsWater() || tile->NW()->IsWater() ) {
+					x( tile::LAYER_WATER );
+				}
+#undef x
+				mesh->CombineNormals( v, count );
+			}
+		}, MT_C
+	);
+	MT_RETIF();
+
 	// average center normals
-	for ( const auto& tile : tiles ) {
-		auto* ts = GetTileState( tile->coord.x, tile->coord.y );
-
-		m_meshes.terrain->SetVertexNormal(
-			ts->layers[ tile::LAYER_LAND ].indices.center, (
-				m_meshes.terrain->GetVertexNormal( ts->layers[ tile::LAYER_LAND ].indices.left ) +
-					m_meshes.terrain->GetVertexNormal( ts->layers[ tile::LAYER_LAND ].indices.top ) +
-					m_meshes.terrain->GetVertexNormal( ts->layers[ tile::LAYER_LAND ].indices.right ) +
-					m_meshes.terrain->GetVertexNormal( ts->layers[ tile::LAYER_LAND ].indices.bottom )
-			) / 4
-		);
+	ProcessInParallel(
+		tiles.size(), [ this, &tiles, &mesh ]( const size_t begin, const size_t end ) -> void {
+			for ( size_t i = begin ; i < end ; i++ ) {
+				const auto* tile = tiles[ i ];
+				const auto& indices = GetTileState( tile )->layers[ tile::LAYER_LAND ].indices;
+				mesh->SetVertexNormal(
+					indices.center, (
+						mesh->GetVertexNormal( indices.left ) +
+							mesh->GetVertexNormal( indices.top ) +
+							mesh->GetVertexNormal( indices.right ) +
+							mesh->GetVertexNormal( indices.bottom )
+					) / 4
+				);
+			}
+		}, MT_C
+	);
+
+	mesh->Update();
+}
+
+void Map::ProcessInParallel( const size_t count, const std::function< void( const size_t begin, const size_t end ) >& f, MT_CANCELABLE ) {
+	size_t threads_count = m_tile_contexts.size();
+	if ( g_engine->GetConfig()->HasLaunchFlag( config::Config::LF_MAP_SERIAL ) ) {
+		threads_count = 1;
+	}
+	if ( threads_count > count / TILES_PER_CHUNK ) {
+		threads_count = std::max< size_t >( 1, count / TILES_PER_CHUNK );
+	}
+	if ( threads_count < 2 ) {
+		f( 0, count );
+		return;
 	}
+	g_engine->GetJobSystem()->ParallelFor( count, TILES_PER_CHUNK, f, canceled );
 }
 
 void Map::CalculateTextureVariants( const texture_variants_type_t type, const texture_variants_rules_t& rules ) {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -10,8 +11,11 @@
 #include "common/MTTypes.h"
 #include "game/map/tile/Types.h"
 #include "types/texture/Types.h"
+#include "util/random/Types.h"
 
 #include "types/Buffer.h"
+#include "types/mesh/Mesh.h"
+#include "MapState.h"
 
 namespace types {
 namespace texture {
@@ -30,6 +34,12 @@ class Random;
 class Perlin;
 }
 
+namespace task {
+namespace mapbenchmark {
+class MapBenchmark;
+}
+}
+
 namespace game {
 
 class Game;
@@ -47,6 +57,7 @@ class Tiles;
 }
 
 class MapState;
+class TerrainTexture;
 
 namespace module {
 class Module;
@@ -57,6 +68,7 @@ class Finalize;
 CLASS( Map, types::Serializable )
 
 	Map( Game* game );
+	Map( util::random::Random* random ); // standalone map without game (i.e. for benchmarks)
 	~Map();
 
 	enum error_code_t {
@@ -101,6 +113,9 @@ CLASS( Map, types::Serializable )
 	tile::TileState* GetTileState( const size_t x, const size_t y ) const;
 	tile::TileState* GetTileState( const tile::Tile* tile ) const;
 	const MapState* GetMapState() const;
+	// tiles only exist on every other column of each row, so pairs of columns share one column of terrain texture cells
+	static const size_t GetTileTextureX( const size_t x );
+	static const size_t GetTileTextureY( const size_t y );
 	void ClearTexture();
 	void AddTexture( const tile::tile_layer_type_t tile_layer, const pcx_texture_coordinates_t& tc, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha = 1.0f, util::Perlin* perlin = nullptr );
 	void CopyTextureFromLayer( const tile::tile_layer_type_t tile_layer_from, const size_t tx_from, const size_t ty_from, const tile::tile_layer_type_t tile_layer, const types::texture::add_flag_t mode, const uint8_t rotate, const float alpha = 1.0f, util::Perlin* perlin = nullptr );
@@ -120,6 +135,20 @@ CLASS( Map, types::Serializable )
 	// be careful using this
 	tile::Tiles* GetTilesPtr() const;
 
+	// optional timings of map initialization stages, collected only when enabled because of clock overhead per tile
+	struct profile_t {
+		struct pass_t {
+			std::vector< std::pair< std::string, uint64_t > > modules_ns = {}; // summed over all worker threads
+			uint64_t wall_ns = 0;
+		};
+		std::vector< pass_t > passes = {};
+		uint64_t copy_from_after_ns = 0;
+		uint64_t meshes_finalize_ns = 0;
+		uint64_t fix_normals_ns = 0;
+	};
+	void EnableProfiling();
+	const profile_t& GetProfile() const;
+
 	const types::Buffer SerializeSpriteActor( const sprite_actor_t& sprite_actor ) const;
 	const sprite_actor_t UnserializeSpriteActor( types::Buffer buf ) const;
 
@@ -130,6 +159,7 @@ CLASS( Map, types::Serializable )
 private:
 	friend class module::Finalize;
 	friend class ::game::Game;
+	friend class ::task::mapbenchmark::MapBenchmark;
 
 	struct {
 		types::mesh::Render* terrain = nullptr;
@@ -140,7 +170,7 @@ private:
 			types::texture::Texture* texture_pcx = nullptr;
 			types::texture::Texture* ter1_pcx = nullptr;
 		} source;
-		types::texture::Texture* terrain = nullptr;
+		TerrainTexture* terrain = nullptr;
 	} m_textures;
 
 	// proxying because we can't create actors in this thread
@@ -155,8 +185,15 @@ private:
 
 private:
 	const int ITERATE_STATE_EVERY_N_TILES = 64;
+	const size_t TILES_PER_CHUNK = 64; // tiles are handed to worker threads in chunks of this size
+
+	Map( Game* game, util::random::Random* random );
 
 	Game* m_game = nullptr;
+	util::random::Random* m_random = nullptr; // used instead of game random if there is no game
+
+	bool m_is_profiling_enabled = false;
+	profile_t m_profile = {};
 
 	tile::Tiles* m_tiles = nullptr;
 	MapState* m_map_state = nullptr;
@@ -168,10 +205,35 @@ private:
 	module_passes_t m_modules; // before finalizing and deferred calls
 	module_passes_t m_modules_deferred; // after finalizing and deferred calls
 
+	// tile that is currently processed by thread
+	struct tile_context_t {
+		const tile::Tile* tile = nullptr;
+		tile::TileState* ts = nullptr;
+		size_t order = 0; // position in tiles list
+		util::random::Random* random = nullptr; // per-tile stream, so that results don't depend on processing order
+		std::vector< uint64_t > modules_ns = {}; // per module of current pass, only if profiling
+		std::vector< MapState::copy_from_after_t > copy_from_after = {}; // requested by tiles of current pass, merged into map state after it
+	};
+	std::vector< tile_context_t > m_tile_contexts = {}; // one per worker thread
+	static thread_local tile_context_t* s_tile_context;
+
 	void InitTextureAndMesh();
-	void ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, MT_CANCELABLE );
-	void LoadTiles( const tiles_t& tiles, MT_CANCELABLE );
+	const size_t GetTerrainTextureColumns() const;
+	const bool CanProcessInParallel( const module_pass_t& module_pass ) const;
+	const bool AccessesNeighbours( const module_pass_t& module_pass ) const;
+	// tiles from ring_begin onwards are neighbour ring of reloaded ones, they only need modules that may see changes of reloaded tiles:
+	//   first pass ( which resets their states ) and every pass starting from first one that accesses neighbour states
+	//   is_ring_joined is set once ring tiles joined, so that following module passes ( i.e. deferred ones ) keep them
+	void ProcessTiles( module_passes_t& module_passes, const tiles_t& tiles, const size_t ring_begin, bool& is_ring_joined, MT_CANCELABLE );
+	void LoadTiles( const tiles_t& tiles, const size_t ring_begin, MT_CANCELABLE );
 	void FixNormals( const tiles_t& tiles, MT_CANCELABLE );
+	// splits range into chunks and processes them with worker threads (or in current thread if range is small)
+	void ProcessInParallel( const size_t count, const std::function< void( const size_t begin, const size_t end ) >& f, MT_CANCELABLE );
+	std::vector< const tile::Tile* > m_normals_combine_tiles = {};
+	std::vector< bool > m_normals_combine_visited = {}; // bit per tile coordinate, kept clear between calls
+	// regenerates already initialized tiles (i.e. after editing) and publishes only changed texture areas and vertices to renderer
+	void ReloadTiles( const tiles_t& tiles, MT_CANCELABLE );
+	static const types::mesh::Mesh::updated_ranges_t GetUpdatedRanges( std::vector< types::mesh::index_t >& indices );
 
 	// texture.pcx contains some textures grouped in certain way based on adjactent neighbours
 	// calculate all variants once and cache for faster lookups later
@@ -184,9 +246,6 @@ private:
 	std::unordered_map< texture_variants_type_t, texture_variants_t > m_texture_variants = {};
 	void CalculateTextureVariants( const texture_variants_type_t type, const texture_variants_rules_t& rules );
 
-	tile::TileState* m_current_ts = nullptr;
-	const tile::Tile* m_current_tile = nullptr;
-
 };
 
 }
@@ -82,6 +82,11 @@ void MapState::LinkTileStates( MT_CANCELABLE ) {
 
 const types::Buffer MapState::Serialize() const {
 	types::Buffer buf;
+	SerializeTo( buf );
+	return buf;
+}
+
+void MapState::SerializeTo( types::Buffer& buf ) const {
 
 	buf.WriteBool( first_run );
 	buf.WriteVec2f( coord );
@@ -92,13 +97,13 @@ const types::Buffer MapState::Serialize() const {
 	for ( auto y = 0 ; y < dimensions.y ; y++ ) {
 		for ( auto x = y & 1 ; x < dimensions.x ; x += 2 ) {
 			const auto* ts = AtConst( x, y );
-			const auto b = ts->Serialize();
-			const auto s = b.ToString();
-			buf.WriteString( s );
+			buf.WriteNested(
+				[ ts ]( types::Buffer& b ) {
+					ts->SerializeTo( b );
+				}
+			);
 		}
 	}
-
-	return buf;
 }
 
 void MapState::Unserialize( types::Buffer buf ) {
@@ -114,7 +119,7 @@ void MapState::Unserialize( types::Buffer buf ) {
 
 	for ( auto y = 0 ; y < dimensions.y ; y++ ) {
 		for ( auto x = y & 1 ; x < dimensions.x ; x += 2 ) {
-			At( x, y )->Unserialize( buf.ReadString() );
+			At( x, y )->Unserialize( buf.ReadNested() );
 		}
 	}
 
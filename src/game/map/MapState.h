@@ -30,15 +30,12 @@ CLASS( MapState, common::Class )
 
 	struct copy_from_after_t {
 		types::texture::add_flag_t mode;
-		size_t tx1_from;
-		size_t ty1_from;
-		size_t tx2_from;
-		size_t ty2_from;
-		size_t tx_to;
-		size_t ty_to;
+		types::Vec2< uint32_t > cell_from; // cells of terrain texture
+		types::Vec2< uint32_t > cell_to;
 		uint8_t rotate;
 		float alpha;
 		util::Perlin* perlin = nullptr;
+		size_t tile_order = 0; // position of tile that requested copy, to keep order stable when tiles are processed in parallel
 	};
 
 	bool first_run;
@@ -59,6 +56,7 @@ CLASS( MapState, common::Class )
 	void LinkTileStates( MT_CANCELABLE );
 
 	const types::Buffer Serialize() const;
+	void SerializeTo( types::Buffer& buf ) const; // writes into existing buffer, i.e. as nested value
 	void Unserialize( types::Buffer buf );
 
 private:
@@ -0,0 +1,316 @@
+#include "TerrainTexture.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "MapState.h"
+#include "Consts.h"
+#include "tile/TileState.h"
+#include "util/Perlin.h"
+
+namespace game {
+namespace map {
+
+TerrainTexture::TerrainTexture( const MapState* map_state, const types::texture::Texture* texture_pcx, const size_t columns )
+	: types::texture::PagedTexture(
+	"TerrainTexture",
+	columns * s_consts.tc.texture_pcx.dimensions.x,
+	map_state->dimensions.y * tile::LAYER_MAX * s_consts.tc.texture_pcx.dimensions.y,
+	PAGE_CELLS * s_consts.tc.texture_pcx.dimensions.x,
+	PAGE_CELLS * s_consts.tc.texture_pcx.dimensions.y
+)
+	, m_map_state( map_state )
+	, m_texture_pcx( texture_pcx )
+	, m_columns( columns )
+	, m_rows( map_state->dimensions.y ) {
+	m_cells.resize( m_columns * m_rows * tile::LAYER_MAX );
+	m_dependent_cells.resize( m_columns * m_rows );
+}
+
+TerrainTexture::~TerrainTexture() {
+	for ( auto& it : m_perlins ) {
+		DELETE( it.second );
+	}
+	for ( auto& scratch_cell : m_scratch_cells ) {
+		DELETE( scratch_cell );
+	}
+}
+
+const TerrainTexture::cell_t TerrainTexture::GetCell( const tile::tile_layer_type_t tile_layer, const size_t tex_x, const size_t tex_y ) const {
+	ASSERT( tile_layer < tile::LAYER_MAX, "invalid tile layer" );
+	ASSERT( tex_x % s_consts.tc.texture_pcx.dimensions.x == 0 && tex_y % s_consts.tc.texture_pcx.dimensions.y == 0, "coordinates are not at cell boundary" );
+	return {
+		(uint32_t)( tex_x / s_consts.tc.texture_pcx.dimensions.x ),
+		(uint32_t)( tile_layer * m_rows + tex_y / s_consts.tc.texture_pcx.dimensions.y )
+	};
+}
+
+void TerrainTexture::ClearCells( const size_t tex_x, const size_t tex_y ) {
+	for ( auto lt = 0 ; lt < tile::LAYER_MAX ; lt++ ) {
+		const auto cell_index = GetCellIndex( GetCell( (tile::tile_layer_type_t)lt, tex_x, tex_y ) );
+		m_cells[ cell_index ].clear();
+		InvalidateCell( cell_index );
+	}
+	// cells of neighbours that read from this tile will look differently too
+	// ( those that aren't regenerated keep their operations, but sources of them are going to change )
+	std::lock_guard guard( m_dependent_cells_mutex );
+	for ( const auto& cell_index : m_dependent_cells.at( GetTileCellIndex( GetCell( tile::LAYER_LAND, tex_x, tex_y ) ) ) ) {
+		InvalidateCell( cell_index );
+	}
+}
+
+void TerrainTexture::AddOperation( const cell_t& cell, const source_t source, const cell_t& source_coords, const types::texture::add_flag_t mode, const types::texture::rotate_t rotate, const float alpha, const uint32_t random_seed, const util::Perlin* perlin ) {
+	const auto cell_index = GetCellIndex( cell );
+	size_t source_operations_count = 0;
+	switch ( source ) {
+		case S_TEXTURE_PCX: {
+			ASSERT( source_coords.x + s_consts.tc.texture_pcx.dimensions.x <= m_texture_pcx->m_width, "texture.pcx x overflow" );
+			ASSERT( source_coords.y + s_consts.tc.texture_pcx.dimensions.y <= m_texture_pcx->m_height, "texture.pcx y overflow" );
+			break;
+		}
+		case S_MOISTURE_ORIGINAL:
+		case S_RIVER_ORIGINAL: {
+			AddDependentCell( GetTileCellIndex( source_coords ), cell_index );
+			break;
+		}
+		case S_CELL: {
+			const auto source_cell_index = GetCellIndex( source_coords );
+			// later operations of source cell ( including ones that copy from this cell ) must not be replayed
+			source_operations_count = m_cells[ source_cell_index ].size();
+			AddDependentCell( GetTileCellIndex( source_coords ), cell_index );
+			break;
+		}
+		default:
+			THROW( "unknown terrain texture source " + std::to_string( source ) );
+	}
+	if ( perlin ) {
+		ASSERT( perlin->IsSeeded(), "unseeded perlin can't be replayed" );
+	}
+	m_cells[ cell_index ].push_back(
+		{
+			source,
+			source_coords,
+			(uint32_t)source_operations_count,
+			mode,
+			rotate,
+			alpha,
+			random_seed,
+			perlin != nullptr,
+			perlin
+				? perlin->GetSeed()
+				: 0
+		}
+	);
+	InvalidateCell( cell_index );
+}
+
+void TerrainTexture::CompositeCell( const cell_t& cell, types::texture::Texture* dest ) const {
+	ASSERT( dest->m_width == s_consts.tc.texture_pcx.dimensions.x && dest->m_height == s_consts.tc.texture_pcx.dimensions.y, "cell size mismatch" );
+	std::lock_guard guard( m_composite_mutex );
+	memset( ptr( dest->m_bitmap, 0, dest->m_bitmap_size ), 0, dest->m_bitmap_size );
+	const auto cell_index = GetCellIndex( cell );
+	CompositeOperations( cell_index, m_cells[ cell_index ].size(), dest, 0, 0, 0 );
+}
+
+const types::Buffer TerrainTexture::Serialize() const {
+	types::Buffer buf( types::Buffer::E_COMPACT );
+	SerializeTo( buf );
+	return buf;
+}
+
+void TerrainTexture::SerializeTo( types::Buffer& buf ) const {
+	buf.WriteInt( m_columns );
+	buf.WriteInt( m_rows );
+	for ( const auto& operations : m_cells ) {
+		buf.WriteInt( operations.size() );
+		for ( const auto& operation : operations ) {
+			buf.WriteInt( operation.source );
+			buf.WriteVec2u( operation.source_coords );
+			buf.WriteInt( operation.source_operations_count );
+			buf.WriteInt( operation.mode );
+			buf.WriteInt( operation.rotate );
+			buf.WriteFloat( operation.alpha );
+			buf.WriteInt( operation.random_seed );
+			buf.WriteBool( operation.has_perlin );
+			if ( operation.has_perlin ) {
+				buf.WriteInt( operation.perlin_seed );
+			}
+		}
+	}
+}
+
+void TerrainTexture::SerializeNested( types::Buffer& buf, const types::Buffer::encoding_t encoding ) const {
+	if ( buf.GetEncoding() == encoding ) {
+		buf.WriteNested(
+			[ this ]( types::Buffer& b ) {
+				SerializeTo( b );
+			}
+		);
+	}
+	else {
+		// different encoding needs separate buffer
+		types::Buffer b( encoding );
+		SerializeTo( b );
+		buf.WriteString( b.ToStringView() );
+	}
+}
+
+void TerrainTexture::Unserialize( types::Buffer buf ) {
+	const size_t columns = buf.ReadInt();
+	ASSERT( columns == m_columns, "terrain texture columns mismatch ( " + std::to_string( columns ) + " != " + std::to_string( m_columns ) + " )" );
+	const size_t rows = buf.ReadInt();
+	ASSERT( rows == m_rows, "terrain texture rows mismatch ( " + std::to_string( rows ) + " != " + std::to_string( m_rows ) + " )" );
+
+	std::lock_guard guard( m_dependent_cells_mutex );
+	for ( auto& dependent_cells : m_dependent_cells ) {
+		dependent_cells.clear();
+	}
+	for ( size_t cell_index = 0 ; cell_index < m_cells.size() ; cell_index++ ) {
+		auto& operations = m_cells[ cell_index ];
+		operations.resize( buf.ReadInt() );
+		for ( auto& operation : operations ) {
+			operation.source = (source_t)buf.ReadInt();
+			operation.source_coords = buf.ReadVec2u();
+			operation.source_operations_count = buf.ReadInt();
+			operation.mode = buf.ReadInt();
+			operation.rotate = buf.ReadInt();
+			operation.alpha = buf.ReadFloat();
+			operation.random_seed = buf.ReadInt();
+			operation.has_perlin = buf.ReadBool();
+			operation.perlin_seed = operation.has_perlin
+				? buf.ReadInt()
+				: 0;
+			// dependencies aren't serialized because they can be derived from operations
+			if ( operation.source != S_TEXTURE_PCX ) {
+				auto& dependent_cells = m_dependent_cells.at( GetTileCellIndex( operation.source_coords ) );
+				if ( std::find( dependent_cells.begin(), dependent_cells.end(), cell_index ) == dependent_cells.end() ) {
+					dependent_cells.push_back( cell_index );
+				}
+			}
+		}
+		InvalidateCell( cell_index );
+	}
+}
+
+void TerrainTexture::CompositeArea( const size_t x1, const size_t y1, const size_t x2, const size_t y2, types::texture::Texture* dest, const size_t dest_x, const size_t dest_y ) const {
+	const auto w = s_consts.tc.texture_pcx.dimensions.x;
+	const auto h = s_consts.tc.texture_pcx.dimensions.y;
+	// pages consist of whole cells
+	ASSERT( x1 % w == 0 && y1 % h == 0 && ( x2 + 1 ) % w == 0 && ( y2 + 1 ) % h == 0, "area is not aligned to cells" );
+	std::lock_guard guard( m_composite_mutex );
+	for ( size_t cy = y1 / h ; cy <= y2 / h ; cy++ ) {
+		for ( size_t cx = x1 / w ; cx <= x2 / w ; cx++ ) {
+			const auto cell_index = cy * m_columns + cx;
+			CompositeOperations( cell_index, m_cells[ cell_index ].size(), dest, dest_x + cx * w - x1, dest_y + cy * h - y1, 0 );
+		}
+	}
+}
+
+const size_t TerrainTexture::GetCellIndex( const cell_t& cell ) const {
+	ASSERT( cell.x < m_columns && cell.y < m_rows * tile::LAYER_MAX, "cell out of range" );
+	return cell.y * m_columns + cell.x;
+}
+
+const size_t TerrainTexture::GetTileCellIndex( const cell_t& cell ) const {
+	ASSERT( cell.x < m_columns && cell.y < m_rows * tile::LAYER_MAX, "cell out of range" );
+	return ( cell.y % m_rows ) * m_columns + cell.x;
+}
+
+void TerrainTexture::InvalidateCell( const size_t cell_index ) {
+	const auto w = s_consts.tc.texture_pcx.dimensions.x;
+	const auto h = s_consts.tc.texture_pcx.dimensions.y;
+	const size_t x = ( cell_index % m_columns ) * w;
+	const size_t y = ( cell_index / m_columns ) * h;
+	InvalidateArea( x, y, x + w - 1, y + h - 1 );
+}
+
+void TerrainTexture::AddDependentCell( const size_t tile_cell_index, const size_t cell_index ) {
+	std::lock_guard guard( m_dependent_cells_mutex );
+	auto& dependent_cells = m_dependent_cells.at( tile_cell_index );
+	if ( std::find( dependent_cells.begin(), dependent_cells.end(), cell_index ) == dependent_cells.end() ) {
+		dependent_cells.push_back( cell_index );
+	}
+}
+
+void TerrainTexture::CompositeOperations( const size_t cell_index, const size_t operations_count, types::texture::Texture* dest, const size_t dest_x, const size_t dest_y, const size_t depth ) const {
+	const auto w = s_consts.tc.texture_pcx.dimensions.x;
+	const auto h = s_consts.tc.texture_pcx.dimensions.y;
+	const auto& operations = m_cells[ cell_index ];
+	// source cell may have been cleared and not drawn fully yet, then cell that copied from it is going to be redrawn too
+	const size_t count = std::min( operations_count, operations.size() );
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		const auto& operation = operations[ i ];
+		const types::texture::Texture* source = nullptr;
+		size_t source_x = 0;
+		size_t source_y = 0;
+		switch ( operation.source ) {
+			case S_TEXTURE_PCX: {
+				source = m_texture_pcx;
+				source_x = operation.source_coords.x;
+				source_y = operation.source_coords.y;
+				break;
+			}
+			case S_MOISTURE_ORIGINAL:
+			case S_RIVER_ORIGINAL: {
+				const auto tile_y = operation.source_coords.y % m_rows;
+				const auto* ts = m_map_state->AtConst( operation.source_coords.x * 2 + ( tile_y & 1 ), tile_y );
+				source = operation.source == S_MOISTURE_ORIGINAL
+					? ts->moisture_original
+					: ts->river_original;
+				ASSERT( source, "tile state texture not set" );
+				break;
+			}
+			case S_CELL: {
+				auto* scratch_cell = GetScratchCell( depth );
+				memset( ptr( scratch_cell->m_bitmap, 0, scratch_cell->m_bitmap_size ), 0, scratch_cell->m_bitmap_size );
+				CompositeOperations( GetCellIndex( operation.source_coords ), operation.source_operations_count, scratch_cell, 0, 0, depth + 1 );
+				source = scratch_cell;
+				break;
+			}
+			default:
+				THROW( "unknown terrain texture source " + std::to_string( operation.source ) );
+		}
+		m_random.SetCounterStream( operation.random_seed );
+		dest->AddFrom(
+			source,
+			operation.mode,
+			source_x,
+			source_y,
+			source_x + w - 1,
+			source_y + h - 1,
+			dest_x,
+			dest_y,
+			operation.rotate,
+			operation.alpha,
+			&m_random,
+			operation.has_perlin
+				? GetPerlin( operation.perlin_seed )
+				: nullptr
+		);
+	}
+}
+
+util::Perlin* TerrainTexture::GetPerlin( const uint32_t seed ) const {
+	auto it = m_perlins.find( seed );
+	if ( it == m_perlins.end() ) {
+		NEWV( perlin, util::Perlin, seed );
+		it = m_perlins.insert(
+			{
+				seed,
+				perlin
+			}
+		).first;
+	}
+	return it->second;
+}
+
+types::texture::Texture* TerrainTexture::GetScratchCell( const size_t depth ) const {
+	while ( m_scratch_cells.size() <= depth ) {
+		NEWV( scratch_cell, types::texture::Texture, "TerrainCell", s_consts.tc.texture_pcx.dimensions.x, s_consts.tc.texture_pcx.dimensions.y );
+		m_scratch_cells.push_back( scratch_cell );
+	}
+	return m_scratch_cells[ depth ];
+}
+
+}
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+#include "types/texture/PagedTexture.h"
+
+#include "types/texture/Types.h"
+#include "types/Buffer.h"
+#include "types/Vec2.h"
+#include "util/random/Random.h"
+#include "tile/Types.h"
+
+namespace util {
+class Perlin;
+}
+
+namespace game {
+namespace map {
+
+class MapState;
+
+// terrain texture of map, every tile has one cell ( of texture.pcx tile size ) per layer
+// cells pixels aren't kept, operations that draw cells are recorded instead and replayed when renderer needs page
+CLASS( TerrainTexture, types::texture::PagedTexture )
+
+	static constexpr size_t PAGE_CELLS = 8; // page is PAGE_CELLS x PAGE_CELLS cells
+
+	// cell x, cell y ( of all layers, layer 0 is at top )
+	typedef types::Vec2< uint32_t > cell_t;
+
+	enum source_t : uint8_t {
+		S_TEXTURE_PCX, // part of texture.pcx
+		S_MOISTURE_ORIGINAL, // moisture original texture of tile
+		S_RIVER_ORIGINAL, // river original texture of tile
+		S_CELL, // other cell, as it was when operation was recorded
+	};
+
+	TerrainTexture( const MapState* map_state, const types::texture::Texture* texture_pcx, const size_t columns );
+	~TerrainTexture();
+
+	// tex_x and tex_y are of tile cell at layer 0 ( see Map::GetTileTextureX(), Map::GetTileTextureY() )
+	const cell_t GetCell( const tile::tile_layer_type_t tile_layer, const size_t tex_x, const size_t tex_y ) const;
+
+	// clears cells of tile at all layers
+	void ClearCells( const size_t tex_x, const size_t tex_y );
+
+	// source_coords are texture.pcx pixel for S_TEXTURE_PCX, any cell of source tile for S_MOISTURE_ORIGINAL and S_RIVER_ORIGINAL, source cell for S_CELL
+	// random-related flags are replayed from counter stream of random_seed, so result is same every time cell is composited
+	void AddOperation( const cell_t& cell, const source_t source, const cell_t& source_coords, const types::texture::add_flag_t mode, const types::texture::rotate_t rotate, const float alpha, const uint32_t random_seed, const util::Perlin* perlin = nullptr );
+
+	// draws cell to dest ( which must be of cell size )
+	void CompositeCell( const cell_t& cell, types::texture::Texture* dest ) const;
+
+	const types::Buffer Serialize() const override; // compact
+	void SerializeTo( types::Buffer& buf ) const; // writes into existing buffer, i.e. as nested value
+	void SerializeNested( types::Buffer& buf, const types::Buffer::encoding_t encoding ) const; // writes as nested value in given encoding
+	void Unserialize( types::Buffer buf ) override;
+
+protected:
+	void CompositeArea( const size_t x1, const size_t y1, const size_t x2, const size_t y2, types::texture::Texture* dest, const size_t dest_x, const size_t dest_y ) const override;
+
+private:
+
+	struct operation_t {
+		source_t source;
+		cell_t source_coords;
+		uint32_t source_operations_count; // for S_CELL, only this many first operations of source cell are replayed
+		types::texture::add_flag_t mode;
+		types::texture::rotate_t rotate;
+		float alpha;
+		uint32_t random_seed;
+		bool has_perlin;
+		uint32_t perlin_seed;
+	};
+	typedef std::vector< operation_t > operations_t;
+
+	const MapState* m_map_state;
+	const types::texture::Texture* m_texture_pcx;
+	const size_t m_columns;
+	const size_t m_rows; // per layer
+
+	std::vector< operations_t > m_cells = {};
+
+	// cells that read from tile ( by index of its layer 0 cell ), they are redrawn when tile is cleared
+	// tiles only read from neighbours, so these stay short
+	std::vector< std::vector< uint32_t > > m_dependent_cells = {};
+	std::mutex m_dependent_cells_mutex; // tiles may be generated in parallel
+
+	// compositing is done from renderer thread too, these are only used while holding m_composite_mutex
+	mutable std::mutex m_composite_mutex;
+	mutable util::random::Random m_random;
+	mutable std::unordered_map< uint32_t, util::Perlin* > m_perlins = {};
+	mutable std::vector< types::texture::Texture* > m_scratch_cells = {}; // one per depth of S_CELL operations
+
+	const size_t GetCellIndex( const cell_t& cell ) const;
+	const size_t GetTileCellIndex( const cell_t& cell ) const;
+	void InvalidateCell( const size_t cell_index );
+	void AddDependentCell( const size_t tile_cell_index, const size_t cell_index );
+
+	void CompositeOperations( const size_t cell_index, const size_t operations_count, types::texture::Texture* dest, const size_t dest_x, const size_t dest_y, const size_t depth ) const;
+	util::Perlin* GetPerlin( const uint32_t seed ) const;
+	types::texture::Texture* GetScratchCell( const size_t depth ) const;
+
+};
+
+}
+}
@@ -144,19 +144,19 @@ void MapGenerator::SmoothTerrain( tile::Tiles* tiles, MT_CANCELABLE, const bool
 			tile->Update();
 
 			if (
-				( tile->is_water_tile && !smooth_water ) ||
-					( !tile->is_water_tile && !smooth_land )
+				( tile->IsWater() && !smooth_water ) ||
+					( !tile->IsWater() && !smooth_land )
 				) {
 				continue;
 			}
 
-			mod = tile->is_water_tile
+			mod = tile->IsWater()
 				? -1
 				: 1;
 
 			// flatten every corner
-			for ( auto& c : tile->elevation.corners ) {
-				*c = ( *c + *tile->elevation.center ) / 2;
+			for ( auto& c : tile->GetElevationCorners() ) {
+				*c = ( *c + *tile->GetElevationCenter() ) / 2;
 			}
 
 			MT_RETIF();
@@ -220,7 +220,7 @@ const float MapGenerator::GetLandAmount( tile::Tiles* tiles, MT_CANCELABLE, tile
 	const auto h = tiles->GetHeight();
 	for ( auto y = 0 ; y < h ; y++ ) {
 		for ( auto x = y & 1 ; x < w ; x += 2 ) {
-			if ( *tiles->AtConst( x, y ).elevation.center > -elevation_diff ) {
+			if ( *tiles->AtConst( x, y ).GetElevationCenter() > -elevation_diff ) {
 				land_tiles++;
 			}
 			MT_RETIFV( 0.0f );
@@ -246,7 +246,7 @@ void MapGenerator::SetFungusAmount( tile::Tiles* tiles, const float amount, MT_C
 	for ( auto y = 0 ; y < h ; y++ ) {
 		for ( auto x = y & 1 ; x < w ; x += 2 ) {
 			tile = &tiles->At( x, y );
-			if ( tile->features & tile::FEATURE_XENOFUNGUS ) {
+			if ( *tile->GetFeatures() & tile::FEATURE_XENOFUNGUS ) {
 				with_fungus.push_back( tile );
 			}
 			else {
@@ -261,7 +261,7 @@ void MapGenerator::SetFungusAmount( tile::Tiles* tiles, const float amount, MT_C
 		Log( "Adding fungus to " + std::to_string( c ) + " tiles" );
 		m_random->Shuffle( without_fungus );
 		for ( auto i = 0 ; i < c ; i++ ) {
-			without_fungus[ i ]->features |= tile::FEATURE_XENOFUNGUS;
+			*without_fungus[ i ]->GetFeatures() |= tile::FEATURE_XENOFUNGUS;
 			MT_RETIF();
 		}
 	}
@@ -270,7 +270,7 @@ void MapGenerator::SetFungusAmount( tile::Tiles* tiles, const float amount, MT_C
 		Log( "Removing fungus from " + std::to_string( c ) + " tiles" );
 		m_random->Shuffle( with_fungus );
 		for ( auto i = 0 ; i < c ; i++ ) {
-			with_fungus[ i ]->features &= ~tile::FEATURE_XENOFUNGUS;
+			*with_fungus[ i ]->GetFeatures() &= ~tile::FEATURE_XENOFUNGUS;
 			MT_RETIF();
 		}
 	}
@@ -278,17 +278,13 @@ void MapGenerator::SetFungusAmount( tile::Tiles* tiles, const float amount, MT_C
 
 const float MapGenerator::GetFungusAmount( tile::Tiles* tiles, MT_CANCELABLE ) {
 	size_t fungus_tiles = 0;
-	const auto w = tiles->GetWidth();
-	const auto h = tiles->GetHeight();
-	for ( auto y = 0 ; y < h ; y++ ) {
-		for ( auto x = y & 1 ; x < w ; x += 2 ) {
-			if ( tiles->At( x, y ).features & tile::FEATURE_XENOFUNGUS ) {
-				fungus_tiles++;
-			}
-			MT_RETIFV( 0.0f );
-		}
+	const size_t count = tiles->GetDataCount();
+	const auto* features = tiles->GetFeatures();
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		fungus_tiles += ( features[ i ] & tile::FEATURE_XENOFUNGUS ) != 0;
 	}
-	return (float)fungus_tiles / ( w * h / 2 );
+	MT_RETIFV( 0.0f );
+	return (float)fungus_tiles / count;
 }
 
 void MapGenerator::SetMoistureAmount( tile::Tiles* tiles, const float amount, MT_CANCELABLE ) {
@@ -310,7 +306,7 @@ void MapGenerator::SetMoistureAmount( tile::Tiles* tiles, const float amount, MT
 	for ( auto y = 0 ; y < h ; y++ ) {
 		for ( auto x = y & 1 ; x < w ; x += 2 ) {
 			tile = &tiles->At( x, y );
-			switch ( tile->moisture ) {
+			switch ( *tile->GetMoisture() ) {
 				case tile::MOISTURE_ARID: {
 					arid_tiles.push_back( tile );
 					break;
@@ -360,10 +356,10 @@ void MapGenerator::SetMoistureAmount( tile::Tiles* tiles, const float amount, MT
 				break; // exceeded
 			}
 			if ( use_moist ) {
-				moist_tiles[ i_moist++ ]->moisture = tile::MOISTURE_RAINY;
+				*moist_tiles[ i_moist++ ]->GetMoisture() = tile::MOISTURE_RAINY;
 			}
 			else {
-				arid_tiles[ i_arid ]->moisture = tile::MOISTURE_MOIST;
+				*arid_tiles[ i_arid ]->GetMoisture() = tile::MOISTURE_MOIST;
 				new_moist_tiles.push_back( arid_tiles[ i_arid ] ); // to make rainy later if needed
 				i_arid++;
 			}
@@ -376,7 +372,7 @@ void MapGenerator::SetMoistureAmount( tile::Tiles* tiles, const float amount, MT
 			i_moist = 0;
 			while ( moisture_amount < desired_moisture_amount ) {
 				ASSERT( i_moist < new_moist_tiles.size(), "unable to add enough moisture" );
-				new_moist_tiles[ i_moist++ ]->moisture = tile::MOISTURE_RAINY;
+				*new_moist_tiles[ i_moist++ ]->GetMoisture() = tile::MOISTURE_RAINY;
 				moisture_amount += 0.5f;
 			}
 		}
@@ -407,10 +403,10 @@ void MapGenerator::SetMoistureAmount( tile::Tiles* tiles, const float amount, MT
 				break; // exceeded
 			}
 			if ( use_moist ) {
-				moist_tiles[ i_moist++ ]->moisture = tile::MOISTURE_ARID;
+				*moist_tiles[ i_moist++ ]->GetMoisture() = tile::MOISTURE_ARID;
 			}
 			else {
-				rainy_tiles[ i_rainy ]->moisture = tile::MOISTURE_MOIST;
+				*rainy_tiles[ i_rainy ]->GetMoisture() = tile::MOISTURE_MOIST;
 				new_moist_tiles.push_back( rainy_tiles[ i_rainy ] ); // to make arid later if needed
 				i_rainy++;
 			}
@@ -423,7 +419,7 @@ void MapGenerator::SetMoistureAmount( tile::Tiles* tiles, const float amount, MT
 			i_moist = 0;
 			while ( moisture_amount > desired_moisture_amount ) {
 				ASSERT( i_moist < new_moist_tiles.size(), "unable to remove enough moisture" );
-				new_moist_tiles[ i_moist++ ]->moisture = tile::MOISTURE_ARID;
+				*new_moist_tiles[ i_moist++ ]->GetMoisture() = tile::MOISTURE_ARID;
 				moisture_amount -= 0.5f;
 			}
 		}
@@ -432,32 +428,28 @@ void MapGenerator::SetMoistureAmount( tile::Tiles* tiles, const float amount, MT
 
 const float MapGenerator::GetMoistureAmount( tile::Tiles* tiles, MT_CANCELABLE ) {
 	float moisture_amount = 0.0f;
-	const auto w = tiles->GetWidth();
-	const auto h = tiles->GetHeight();
-	for ( auto y = 0 ; y < h ; y++ ) {
-		for ( auto x = y & 1 ; x < w ; x += 2 ) {
-			switch ( tiles->AtConst( x, y ).moisture ) {
-				case tile::MOISTURE_ARID: {
-					break;
-				}
-				case tile::MOISTURE_MOIST: {
-					moisture_amount += 0.5f;
-					break;
-				}
-				case tile::MOISTURE_RAINY: {
-					moisture_amount += 1.0f;
-					break;
-				}
-				default: {
-					THROW( "unknown moisture value" );
-				}
+	const size_t count = tiles->GetDataCount();
+	const auto* moistures = tiles->GetMoistures();
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		switch ( moistures[ i ] ) {
+			case tile::MOISTURE_ARID: {
+				break;
+			}
+			case tile::MOISTURE_MOIST: {
+				moisture_amount += 0.5f;
+				break;
+			}
+			case tile::MOISTURE_RAINY: {
+				moisture_amount += 1.0f;
+				break;
+			}
+			default: {
+				THROW( "unknown moisture value" );
 			}
-
-			MT_RETIFV( 0.0f );
 		}
 	}
-	return moisture_amount / ( w * h / 2 );
-
+	MT_RETIFV( 0.0f );
+	return moisture_amount / count;
 }
 
 void MapGenerator::FixImpossibleThings( tile::Tiles* tiles, MT_CANCELABLE ) {
@@ -467,9 +459,9 @@ void MapGenerator::FixImpossibleThings( tile::Tiles* tiles, MT_CANCELABLE ) {
 	for ( auto y = 0 ; y < h ; y++ ) {
 		for ( auto x = y & 1 ; x < w ; x += 2 ) {
 			tile = &tiles->At( x, y );
-			if ( tile->features & tile::FEATURE_JUNGLE && tile->moisture != tile::MOISTURE_RAINY ) {
+			if ( *tile->GetFeatures() & tile::FEATURE_JUNGLE && *tile->GetMoisture() != tile::MOISTURE_RAINY ) {
 				// jungle should only be on rainy tiles
-				tile->features &= ~tile::FEATURE_JUNGLE;
+				*tile->GetFeatures() &= ~tile::FEATURE_JUNGLE;
 			}
 			MT_RETIF();
 		}
@@ -500,8 +492,8 @@ void MapGenerator::RaiseAllTilesBy( tile::Tiles* tiles, tile::elevation_t amount
 	MT_RETIF();
 
 	for ( auto& tile : randomtiles ) {
-		*tile->elevation.center += amount;
-		*tile->elevation.bottom += amount;
+		*tile->GetElevationCenter() += amount;
+		*tile->GetElevationBottom() += amount;
 		MT_RETIF();
 	}
 
@@ -526,15 +518,14 @@ void MapGenerator::ScaleAllTilesBy( tile::Tiles* tiles, float amount, MT_CANCELA
 	Log( "Multiplying all tiles by " + std::to_string( amount ) );
 	const auto w = tiles->GetWidth();
 	const auto h = tiles->GetHeight();
-	tile::Tile* tile;
-	for ( auto y = 0 ; y < h ; y++ ) {
-		for ( auto x = y & 1 ; x < w ; x += 2 ) {
-			tile = &tiles->At( x, y );
-			*tile->elevation.center *= amount;
-			*tile->elevation.bottom *= amount;
-			MT_RETIF();
-		}
+	const size_t count = tiles->GetDataCount();
+	auto* centers = tiles->GetCenterElevations();
+	auto* bottoms = tiles->GetBottomElevations();
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		centers[ i ] *= amount;
+		bottoms[ i ] *= amount;
 	}
+	MT_RETIF();
 	for ( auto y = 0 ; y < h ; y++ ) {
 		for ( auto x = y & 1 ; x < w ; x += 2 ) {
 			tiles->At( x, y ).Update();
@@ -555,7 +546,7 @@ const std::pair< tile::elevation_t, tile::elevation_t > MapGenerator::GetElevati
 	for ( auto y = 0 ; y < h ; y++ ) {
 		for ( auto x = y & 1 ; x < w ; x += 2 ) {
 			tile = &tiles->AtConst( x, y );
-			for ( auto& c : tile->elevation.corners ) {
+			for ( auto& c : tile->GetElevationCorners() ) {
 				if ( *c < result.first ) {
 					result.first = *c;
 				}
@@ -603,21 +594,24 @@ void MapGenerator::RemoveExtremeSlopes( tile::Tiles* tiles, const tile::elevatio
 		for ( i = 0 ; i < randomtiles.size() ; i++ ) {
 			tile = randomtiles[ i ];
 
-#define x( _a, _b ) \
-                if ( abs( *tile->elevation._a - *tile->elevation._b ) > max_allowed_diff ) { \
-                    /*Log( "fixing slope: " + std::to_string( *tile->elevation._a ) + "," + std::to_string( *tile->elevation._b ) + " / " + std::to_string( elevation_fixby ) );*/ \
-                    *tile->elevation._a += ( *tile->elevation._a < *tile->elevation._b ) ? elevation_fixby : -elevation_fixby; \
-                    *tile->elevation._b += ( *tile->elevation._b < *tile->elevation._a ) ? elevation_fixby : -elevation_fixby; \
-                    *tile->elevation._a /= elevation_fixby_div; \
-                    *tile->elevation._b /= elevation_fixby_div; \
+#define x( _a, _b ) { \
+                auto* a = tile->GetElevation##_a(); \
+                auto* b = tile->GetElevation##_b(); \
+                if ( abs( *a - *b ) > max_allowed_diff ) { \
+                    /*Log( "fixing slope: " + std::to_string( *a ) + "," + std::to_string( *b ) + " / " + std::to_string( elevation_fixby ) );*/ \
+                    *a += ( *a < *b ) ? elevation_fixby : -elevation_fixby; \
+                    *b += ( *b < *a ) ? elevation_fixby : -elevation_fixby; \
+                    *a /= elevation_fixby_div; \
+                    *b /= elevation_fixby_div; \
                     found = true; \
-                }
-			x( left, right );
-			x( left, top );
-			x( left, bottom );
-			x( right, top );
-			x( right, bottom );
-			x( top, bottom );
+                } \
+            }
+			x( Left, Right );
+			x( Left, Top );
+			x( Left, Bottom );
+			x( Right, Top );
+			x( Right, Bottom );
+			x( Top, Bottom );
 #undef x
 
 			if ( found ) {
@@ -652,8 +646,8 @@ void MapGenerator::NormalizeElevationRange( tile::Tiles* tiles, MT_CANCELABLE )
 	MT_RETIF();
 
 	for ( auto& tile : randomtiles ) {
-		tile->elevation_data.bottom = converter.Clamp( tile->elevation_data.bottom );
-		tile->elevation_data.center = converter.Clamp( tile->elevation_data.center );
+		*tile->GetElevationBottom() = converter.Clamp( *tile->GetElevationBottom() );
+		*tile->GetElevationCenter() = converter.Clamp( *tile->GetElevationCenter() );
 		MT_RETIF();
 	}
 
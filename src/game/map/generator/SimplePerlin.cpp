@@ -1,4 +1,5 @@
 #include <cmath>
+#include <unordered_set>
 
 #include "SimplePerlin.h"
 
@@ -18,7 +19,7 @@
 #define RIVER_SPLIT_CHANCE_DIFFICULTY 6
 #define RIVER_JOIN_CHANCE_DIFFICULTY 12
 
-#define RIVER_RANDOM_DIRECTION ( m_random->GetUInt( 0, ( tile->neighbours.size() - 1 ) ) )
+#define RIVER_RANDOM_DIRECTION ( m_random->GetUInt( 0, ( tile->GetNeighbours().size() - 1 ) ) )
 #define RIVER_RANDOM_DIRECTION_DIAGONAL ( m_random->GetUInt( 0, 1 ) * 2 - 1 )
 
 #define RESOURCE_SPAWN_CHANCE_DIFFICULTY 24
@@ -60,23 +61,50 @@ void SimplePerlin::GenerateElevations( tile::Tiles* tiles, const game::settings:
 	std::vector< tile::Tile* > randomtiles = GetTilesInRandomOrder( tiles, MT_C );
 	MT_RETIF();
 
-	for ( auto& tile : randomtiles ) {
-
 #define PERLIN_S( _x, _y, _z, _scale ) perlin.Noise( (float) ( (float)_x ) * _scale, (float) ( (float)_y ) * _scale, _z * _scale, PERLIN_PASSES )
-#define PERLIN( _x, _y, _z ) PERLIN_S( _x, _y, _z, 1.0f )
 
-		*tile->elevation.left = *tile->elevation.top = *tile->elevation.right = *tile->elevation.bottom = *tile->elevation.center = 0;
-
-		const float z_elevation = 0;
+	// every corner vertex is shared by up to 4 tiles and each of them samples noise at different point, so only the last one to write it matters
+	// walk tiles backwards to find those samples, then calculate each vertex once, in batches
+	std::vector< tile::elevation_t* > vertices;
+	std::vector< float > xs;
+	std::vector< float > ys;
+	vertices.reserve( randomtiles.size() * 2 );
+	xs.reserve( randomtiles.size() * 2 );
+	ys.reserve( randomtiles.size() * 2 );
+	std::unordered_set< tile::elevation_t* > assigned_vertices;
+	assigned_vertices.reserve( randomtiles.size() * 2 );
+	for ( auto it = randomtiles.rbegin() ; it != randomtiles.rend() ; it++ ) {
+		const auto* t = *it;
+		const std::pair< tile::elevation_t*, std::pair< float, float > > samples[ 4 ] = {
+			// in reverse of original write order
+			{ t->GetElevationBottom(), { t->GetCoords().x + 0.5f, t->GetCoords().y + 1.0f } },
+			{ t->GetElevationRight(),  { t->GetCoords().x + 1.0f, t->GetCoords().y + 0.5f } },
+			{ t->GetElevationTop(),    { t->GetCoords().x + 0.5f, t->GetCoords().y } },
+			{ t->GetElevationLeft(),   { t->GetCoords().x, t->GetCoords().y + 0.5f } },
+		};
+		for ( const auto& sample : samples ) {
+			if ( assigned_vertices.insert( sample.first ).second ) {
+				vertices.push_back( sample.first );
+				xs.push_back( sample.second.first );
+				ys.push_back( sample.second.second );
+			}
+		}
+		MT_RETIF();
+	}
 
-		*tile->elevation.left = perlin_to_elevation.Clamp( PERLIN( tile->coord.x, tile->coord.y + 0.5f, z_elevation ) );
-		*tile->elevation.top = perlin_to_elevation.Clamp( PERLIN( tile->coord.x + 0.5f, tile->coord.y, z_elevation ) );
-		*tile->elevation.right = perlin_to_elevation.Clamp( PERLIN( tile->coord.x + 1.0f, tile->coord.y + 0.5f, z_elevation ) );
-		*tile->elevation.bottom = perlin_to_elevation.Clamp( PERLIN( tile->coord.x + 0.5f, tile->coord.y + 1.0f, z_elevation ) );
+	const size_t batch_size = 1024;
+	std::vector< float > results( batch_size );
+	for ( size_t i = 0 ; i < vertices.size() ; i += batch_size ) {
+		const size_t count = std::min( batch_size, vertices.size() - i );
+		perlin.Noise( &xs[ i ], &ys[ i ], count, PERLIN_PASSES, results.data() );
+		for ( size_t j = 0 ; j < count ; j++ ) {
+			*vertices[ i + j ] = perlin_to_elevation.Clamp( results[ j ] );
+		}
+		MT_RETIF();
+	}
 
+	for ( auto& tile : randomtiles ) {
 		tile->Update();
-
-		MT_RETIF();
 	}
 
 	for ( auto y = 0 ; y < h ; y++ ) {
@@ -89,27 +117,27 @@ void SimplePerlin::GenerateElevations( tile::Tiles* tiles, const game::settings:
 			const float z_xenofungus = m_random->GetFloat( 0.0f, 1.0f );
 
 			// moisture
-			tile->moisture = perlin_to_value.Clamp( ceil( PERLIN_S( x + 0.5f, y + 0.5f, z_moisture, 0.6f ) ) );
-			if ( tile->moisture == tile::MOISTURE_RAINY ) {
+			*tile->GetMoisture() = perlin_to_value.Clamp( ceil( PERLIN_S( x + 0.5f, y + 0.5f, z_moisture, 0.6f ) ) );
+			if ( *tile->GetMoisture() == tile::MOISTURE_RAINY ) {
 				if ( PERLIN_S( x + 0.5f, y + 0.5f, z_jungle, 0.2f ) > 0.7 ) {
-					tile->features |= tile::FEATURE_JUNGLE;
+					*tile->GetFeatures() |= tile::FEATURE_JUNGLE;
 				}
 			}
 
 			// rockiness
-			tile->rockiness = perlin_to_value.Clamp( round( PERLIN_S( x + 0.5f, y + 0.5f, z_rocks, 1.0f ) ) );
-			if ( tile->rockiness == tile::ROCKINESS_ROCKY ) {
+			*tile->GetRockiness() = perlin_to_value.Clamp( round( PERLIN_S( x + 0.5f, y + 0.5f, z_rocks, 1.0f ) ) );
+			if ( *tile->GetRockiness() == tile::ROCKINESS_ROCKY ) {
 				if ( m_random->IsLucky( 3 ) ) {
-					tile->rockiness = tile::ROCKINESS_ROLLING;
+					*tile->GetRockiness() = tile::ROCKINESS_ROLLING;
 				}
 			}
 			// extra rockiness spots
 			if ( m_random->IsLucky( 30 ) ) {
-				tile->rockiness = tile::ROCKINESS_ROCKY;
-				for ( auto& t : tile->neighbours ) {
+				*tile->GetRockiness() = tile::ROCKINESS_ROCKY;
+				for ( auto& t : tile->GetNeighbours() ) {
 					if ( m_random->IsLucky( 3 ) ) {
-						if ( t->rockiness != tile::ROCKINESS_ROCKY ) {
-							t->rockiness = tile::ROCKINESS_ROLLING;
+						if ( *t->GetRockiness() != tile::ROCKINESS_ROCKY ) {
+							*t->GetRockiness() = tile::ROCKINESS_ROLLING;
 						}
 					}
 				}
@@ -117,7 +145,7 @@ void SimplePerlin::GenerateElevations( tile::Tiles* tiles, const game::settings:
 
 			// fungus
 			if ( PERLIN_S( x + 0.5f, y + 0.5f, z_xenofungus, 0.6f ) > 0.4 ) {
-				tile->features |= tile::FEATURE_XENOFUNGUS;
+				*tile->GetFeatures() |= tile::FEATURE_XENOFUNGUS;
 			}
 
 			MT_RETIF();
@@ -156,7 +184,7 @@ void SimplePerlin::GenerateDetails( tile::Tiles* tiles, const game::settings::Ma
 
 			// bonus resources
 			if ( m_random->IsLucky( RESOURCE_SPAWN_CHANCE_DIFFICULTY ) ) {
-				tile->bonus = m_random->GetUInt( tile::BONUS_NUTRIENT, tile::BONUS_MINERALS );
+				*tile->GetBonus() = m_random->GetUInt( tile::BONUS_NUTRIENT, tile::BONUS_MINERALS );
 			}
 
 			MT_RETIF();
@@ -166,25 +194,25 @@ void SimplePerlin::GenerateDetails( tile::Tiles* tiles, const game::settings::Ma
 
 void SimplePerlin::GenerateRiver( tile::Tiles* tiles, tile::Tile* tile, uint8_t length, uint8_t direction, int8_t direction_diagonal, MT_CANCELABLE ) {
 
-	if ( tile->features & tile::FEATURE_RIVER ) {
+	if ( *tile->GetFeatures() & tile::FEATURE_RIVER ) {
 		// joined existing river
 		return;
 	}
-	if ( tile->is_water_tile ) {
+	if ( tile->IsWater() ) {
 		// reached water
 		return;
 	}
 
 	MT_RETIF();
 
-	tile->features |= tile::FEATURE_RIVER;
+	*tile->GetFeatures() |= tile::FEATURE_RIVER;
 
 	length--;
 	if ( length > 0 ) {
 
 		if ( m_random->IsLucky( RIVER_DIRECTION_CHANGE_CHANCE_DIFFICULTY ) ) {
 			if ( m_random->IsLucky() ) {
-				if ( direction < tile->neighbours.size() - 1 ) {
+				if ( direction < tile->GetNeighbours().size() - 1 ) {
 					direction++;
 				}
 				else {
@@ -196,7 +224,7 @@ void SimplePerlin::GenerateRiver( tile::Tiles* tiles, tile::Tile* tile, uint8_t
 					direction--;
 				}
 				else {
-					direction = tile->neighbours.size() - 1;
+					direction = tile->GetNeighbours().size() - 1;
 				}
 			}
 		}
@@ -208,14 +236,14 @@ void SimplePerlin::GenerateRiver( tile::Tiles* tiles, tile::Tile* tile, uint8_t
 		else {
 			real_direction = (int8_t)direction + direction_diagonal;
 			if ( real_direction < 0 ) {
-				real_direction = tile->neighbours.size() - 1;
+				real_direction = tile->GetNeighbours().size() - 1;
 			}
-			else if ( real_direction > tile->neighbours.size() - 1 ) {
+			else if ( real_direction > tile->GetNeighbours().size() - 1 ) {
 				real_direction = 0;
 			}
 			direction_diagonal *= -1;
 		}
-		auto* selected_tile = tile->neighbours.at( real_direction );
+		auto* selected_tile = tile->GetNeighbours().at( real_direction );
 		if ( !HasRiversNearby( tile, selected_tile ) || m_random->IsLucky( RIVER_JOIN_CHANCE_DIFFICULTY ) ) {
 			GenerateRiver( tiles, selected_tile, length, real_direction, direction_diagonal, MT_C );
 		}
@@ -226,11 +254,11 @@ void SimplePerlin::GenerateRiver( tile::Tiles* tiles, tile::Tile* tile, uint8_t
 			// split at 90 degrees angle
 			uint8_t child_direction = direction;
 			if ( m_random->IsLucky() ) { // clockwise
-				if ( child_direction < tile->neighbours.size() - 2 ) {
+				if ( child_direction < tile->GetNeighbours().size() - 2 ) {
 					child_direction += 2;
 				}
 				else {
-					child_direction = child_direction + 2 - tile->neighbours.size();
+					child_direction = child_direction + 2 - tile->GetNeighbours().size();
 				}
 			}
 			else { // counter-clockwise
@@ -238,11 +266,11 @@ void SimplePerlin::GenerateRiver( tile::Tiles* tiles, tile::Tile* tile, uint8_t
 					child_direction -= 2;
 				}
 				else {
-					child_direction = tile->neighbours.size() - child_direction - 1;
+					child_direction = tile->GetNeighbours().size() - child_direction - 1;
 				}
 			}
 
-			selected_tile = tile->neighbours.at( child_direction );
+			selected_tile = tile->GetNeighbours().at( child_direction );
 			if ( !HasRiversNearby( tile, selected_tile ) || m_random->IsLucky( RIVER_JOIN_CHANCE_DIFFICULTY ) ) {
 				GenerateRiver( tiles, selected_tile, length, child_direction, direction_diagonal * -1, MT_C );
 			}
@@ -253,8 +281,8 @@ void SimplePerlin::GenerateRiver( tile::Tiles* tiles, tile::Tile* tile, uint8_t
 }
 
 bool SimplePerlin::HasRiversNearby( tile::Tile* current_tile, tile::Tile* tile ) {
-	for ( auto& t : tile->neighbours ) {
-		if ( t != current_tile && t->features & tile::FEATURE_RIVER ) {
+	for ( auto& t : tile->GetNeighbours() ) {
+		if ( t != current_tile && *t->GetFeatures() & tile::FEATURE_RIVER ) {
 			return true;
 		}
 	}
@@ -10,8 +10,8 @@ namespace module {
 
 class Coastlines : public Module {
 public:
-	Coastlines( Map* const map )
-		: Module( map ) {}
+	Coastlines( Map* const map, const neighbour_access_t neighbour_access )
+		: Module( map, neighbour_access ) {}
 
 protected:
 	struct coastline_corner_t {
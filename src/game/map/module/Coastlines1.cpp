@@ -13,7 +13,7 @@ namespace map {
 namespace module {
 
 Coastlines1::Coastlines1( Map* const map )
-	: Coastlines( map ) {
+	: Coastlines( map, NA_NONE ) {
 	NEW( m_perlin, util::Perlin, map->GetRandom()->GetUInt( 0, UINT32_MAX - 1 ) );
 }
 
@@ -36,17 +36,17 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 	std::vector< coastline_corner_t > coastline_corners = {};
 	coastline_corner_t coastline_corner_tmp = {};
 
-	if ( !tile->is_water_tile ) {
+	if ( !tile->IsWater() ) {
 
-		if ( tile->W->is_water_tile || tile->NW->is_water_tile || tile->SW->is_water_tile ) {
+		if ( tile->W()->IsWater() || tile->NW()->IsWater() || tile->SW()->IsWater() ) {
 			//ts->layers[ tile::LAYER_LAND ].colors.left = s_consts.coastlines.coastline_tint;
-			if ( tile->W->is_water_tile && ( tile->NW->is_water_tile || tile->SW->is_water_tile ) ) {
+			if ( tile->W()->IsWater() && ( tile->NW()->IsWater() || tile->SW()->IsWater() ) ) {
 				ts->layers[ tile::LAYER_LAND ].coords.left.x += cw;
-				if ( !tile->NW->is_water_tile ) {
+				if ( !tile->NW()->IsWater() ) {
 					ts->layers[ tile::LAYER_LAND ].coords.left.y -= cw;
 					ts->layers[ tile::LAYER_LAND ].tex_coords.left.y -= tcwh;
 				}
-				else if ( !tile->SW->is_water_tile ) {
+				else if ( !tile->SW()->IsWater() ) {
 					ts->layers[ tile::LAYER_LAND ].coords.left.y += cw;
 					ts->layers[ tile::LAYER_LAND ].tex_coords.left.x += tcww;
 				}
@@ -57,15 +57,15 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 				}
 			}
 		}
-		if ( tile->N->is_water_tile || tile->NW->is_water_tile || tile->NE->is_water_tile ) {
+		if ( tile->N()->IsWater() || tile->NW()->IsWater() || tile->NE()->IsWater() ) {
 			//ts->layers[ tile::LAYER_LAND ].colors.top = s_consts.coastlines.coastline_tint;
-			if ( tile->N->is_water_tile && ( tile->NW->is_water_tile || tile->NE->is_water_tile ) ) {
+			if ( tile->N()->IsWater() && ( tile->NW()->IsWater() || tile->NE()->IsWater() ) ) {
 				ts->layers[ tile::LAYER_LAND ].coords.top.y += cw;
-				if ( !tile->NW->is_water_tile ) {
+				if ( !tile->NW()->IsWater() ) {
 					ts->layers[ tile::LAYER_LAND ].coords.top.x -= cw;
 					ts->layers[ tile::LAYER_LAND ].tex_coords.top.y += tcwh;
 				}
-				else if ( !tile->NE->is_water_tile ) {
+				else if ( !tile->NE()->IsWater() ) {
 					ts->layers[ tile::LAYER_LAND ].coords.top.x += cw;
 					ts->layers[ tile::LAYER_LAND ].tex_coords.top.x += tcww;
 				}
@@ -76,15 +76,15 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 				}
 			}
 		}
-		if ( tile->E->is_water_tile || tile->NE->is_water_tile || tile->SE->is_water_tile ) {
+		if ( tile->E()->IsWater() || tile->NE()->IsWater() || tile->SE()->IsWater() ) {
 			//ts->layers[ tile::LAYER_LAND ].colors.right = s_consts.coastlines.coastline_tint;
-			if ( tile->E->is_water_tile && ( tile->NE->is_water_tile || tile->SE->is_water_tile ) ) {
+			if ( tile->E()->IsWater() && ( tile->NE()->IsWater() || tile->SE()->IsWater() ) ) {
 				ts->layers[ tile::LAYER_LAND ].coords.right.x -= cw;
-				if ( !tile->NE->is_water_tile ) {
+				if ( !tile->NE()->IsWater() ) {
 					ts->layers[ tile::LAYER_LAND ].coords.right.y -= cw;
 					ts->layers[ tile::LAYER_LAND ].tex_coords.right.x -= tcww;
 				}
-				else if ( !tile->SE->is_water_tile ) {
+				else if ( !tile->SE()->IsWater() ) {
 					ts->layers[ tile::LAYER_LAND ].coords.right.y += cw;
 					ts->layers[ tile::LAYER_LAND ].tex_coords.right.y += tcwh;
 				}
@@ -95,15 +95,15 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 				}
 			}
 		}
-		if ( tile->S->is_water_tile || tile->SW->is_water_tile || tile->SE->is_water_tile ) {
+		if ( tile->S()->IsWater() || tile->SW()->IsWater() || tile->SE()->IsWater() ) {
 			//ts->layers[ tile::LAYER_LAND ].colors.bottom = s_consts.coastlines.coastline_tint;
-			if ( tile->S->is_water_tile && ( tile->SW->is_water_tile || tile->SE->is_water_tile ) ) {
+			if ( tile->S()->IsWater() && ( tile->SW()->IsWater() || tile->SE()->IsWater() ) ) {
 				ts->layers[ tile::LAYER_LAND ].coords.bottom.y -= cw;
-				if ( !tile->SW->is_water_tile ) {
+				if ( !tile->SW()->IsWater() ) {
 					ts->layers[ tile::LAYER_LAND ].coords.bottom.x -= cw;
 					ts->layers[ tile::LAYER_LAND ].tex_coords.bottom.x -= tcww;
 				}
-				else if ( !tile->SE->is_water_tile ) {
+				else if ( !tile->SE()->IsWater() ) {
 					ts->layers[ tile::LAYER_LAND ].coords.bottom.x += cw;
 					ts->layers[ tile::LAYER_LAND ].tex_coords.bottom.y -= tcwh;
 				}
@@ -118,7 +118,7 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 		ts->layers[ tile::LAYER_LAND ].tex_coords.center.y = ( ts->layers[ tile::LAYER_LAND ].tex_coords.left.y + ts->layers[ tile::LAYER_LAND ].tex_coords.top.y + ts->layers[ tile::LAYER_LAND ].tex_coords.right.y + ts->layers[ tile::LAYER_LAND ].tex_coords.bottom.y ) / 4;
 
 	}
-	else { // is_water_tile
+	else { // IsWater()
 
 	}
 
@@ -129,15 +129,15 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 	};
 
 	// coast water texture
-	if ( !tile->is_water_tile && (
-		tile->W->is_water_tile ||
-			tile->NW->is_water_tile ||
-			tile->N->is_water_tile ||
-			tile->NE->is_water_tile ||
-			tile->E->is_water_tile ||
-			tile->SE->is_water_tile ||
-			tile->S->is_water_tile ||
-			tile->SW->is_water_tile
+	if ( !tile->IsWater() && (
+		tile->W()->IsWater() ||
+			tile->NW()->IsWater() ||
+			tile->N()->IsWater() ||
+			tile->NE()->IsWater() ||
+			tile->E()->IsWater() ||
+			tile->SE()->IsWater() ||
+			tile->S()->IsWater() ||
+			tile->SW()->IsWater()
 	) ) {
 		/*m_map->AddTexture(
 			tile::LAYER_WATER_SURFACE,
@@ -155,41 +155,41 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 							s_consts.coastlines.coastline_tint;
 	}
 
-	if ( tile->is_water_tile && (
-		!tile->W->is_water_tile ||
-			!tile->NW->is_water_tile ||
-			!tile->N->is_water_tile ||
-			!tile->NE->is_water_tile ||
-			!tile->E->is_water_tile ||
-			!tile->SE->is_water_tile ||
-			!tile->S->is_water_tile ||
-			!tile->SW->is_water_tile
+	if ( tile->IsWater() && (
+		!tile->W()->IsWater() ||
+			!tile->NW()->IsWater() ||
+			!tile->N()->IsWater() ||
+			!tile->NE()->IsWater() ||
+			!tile->E()->IsWater() ||
+			!tile->SE()->IsWater() ||
+			!tile->S()->IsWater() ||
+			!tile->SW()->IsWater()
 	) ) {
 
 		ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.center.value.alpha = s_consts.coastlines.coast_water_center_alpha;
 
-		if ( tile->W->is_water_tile && tile->NW->is_water_tile && tile->SW->is_water_tile ) {
+		if ( tile->W()->IsWater() && tile->NW()->IsWater() && tile->SW()->IsWater() ) {
 			ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.left.value.alpha = 0.0f;
 		}
 		else {
 			ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.left = s_consts.coastlines.coastline_tint;
 		}
 
-		if ( tile->N->is_water_tile && tile->NW->is_water_tile && tile->NE->is_water_tile ) {
+		if ( tile->N()->IsWater() && tile->NW()->IsWater() && tile->NE()->IsWater() ) {
 			ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.top.value.alpha = 0.0f;
 		}
 		else {
 			ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.top = s_consts.coastlines.coastline_tint;
 		}
 
-		if ( tile->E->is_water_tile && tile->NE->is_water_tile && tile->SE->is_water_tile ) {
+		if ( tile->E()->IsWater() && tile->NE()->IsWater() && tile->SE()->IsWater() ) {
 			ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.right.value.alpha = 0.0f;
 		}
 		else {
 			ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.right = s_consts.coastlines.coastline_tint;
 		}
 
-		if ( tile->S->is_water_tile && tile->SW->is_water_tile && tile->SE->is_water_tile ) {
+		if ( tile->S()->IsWater() && tile->SW()->IsWater() && tile->SE()->IsWater() ) {
 			ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.bottom.value.alpha = 0.0f;
 		}
 		else {
@@ -221,45 +221,45 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 			// TODO: refactor?
 			auto add_flags = types::texture::AM_MERGE | types::texture::AM_COASTLINE_BORDER;
 			if (
-				tile->W->is_water_tile &&
-					( tile->SW->is_water_tile || tile->coord.y == ms->dimensions.y - 1 ) &&
-					( tile->NW->is_water_tile || tile->coord.y == 0 )
+				tile->W()->IsWater() &&
+					( tile->SW()->IsWater() || tile->GetCoords().y == ms->dimensions.y - 1 ) &&
+					( tile->NW()->IsWater() || tile->GetCoords().y == 0 )
 				) {
 				add_flags |= types::texture::AM_ROUND_LEFT;
 			}
 			if (
-				( tile->N->is_water_tile || tile->coord.y <= 1 ) &&
-					( tile->NW->is_water_tile || tile->coord.y == 0 ) &&
-					( tile->NE->is_water_tile || tile->coord.y == 0 )
+				( tile->N()->IsWater() || tile->GetCoords().y <= 1 ) &&
+					( tile->NW()->IsWater() || tile->GetCoords().y == 0 ) &&
+					( tile->NE()->IsWater() || tile->GetCoords().y == 0 )
 				) {
 				add_flags |= types::texture::AM_ROUND_TOP;
 			}
 			if (
-				tile->E->is_water_tile &&
-					( tile->SE->is_water_tile || tile->coord.y == ms->dimensions.y - 1 ) &&
-					( tile->NE->is_water_tile || tile->coord.y == 0 )
+				tile->E()->IsWater() &&
+					( tile->SE()->IsWater() || tile->GetCoords().y == ms->dimensions.y - 1 ) &&
+					( tile->NE()->IsWater() || tile->GetCoords().y == 0 )
 				) {
 				add_flags |= types::texture::AM_ROUND_RIGHT;
 			}
 			if (
-				( tile->S->is_water_tile || tile->coord.y <= ms->dimensions.y - 2 ) &&
-					( tile->SE->is_water_tile || tile->coord.y == ms->dimensions.y - 1 ) &&
-					( tile->SW->is_water_tile || tile->coord.y == ms->dimensions.y - 1 )
+				( tile->S()->IsWater() || tile->GetCoords().y <= ms->dimensions.y - 2 ) &&
+					( tile->SE()->IsWater() || tile->GetCoords().y == ms->dimensions.y - 1 ) &&
+					( tile->SW()->IsWater() || tile->GetCoords().y == ms->dimensions.y - 1 )
 				) {
 				add_flags |= types::texture::AM_ROUND_BOTTOM;
 			}
 
 			// coastline tint
-/*			if ( tile->W->is_water_tile || tile->SW->is_water_tile || tile->NW->is_water_tile ) {
+/*			if ( tile->W()->IsWater() || tile->SW()->IsWater() || tile->NW()->IsWater() ) {
 				ts->layers[ tile::LAYER_WATER ].colors.left = s_consts.coastlines.coastline_tint;
 			}
-			if ( tile->N->is_water_tile || tile->NW->is_water_tile || tile->NE->is_water_tile ) {
+			if ( tile->N()->IsWater() || tile->NW()->IsWater() || tile->NE()->IsWater() ) {
 				ts->layers[ tile::LAYER_WATER ].colors.top = s_consts.coastlines.coastline_tint;
 			}
-			if ( tile->E->is_water_tile || tile->SE->is_water_tile || tile->NE->is_water_tile ) {
+			if ( tile->E()->IsWater() || tile->SE()->IsWater() || tile->NE()->IsWater() ) {
 				ts->layers[ tile::LAYER_WATER ].colors.right = s_consts.coastlines.coastline_tint;
 			}
-			if ( tile->S->is_water_tile || tile->SW->is_water_tile || tile->SE->is_water_tile ) {
+			if ( tile->S()->IsWater() || tile->SW()->IsWater() || tile->SE()->IsWater() ) {
 				ts->layers[ tile::LAYER_WATER ].colors.bottom = s_consts.coastlines.coastline_tint;
 			}*/
 
@@ -271,21 +271,21 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 		coastline_corners.clear();
 
 		// corners on water tiles
-		if ( tile->is_water_tile ) {
+		if ( tile->IsWater() ) {
 
-			if ( !tile->SW->is_water_tile && !tile->NW->is_water_tile ) {
+			if ( !tile->SW()->IsWater() && !tile->NW()->IsWater() ) {
 				coastline_corner_tmp = {};
 				coastline_corner_tmp.flags = types::texture::AM_ROUND_LEFT;
 				//ts->layers[ tile::LAYER_WATER ].colors.left = s_consts.coastlines.coastline_tint;
-				if ( !tile->W->is_water_tile ) {
+				if ( !tile->W()->IsWater() ) {
 					coastline_corner_tmp.can_mirror = true;
-					if ( tile->coord.x >= 2 ) {
-						coastline_corner_tmp.msx = tile->coord.x - 2;
+					if ( tile->GetCoords().x >= 2 ) {
+						coastline_corner_tmp.msx = tile->GetCoords().x - 2;
 					}
 					else {
-						coastline_corner_tmp.msx = ms->dimensions.x - 2 + tile->coord.x;
+						coastline_corner_tmp.msx = ms->dimensions.x - 2 + tile->GetCoords().x;
 					}
-					coastline_corner_tmp.msy = tile->coord.y;
+					coastline_corner_tmp.msy = tile->GetCoords().y;
 				}
 				else {
 					coastline_corner_tmp.maybe_mirror_sw = true;
@@ -294,15 +294,15 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 				coastline_corners.push_back( coastline_corner_tmp );
 			}
 
-			if ( !tile->NW->is_water_tile && !tile->NE->is_water_tile ) {
+			if ( !tile->NW()->IsWater() && !tile->NE()->IsWater() ) {
 				coastline_corner_tmp = {};
 				coastline_corner_tmp.flags = types::texture::AM_ROUND_TOP;
 				//ts->layers[ tile::LAYER_WATER ].colors.top = s_consts.coastlines.coastline_tint;
-				if ( !tile->N->is_water_tile ) {
-					if ( tile->coord.y >= 2 ) {
+				if ( !tile->N()->IsWater() ) {
+					if ( tile->GetCoords().y >= 2 ) {
 						coastline_corner_tmp.can_mirror = true;
-						coastline_corner_tmp.msx = tile->coord.x;
-						coastline_corner_tmp.msy = tile->coord.y - 2;
+						coastline_corner_tmp.msx = tile->GetCoords().x;
+						coastline_corner_tmp.msy = tile->GetCoords().y - 2;
 					}
 				}
 				else {
@@ -311,19 +311,19 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 				}
 				coastline_corners.push_back( coastline_corner_tmp );
 			}
-			if ( !tile->SE->is_water_tile && !tile->NE->is_water_tile ) {
+			if ( !tile->SE()->IsWater() && !tile->NE()->IsWater() ) {
 				coastline_corner_tmp = {};
 				coastline_corner_tmp.flags = types::texture::AM_ROUND_RIGHT;
 				//ts->layers[ tile::LAYER_WATER ].colors.right = s_consts.coastlines.coastline_tint;
-				if ( !tile->E->is_water_tile ) {
+				if ( !tile->E()->IsWater() ) {
 					coastline_corner_tmp.can_mirror = true;
-					if ( tile->coord.x < ms->dimensions.x - 2 ) {
-						coastline_corner_tmp.msx = tile->coord.x + 2;
+					if ( tile->GetCoords().x < ms->dimensions.x - 2 ) {
+						coastline_corner_tmp.msx = tile->GetCoords().x + 2;
 					}
 					else {
-						coastline_corner_tmp.msx = tile->coord.x % 2;
+						coastline_corner_tmp.msx = tile->GetCoords().x % 2;
 					}
-					coastline_corner_tmp.msy = tile->coord.y;
+					coastline_corner_tmp.msy = tile->GetCoords().y;
 				}
 				else {
 					coastline_corner_tmp.maybe_mirror_se = true;
@@ -331,15 +331,15 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 				}
 				coastline_corners.push_back( coastline_corner_tmp );
 			}
-			if ( !tile->SE->is_water_tile && !tile->SW->is_water_tile ) {
+			if ( !tile->SE()->IsWater() && !tile->SW()->IsWater() ) {
 				coastline_corner_tmp = {};
 				coastline_corner_tmp.flags = types::texture::AM_ROUND_BOTTOM;
 				//ts->layers[ tile::LAYER_WATER ].colors.bottom = s_consts.coastlines.coastline_tint;
-				if ( !tile->S->is_water_tile ) {
-					if ( tile->coord.y < ms->dimensions.y - 2 ) {
+				if ( !tile->S()->IsWater() ) {
+					if ( tile->GetCoords().y < ms->dimensions.y - 2 ) {
 						coastline_corner_tmp.can_mirror = true;
-						coastline_corner_tmp.msx = tile->coord.x;
-						coastline_corner_tmp.msy = tile->coord.y + 2;
+						coastline_corner_tmp.msx = tile->GetCoords().x;
+						coastline_corner_tmp.msy = tile->GetCoords().y + 2;
 					}
 				}
 				else {
@@ -355,11 +355,11 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 					c.mirror_mode = types::texture::AM_MIRROR_X | types::texture::AM_MIRROR_Y;
 				}
 
-				if ( !c.can_mirror && tile->coord.y >= 1 ) {
-					c.msy = tile->coord.y - 1;
+				if ( !c.can_mirror && tile->GetCoords().y >= 1 ) {
+					c.msy = tile->GetCoords().y - 1;
 					if ( !c.can_mirror && coastline_corner_tmp.maybe_mirror_nw ) {
-						if ( tile->coord.x >= 1 ) {
-							c.msx = tile->coord.x - 1;
+						if ( tile->GetCoords().x >= 1 ) {
+							c.msx = tile->GetCoords().x - 1;
 						}
 						else {
 							c.msx = ms->dimensions.x - 1;
@@ -368,8 +368,8 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 						c.can_mirror = true;
 					}
 					if ( !c.can_mirror && coastline_corner_tmp.maybe_mirror_ne ) {
-						if ( tile->coord.x < ms->dimensions.x - 1 ) {
-							c.msx = tile->coord.x + 1;
+						if ( tile->GetCoords().x < ms->dimensions.x - 1 ) {
+							c.msx = tile->GetCoords().x + 1;
 						}
 						else {
 							c.msx = 1;
@@ -378,11 +378,11 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 						c.can_mirror = true;
 					}
 				}
-				if ( !c.can_mirror && tile->coord.y < ms->dimensions.y - 1 ) {
-					c.msy = tile->coord.y + 1;
+				if ( !c.can_mirror && tile->GetCoords().y < ms->dimensions.y - 1 ) {
+					c.msy = tile->GetCoords().y + 1;
 					if ( !c.can_mirror && coastline_corner_tmp.maybe_mirror_sw ) {
-						if ( tile->coord.x >= 1 ) {
-							c.msx = tile->coord.x - 1;
+						if ( tile->GetCoords().x >= 1 ) {
+							c.msx = tile->GetCoords().x - 1;
 						}
 						else {
 							c.msx = ms->dimensions.x - 1;
@@ -391,8 +391,8 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 						c.can_mirror = true;
 					}
 					if ( !c.can_mirror && coastline_corner_tmp.maybe_mirror_se ) {
-						if ( tile->coord.x < ms->dimensions.x - 1 ) {
-							c.msx = tile->coord.x + 1;
+						if ( tile->GetCoords().x < ms->dimensions.x - 1 ) {
+							c.msx = tile->GetCoords().x + 1;
 						}
 						else {
 							c.msx = 1;
@@ -406,8 +406,8 @@ void Coastlines1::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 					// mirror opposite tile
 					m_map->CopyTextureDeferred(
 						tile::LAYER_LAND,
-						c.msx * s_consts.tc.texture_pcx.dimensions.x,
-						c.msy * s_consts.tc.texture_pcx.dimensions.y,
+						m_map->GetTileTextureX( c.msx ),
+						m_map->GetTileTextureY( c.msy ),
 						tile::LAYER_WATER,
 						coastline_mode | c.flags | c.mirror_mode,
 						0
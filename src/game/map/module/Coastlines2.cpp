@@ -13,7 +13,7 @@ namespace map {
 namespace module {
 
 Coastlines2::Coastlines2( Map* const map )
-	: Coastlines( map ) {
+	: Coastlines( map, NA_WRITE ) {
 	NEW( m_perlin, util::Perlin, map->GetRandom()->GetUInt( 0, UINT32_MAX - 1 ) );
 }
 
@@ -28,41 +28,41 @@ void Coastlines2::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 	if ( ts->has_water ) {
 		if ( ts->is_coastline_corner ) {
 			if (
-				tile->W->is_water_tile &&
-					( tile->SW->is_water_tile || tile->coord.y == ms->dimensions.y - 1 ) &&
-					( tile->NW->is_water_tile || tile->coord.y == 0 )
+				tile->W()->IsWater() &&
+					( tile->SW()->IsWater() || tile->GetCoords().y == ms->dimensions.y - 1 ) &&
+					( tile->NW()->IsWater() || tile->GetCoords().y == 0 )
 				) {
 				ts->W->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.center.value.alpha *= s_consts.coastlines.coast_water_center_alpha_corner_mod;
 			}
 			if (
-				( tile->N->is_water_tile || tile->coord.y <= 1 ) &&
-					( tile->NW->is_water_tile || tile->coord.y == 0 ) &&
-					( tile->NE->is_water_tile || tile->coord.y == 0 )
+				( tile->N()->IsWater() || tile->GetCoords().y <= 1 ) &&
+					( tile->NW()->IsWater() || tile->GetCoords().y == 0 ) &&
+					( tile->NE()->IsWater() || tile->GetCoords().y == 0 )
 				) {
 				ts->N->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.center.value.alpha *= s_consts.coastlines.coast_water_center_alpha_corner_mod;
 			}
 			if (
-				tile->E->is_water_tile &&
-					( tile->SE->is_water_tile || tile->coord.y == ms->dimensions.y - 1 ) &&
-					( tile->NE->is_water_tile || tile->coord.y == 0 )
+				tile->E()->IsWater() &&
+					( tile->SE()->IsWater() || tile->GetCoords().y == ms->dimensions.y - 1 ) &&
+					( tile->NE()->IsWater() || tile->GetCoords().y == 0 )
 				) {
 				ts->E->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.center.value.alpha *= s_consts.coastlines.coast_water_center_alpha_corner_mod;
 			}
 			if (
-				( tile->S->is_water_tile || tile->coord.y <= ms->dimensions.y - 2 ) &&
-					( tile->SE->is_water_tile || tile->coord.y == ms->dimensions.y - 1 ) &&
-					( tile->SW->is_water_tile || tile->coord.y == ms->dimensions.y - 1 )
+				( tile->S()->IsWater() || tile->GetCoords().y <= ms->dimensions.y - 2 ) &&
+					( tile->SE()->IsWater() || tile->GetCoords().y == ms->dimensions.y - 1 ) &&
+					( tile->SW()->IsWater() || tile->GetCoords().y == ms->dimensions.y - 1 )
 				) {
 				ts->S->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.center.value.alpha *= s_consts.coastlines.coast_water_center_alpha_corner_mod;
 			}
 		}
 	}
-	if ( tile->is_water_tile ) {
+	if ( tile->IsWater() ) {
 		if (
-			( !tile->SW->is_water_tile && !tile->NW->is_water_tile ) ||
-				( !tile->NW->is_water_tile && !tile->NE->is_water_tile ) ||
-				( !tile->SE->is_water_tile && !tile->NE->is_water_tile ) ||
-				( !tile->SE->is_water_tile && !tile->SW->is_water_tile )
+			( !tile->SW()->IsWater() && !tile->NW()->IsWater() ) ||
+				( !tile->NW()->IsWater() && !tile->NE()->IsWater() ) ||
+				( !tile->SE()->IsWater() && !tile->NE()->IsWater() ) ||
+				( !tile->SE()->IsWater() && !tile->SW()->IsWater() )
 			) {
 			ts->layers[ tile::LAYER_WATER_SURFACE_EXTRA ].colors.center.value.alpha /= s_consts.coastlines.coast_water_center_alpha_corner_mod / 2;
 		}
@@ -72,76 +72,76 @@ void Coastlines2::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 		std::vector< coastline_corner_t > coastline_corners = {};
 		coastline_corner_t coastline_corner_tmp = {};
 
-		if ( !tile->NW->is_water_tile && tile->coord.y > 0 ) {
+		if ( !tile->NW()->IsWater() && tile->GetCoords().y > 0 ) {
 			coastline_corner_tmp = {};
 			coastline_corner_tmp.flags = types::texture::AM_MIRROR_X | types::texture::AM_PERLIN_LEFT;
-			if ( tile->N->is_water_tile ) {
+			if ( tile->N()->IsWater() ) {
 				coastline_corner_tmp.flags |= types::texture::AM_PERLIN_CUT_TOP;
 			}
-			if ( tile->W->is_water_tile ) {
+			if ( tile->W()->IsWater() ) {
 				coastline_corner_tmp.flags |= types::texture::AM_PERLIN_CUT_BOTTOM;
 			}
-			if ( tile->coord.x > 0 ) {
-				coastline_corner_tmp.msx = tile->coord.x - 1;
+			if ( tile->GetCoords().x > 0 ) {
+				coastline_corner_tmp.msx = tile->GetCoords().x - 1;
 			}
 			else {
 				coastline_corner_tmp.msx = ms->dimensions.x - 1;
 			}
-			coastline_corner_tmp.msy = tile->coord.y - 1;
+			coastline_corner_tmp.msy = tile->GetCoords().y - 1;
 			coastline_corners.push_back( coastline_corner_tmp );
 		}
-		if ( !tile->NE->is_water_tile && tile->coord.y > 0 ) {
+		if ( !tile->NE()->IsWater() && tile->GetCoords().y > 0 ) {
 			coastline_corner_tmp = {};
 			coastline_corner_tmp.flags |= types::texture::AM_MIRROR_Y | types::texture::AM_PERLIN_TOP;
-			if ( tile->N->is_water_tile ) {
+			if ( tile->N()->IsWater() ) {
 				coastline_corner_tmp.flags |= types::texture::AM_PERLIN_CUT_LEFT;
 			}
-			if ( tile->E->is_water_tile ) {
+			if ( tile->E()->IsWater() ) {
 				coastline_corner_tmp.flags |= types::texture::AM_PERLIN_CUT_RIGHT;
 			}
-			if ( tile->coord.x < ms->dimensions.x - 1 ) {
-				coastline_corner_tmp.msx = tile->coord.x + 1;
+			if ( tile->GetCoords().x < ms->dimensions.x - 1 ) {
+				coastline_corner_tmp.msx = tile->GetCoords().x + 1;
 			}
 			else {
 				coastline_corner_tmp.msx = 0;
 			}
-			coastline_corner_tmp.msy = tile->coord.y - 1;
+			coastline_corner_tmp.msy = tile->GetCoords().y - 1;
 			coastline_corners.push_back( coastline_corner_tmp );
 		}
-		if ( !tile->SE->is_water_tile && tile->coord.y < ms->dimensions.y - 1 ) {
+		if ( !tile->SE()->IsWater() && tile->GetCoords().y < ms->dimensions.y - 1 ) {
 			coastline_corner_tmp = {};
 			coastline_corner_tmp.flags |= types::texture::AM_MIRROR_X | types::texture::AM_PERLIN_RIGHT;
-			if ( tile->E->is_water_tile ) {
+			if ( tile->E()->IsWater() ) {
 				coastline_corner_tmp.flags |= types::texture::AM_PERLIN_CUT_TOP;
 			}
-			if ( tile->S->is_water_tile ) {
+			if ( tile->S()->IsWater() ) {
 				coastline_corner_tmp.flags |= types::texture::AM_PERLIN_CUT_BOTTOM;
 			}
-			if ( tile->coord.x < ms->dimensions.x - 1 ) {
-				coastline_corner_tmp.msx = tile->coord.x + 1;
+			if ( tile->GetCoords().x < ms->dimensions.x - 1 ) {
+				coastline_corner_tmp.msx = tile->GetCoords().x + 1;
 			}
 			else {
 				coastline_corner_tmp.msx = 0;
 			}
-			coastline_corner_tmp.msy = tile->coord.y + 1;
+			coastline_corner_tmp.msy = tile->GetCoords().y + 1;
 			coastline_corners.push_back( coastline_corner_tmp );
 		}
-		if ( !tile->SW->is_water_tile && tile->coord.y < ms->dimensions.y - 1 ) {
+		if ( !tile->SW()->IsWater() && tile->GetCoords().y < ms->dimensions.y - 1 ) {
 			coastline_corner_tmp = {};
 			coastline_corner_tmp.flags |= types::texture::AM_MIRROR_Y | types::texture::AM_PERLIN_BOTTOM;
-			if ( tile->W->is_water_tile ) {
+			if ( tile->W()->IsWater() ) {
 				coastline_corner_tmp.flags |= types::texture::AM_PERLIN_CUT_LEFT;
 			}
-			if ( tile->S->is_water_tile ) {
+			if ( tile->S()->IsWater() ) {
 				coastline_corner_tmp.flags |= types::texture::AM_PERLIN_CUT_RIGHT;
 			}
-			if ( tile->coord.x > 0 ) {
-				coastline_corner_tmp.msx = tile->coord.x - 1;
+			if ( tile->GetCoords().x > 0 ) {
+				coastline_corner_tmp.msx = tile->GetCoords().x - 1;
 			}
 			else {
 				coastline_corner_tmp.msx = ms->dimensions.x - 1;
 			}
-			coastline_corner_tmp.msy = tile->coord.y + 1;
+			coastline_corner_tmp.msy = tile->GetCoords().y + 1;
 			coastline_corners.push_back( coastline_corner_tmp );
 		}
 
@@ -152,8 +152,8 @@ void Coastlines2::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 
 			m_map->CopyTextureDeferred(
 				tile::LAYER_LAND,
-				c.msx * s_consts.tc.texture_pcx.dimensions.x,
-				c.msy * s_consts.tc.texture_pcx.dimensions.y,
+				m_map->GetTileTextureX( c.msx ),
+				m_map->GetTileTextureY( c.msy ),
 				tile::LAYER_WATER,
 				types::texture::AM_MERGE | c.flags | types::texture::AM_COASTLINE_BORDER,
 				0,
@@ -37,11 +37,11 @@ void Finalize::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapSta
 	// TODO: investigate why it happens
 	const uint8_t em = 1; // for elevations
 	const float emf = 0.00000;//1f; // for vertices z
-	if ( tile->is_water_tile && *tile->elevation.center > -em ) {
-		*tile->elevation.center = -em;
+	if ( tile->IsWater() && *tile->GetElevationCenter() > -em ) {
+		*tile->GetElevationCenter() = -em;
 	}
-	else if ( !tile->is_water_tile && *tile->elevation.center < em ) {
-		*tile->elevation.center = em;
+	else if ( !tile->IsWater() && *tile->GetElevationCenter() < em ) {
+		*tile->GetElevationCenter() = em;
 	}
 
 	for ( auto lt = 0 ; lt < tile::LAYER_MAX ; lt++ ) {
@@ -52,7 +52,7 @@ void Finalize::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapSta
 #undef x
 
 		vertices = ts->layers[ lt ].coords;
-		if ( lt == tile::LAYER_LAND && !tile->is_water_tile && !ts->has_water ) {
+		if ( lt == tile::LAYER_LAND && !tile->IsWater() && !ts->has_water ) {
 
 			// smooth center vertices a bit and add some randomness
 
@@ -67,10 +67,10 @@ void Finalize::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapSta
 					( cs.top.z - cs.bottom.z )
 			) / 12; // TODO: fix black lines when texture is perpendicular to camera
 
-			if ( tile->is_water_tile && vertices.center.z > s_consts.tile.scale.z - emf ) {
+			if ( tile->IsWater() && vertices.center.z > s_consts.tile.scale.z - emf ) {
 				vertices.center.z = s_consts.tile.scale.z - emf;
 			}
-			if ( !tile->is_water_tile && vertices.center.z < s_consts.tile.scale.z + emf ) {
+			if ( !tile->IsWater() && vertices.center.z < s_consts.tile.scale.z + emf ) {
 				vertices.center.z = s_consts.tile.scale.z + emf;
 			}
 
@@ -99,7 +99,7 @@ void Finalize::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapSta
 		// TODO: investigate why it happens
 		{
 #define x( _k ) \
-                if ( !tile->is_water_tile ) { \
+                if ( !tile->IsWater() ) { \
                     if ( lt == tile::LAYER_LAND && vertices._k.z < s_consts.tile.scale.z + emf ) { \
                         vertices._k.z = s_consts.tile.scale.z + emf; \
                     } \
@@ -124,7 +124,7 @@ void Finalize::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapSta
 		do_x();
 #undef x
 
-		if ( tile->coord.x == 0 && lt == tile::LAYER_LAND ) {
+		if ( tile->GetCoords().x == 0 && lt == tile::LAYER_LAND ) {
 
 			// also copy tile to overdraw column
 
@@ -163,22 +163,22 @@ void Finalize::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapSta
 
 	// also add to data mesh for click lookups
 
-	if ( tile->is_water_tile ) {
+	if ( tile->IsWater() ) {
 		vertices = ts->layers[ tile::LAYER_WATER ].coords;
 	}
 	else {
 		vertices = ts->layers[ tile::LAYER_LAND ].coords;
 		if ( ts->is_coastline_corner ) {
-			if ( tile->W->is_water_tile ) {
+			if ( tile->W()->IsWater() ) {
 				vertices.left = ts->layers[ tile::LAYER_WATER ].coords.left;
 			}
-			if ( tile->N->is_water_tile ) {
+			if ( tile->N()->IsWater() ) {
 				vertices.top = ts->layers[ tile::LAYER_WATER ].coords.top;
 			}
-			if ( tile->E->is_water_tile ) {
+			if ( tile->E()->IsWater() ) {
 				vertices.right = ts->layers[ tile::LAYER_WATER ].coords.right;
 			}
-			if ( tile->S->is_water_tile ) {
+			if ( tile->S()->IsWater() ) {
 				vertices.bottom = ts->layers[ tile::LAYER_WATER ].coords.bottom;
 			}
 			vertices.center.z = ( vertices.left.z + vertices.top.z + vertices.right.z + vertices.bottom.z ) / 4;
@@ -186,7 +186,8 @@ void Finalize::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapSta
 	}
 
 	// store tile coordinates
-	types::mesh::data_t data = tile->coord.y * ms->dimensions.x + tile->coord.x + 1; // +1 because we need to differentiate 'tile at 0,0' from 'no tiles'
+	const auto c = tile->GetCoords();
+	types::mesh::data_t data = c.y * ms->dimensions.x + c.x + 1; // +1 because we need to differentiate 'tile at 0,0' from 'no tiles'
 
 	if ( ms->first_run ) {
 #define x( _k ) ts->data_mesh.indices._k = m_map->m_meshes.terrain_data->AddEmptyVertex()
@@ -9,7 +9,7 @@ namespace module {
 CLASS( Finalize, Module )
 
 	Finalize( Map* const map )
-		: Module( map ) {}
+		: Module( map, NA_WRITE ) {}
 
 	void GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) override;
 
@@ -24,7 +24,7 @@ void LandMoisture::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Ma
 
 	auto add_flags = types::texture::AM_DEFAULT;
 
-	switch ( tile->moisture ) {
+	switch ( *tile->GetMoisture() ) {
 		case tile::MOISTURE_NONE: {
 			// invisible tile (for dev/test purposes)
 			break;
@@ -9,7 +9,7 @@ namespace module {
 CLASS( LandMoisture, Module )
 
 	LandMoisture( Map* const map )
-		: Module( map ) {}
+		: Module( map, NA_NONE ) {}
 
 	void GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) override;
 
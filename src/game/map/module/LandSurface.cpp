@@ -18,36 +18,36 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 	m_map->SetTexture( tile::LAYER_LAND, ts->moisture_original, types::texture::AM_DEFAULT );
 
 	// blend a bit from rainy to non-rainy and vice versa
-	for ( auto& t : tile->neighbours ) {
-		if ( !t->is_water_tile && ( t->moisture == tile::MOISTURE_RAINY ) != ( tile->moisture == tile::MOISTURE_RAINY ) ) {
+	for ( auto& t : tile->GetNeighbours() ) {
+		if ( !t->IsWater() && ( *t->GetMoisture() == tile::MOISTURE_RAINY ) != ( *tile->GetMoisture() == tile::MOISTURE_RAINY ) ) {
 
 			// TODO: add pointer connection between tile and tile_t?
-			auto src = m_map->GetTileState( t->coord.x, t->coord.y )->moisture_original;
+			auto src = m_map->GetTileState( t )->moisture_original;
 
 			types::texture::add_flag_t add_flags = types::texture::AM_DEFAULT;
 
-			if ( t == tile->NW ) {
+			if ( t == tile->NW() ) {
 				add_flags = types::texture::AM_GRADIENT_LEFT;
 			}
-			else if ( t == tile->N ) {
+			else if ( t == tile->N() ) {
 				add_flags = types::texture::AM_GRADIENT_LEFT | types::texture::AM_GRADIENT_TOP;
 			}
-			else if ( t == tile->NE ) {
+			else if ( t == tile->NE() ) {
 				add_flags = types::texture::AM_GRADIENT_TOP;
 			}
-			else if ( t == tile->E ) {
+			else if ( t == tile->E() ) {
 				add_flags = types::texture::AM_GRADIENT_TOP | types::texture::AM_GRADIENT_RIGHT;
 			}
-			else if ( t == tile->SE ) {
+			else if ( t == tile->SE() ) {
 				add_flags = types::texture::AM_GRADIENT_RIGHT;
 			}
-			else if ( t == tile->S ) {
+			else if ( t == tile->S() ) {
 				add_flags = types::texture::AM_GRADIENT_RIGHT | types::texture::AM_GRADIENT_BOTTOM;
 			}
-			else if ( t == tile->SW ) {
+			else if ( t == tile->SW() ) {
 				add_flags = types::texture::AM_GRADIENT_BOTTOM;
 			}
-			else if ( t == tile->W ) {
+			else if ( t == tile->W() ) {
 				add_flags = types::texture::AM_GRADIENT_BOTTOM | types::texture::AM_GRADIENT_LEFT;
 			}
 
@@ -71,7 +71,7 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 	}
 
 	// add underwater color
-	if ( tile->is_water_tile ) {
+	if ( tile->IsWater() ) {
 #define x( _k ) ts->layers[ tile::LAYER_LAND ].colors._k = s_consts.underwater_tint;
 		x( center );
 		x( left );
@@ -84,7 +84,7 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 	// add map details
 	// order is important (textures are drawn on top of previous ones)
 
-	if ( tile->features & tile::FEATURE_DUNES ) {
+	if ( *tile->GetFeatures() & tile::FEATURE_DUNES ) {
 		m_map->AddTexture(
 			tile::LAYER_LAND,
 			s_consts.tc.texture_pcx.dunes[ 0 ],
@@ -93,7 +93,7 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 		);
 	}
 
-	switch ( tile->rockiness ) {
+	switch ( *tile->GetRockiness() ) {
 		case tile::ROCKINESS_NONE:
 		case tile::ROCKINESS_FLAT: {
 			// nothing
@@ -121,7 +121,7 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 			THROW( "invalid rockiness value" );
 	}
 
-	if ( tile->features & tile::FEATURE_JUNGLE ) {
+	if ( *tile->GetFeatures() & tile::FEATURE_JUNGLE ) {
 		auto txinfo = m_map->GetTileTextureInfo( Map::TVT_TILES, tile, Map::TG_FEATURE, tile::FEATURE_JUNGLE );
 		m_map->AddTexture(
 			tile::LAYER_LAND,
@@ -131,19 +131,19 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 		);
 	}
 
-	if ( !tile->is_water_tile ) {
+	if ( !tile->IsWater() ) {
 
-		if ( tile->terraforming & tile::TERRAFORMING_FARM || tile->terraforming & tile::TERRAFORMING_SOIL_ENRICHER ) {
+		if ( *tile->GetTerraforming() & tile::TERRAFORMING_FARM || *tile->GetTerraforming() & tile::TERRAFORMING_SOIL_ENRICHER ) {
 			// TODO: select based on nutrients yields instead of moisture
 			m_map->AddTexture(
 				tile::LAYER_LAND,
-				s_consts.tc.texture_pcx.farm[ m_map->GetRandom()->GetUInt( 0, 2 ) * 3 + ( tile->moisture - 1 ) ],
+				s_consts.tc.texture_pcx.farm[ m_map->GetRandom()->GetUInt( 0, 2 ) * 3 + ( *tile->GetMoisture() - 1 ) ],
 				types::texture::AM_MERGE,
 				RandomRotate()
 			);
 		}
 
-		if ( tile->terraforming & tile::TERRAFORMING_FOREST ) {
+		if ( *tile->GetTerraforming() & tile::TERRAFORMING_FOREST ) {
 			auto txinfo = m_map->GetTileTextureInfo( Map::TVT_RIVERS_FORESTS, tile, Map::TG_TERRAFORMING, tile::TERRAFORMING_FOREST );
 			auto& tc = s_consts.tc.texture_pcx.forest[ txinfo.texture_variant ];
 			auto add_flags = types::texture::AM_MERGE | txinfo.texture_flags;
@@ -155,7 +155,7 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 			);
 		}
 
-		if ( tile->features & tile::FEATURE_XENOFUNGUS ) {
+		if ( *tile->GetFeatures() & tile::FEATURE_XENOFUNGUS ) {
 			auto txinfo = m_map->GetTileTextureInfo( Map::TVT_TILES, tile, Map::TG_FEATURE, tile::FEATURE_XENOFUNGUS );
 			m_map->AddTexture(
 				tile::LAYER_LAND,
@@ -165,7 +165,7 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 			);
 		}
 
-		if ( tile->features & tile::FEATURE_RIVER ) {
+		if ( *tile->GetFeatures() & tile::FEATURE_RIVER ) {
 			auto txinfo = m_map->GetTileTextureInfo( Map::TVT_RIVERS_FORESTS, tile, Map::TG_FEATURE, tile::FEATURE_RIVER );
 			auto& tc = s_consts.tc.texture_pcx.river[ txinfo.texture_variant ];
 			auto add_flags = types::texture::AM_MERGE | txinfo.texture_flags;
@@ -194,12 +194,12 @@ void LandSurface::GenerateTile( const tile::Tile* tile, tile::TileState* ts, Map
 			tile::TERRAFORMING_ROAD,
 			tile::TERRAFORMING_MAG_TUBE
 		} ) {
-			if ( tile->terraforming & t ) {
+			if ( *tile->GetTerraforming() & t ) {
 				std::vector< uint8_t > road_variants = {};
 				road_variants.reserve( 9 ); // to minimize reallocations
 
 #define x( _side, _variant ) { \
-                    if ( tile->_side->terraforming & t ) \
+                    if ( *tile->_side()->GetTerraforming() & t ) \
                         road_variants.push_back( _variant ); \
                     }
 				x( NE, 1 );
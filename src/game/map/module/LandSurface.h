@@ -9,7 +9,7 @@ namespace module {
 CLASS( LandSurface, Module )
 
 	LandSurface( Map* const map )
-		: Module( map ) {}
+		: Module( map, NA_READ ) {}
 
 	void GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) override;
 
@@ -11,9 +11,9 @@ namespace module {
 
 void LandSurfacePP::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) {
 
-	if ( !tile->is_water_tile ) {
+	if ( !tile->IsWater() ) {
 
-		if ( tile->features & tile::FEATURE_RIVER ) {
+		if ( *tile->GetFeatures() & tile::FEATURE_RIVER ) {
 			if ( ts->has_water ) {
 
 				// apply river texture again on top of coastline border to erase beach
@@ -23,16 +23,16 @@ void LandSurfacePP::GenerateTile( const tile::Tile* tile, tile::TileState* ts, M
 				const auto lt = tile::LAYER_WATER;
 				const auto mode = types::texture::AM_MERGE | types::texture::AM_KEEP_TRANSPARENCY;
 
-				if ( tile->NW->is_water_tile ) {
+				if ( tile->NW()->IsWater() ) {
 					m_map->SetTexture( lt, ts->NW, ts->river_original, mode | types::texture::AM_MIRROR_X );
 				}
-				if ( tile->NE->is_water_tile ) {
+				if ( tile->NE()->IsWater() ) {
 					m_map->SetTexture( lt, ts->NE, ts->river_original, mode | types::texture::AM_MIRROR_Y );
 				}
-				if ( tile->SE->is_water_tile ) {
+				if ( tile->SE()->IsWater() ) {
 					m_map->SetTexture( lt, ts->SE, ts->river_original, mode | types::texture::AM_MIRROR_X );
 				}
-				if ( tile->SW->is_water_tile ) {
+				if ( tile->SW()->IsWater() ) {
 					m_map->SetTexture( lt, ts->SW, ts->river_original, mode | types::texture::AM_MIRROR_Y );
 				}
 
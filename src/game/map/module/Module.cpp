@@ -7,11 +7,16 @@ namespace game {
 namespace map {
 namespace module {
 
-Module::Module( Map* map )
-	: m_map( map ) {
+Module::Module( Map* map, const neighbour_access_t neighbour_access )
+	: m_map( map )
+	, m_neighbour_access( neighbour_access ) {
 
 }
 
+const Module::neighbour_access_t Module::GetNeighbourAccess() const {
+	return m_neighbour_access;
+}
+
 const uint8_t Module::RandomRotate() const {
 	return m_map->GetRandom()->GetUInt( 0, 3 );
 }
@@ -19,12 +19,23 @@ namespace module {
 
 CLASS( Module, common::Class )
 
-	Module( Map* const map );
+	// which tile states (besides current one) are accessed by GenerateTile()
+	// passes where no module writes to neighbours can be processed in parallel
+	enum neighbour_access_t : uint8_t {
+		NA_NONE = 0, // only current tile state is read and written
+		NA_READ = 1 << 0, // neighbour states are read, but only values written during previous passes
+		NA_WRITE = 1 << 1, // neighbour states or shared map data are written (or read while being written in same pass)
+	};
+
+	Module( Map* const map, const neighbour_access_t neighbour_access );
 
 	virtual void GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) = 0;
 
+	const neighbour_access_t GetNeighbourAccess() const;
+
 protected:
 	Map* const m_map;
+	const neighbour_access_t m_neighbour_access;
 
 	const uint8_t RandomRotate() const;
 };
@@ -13,10 +13,10 @@ void Prepare::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapStat
 
 	if ( ms->first_run ) {
 		// set some defaults
-		ts->coord.x = ms->coord.x + tile->coord.x * s_consts.tile.radius.x;
-		ts->coord.y = ms->coord.y + tile->coord.y * s_consts.tile.radius.y;
-		ts->tex_coord.x1 = tile->coord.x * s_consts.tc.texture_pcx.dimensions.x;
-		ts->tex_coord.y1 = tile->coord.y * s_consts.tc.texture_pcx.dimensions.y;
+		ts->coord.x = ms->coord.x + tile->GetCoords().x * s_consts.tile.radius.x;
+		ts->coord.y = ms->coord.y + tile->GetCoords().y * s_consts.tile.radius.y;
+		ts->tex_coord.x1 = m_map->GetTileTextureX( tile->GetCoords().x );
+		ts->tex_coord.y1 = m_map->GetTileTextureY( tile->GetCoords().y );
 		ts->tex_coord.x2 = ts->tex_coord.x1 + s_consts.tc.texture_pcx.dimensions.x;
 		ts->tex_coord.y2 = ts->tex_coord.y1 + s_consts.tc.texture_pcx.dimensions.y;
 		ts->tex_coord.x = ts->tex_coord.x1 + s_consts.tc.texture_pcx.radius.x;
@@ -27,47 +27,47 @@ void Prepare::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapStat
 		m_map->ClearTexture();
 	}
 
-	ts->elevations.left = *tile->elevation.left;
-	ts->elevations.top = *tile->elevation.top;
-	ts->elevations.right = *tile->elevation.right;
-	ts->elevations.bottom = *tile->elevation.bottom;
-	ts->elevations.center = *tile->elevation.center;
+	ts->elevations.left = *tile->GetElevationLeft();
+	ts->elevations.top = *tile->GetElevationTop();
+	ts->elevations.right = *tile->GetElevationRight();
+	ts->elevations.bottom = *tile->GetElevationBottom();
+	ts->elevations.center = *tile->GetElevationCenter();
 
 	// modify elevations based on water / not water, to avoid displaying half-submerged tiles
 	// original tile isn't modified, this is just for rendering
-	int8_t em = tile->is_water_tile
+	int8_t em = tile->IsWater()
 		? -1
 		: 3; // setting -1 : 100 gives interesting shadow effect, but it's not very realistic
 	if (
-		( tile->is_water_tile != tile->W->is_water_tile ) ||
-			( tile->is_water_tile != tile->NW->is_water_tile ) ||
-			( tile->is_water_tile != tile->SW->is_water_tile )
+		( tile->IsWater() != tile->W()->IsWater() ) ||
+			( tile->IsWater() != tile->NW()->IsWater() ) ||
+			( tile->IsWater() != tile->SW()->IsWater() )
 		) {
 		ts->elevations.left = tile::ELEVATION_LEVEL_COAST + em;
 	}
 	if (
-		( tile->is_water_tile != tile->E->is_water_tile ) ||
-			( tile->is_water_tile != tile->NE->is_water_tile ) ||
-			( tile->is_water_tile != tile->SE->is_water_tile )
+		( tile->IsWater() != tile->E()->IsWater() ) ||
+			( tile->IsWater() != tile->NE()->IsWater() ) ||
+			( tile->IsWater() != tile->SE()->IsWater() )
 		) {
 		ts->elevations.right = tile::ELEVATION_LEVEL_COAST + em;
 	}
 	if (
-		( tile->is_water_tile != tile->N->is_water_tile ) ||
-			( tile->is_water_tile != tile->NE->is_water_tile ) ||
-			( tile->is_water_tile != tile->NW->is_water_tile )
+		( tile->IsWater() != tile->N()->IsWater() ) ||
+			( tile->IsWater() != tile->NE()->IsWater() ) ||
+			( tile->IsWater() != tile->NW()->IsWater() )
 		) {
 		ts->elevations.top = tile::ELEVATION_LEVEL_COAST + em;
 	}
 	if (
-		( tile->is_water_tile != tile->S->is_water_tile ) ||
-			( tile->is_water_tile != tile->SE->is_water_tile ) ||
-			( tile->is_water_tile != tile->SW->is_water_tile )
+		( tile->IsWater() != tile->S()->IsWater() ) ||
+			( tile->IsWater() != tile->SE()->IsWater() ) ||
+			( tile->IsWater() != tile->SW()->IsWater() )
 		) {
 		ts->elevations.bottom = tile::ELEVATION_LEVEL_COAST + em;
 	}
 
-	if ( tile->is_water_tile ) {
+	if ( tile->IsWater() ) {
 		// do not allow anything above water on water tiles
 		if ( ts->elevations.left >= tile::ELEVATION_LEVEL_COAST + em ) {
 			ts->elevations.left = tile::ELEVATION_LEVEL_COAST + em;
@@ -141,11 +141,11 @@ void Prepare::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapStat
 
 	}
 
-	ts->is_coastline_corner = !tile->is_water_tile && (
-		( tile->W->is_water_tile && ( tile->NW->is_water_tile || tile->SW->is_water_tile ) ) ||
-			( tile->N->is_water_tile && ( tile->NW->is_water_tile || tile->NE->is_water_tile ) ) ||
-			( tile->E->is_water_tile && ( tile->NE->is_water_tile || tile->SE->is_water_tile ) ) ||
-			( tile->S->is_water_tile && ( tile->SW->is_water_tile || tile->SE->is_water_tile ) )
+	ts->is_coastline_corner = !tile->IsWater() && (
+		( tile->W()->IsWater() && ( tile->NW()->IsWater() || tile->SW()->IsWater() ) ) ||
+			( tile->N()->IsWater() && ( tile->NW()->IsWater() || tile->NE()->IsWater() ) ) ||
+			( tile->E()->IsWater() && ( tile->NE()->IsWater() || tile->SE()->IsWater() ) ) ||
+			( tile->S()->IsWater() && ( tile->SW()->IsWater() || tile->SE()->IsWater() ) )
 	);
 
 	ts->has_water = (
@@ -59,19 +59,19 @@ void Sprites::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapStat
     GenerateSprite( tile, ts, _name, s_consts.tc.ter1_pcx._texture, 0.002f * ( std::find( sprite_z_order.begin(), sprite_z_order.end(), _name ) - sprite_z_order.begin() ) )
 
 #define FEATURE_SPRITE( _feature, _name, _texture ) \
-    if ( tile->features & tile::_feature ) { \
+    if ( *tile->GetFeatures() & tile::_feature ) { \
         SPRITE( _name, _texture ); \
     }
 
 #define TERRAFORMING_SPRITE( _terraforming, _name, _texture ) \
-    if ( tile->terraforming & tile::_terraforming ) { \
+    if ( *tile->GetTerraforming() & tile::_terraforming ) { \
         SPRITE( _name, _texture ); \
     }
 
-	if ( tile->is_water_tile ) {
+	if ( tile->IsWater() ) {
 		FEATURE_SPRITE( FEATURE_GEOTHERMAL, "Geothermal", geothermal[ 0 ] );
 
-		switch ( tile->bonus ) {
+		switch ( *tile->GetBonus() ) {
 			case tile::BONUS_NUTRIENT: {
 				SPRITE( "NutrientBonusSea", nutrient_bonus_water[ m_map->GetRandom()->GetUInt( 0, 1 ) ] );
 				break;
@@ -94,7 +94,7 @@ void Sprites::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapStat
 		TERRAFORMING_SPRITE( TERRAFORMING_MINE, "MineSea", mine_water[ 0 ] );
 	}
 	else {
-		switch ( tile->bonus ) {
+		switch ( *tile->GetBonus() ) {
 			case tile::BONUS_NUTRIENT: {
 				SPRITE( "NutrientBonusLand", nutrient_bonus_land[ m_map->GetRandom()->GetUInt( 0, 1 ) ] );
 				break;
@@ -118,8 +118,8 @@ void Sprites::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapStat
 		TERRAFORMING_SPRITE( TERRAFORMING_SOLAR, "SolarLand", solar_land[ 0 ] );
 
 		// TODO: select based on nutrients yields instead of moisture
-		TERRAFORMING_SPRITE( TERRAFORMING_FARM, "FarmLand", farm_land[ tile->moisture ] );
-		TERRAFORMING_SPRITE( TERRAFORMING_SOIL_ENRICHER, "SoilEnricher", soil_enricher[ tile->moisture ] );
+		TERRAFORMING_SPRITE( TERRAFORMING_FARM, "FarmLand", farm_land[ *tile->GetMoisture() ] );
+		TERRAFORMING_SPRITE( TERRAFORMING_SOIL_ENRICHER, "SoilEnricher", soil_enricher[ *tile->GetMoisture() ] );
 
 		TERRAFORMING_SPRITE( TERRAFORMING_MINE, "MineLand", mine_land[ 0 ] );
 		TERRAFORMING_SPRITE( TERRAFORMING_MIRROR, "EchelonMirror", mirror[ 0 ] );
@@ -133,11 +133,11 @@ void Sprites::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapStat
 
 	TERRAFORMING_SPRITE( TERRAFORMING_SENSOR, "Sensor", sensor[ 0 ] );
 
-	if ( !tile->is_water_tile ) {
+	if ( !tile->IsWater() ) {
 		TERRAFORMING_SPRITE( TERRAFORMING_BUNKER, "Bunker", bunker[ 0 ] );
 	}
 
-	if ( !tile->is_water_tile ) {
+	if ( !tile->IsWater() ) {
 		FEATURE_SPRITE( FEATURE_UNITY_POD, "UnityPodLand", unity_pod_land[ m_map->GetRandom()->GetUInt( 0, 2 ) ] );
 	}
 	else {
@@ -153,7 +153,7 @@ void Sprites::GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapStat
 void Sprites::GenerateSprite( const tile::Tile* tile, tile::TileState* ts, const std::string& name, const pcx_texture_coordinates_t& tex_coords, const float z_index ) {
 	tile::TileState::sprite_t sprite = {};
 
-	const auto& coords = tile->is_water_tile
+	const auto& coords = tile->IsWater()
 		? ts->layers[ tile::LAYER_WATER ].coords
 		: ts->layers[ tile::LAYER_LAND ].coords;
 
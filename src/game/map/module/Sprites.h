@@ -11,7 +11,7 @@ namespace module {
 CLASS( Sprites, Module )
 
 	Sprites( Map* const map )
-		: Module( map ) {}
+		: Module( map, NA_WRITE ) {}
 	void GenerateTile( const tile::Tile* tile, tile::TileState* ts, MapState* ms ) override;
 
 private:
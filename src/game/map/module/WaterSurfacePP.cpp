@@ -14,7 +14,7 @@ void WaterSurfacePP::GenerateTile( const tile::Tile* tile, tile::TileState* ts,
 	if ( ts->has_water ) {
 
 		// it's here instead of WaterSurface because it needs to be drawn on top of coastline river fix redraw
-		if ( tile->features & tile::FEATURE_XENOFUNGUS ) {
+		if ( *tile->GetFeatures() & tile::FEATURE_XENOFUNGUS ) {
 			auto txinfo = m_map->GetTileTextureInfo( Map::TVT_TILES, tile, Map::TG_FEATURE, tile::FEATURE_XENOFUNGUS );
 			m_map->AddTexture(
 				tile::LAYER_WATER,
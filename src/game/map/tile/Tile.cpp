@@ -1,5 +1,7 @@
 #include "Tile.h"
 
+#include "Tiles.h"
+
 #include "gse/type/Object.h"
 #include "gse/type/Array.h"
 #include "gse/type/Int.h"
@@ -16,6 +18,10 @@ namespace game {
 namespace map {
 namespace tile {
 
+const coords_t Tile::GetCoords() const {
+	return m_tiles->GetCoordsByIndex( m_index );
+}
+
 const std::string Tile::TilePositionsToString( const positions_t& tile_positions, std::string prefx ) {
 	// TODO: refactor
 	std::string result = TS_ARR_BEGIN( "Tiles" );
@@ -52,47 +58,166 @@ const std::string& Tile::GetDirectionString( const direction_t direction ) {
 	return s->second;
 }
 
-Tile* Tile::GetNeighbour( const direction_t direction ) {
-	switch ( direction ) {
-		case D_NONE: return this;
-		case D_W: return W;
-		case D_NW: return NW;
-		case D_N: return N;
-		case D_NE: return NE;
-		case D_E: return E;
-		case D_SE: return SE;
-		case D_S: return S;
-		case D_SW: return SW;
-		default:
-			THROW( "unknown tile direction: " + std::to_string( direction ) );
+elevation_t* Tile::GetElevationCenter() const {
+	return &m_tiles->m_center_elevations[ m_index ];
+}
+
+elevation_t* Tile::GetElevationLeft() const {
+	// left corner is right corner of western tile
+	return W()->GetElevationRight();
+}
+
+elevation_t* Tile::GetElevationTop() const {
+	const auto c = GetCoords();
+	if ( c.y >= 2 ) {
+		return N()->GetElevationBottom();
+	}
+	else if ( c.y > 0 ) {
+		return m_tiles->TopRightVertexAt( c.x - 1 );
+	}
+	else {
+		return m_tiles->TopVertexAt( c.x, c.y );
 	}
 }
 
+elevation_t* Tile::GetElevationRight() const {
+	const auto c = GetCoords();
+	if ( c.y == 0 ) {
+		return m_tiles->TopRightVertexAt( c.x );
+	}
+	else {
+		// right corner is bottom corner of north-eastern tile
+		return NE()->GetElevationBottom();
+	}
+}
+
+elevation_t* Tile::GetElevationBottom() const {
+	return &m_tiles->m_bottom_elevations[ m_index ];
+}
+
+const std::array< elevation_t*, 4 > Tile::GetElevationCorners() const {
+	return {
+		GetElevationLeft(),
+		GetElevationTop(),
+		GetElevationRight(),
+		GetElevationBottom(),
+	};
+}
+
+#define X( _direction ) \
+Tile* Tile::_direction() const { \
+	return GetNeighbour( D_##_direction ); \
+}
+X( W )
+X( NW )
+X( N )
+X( NE )
+X( E )
+X( SE )
+X( S )
+X( SW )
+#undef X
+
+const std::array< Tile*, 8 > Tile::GetNeighbours() const {
+	return {
+		W(),
+		NW(),
+		N(),
+		NE(),
+		E(),
+		SE(),
+		S(),
+		SW(),
+	};
+}
+
+Tile* Tile::GetNeighbour( const direction_t direction ) const {
+	const auto c = GetCoords();
+	const auto n = m_tiles->GetNeighbourCoords( c.x, c.y, direction );
+	return &m_tiles->At( n.x, n.y );
+}
+
 void Tile::Update() {
 
-	*elevation.center = ( *elevation.left + *elevation.top + *elevation.right + *elevation.bottom ) / 4;
+	const auto corners = GetElevationCorners();
+	auto* center = GetElevationCenter();
+
+	*center = ( *corners[ 0 ] + *corners[ 1 ] + *corners[ 2 ] + *corners[ 3 ] ) / 4;
 
-	uint8_t corners_in_water = *elevation.center < ELEVATION_LEVEL_COAST
+	uint8_t corners_in_water = *center < ELEVATION_LEVEL_COAST
 		? 1
 		: 0;
-	for ( auto& c : elevation.corners ) {
+	for ( auto& c : corners ) {
 		if ( *c < ELEVATION_LEVEL_COAST ) {
 			corners_in_water++;
 		}
 	}
 
-	is_water_tile = corners_in_water > 2;
+	m_tiles->m_is_water[ m_index ] = corners_in_water > 2;
+}
+
+const bool Tile::IsWater() const {
+	return m_tiles->m_is_water[ m_index ];
+}
+
+moisture_t* Tile::GetMoisture() const {
+	return &m_tiles->m_moistures[ m_index ];
+}
+
+rockiness_t* Tile::GetRockiness() const {
+	return &m_tiles->m_rockinesses[ m_index ];
+}
+
+feature_t* Tile::GetFeatures() const {
+	return &m_tiles->m_features[ m_index ];
+}
+
+bonus_t* Tile::GetBonus() const {
+	return &m_tiles->m_bonuses[ m_index ];
+}
+
+terraforming_t* Tile::GetTerraforming() const {
+	return &m_tiles->m_terraformings[ m_index ];
+}
+
+std::map< size_t, unit::Unit* >& Tile::GetUnits() {
+	return m_tiles->m_units[ m_index ];
+}
+
+const std::map< size_t, unit::Unit* >& Tile::GetUnits() const {
+	static const std::map< size_t, unit::Unit* > s_no_units = {};
+	const auto& it = m_tiles->m_units.find( m_index );
+	return it != m_tiles->m_units.end()
+		? it->second
+		: s_no_units;
+}
+
+base::Base* Tile::GetBase() const {
+	const auto& it = m_tiles->m_bases.find( m_index );
+	return it != m_tiles->m_bases.end()
+		? it->second
+		: nullptr;
+}
+
+void Tile::SetBase( base::Base* base ) {
+	if ( base ) {
+		m_tiles->m_bases[ m_index ] = base;
+	}
+	else {
+		m_tiles->m_bases.erase( m_index );
+	}
 }
 
 void Tile::Clear() {
-	for ( auto& c : elevation.corners ) {
+	for ( auto& c : GetElevationCorners() ) {
 		*c = 0;
 	}
-	moisture = rockiness = bonus = features = terraforming = is_water_tile = 0;
+	*GetMoisture() = *GetRockiness() = *GetFeatures() = *GetBonus() = *GetTerraforming() = 0;
+	m_tiles->m_is_water[ m_index ] = false;
 }
 
 const bool Tile::IsAdjactentTo( const Tile* other ) const {
-	for ( const auto& n : neighbours ) {
+	for ( const auto& n : GetNeighbours() ) {
 		if ( n == other ) {
 			return true;
 		}
@@ -102,86 +227,91 @@ const bool Tile::IsAdjactentTo( const Tile* other ) const {
 
 const types::Buffer Tile::Serialize() const {
 	types::Buffer buf;
+	SerializeTo( buf );
+	return buf;
+}
 
-	buf.WriteInt( coord.x );
-	buf.WriteInt( coord.y );
-
-	buf.WriteInt( *elevation.center );
-	buf.WriteInt( *elevation.left );
-	buf.WriteInt( *elevation.top );
-	buf.WriteInt( *elevation.right );
-	buf.WriteInt( *elevation.bottom );
+void Tile::SerializeTo( types::Buffer& buf ) const {
+	const auto c = GetCoords();
+	buf.WriteInt( c.x );
+	buf.WriteInt( c.y );
 
-	buf.WriteInt( moisture );
-	buf.WriteInt( rockiness );
-	buf.WriteInt( bonus );
+	buf.WriteInt( *GetElevationCenter() );
+	buf.WriteInt( *GetElevationLeft() );
+	buf.WriteInt( *GetElevationTop() );
+	buf.WriteInt( *GetElevationRight() );
+	buf.WriteInt( *GetElevationBottom() );
 
-	buf.WriteInt( features );
-	buf.WriteInt( terraforming );
+	buf.WriteInt( *GetMoisture() );
+	buf.WriteInt( *GetRockiness() );
+	buf.WriteInt( *GetBonus() );
 
-	return buf;
+	buf.WriteInt( *GetFeatures() );
+	buf.WriteInt( *GetTerraforming() );
 }
 
 void Tile::Unserialize( types::Buffer buf ) {
 
-	coord.x = buf.ReadInt();
-	coord.y = buf.ReadInt();
+	// coordinates are defined by tile index, skip them
+	buf.ReadInt();
+	buf.ReadInt();
 
-	*elevation.center = buf.ReadInt();
-	*elevation.left = buf.ReadInt();
-	*elevation.top = buf.ReadInt();
-	*elevation.right = buf.ReadInt();
-	*elevation.center = buf.ReadInt();
+	*GetElevationCenter() = buf.ReadInt();
+	*GetElevationLeft() = buf.ReadInt();
+	*GetElevationTop() = buf.ReadInt();
+	*GetElevationRight() = buf.ReadInt();
+	*GetElevationCenter() = buf.ReadInt();
 
-	moisture = buf.ReadInt();
-	rockiness = buf.ReadInt();
-	bonus = buf.ReadInt();
+	*GetMoisture() = buf.ReadInt();
+	*GetRockiness() = buf.ReadInt();
+	*GetBonus() = buf.ReadInt();
 
-	features = buf.ReadInt();
-	terraforming = buf.ReadInt();
+	*GetFeatures() = buf.ReadInt();
+	*GetTerraforming() = buf.ReadInt();
 
 	Update();
 }
 
 const std::string Tile::ToString() const {
-	return "@[ " + std::to_string( coord.x ) + " " + std::to_string( coord.y ) + " ]";
+	const auto c = GetCoords();
+	return "@[ " + std::to_string( c.x ) + " " + std::to_string( c.y ) + " ]";
 }
 
 #define GETN( _n ) \
 { \
 	"get_" #_n, \
-	NATIVE_CALL( this ) { return _n->Wrap(); } ) \
+	NATIVE_CALL( this ) { return _n()->Wrap(); } ) \
 }
 
 WRAPIMPL_BEGIN( Tile, CLASS_TILE )
 	WRAPIMPL_PROPS {
 		{
 			"x",
-			VALUE( gse::type::Int, coord.x )
+			VALUE( gse::type::Int, GetCoords().x )
 		},
 		{
 			"y",
-			VALUE( gse::type::Int, coord.y )
+			VALUE( gse::type::Int, GetCoords().y )
 		},
 		{
 			"is_water",
-			VALUE( gse::type::Bool, is_water_tile )
+			VALUE( gse::type::Bool, IsWater() )
 		},
 		{
 			"is_land",
-			VALUE( gse::type::Bool, !is_water_tile )
+			VALUE( gse::type::Bool, !IsWater() )
 		},
 		{
 			"is_rocky",
-			VALUE( gse::type::Bool, rockiness == ROCKINESS_ROCKY )
+			VALUE( gse::type::Bool, *GetRockiness() == ROCKINESS_ROCKY )
 		},
 		{
 			"has_fungus",
-			VALUE( gse::type::Bool, features & FEATURE_XENOFUNGUS )
+			VALUE( gse::type::Bool, *GetFeatures() & FEATURE_XENOFUNGUS )
 		},
 		{
 			"has_river",
-			VALUE( gse::type::Bool, features & FEATURE_RIVER )
+			VALUE( gse::type::Bool, *GetFeatures() & FEATURE_RIVER )
 		},
 		GETN( W ),
 		GETN( NW ),
@@ -204,7 +334,7 @@ WRAPIMPL_BEGIN( Tile, CLASS_TILE )
 			NATIVE_CALL( this ) {
 				N_EXPECT_ARGS( 0 );
 				gse::type::array_elements_t result = {};
-				for ( const auto& n : neighbours ) {
+				for ( const auto& n : GetNeighbours() ) {
 					result.push_back( n->Wrap() );
 				}
 				return VALUE( gse::type::Array, result );
@@ -215,7 +345,7 @@ WRAPIMPL_BEGIN( Tile, CLASS_TILE )
 			NATIVE_CALL( this ) {
 				N_EXPECT_ARGS( 0 );
 				gse::type::array_elements_t result = {};
-				for ( auto& it : units ) {
+				for ( auto& it : GetUnits() ) {
 					result.push_back( it.second->Wrap() );
 				}
 				return VALUE( gse::type::Array, result );
@@ -225,6 +355,7 @@ WRAPIMPL_BEGIN( Tile, CLASS_TILE )
 			"get_base",
 			NATIVE_CALL( this ) {
 				N_EXPECT_ARGS( 0 );
+				auto* base = GetBase();
 				if ( base ) {
 					return base->Wrap();
 				}
@@ -239,19 +370,19 @@ WRAPIMPL_END_PTR( Tile )
 UNWRAPIMPL_PTR( Tile )
 
 void Tile::Lock( const size_t initiator_slot ) {
-	ASSERT_NOLOG( !m_is_locked, "tile already locked" );
-	m_lock_initiator_slot = initiator_slot;
-	m_is_locked = true;
+	ASSERT_NOLOG( !IsLocked(), "tile already locked" );
+	m_tiles->m_lock_initiator_slots[ m_index ] = initiator_slot;
 }
 void Tile::Unlock() {
-	ASSERT_NOLOG( m_is_locked, "tile not locked" );
-	m_is_locked = false;
+	ASSERT_NOLOG( IsLocked(), "tile not locked" );
+	m_tiles->m_lock_initiator_slots.erase( m_index );
 }
 const bool Tile::IsLocked() const {
-	return m_is_locked;
+	return m_tiles->m_lock_initiator_slots.find( m_index ) != m_tiles->m_lock_initiator_slots.end();
 }
 const bool Tile::IsLockedBy( const size_t initiator_slot ) const {
-	return m_is_locked && m_lock_initiator_slot == initiator_slot;
+	const auto& it = m_tiles->m_lock_initiator_slots.find( m_index );
+	return it != m_tiles->m_lock_initiator_slots.end() && it->second == initiator_slot;
 }
 
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <array>
 #include <vector>
 #include <map>
 #include <unordered_map>
@@ -24,63 +25,58 @@ class Base;
 namespace map {
 namespace tile {
 
-// WARNING: for now everything is public (because it's not clear what should be hidden from what)
-//   you can read any properties you need
-//   but be careful modifying anything, some things are only to be modified within Tile::Update() to keep consistent state
-// Some day this class will be refactored with access isolation and getters/setters
+class Tiles;
+
+// lightweight view into per-map tile data stored in Tiles, holds only map pointer and tile index
+// all values are kept in packed per-map arrays (see Tiles), getters return pointers into them so that values can be modified in place
+// neighbours and corners are not stored but computed from coordinates (see Tiles::GetNeighbourCoords)
 class Tile : public gse::Wrappable {
 public:
 
-	coords_t coord;
+	const coords_t GetCoords() const;
 
 	static const std::string TilePositionsToString( const positions_t& tile_positions, std::string prefx = "" );
 
-	// when reading or writing elevation - work only with values, make sure to not modify pointers themselves!
-	// pointers are set only once by Tiles and are not to be changed after
-	struct {
-		elevation_t* center = nullptr;
-		elevation_t* left = nullptr;
-		elevation_t* top = nullptr;
-		elevation_t* right = nullptr;
-		elevation_t* bottom = nullptr;
-		std::vector< elevation_t* > corners = {}; // for more convenient iteration, contains left, top, right and bottom pointers
-	} elevation;
-
-	struct { // moved to separate structure to allow main structure to have only pointers, for consistency
-		elevation_t bottom;
-		elevation_t center;
-	} elevation_data;
-
-	// links to adjactent tiles ( west, north, east, south and combinations )
-	// will be linked to itself if tile is at north or south map edge
-	// never modify these pointers, work only with values
-	Tile* W = nullptr;
-	Tile* NW = nullptr;
-	Tile* N = nullptr;
-	Tile* NE = nullptr;
-	Tile* E = nullptr;
-	Tile* SE = nullptr;
-	Tile* S = nullptr;
-	Tile* SW = nullptr;
-	std::vector< Tile* > neighbours = {}; // for more convenient iteration, contains all neighbouring tiles
+	// when reading or writing elevation - work only with values, never keep pointers after tiles are resized
+	// left, top and right corners are shared with other tiles ( bottoms of adjactent tiles or top vertex rows )
+	elevation_t* GetElevationCenter() const;
+	elevation_t* GetElevationLeft() const;
+	elevation_t* GetElevationTop() const;
+	elevation_t* GetElevationRight() const;
+	elevation_t* GetElevationBottom() const;
+	const std::array< elevation_t*, 4 > GetElevationCorners() const; // for more convenient iteration, contains left, top, right and bottom pointers
+
+	// adjactent tiles ( west, north, east, south and combinations ), shortcuts for GetNeighbour()
+	// tile itself is returned if tile is at north or south map edge
+	Tile* W() const;
+	Tile* NW() const;
+	Tile* N() const;
+	Tile* NE() const;
+	Tile* E() const;
+	Tile* SE() const;
+	Tile* S() const;
+	Tile* SW() const;
+	const std::array< Tile*, 8 > GetNeighbours() const; // for more convenient iteration, contains all neighbouring tiles
 
 	static const std::unordered_map< direction_t, std::string > s_direction_str;
 	static const std::string& GetDirectionString( const direction_t direction );
-	Tile* GetNeighbour( const direction_t direction );
+	Tile* GetNeighbour( const direction_t direction ) const;
 
-	// dynamic parameters, do not modify them manually
-	bool is_water_tile = false;
+	// dynamic parameter, recalculated by Update()
+	const bool IsWater() const;
 
-	moisture_t moisture;
-	rockiness_t rockiness;
-	bonus_t bonus;
-	feature_t features;
-	terraforming_t terraforming;
+	moisture_t* GetMoisture() const;
+	rockiness_t* GetRockiness() const;
+	feature_t* GetFeatures() const;
+	bonus_t* GetBonus() const;
+	terraforming_t* GetTerraforming() const;
 
-	// units (id -> unit)
-	std::map< size_t, unit::Unit* > units = {};
+	// units (id -> unit), most tiles have none so they are stored sparsely
+	std::map< size_t, unit::Unit* >& GetUnits();
+	const std::map< size_t, unit::Unit* >& GetUnits() const;
 
-	base::Base* base = nullptr;
+	base::Base* GetBase() const;
+	void SetBase( base::Base* base );
 
 	// WARNING: make sure to call this after changing something in tile
 	//   it recalculates dynamic properties and solves inconsistencies
@@ -93,6 +89,7 @@ public:
 	const bool IsAdjactentTo( const Tile* other ) const;
 
 	const types::Buffer Serialize() const;
+	void SerializeTo( types::Buffer& buf ) const; // writes into existing buffer, i.e. as nested value
 	void Unserialize( types::Buffer data );
 
 	const std::string ToString() const;
@@ -105,8 +102,11 @@ public:
 	const bool IsLockedBy( const size_t initiator_slot ) const;
 
 private:
-	bool m_is_locked = false;
-	size_t m_lock_initiator_slot = 0;
+	friend class Tiles;
+
+	// set only once by Tiles::Resize
+	Tiles* m_tiles = nullptr;
+	size_t m_index = 0;
 };
 
 }
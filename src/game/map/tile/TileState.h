@@ -48,7 +48,7 @@ public:
 		types::mesh::index_t right;
 		types::mesh::index_t top;
 		types::mesh::index_t bottom;
-		const types::Buffer Serialize() const;
+		void SerializeTo( types::Buffer& buf ) const;
 		void Unserialize( types::Buffer buf );
 	};
 
@@ -57,7 +57,7 @@ public:
 		types::mesh::surface_id_t top_right;
 		types::mesh::surface_id_t right_bottom;
 		types::mesh::surface_id_t bottom_left;
-		const types::Buffer Serialize() const;
+		void SerializeTo( types::Buffer& buf ) const;
 		void Unserialize( types::Buffer buf );
 	};
 
@@ -69,7 +69,7 @@ public:
 		tile_colors_t colors;
 		types::Vec2< types::mesh::coord_t > texture_stretch; // each tile has only one 'own' stretch value (for bottom vertex), others are copied from neighbours
 		bool texture_stretch_at_edges;
-		const types::Buffer Serialize() const;
+		void SerializeTo( types::Buffer& buf ) const;
 		void Unserialize( types::Buffer buf );
 	};
 
@@ -79,7 +79,7 @@ public:
 		elevation_t top;
 		elevation_t right;
 		elevation_t bottom;
-		const types::Buffer Serialize() const;
+		void SerializeTo( types::Buffer& buf ) const;
 		void Unserialize( types::Buffer buf );
 	};
 
@@ -119,14 +119,15 @@ public:
 	const types::Vec3& GetCenterCoords( tile_layer_type_t layer ) const;
 
 	const types::Buffer Serialize() const;
+	void SerializeTo( types::Buffer& buf ) const; // writes into existing buffer, i.e. as nested value
 	void Unserialize( types::Buffer buf );
 
 private:
-	static const types::Buffer SerializeTileVertices( const tile_vertices_t& vertices );
+	static void SerializeTileVertices( types::Buffer& buf, const tile_vertices_t& vertices );
 	static const tile_vertices_t UnserializeTileVertices( types::Buffer buf );
-	static const types::Buffer SerializeTileTexCoords( const tile_tex_coords_t& tex_coords );
+	static void SerializeTileTexCoords( types::Buffer& buf, const tile_tex_coords_t& tex_coords );
 	static const tile_tex_coords_t UnserializeTileTexCoords( types::Buffer buf );
-	static const types::Buffer SerializeTileColors( const tile_colors_t& colors );
+	static void SerializeTileColors( types::Buffer& buf, const tile_colors_t& colors );
 	static const tile_colors_t UnserializeTileColors( types::Buffer buf );
 };
 
@@ -1,10 +1,12 @@
 #include <cstring>
 #include <random>
+#include <type_traits>
 
 #include "Tiles.h"
 
 #include "util/Clamper.h"
 #include "util/random/Random.h"
+#include "util/crc32/CRC32.h"
 
 namespace game {
 namespace map {
@@ -31,136 +33,27 @@ void Tiles::Resize( const uint32_t width, const uint32_t height ) {
 		m_width = width;
 		m_height = height;
 
-		m_data.resize( width * height );
-		m_top_vertex_row.resize( m_width * 2 );
-		m_top_right_vertex_row.resize( width );
-
-		Tile* tile;
-		for ( auto y = 0 ; y < m_height ; y++ ) {
-			for ( auto x = y & 1 ; x < m_width ; x += 2 ) {
-				tile = &At( x, y );
-
-				// link to other tiles
-				tile->W = ( x >= 2 )
-					? &At( x - 2, y )
-					: &At( m_width - 1 - ( 1 - ( y % 2 ) ), y );
-				tile->NW = ( y >= 1 )
-					? ( ( x >= 1 )
-						? &At( x - 1, y - 1 )
-						: &At( m_width - 1, y - 1 )
-					)
-					: tile;
-				tile->N = ( y >= 2 )
-					? &At( x, y - 2 )
-					: tile;
-				tile->NE = ( y >= 1 )
-					? ( ( x < m_width - 1 )
-						? &At( x + 1, y - 1 )
-						: &At( 0, y - 1 )
-					)
-					: tile;
-				tile->E = ( x < m_width - 2 )
-					? &At( x + 2, y )
-					: &At( y % 2, y );
-				tile->SE = ( y < m_height - 1 )
-					? ( ( x < m_width - 1 )
-						? &At( x + 1, y + 1 )
-						: &At( 0, y + 1 )
-					)
-					: tile;
-				tile->S = ( y < m_height - 2 )
-					? &At( x, y + 2 )
-					: tile;
-				tile->SW = ( y < m_height - 1 )
-					? ( ( x >= 1 )
-						? &At( x - 1, y + 1 )
-						: &At( m_width - 1, y + 1 )
-					)
-					: tile;
-
-				tile->elevation.bottom = &tile->elevation_data.bottom;
-				tile->elevation.center = &tile->elevation_data.center;
-
-				if ( y >= 2 ) {
-					tile->elevation.top = tile->N->elevation.bottom;
-				}
-				else if ( y > 0 ) {
-					ASSERT( x > 0, "x is zero while y isn't" );
-					tile->elevation.top = AtConst( x - 1, y - 1 ).elevation.right;
-				}
-				else {
-					tile->elevation.top = TopVertexAt( x, y );
-				}
-
-				if ( x >= 2 ) {
-					tile->elevation.left = tile->W->elevation.right;
-				}
-
-				if ( y == 0 ) {
-					tile->elevation.right = TopRightVertexAt( x );
-				}
-				else if ( x < m_width - 1 ) {
-					tile->elevation.right = AtConst( x + 1, y - 1 ).elevation.bottom;
-				}
-			}
-
-			// link left edge to right edge and vice versa
-			if ( y % 2 ) {
-				At( m_width - 1, y ).elevation.right = ( y > 0
-					? AtConst( 0, y - 1 ).elevation.bottom
-					: TopRightVertexAt( 0 )
-				);
-			}
-			At( y % 2, y ).elevation.left = AtConst( m_width - 1 - ( 1 - ( y % 2 ) ), y ).elevation.right;
-
-		}
-
-		// add some state variables
-		for ( auto y = 0 ; y < m_height ; y++ ) {
-			for ( auto x = y & 1 ; x < m_width ; x += 2 ) {
-				tile = &At( x, y );
-
-#ifdef DEBUG
-				// check that all pointers are linked to something
-#define CHECKTILE( _what ) ASSERT( tile->_what, "tile " #_what " not linked at " + std::to_string( x ) + "x" + std::to_string( y ) );
-
-				CHECKTILE( W );
-				CHECKTILE( NW );
-				CHECKTILE( N );
-				CHECKTILE( NE );
-				CHECKTILE( E );
-				CHECKTILE( SE );
-				CHECKTILE( S );
-				CHECKTILE( SW );
-
-				CHECKTILE( elevation.left );
-				CHECKTILE( elevation.top );
-				CHECKTILE( elevation.right );
-
-#undef CHECKTILE
-#endif
-
-				tile->coord.x = x;
-				tile->coord.y = y;
-
-				// generate pointer vectors
-				tile->elevation.corners = {
-					tile->elevation.left,
-					tile->elevation.top,
-					tile->elevation.right,
-					tile->elevation.bottom,
-				};
-				tile->neighbours = {
-					tile->W,
-					tile->NW,
-					tile->N,
-					tile->NE,
-					tile->E,
-					tile->SE,
-					tile->S,
-					tile->SW,
-				};
-			}
+		// reallocate from scratch, tiles only keep map pointer and index so values don't need to be relinked
+		const size_t tiles_count = width * height / 2;
+		m_data = std::vector< Tile >( tiles_count );
+		m_center_elevations = std::vector< elevation_t >( tiles_count );
+		m_bottom_elevations = std::vector< elevation_t >( tiles_count );
+		m_moistures = std::vector< moisture_t >( tiles_count );
+		m_rockinesses = std::vector< rockiness_t >( tiles_count );
+		m_features = std::vector< feature_t >( tiles_count );
+		m_bonuses = std::vector< bonus_t >( tiles_count );
+		m_terraformings = std::vector< terraforming_t >( tiles_count );
+		m_is_water = std::vector< uint8_t >( tiles_count );
+		m_top_vertex_row = std::vector< elevation_t >( m_width * 2 );
+		m_top_right_vertex_row = std::vector< elevation_t >( width );
+		m_units.clear();
+		m_bases.clear();
+		m_lock_initiator_slots.clear();
+
+		for ( size_t index = 0 ; index < tiles_count ; index++ ) {
+			auto& tile = m_data.at( index );
+			tile.m_tiles = this;
+			tile.m_index = index;
 		}
 	}
 }
@@ -187,14 +80,14 @@ Tile& Tiles::At( const size_t x, const size_t y ) {
 	ASSERT( x < m_width, "invalid x tile coordinate ( " + std::to_string( x ) + " >= " + std::to_string( m_width ) + " )" );
 	ASSERT( y < m_height, "invalid y tile coordinate ( " + std::to_string( y ) + " >= " + std::to_string( m_height ) + " )" );
 	ASSERT( ( x % 2 ) == ( y % 2 ), "tile coordinate axis oddity differs" );
-	return m_data.at( y * m_width + x / 2 );
+	return m_data.at( GetIndex( x, y ) );
 }
 
 const Tile& Tiles::AtConst( const size_t x, const size_t y ) const {
 	ASSERT( x < m_width, "invalid x tile coordinate ( " + std::to_string( x ) + " >= " + std::to_string( m_width ) + " )" );
 	ASSERT( y < m_height, "invalid y tile coordinate ( " + std::to_string( y ) + " >= " + std::to_string( m_height ) + " )" );
 	ASSERT( ( x % 2 ) == ( y % 2 ), "tile coordinate axis oddity differs" );
-	return m_data.at( y * m_width + x / 2 );
+	return m_data.at( GetIndex( x, y ) );
 }
 
 const std::vector< Tile >* Tiles::GetTilesPtr() const {
@@ -213,6 +106,94 @@ elevation_t* Tiles::TopRightVertexAt( const size_t x ) {
 	return &m_top_right_vertex_row.at( x );
 }
 
+elevation_t* Tiles::GetCenterElevations() {
+	return m_center_elevations.data();
+}
+
+elevation_t* Tiles::GetBottomElevations() {
+	return m_bottom_elevations.data();
+}
+
+moisture_t* Tiles::GetMoistures() {
+	return m_moistures.data();
+}
+
+rockiness_t* Tiles::GetRockinesses() {
+	return m_rockinesses.data();
+}
+
+feature_t* Tiles::GetFeatures() {
+	return m_features.data();
+}
+
+const coords_t Tiles::GetNeighbourCoords( const size_t x, const size_t y, const direction_t direction ) const {
+	ASSERT( x < m_width && y < m_height, "invalid tile coordinates" );
+	// map wraps horizontally but not vertically
+	switch ( direction ) {
+		case D_NONE:
+			return { x, y };
+		case D_W:
+			return ( x >= 2 )
+				? coords_t{ x - 2, y }
+				: coords_t{ m_width - 1 - ( 1 - ( y % 2 ) ), y };
+		case D_NW:
+			return ( y >= 1 )
+				? ( ( x >= 1 )
+					? coords_t{ x - 1, y - 1 }
+					: coords_t{ m_width - 1, y - 1 }
+				)
+				: coords_t{ x, y };
+		case D_N:
+			return ( y >= 2 )
+				? coords_t{ x, y - 2 }
+				: coords_t{ x, y };
+		case D_NE:
+			return ( y >= 1 )
+				? ( ( x < m_width - 1 )
+					? coords_t{ x + 1, y - 1 }
+					: coords_t{ 0, y - 1 }
+				)
+				: coords_t{ x, y };
+		case D_E:
+			return ( x < m_width - 2 )
+				? coords_t{ x + 2, y }
+				: coords_t{ y % 2, y };
+		case D_SE:
+			return ( y < m_height - 1 )
+				? ( ( x < m_width - 1 )
+					? coords_t{ x + 1, y + 1 }
+					: coords_t{ 0, y + 1 }
+				)
+				: coords_t{ x, y };
+		case D_S:
+			return ( y < m_height - 2 )
+				? coords_t{ x, y + 2 }
+				: coords_t{ x, y };
+		case D_SW:
+			return ( y < m_height - 1 )
+				? ( ( x >= 1 )
+					? coords_t{ x - 1, y + 1 }
+					: coords_t{ m_width - 1, y + 1 }
+				)
+				: coords_t{ x, y };
+		default:
+			THROW( "unknown tile direction: " + std::to_string( direction ) );
+	}
+}
+
+const size_t Tiles::GetIndex( const size_t x, const size_t y ) const {
+	return ( y * m_width + x ) / 2; // width is always even
+}
+
+const coords_t Tiles::GetCoordsByIndex( const size_t index ) const {
+	// reverse of GetIndex, x has same oddity as y
+	const size_t y = index * 2 / m_width;
+	return {
+		index * 2 - y * m_width + ( y & 1 ),
+		y
+	};
+}
+
 void Tiles::Validate( MT_CANCELABLE ) {
 	if ( !m_is_validated ) {
 		Log( "Validating map" );
@@ -222,11 +203,11 @@ void Tiles::Validate( MT_CANCELABLE ) {
 			for ( auto x = y & 1 ; x < m_width ; x += 2 ) {
 				tile = &AtConst( x, y );
 
-				if ( tile->moisture > MOISTURE_RAINY ) {
-					Log( "tile moisture overflow ( " + std::to_string( tile->moisture ) + " > 3 ) at " + std::to_string( x ) + "x" + std::to_string( y ) );
+				if ( *tile->GetMoisture() > MOISTURE_RAINY ) {
+					Log( "tile moisture overflow ( " + std::to_string( *tile->GetMoisture() ) + " > 3 ) at " + std::to_string( x ) + "x" + std::to_string( y ) );
 				}
-				if ( tile->rockiness > ROCKINESS_ROCKY ) {
-					Log( "tile rockiness overflow ( " + std::to_string( tile->rockiness ) + " > 3 ) at " + std::to_string( x ) + "x" + std::to_string( y ) );
+				if ( *tile->GetRockiness() > ROCKINESS_ROCKY ) {
+					Log( "tile rockiness overflow ( " + std::to_string( *tile->GetRockiness() ) + " > 3 ) at " + std::to_string( x ) + "x" + std::to_string( y ) );
 				}
 
 				MT_RETIF();
@@ -251,13 +232,13 @@ void Tiles::FixTopBottomRows( util::random::Random* random ) {
 			: -1;
 		if ( x % 2 == 0 ) {
 			tile = &At( x, 0 );
-			*tile->elevation.left = *tile->elevation.right = top_bottom_elevation;
-			*tile->elevation.top = 0;
+			*tile->GetElevationLeft() = *tile->GetElevationRight() = top_bottom_elevation;
+			*tile->GetElevationTop() = 0;
 		}
 		else {
 			tile = &At( x, GetHeight() - 1 );
-			*tile->elevation.left = *tile->elevation.right = top_bottom_elevation;
-			*tile->elevation.bottom = 0;
+			*tile->GetElevationLeft() = *tile->GetElevationRight() = top_bottom_elevation;
+			*tile->GetElevationBottom() = 0;
 		}
 	}
 
@@ -275,7 +256,7 @@ void Tiles::FixTopBottomRows( util::random::Random* random ) {
 
 const std::vector< Tile* > Tiles::GetVector( MT_CANCELABLE ) {
 	std::vector< Tile* > tiles;
-	const size_t tiles_count = GetDataCount() / 2; // / 2 because SMAC coordinate system
+	const size_t tiles_count = GetDataCount();
 	tiles.reserve( tiles_count );
 	for ( size_t y = 0 ; y < m_height ; y++ ) {
 		for ( size_t x = y & 1 ; x < m_width ; x += 2 ) {
@@ -289,20 +270,45 @@ const std::vector< Tile* > Tiles::GetVector( MT_CANCELABLE ) {
 }
 
 const types::Buffer Tiles::Serialize() const {
-	types::Buffer buf;
+	return Serialize( types::Buffer::E_COMPACT );
+}
+
+const types::Buffer Tiles::Serialize( const types::Buffer::encoding_t encoding ) const {
+	types::Buffer buf( encoding );
+	SerializeTo( buf );
+	return buf;
+}
+
+void Tiles::SerializeNested( types::Buffer& buf, const types::Buffer::encoding_t encoding ) const {
+	if ( buf.GetEncoding() == encoding ) {
+		buf.WriteNested(
+			[ this ]( types::Buffer& b ) {
+				SerializeTo( b );
+			}
+		);
+	}
+	else {
+		// different encoding needs separate buffer
+		buf.WriteString( Serialize( encoding ).ToStringView() );
+	}
+}
+
+void Tiles::SerializeTo( types::Buffer& buf ) const {
 
 	buf.WriteInt( m_width );
 	buf.WriteInt( m_height );
 
 	for ( auto y = 0 ; y < m_height ; y++ ) {
 		for ( auto x = y & 1 ; x < m_width ; x += 2 ) {
-			buf.WriteString( AtConst( x, y ).Serialize().ToString() );
+			buf.WriteNested(
+				[ this, x, y ]( types::Buffer& b ) {
+					AtConst( x, y ).SerializeTo( b );
+				}
+			);
 		}
 	}
 
 	buf.WriteBool( m_is_validated );
-
-	return buf;
 }
 
 void Tiles::Unserialize( types::Buffer buf ) {
@@ -315,7 +321,7 @@ void Tiles::Unserialize( types::Buffer buf ) {
 
 	for ( auto y = 0 ; y < m_height ; y++ ) {
 		for ( auto x = y & 1 ; x < m_width ; x += 2 ) {
-			At( x, y ).Unserialize( types::Buffer( buf.ReadString() ) );
+			At( x, y ).Unserialize( buf.ReadNested() );
 		}
 	}
 
@@ -327,6 +333,215 @@ void Tiles::Unserialize( types::Buffer buf ) {
 
 }
 
+/*
+ * Compact map file format (all values are little-endian regardless of host, see WriteLE and ReadLE):
+ *   header ( 32 bytes: magic, then version, width, height, tiles count, flags, checksum and reserved as uint32 )
+ *   top vertex row elevations ( int16 x width * 2 )
+ *   top right vertex row elevations ( int16 x width )
+ *   bottom elevations ( int16 x tiles )
+ *   moisture ( uint8 x tiles )
+ *   rockiness ( uint8 x tiles )
+ *   bonus ( uint8 x tiles )
+ *   features ( uint16 x tiles )
+ *   terraforming ( uint16 x tiles )
+ * Tiles are stored in row order, every vertex is stored only once because left, top and right corners are linked to bottoms of other tiles or to top rows.
+ * Checksum is crc32 of whole file with checksum field set to 0.
+ */
+
+static constexpr char COMPACT_MAGIC[ 4 ] = { 'G', 'S', 'M', '2' };
+static constexpr uint32_t COMPACT_VERSION = 2;
+
+struct compact_header_t {
+	char magic[ 4 ];
+	uint32_t version;
+	uint32_t width;
+	uint32_t height;
+	uint32_t tiles_count;
+	uint32_t flags; // reserved
+	uint32_t checksum;
+	uint32_t reserved;
+};
+static constexpr size_t COMPACT_HEADER_SIZE = 32;
+static constexpr size_t COMPACT_CHECKSUM_OFFSET = 24;
+
+// values are assembled byte by byte so that files are same on any host, compilers turn these into plain loads and stores on little-endian ones
+template< typename T >
+static void WriteLE( unsigned char* data, size_t& offset, const T value ) {
+	const typename std::make_unsigned< T >::type v = value;
+	for ( size_t i = 0 ; i < sizeof( T ) ; i++ ) {
+		data[ offset++ ] = ( v >> ( i * 8 ) ) & 0xff;
+	}
+}
+
+template< typename T >
+static const T ReadLE( const unsigned char* data, size_t& offset ) {
+	typename std::make_unsigned< T >::type v = 0;
+	for ( size_t i = 0 ; i < sizeof( T ) ; i++ ) {
+		v |= (typename std::make_unsigned< T >::type)data[ offset++ ] << ( i * 8 );
+	}
+	return (T)v;
+}
+
+static void WriteHeader( unsigned char* data, const compact_header_t& header ) {
+	memcpy( data, header.magic, sizeof( header.magic ) );
+	size_t offset = sizeof( header.magic );
+	WriteLE( data, offset, header.version );
+	WriteLE( data, offset, header.width );
+	WriteLE( data, offset, header.height );
+	WriteLE( data, offset, header.tiles_count );
+	WriteLE( data, offset, header.flags );
+	ASSERT_NOLOG( offset == COMPACT_CHECKSUM_OFFSET, "compact map checksum offset mismatch" );
+	WriteLE( data, offset, header.checksum );
+	WriteLE( data, offset, header.reserved );
+	ASSERT_NOLOG( offset == COMPACT_HEADER_SIZE, "compact map header size mismatch" );
+}
+
+static const compact_header_t ReadHeader( const unsigned char* data ) {
+	compact_header_t header;
+	memcpy( header.magic, data, sizeof( header.magic ) );
+	size_t offset = sizeof( header.magic );
+	header.version = ReadLE< uint32_t >( data, offset );
+	header.width = ReadLE< uint32_t >( data, offset );
+	header.height = ReadLE< uint32_t >( data, offset );
+	header.tiles_count = ReadLE< uint32_t >( data, offset );
+	header.flags = ReadLE< uint32_t >( data, offset );
+	header.checksum = ReadLE< uint32_t >( data, offset );
+	header.reserved = ReadLE< uint32_t >( data, offset );
+	return header;
+}
+
+static const size_t GetCompactSize( const uint32_t width, const uint32_t height ) {
+	const size_t tiles_count = (size_t)width * height / 2;
+	return COMPACT_HEADER_SIZE +
+		( width * 2 + width + tiles_count ) * sizeof( int16_t ) + // elevations
+		tiles_count * ( sizeof( moisture_t ) + sizeof( rockiness_t ) + sizeof( bonus_t ) + sizeof( feature_t ) + sizeof( terraforming_t ) );
+}
+
+const bool Tiles::IsCompactFormat( const unsigned char* data, const size_t size ) {
+	return size >= COMPACT_HEADER_SIZE && !memcmp( data, COMPACT_MAGIC, sizeof( COMPACT_MAGIC ) );
+}
+
+const std::string Tiles::SerializeCompact() const {
+	ASSERT( m_width && m_height, "tiles not initialized" );
+
+	std::string result;
+	result.resize( GetCompactSize( m_width, m_height ) );
+	auto* data = (unsigned char*)result.data();
+
+	compact_header_t header = {};
+	memcpy( header.magic, COMPACT_MAGIC, sizeof( COMPACT_MAGIC ) );
+	header.version = COMPACT_VERSION;
+	header.width = m_width;
+	header.height = m_height;
+	header.tiles_count = m_width * m_height / 2;
+	WriteHeader( data, header );
+	size_t offset = COMPACT_HEADER_SIZE;
+
+	const auto f_write_elevation = [ &data, &offset ]( const elevation_t elevation ) {
+		if ( elevation < INT16_MIN || elevation > INT16_MAX ) {
+			THROW( "elevation out of range ( " + std::to_string( elevation ) + " )" );
+		}
+		WriteLE< int16_t >( data, offset, elevation );
+	};
+	for ( const auto& elevation : m_top_vertex_row ) {
+		f_write_elevation( elevation );
+	}
+	for ( const auto& elevation : m_top_right_vertex_row ) {
+		f_write_elevation( elevation );
+	}
+	for ( const auto& elevation : m_bottom_elevations ) {
+		f_write_elevation( elevation );
+	}
+
+	// packed arrays are in file order
+#define P( _values ) \
+	for ( const auto& value : _values ) { \
+		WriteLE( data, offset, value ); \
+	}
+	P( m_moistures );
+	P( m_rockinesses );
+	P( m_bonuses );
+	P( m_features );
+	P( m_terraformings );
+#undef P
+
+	ASSERT( offset == result.size(), "compact map size mismatch" );
+
+	header.checksum = util::crc32::CRC32::Calculate( data, result.size() );
+	WriteHeader( data, header );
+
+	return result;
+}
+
+void Tiles::UnserializeCompact( const unsigned char* data, const size_t size ) {
+	if ( !IsCompactFormat( data, size ) ) {
+		THROW( "not a compact map file" );
+	}
+
+	const auto header = ReadHeader( data );
+	if ( header.version != COMPACT_VERSION ) {
+		THROW( "unsupported map file version ( " + std::to_string( header.version ) + " )" );
+	}
+	if (
+		!header.width || !header.height ||
+			( header.width & 1 ) || ( header.height & 1 ) ||
+			header.tiles_count != header.width * header.height / 2 ||
+			size != GetCompactSize( header.width, header.height )
+		) {
+		THROW( "map file size mismatch" );
+	}
+
+	{
+		// checksum is calculated with checksum field zeroed
+		unsigned char zeroed[ COMPACT_HEADER_SIZE ];
+		memcpy( zeroed, data, COMPACT_HEADER_SIZE );
+		memset( zeroed + COMPACT_CHECKSUM_OFFSET, 0, sizeof( header.checksum ) );
+		auto crc = util::crc32::CRC32::Calculate( zeroed, COMPACT_HEADER_SIZE );
+		crc = util::crc32::CRC32::Calculate( data + COMPACT_HEADER_SIZE, size - COMPACT_HEADER_SIZE, crc );
+		if ( crc != header.checksum ) {
+			THROW( "map file checksum mismatch" );
+		}
+	}
+
+	m_width = m_height = 0;
+	Resize( header.width, header.height );
+
+	size_t offset = COMPACT_HEADER_SIZE;
+
+	const auto f_read_elevation = [ &data, &offset ]() -> elevation_t {
+		return ReadLE< int16_t >( data, offset );
+	};
+	for ( auto& elevation : m_top_vertex_row ) {
+		elevation = f_read_elevation();
+	}
+	for ( auto& elevation : m_top_right_vertex_row ) {
+		elevation = f_read_elevation();
+	}
+	for ( auto& elevation : m_bottom_elevations ) {
+		elevation = f_read_elevation();
+	}
+
+	// packed arrays are in file order
+#define P( _values ) \
+	for ( auto& value : _values ) { \
+		value = ReadLE< std::remove_reference< decltype( value ) >::type >( data, offset ); \
+	}
+	P( m_moistures );
+	P( m_rockinesses );
+	P( m_bonuses );
+	P( m_features );
+	P( m_terraformings );
+#undef P
+
+	ASSERT( offset == size, "compact map size mismatch" );
+
+	for ( auto y = 0 ; y < m_height ; y++ ) {
+		for ( auto x = y & 1 ; x < m_width ; x += 2 ) {
+			At( x, y ).Update();
+		}
+	}
+}
+
 }
 }
 }
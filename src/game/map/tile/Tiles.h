@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
 
 #include "types/Serializable.h"
 
@@ -35,6 +36,16 @@ CLASS( Tiles, types::Serializable )
 	elevation_t* TopVertexAt( const size_t x, const size_t y );
 	elevation_t* TopRightVertexAt( const size_t x );
 
+	// contiguous per-tile elevations, in same order as tiles (row by row)
+	elevation_t* GetCenterElevations();
+	elevation_t* GetBottomElevations();
+	moisture_t* GetMoistures();
+	rockiness_t* GetRockinesses();
+	feature_t* GetFeatures();
+
+	// computed from coordinates, used by Tile neighbour getters ( tile itself is returned at north and south edges )
+	const coords_t GetNeighbourCoords( const size_t x, const size_t y, const direction_t direction ) const;
+
 	void Validate( MT_CANCELABLE );
 
 	const size_t GetDataCount() const;
@@ -43,16 +54,43 @@ CLASS( Tiles, types::Serializable )
 
 	const std::vector< Tile* > GetVector( MT_CANCELABLE );
 
-	const types::Buffer Serialize() const override;
+	// unserializing detects encoding automatically
+	const types::Buffer Serialize() const override; // compact
+	const types::Buffer Serialize( const types::Buffer::encoding_t encoding ) const;
+	void SerializeTo( types::Buffer& buf ) const; // writes into existing buffer, i.e. as nested value
+	void SerializeNested( types::Buffer& buf, const types::Buffer::encoding_t encoding ) const; // writes as nested value in given encoding
 	void Unserialize( types::Buffer buf ) override;
 
+	// compact columnar format for map files (see Tiles.cpp for layout)
+	static const bool IsCompactFormat( const unsigned char* data, const size_t size );
+	const std::string SerializeCompact() const;
+	void UnserializeCompact( const unsigned char* data, const size_t size );
+
 private:
+	friend class Tile;
+
 	uint32_t m_width = 0;
 	uint32_t m_height = 0;
 
 	std::vector< elevation_t > m_top_vertex_row = {};
 	std::vector< elevation_t > m_top_right_vertex_row = {};
-	std::vector< Tile > m_data = {};
+	std::vector< Tile > m_data = {}; // tiles only exist where x and y have same oddity, so only these are stored
+	std::vector< elevation_t > m_center_elevations = {};
+	std::vector< elevation_t > m_bottom_elevations = {};
+	std::vector< moisture_t > m_moistures = {};
+	std::vector< rockiness_t > m_rockinesses = {};
+	std::vector< feature_t > m_features = {};
+	std::vector< bonus_t > m_bonuses = {};
+	std::vector< terraforming_t > m_terraformings = {};
+	std::vector< uint8_t > m_is_water = {}; // not bool to keep tiles independent when updated from different threads
+
+	// sparse per-tile data, keyed by tile index
+	std::unordered_map< size_t, std::map< size_t, unit::Unit* > > m_units = {};
+	std::unordered_map< size_t, base::Base* > m_bases = {};
+	std::unordered_map< size_t, size_t > m_lock_initiator_slots = {};
+
+	const size_t GetIndex( const size_t x, const size_t y ) const;
+	const coords_t GetCoordsByIndex( const size_t index ) const;
 
 	bool m_is_validated = false;
 
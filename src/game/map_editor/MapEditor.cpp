@@ -76,7 +76,7 @@ const bool MapEditor::IsEnabled() const {
 
 const tiles_t MapEditor::Draw( map::tile::Tile* tile, const draw_mode_t mode ) {
 	if ( IsEnabled() && mode != DM_NONE && m_active_tool && m_active_brush ) {
-		Log( "Drawing at " + tile->coord.ToString() + " with brush " + std::to_string( GetActiveBrushType() ) + " tool " + std::to_string( GetActiveToolType() ) );
+		Log( "Drawing at " + tile->GetCoords().ToString() + " with brush " + std::to_string( GetActiveBrushType() ) + " tool " + std::to_string( GetActiveToolType() ) );
 		tiles_t tiles_to_reload = {};
 		const tiles_t tiles_to_draw = GetUniqueTiles( m_active_brush->Draw( tile ) );
 		for ( auto& t : tiles_to_draw ) {
@@ -48,26 +48,26 @@ const tiles_t Square::Draw( map::tile::Tile* center_tile ) {
 
 			f_add_tile_maybe(
 				{
-					(ssize_t)center_tile->coord.x + x,
-					(ssize_t)center_tile->coord.y - y
+					(ssize_t)center_tile->GetCoords().x + x,
+					(ssize_t)center_tile->GetCoords().y - y
 				}
 			);
 			f_add_tile_maybe(
 				{
-					(ssize_t)center_tile->coord.x - x,
-					(ssize_t)center_tile->coord.y + y
+					(ssize_t)center_tile->GetCoords().x - x,
+					(ssize_t)center_tile->GetCoords().y + y
 				}
 			);
 			f_add_tile_maybe(
 				{
-					(ssize_t)center_tile->coord.x + x,
-					(ssize_t)center_tile->coord.y + y
+					(ssize_t)center_tile->GetCoords().x + x,
+					(ssize_t)center_tile->GetCoords().y + y
 				}
 			);
 			f_add_tile_maybe(
 				{
-					(ssize_t)center_tile->coord.x - x,
-					(ssize_t)center_tile->coord.y - y
+					(ssize_t)center_tile->GetCoords().x - x,
+					(ssize_t)center_tile->GetCoords().y - y
 				}
 			);
 		}
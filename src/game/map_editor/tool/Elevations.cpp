@@ -17,7 +17,7 @@ Elevations::Elevations( Game* game )
 const tiles_t Elevations::Draw( map::tile::Tile* tile, const draw_mode_t mode ) {
 	tiles_t tiles_to_reload = {};
 
-	if ( tile->coord.y > 1 && tile->coord.y < m_game->GetMap()->GetHeight() - 2 ) { // editing poles will screw things up
+	if ( tile->GetCoords().y > 1 && tile->GetCoords().y < m_game->GetMap()->GetHeight() - 2 ) { // editing poles will screw things up
 
 		map::tile::elevation_t elevation, change;
 
@@ -35,9 +35,9 @@ const tiles_t Elevations::Draw( map::tile::Tile* tile, const draw_mode_t mode )
 				else if ( mode == DM_INC ) {
 					elevation = std::min< map::tile::elevation_t >( map::tile::ELEVATION_MAX, elevation + change );
 				}
-				for ( auto& n : tile->neighbours ) {
-					elevation = std::min< map::tile::elevation_t >( elevation, *n->elevation.center + el );
-					elevation = std::max< map::tile::elevation_t >( elevation, *n->elevation.center - el );
+				for ( auto& n : tile->GetNeighbours() ) {
+					elevation = std::min< map::tile::elevation_t >( elevation, *n->GetElevationCenter() + el );
+					elevation = std::max< map::tile::elevation_t >( elevation, *n->GetElevationCenter() - el );
 				}
 				if ( mode == DM_DEC ) {
 					*corner = std::min< map::tile::elevation_t >( *corner, elevation );
@@ -47,23 +47,23 @@ const tiles_t Elevations::Draw( map::tile::Tile* tile, const draw_mode_t mode )
 				}
 			};
 
-		f_change_corner( tile->elevation.left );
-		f_change_corner( tile->elevation.top );
-		f_change_corner( tile->elevation.right );
-		f_change_corner( tile->elevation.bottom );
+		f_change_corner( tile->GetElevationLeft() );
+		f_change_corner( tile->GetElevationTop() );
+		f_change_corner( tile->GetElevationRight() );
+		f_change_corner( tile->GetElevationBottom() );
 
 		tile->Update();
 
 		// tile can be either full-underwater or full-land
-		for ( auto& corner : tile->elevation.corners ) {
-			if ( *tile->elevation.center > 0 != *corner > 0 ) {
+		for ( auto& corner : tile->GetElevationCorners() ) {
+			if ( *tile->GetElevationCenter() > 0 != *corner > 0 ) {
 				*corner = -*corner;
 			}
 		}
 		tile->Update();
 
 		// update neighbour tiles because they share some corners
-		for ( auto& n : tile->neighbours ) {
+		for ( auto& n : tile->GetNeighbours() ) {
 			n->Update();
 		}
 
@@ -71,30 +71,30 @@ const tiles_t Elevations::Draw( map::tile::Tile* tile, const draw_mode_t mode )
 		// TODO: reduce based on some conditions
 		tiles_to_reload = {
 			tile,
-			tile->W,
-			tile->W->SW,
-			tile->W->W,
-			tile->W->NW,
-			tile->NW,
-			tile->NW->NW,
-			tile->N,
-			tile->N->NW,
-			tile->N->N,
-			tile->N->NE,
-			tile->NE,
-			tile->NE->NE,
-			tile->E,
-			tile->E->NE,
-			tile->E->E,
-			tile->E->SE,
-			tile->SE,
-			tile->SE->SE,
-			tile->S,
-			tile->S->SE,
-			tile->S->S,
-			tile->S->SW,
-			tile->SW,
-			tile->SW->SW
+			tile->W(),
+			tile->W()->SW(),
+			tile->W()->W(),
+			tile->W()->NW(),
+			tile->NW(),
+			tile->NW()->NW(),
+			tile->N(),
+			tile->N()->NW(),
+			tile->N()->N(),
+			tile->N()->NE(),
+			tile->NE(),
+			tile->NE()->NE(),
+			tile->E(),
+			tile->E()->NE(),
+			tile->E()->E(),
+			tile->E()->SE(),
+			tile->SE(),
+			tile->SE()->SE(),
+			tile->S(),
+			tile->S()->SE(),
+			tile->S()->S(),
+			tile->S()->SW(),
+			tile->SW(),
+			tile->SW()->SW()
 		};
 	}
 
@@ -14,35 +14,20 @@ Feature::Feature( Game* game, const tool_type_t type, const map::tile::feature_t
 
 const tiles_t Feature::Draw( map::tile::Tile* tile, const draw_mode_t mode ) {
 	if ( mode == DM_DEC ) {
-		if ( !( tile->features & m_feature ) ) {
+		if ( !( *tile->GetFeatures() & m_feature ) ) {
 			return {}; // already unset
 		}
-		tile->features &= ~m_feature;
+		*tile->GetFeatures() &= ~m_feature;
 	}
 	else if ( mode == DM_INC ) {
-		if ( tile->features & m_feature ) {
+		if ( *tile->GetFeatures() & m_feature ) {
 			return {}; // already set
 		}
-		tile->features |= m_feature;
+		*tile->GetFeatures() |= m_feature;
 	}
 
-	// some features will alter surrounding tiles, others won't
-	if ( m_feature & ( map::tile::FEATURE_JUNGLE | map::tile::FEATURE_RIVER | map::tile::FEATURE_XENOFUNGUS ) ) {
-		return {
-			tile,
-			tile->W,
-			tile->NW,
-			tile->N,
-			tile->NE,
-			tile->E,
-			tile->SE,
-			tile->S,
-			tile->SW,
-		};
-	}
-	else {
-		return { tile };
-	}
+	// surrounding tiles that are altered by it ( i.e. connecting rivers ) are regenerated with map's neighbour ring
+	return { tile };
 }
 
 }
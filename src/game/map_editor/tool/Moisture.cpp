@@ -14,29 +14,30 @@ Moisture::Moisture( Game* game )
 
 const tiles_t Moisture::Draw( map::tile::Tile* tile, const draw_mode_t mode ) {
 	if ( mode == DM_DEC ) {
-		if ( tile->moisture <= map::tile::MOISTURE_ARID ) {
+		if ( *tile->GetMoisture() <= map::tile::MOISTURE_ARID ) {
 			return {}; // can't decrease further
 		}
-		tile->moisture--;
+		( *tile->GetMoisture() )--;
 	}
 	else if ( mode == DM_INC ) {
-		if ( tile->moisture >= map::tile::MOISTURE_RAINY ) {
+		if ( *tile->GetMoisture() >= map::tile::MOISTURE_RAINY ) {
 			return {}; // can't increase further
 		}
-		tile->moisture++;
+		( *tile->GetMoisture() )++;
 	}
 
 	// we need to reload surrounding tiles too because they need to blend correctly
+	// ( moisture textures are picked by looking at neighbours in pass that neighbour ring of map reload skips )
 	return {
 		tile,
-		tile->W,
-		tile->NW,
-		tile->N,
-		tile->NE,
-		tile->E,
-		tile->SE,
-		tile->S,
-		tile->SW,
+		tile->W(),
+		tile->NW(),
+		tile->N(),
+		tile->NE(),
+		tile->E(),
+		tile->SE(),
+		tile->S(),
+		tile->SW(),
 	};
 }
 
@@ -13,18 +13,18 @@ Resource::Resource( Game* game )
 
 const tiles_t Resource::Draw( map::tile::Tile* tile, const draw_mode_t mode ) {
 	if ( mode == DM_DEC ) {
-		if ( tile->bonus == map::tile::BONUS_NONE ) {
+		if ( *tile->GetBonus() == map::tile::BONUS_NONE ) {
 			return {}; // nothing to remove
 		}
-		tile->bonus = map::tile::BONUS_NONE;
+		*tile->GetBonus() = map::tile::BONUS_NONE;
 	}
 	else if ( mode == DM_INC ) {
 		// rotate
-		if ( tile->bonus == map::tile::BONUS_MINERALS ) {
-			tile->bonus = map::tile::BONUS_NUTRIENT;
+		if ( *tile->GetBonus() == map::tile::BONUS_MINERALS ) {
+			*tile->GetBonus() = map::tile::BONUS_NUTRIENT;
 		}
 		else {
-			tile->bonus++;
+			( *tile->GetBonus() )++;
 		}
 	}
 
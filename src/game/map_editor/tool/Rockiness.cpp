@@ -13,30 +13,20 @@ Rockiness::Rockiness( Game* game )
 
 const tiles_t Rockiness::Draw( map::tile::Tile* tile, const draw_mode_t mode ) {
 	if ( mode == DM_DEC ) {
-		if ( tile->rockiness <= map::tile::ROCKINESS_FLAT ) {
+		if ( *tile->GetRockiness() <= map::tile::ROCKINESS_FLAT ) {
 			return {}; // can't decrease further
 		}
-		tile->rockiness--;
+		( *tile->GetRockiness() )--;
 	}
 	else if ( mode == DM_INC ) {
-		if ( tile->rockiness >= map::tile::ROCKINESS_ROCKY ) {
+		if ( *tile->GetRockiness() >= map::tile::ROCKINESS_ROCKY ) {
 			return {}; // can't increase further
 		}
-		tile->rockiness++;
+		( *tile->GetRockiness() )++;
 	}
 
-	// we need to reload surrounding tiles too because they need to blend correctly
-	return {
-		tile,
-		tile->W,
-		tile->NW,
-		tile->N,
-		tile->NE,
-		tile->E,
-		tile->SE,
-		tile->S,
-		tile->SW,
-	};
+	// surrounding tiles blend with it in modules that read neighbours, map reloads those for neighbour ring by itself
+	return { tile };
 }
 
 }
@@ -17,13 +17,13 @@ const types::Buffer Rules::Serialize() const {
 	for ( auto& id : m_factions_order ) {
 		const auto& faction = m_factions.at( id );
 		buf.WriteString( id );
-		buf.WriteString( faction.Serialize().ToString() );
+		buf.WriteString( faction.Serialize().ToStringView() );
 	}
 
 	buf.WriteInt( m_difficulty_levels.size() );
 	for ( auto& difficulty_level : m_difficulty_levels ) {
 		buf.WriteInt( difficulty_level.first );
-		buf.WriteString( difficulty_level.second.Serialize().ToString() );
+		buf.WriteString( difficulty_level.second.Serialize().ToStringView() );
 	}
 
 	return buf;
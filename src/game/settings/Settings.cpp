@@ -41,9 +41,9 @@ void GlobalSettings::Initialize() {
 const types::Buffer GlobalSettings::Serialize() const {
 	types::Buffer buf;
 
-	buf.WriteString( map.Serialize().ToString() );
-	buf.WriteString( game_rules.Serialize().ToString() );
-	buf.WriteString( global_difficulty.Serialize().ToString() );
+	buf.WriteString( map.Serialize().ToStringView() );
+	buf.WriteString( game_rules.Serialize().ToStringView() );
+	buf.WriteString( global_difficulty.Serialize().ToStringView() );
 	buf.WriteString( game_name );
 
 	return buf;
@@ -79,15 +79,15 @@ void LocalSettings::Unserialize( types::Buffer buf ) {
 const types::Buffer Settings::Serialize() const {
 	types::Buffer buf;
 
-	buf.WriteString( global.Serialize().ToString() );
-	buf.WriteString( local.Serialize().ToString() );
+	buf.WriteString( global.Serialize().ToStringView() );
+	buf.WriteString( local.Serialize().ToStringView() );
 
 	return buf;
 }
 
 void Settings::Unserialize( types::Buffer buf ) {
-	global.Unserialize( types::Buffer( buf.ReadString() ) );
-	local.Unserialize( types::Buffer( buf.ReadString() ) );
+	global.Unserialize( types::Buffer( buf.ReadStringView() ) );
+	local.Unserialize( types::Buffer( buf.ReadStringView() ) );
 }
 
 }
@@ -135,7 +135,7 @@ const types::Buffer Slot::Serialize() const {
 
 	buf.WriteInt( m_slot_state );
 	if ( m_slot_state == SS_PLAYER ) {
-		buf.WriteString( m_player_data.player->Serialize().ToString() );
+		buf.WriteString( m_player_data.player->Serialize().ToStringView() );
 		// not sending cid
 		// not sending remote address
 		buf.WriteInt( m_player_data.flags );
@@ -45,7 +45,7 @@ const types::Buffer Slots::Serialize() const {
 	buf.WriteInt( m_slots.size() );
 
 	for ( auto& slot : m_slots ) {
-		buf.WriteString( slot.Serialize().ToString() );
+		buf.WriteString( slot.Serialize().ToStringView() );
 	}
 
 	return buf;
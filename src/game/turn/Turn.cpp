@@ -28,7 +28,12 @@ void Turn::AdvanceTurn( const size_t turn_id ) {
 const util::crc32::crc_t Turn::FinalizeAndChecksum() {
 	ASSERT_NOLOG( m_is_active, "turn not active" );
 	m_is_active = false;
-	return util::crc32::CRC32::CalculateFromBuffer( event::Event::SerializeMultiple( m_events ) );
+	// event by event, so that whole list is never serialized at once
+	util::crc32::crc_t crc = 0;
+	for ( const auto& event : m_events ) {
+		crc = util::crc32::CRC32::CalculateFromBuffer( event::Event::Serialize( event ), crc );
+	}
+	return crc;
 }
 
 void Turn::AddEvent( event::Event* event ) {
@@ -21,7 +21,7 @@ Def::Def( const std::string& id, const MoraleSet* moraleset, const def_type_t ty
 const types::Buffer Def::Serialize( const Def* def ) {
 	types::Buffer buf;
 	buf.WriteString( def->m_id );
-	buf.WriteString( MoraleSet::Serialize( def->m_moraleset ).ToString() );
+	buf.WriteString( MoraleSet::Serialize( def->m_moraleset ).ToStringView() );
 	buf.WriteString( def->m_name );
 	buf.WriteInt( def->m_type );
 	switch ( def->m_type ) {
@@ -37,7 +37,7 @@ const types::Buffer Def::Serialize( const Def* def ) {
 
 Def* Def::Unserialize( types::Buffer& buf ) {
 	const auto id = buf.ReadString();
-	auto moralesetbuf = types::Buffer( buf.ReadString() );
+	auto moralesetbuf = types::Buffer( buf.ReadStringView() );
 	const auto* moraleset = MoraleSet::Unserialize( moralesetbuf );
 	const auto name = buf.ReadString();
 	const auto type = (def_type_t)buf.ReadInt();
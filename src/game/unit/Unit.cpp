@@ -65,10 +65,10 @@ const std::string& Unit::GetMoraleString() const {
 
 void Unit::SetTile( map::tile::Tile* tile ) {
 	if ( m_tile ) {
-		m_tile->units.erase( m_id );
+		m_tile->GetUnits().erase( m_id );
 	}
-	ASSERT_NOLOG( tile->units.find( m_id ) == tile->units.end(), "duplicate unit id in tile" );
-	tile->units.insert(
+	ASSERT_NOLOG( tile->GetUnits().find( m_id ) == tile->GetUnits().end(), "duplicate unit id in tile" );
+	tile->GetUnits().insert(
 		{
 			m_id,
 			this
@@ -81,10 +81,10 @@ void Unit::SetTile( map::tile::Tile* tile ) {
 const types::Buffer Unit::Serialize( const Unit* unit ) {
 	types::Buffer buf;
 	buf.WriteInt( unit->m_id );
-	buf.WriteString( Def::Serialize( unit->m_def ).ToString() );
+	buf.WriteString( Def::Serialize( unit->m_def ).ToStringView() );
 	buf.WriteInt( unit->m_owner->GetIndex() );
-	buf.WriteInt( unit->m_tile->coord.x );
-	buf.WriteInt( unit->m_tile->coord.y );
+	buf.WriteInt( unit->m_tile->GetCoords().x );
+	buf.WriteInt( unit->m_tile->GetCoords().y );
 	buf.WriteFloat( unit->m_movement );
 	buf.WriteInt( unit->m_morale );
 	buf.WriteFloat( unit->m_health );
@@ -94,7 +94,7 @@ const types::Buffer Unit::Serialize( const Unit* unit ) {
 
 Unit* Unit::Unserialize( types::Buffer& buf, Game* game ) {
 	const auto id = buf.ReadInt();
-	auto defbuf = types::Buffer( buf.ReadString() );
+	auto defbuf = types::Buffer( buf.ReadStringView() );
 	auto* def = Def::Unserialize( defbuf );
 	auto* slot = game ? &game->GetState()->m_slots->GetSlot( buf.ReadInt() ) : nullptr;
 	const auto pos_x = buf.ReadInt();
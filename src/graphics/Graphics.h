@@ -13,6 +13,7 @@ typedef std::function< void( const float aspect_ratio ) > on_resize_handler_t;
 
 namespace types::texture {
 class Texture;
+class PagedTexture;
 }
 
 namespace scene {
@@ -39,6 +40,8 @@ CLASS( Graphics, common::Module )
 	virtual void LoadTexture( types::texture::Texture* texture ) = 0;
 	virtual void UnloadTexture( const types::texture::Texture* texture ) = 0;
 	virtual void EnableTexture( const types::texture::Texture* texture ) = 0;
+	// composites and loads page first if it's not loaded or outdated
+	virtual void EnableTexturePage( const types::texture::PagedTexture* texture, const size_t page ) = 0;
 	virtual void DisableTexture() = 0;
 
 	virtual const bool IsFullscreen() const = 0;
@@ -19,6 +19,7 @@ CLASS( Null, Graphics )
 	void LoadTexture( types::texture::Texture* texture ) override {};
 	void UnloadTexture( const types::texture::Texture* texture ) override {};
 	void EnableTexture( const types::texture::Texture* texture ) override {};
+	void EnableTexturePage( const types::texture::PagedTexture* texture, const size_t page ) override {};
 	void DisableTexture() override {};
 
 	const bool IsFullscreen() const override { return false; }
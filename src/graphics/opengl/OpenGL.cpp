@@ -13,6 +13,7 @@
 #include "routine/World.h"
 #include "FBO.h"
 #include "types/texture/Texture.h"
+#include "types/texture/PagedTexture.h"
 
 namespace graphics {
 namespace opengl {
@@ -187,6 +188,17 @@ void OpenGL::Stop() {
 	}
 	m_textures.clear();
 
+	for ( auto& it : m_texture_pages ) {
+		glDeleteTextures( 1, &it.second.obj );
+	}
+	m_texture_pages.clear();
+	m_texture_pages_lru.clear();
+	m_texture_pages_size = 0;
+	if ( m_texture_page_bitmap ) {
+		DELETE( m_texture_page_bitmap );
+		m_texture_page_bitmap = nullptr;
+	}
+
 	SDL_GL_DeleteContext( m_gl_context );
 
 	Log( "Destroying window" );
@@ -221,6 +233,8 @@ void OpenGL::Iterate() {
 		THROW( "OpenGL error occured in render loop, aborting" );
 	}
 
+	m_frame++;
+
 	Unlock();
 
 	DEBUG_STAT_INC( frames_rendered );
@@ -289,6 +303,10 @@ void OpenGL::OnWindowResize() {
 void OpenGL::LoadTexture( types::texture::Texture* texture ) {
 	ASSERT( texture, "texture is null" );
 
+	if ( texture->m_is_paged ) {
+		return; // pages are loaded when they are enabled
+	}
+
 	bool is_reload_needed = false;
 
 	const size_t texture_update_counter = texture->UpdatedCount();
@@ -322,151 +340,91 @@ void OpenGL::LoadTexture( types::texture::Texture* texture ) {
 
 		glBindTexture( GL_TEXTURE_2D, t.obj );
 
+		// texture may be updated from other thread meanwhile, so take areas at once
+		const auto updated_areas = texture->TakeUpdatedAreas();
+		const auto published_areas = texture->TakePublishedAreas();
+
 		if ( need_full_update ) {
 			ASSERT( !glGetError(), "Texture parameter error" );
 			glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
 
-			glTexImage2D(
-				GL_TEXTURE_2D,
-				0,
-				GL_RGBA8,
-				(GLsizei)texture->m_width,
-				(GLsizei)texture->m_height,
-				0,
-				GL_RGBA,
-				GL_UNSIGNED_BYTE,
-				ptr( texture->m_bitmap, 0, texture->m_width * texture->m_height * 4 )
-			);
+			{
+				// newer than any published areas, so these can be skipped
+				const auto bitmap_lock = texture->LockBitmap();
+				glTexImage2D(
+					GL_TEXTURE_2D,
+					0,
+					GL_RGBA8,
+					(GLsizei)texture->m_width,
+					(GLsizei)texture->m_height,
+					0,
+					GL_RGBA,
+					GL_UNSIGNED_BYTE,
+					ptr( texture->m_bitmap, 0, texture->m_width * texture->m_height * 4 )
+				);
+			}
 
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT );
 			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT );
 		}
-		else if ( !texture->GetUpdatedAreas().empty() ) {
-
-			// combine multiple updates into one or fewer
-
-			types::texture::Texture::updated_areas_t areas = {};
-
-			const auto& updated_areas = texture->GetUpdatedAreas();
-
-			const uint8_t od = 1; // overlap distance
-
-			const auto f_are_combineable = []( const types::texture::Texture::updated_area_t& first, const types::texture::Texture::updated_area_t& second ) -> bool {
-				return
-					(
-						( first.left + od >= second.left && first.left - od <= second.right ) ||
-							( first.right + od >= second.left && first.right - od <= second.right )
-					) &&
-						(
-							( first.top + od >= second.top && first.top - od <= second.bottom ) ||
-								( first.bottom + od >= second.top && first.bottom - od <= second.bottom )
-						);
-			};
-
-			const auto f_combine = []( types::texture::Texture::updated_area_t& first, const types::texture::Texture::updated_area_t& second ) -> void {
-				//Log( "Merging texture area " + second.ToString() + " into " + first.ToString() );
-				first.left = std::min< size_t >( first.left, second.left );
-				first.top = std::min< size_t >( first.top, second.top );
-				first.right = std::max< size_t >( first.right, second.right );
-				first.bottom = std::max< size_t >( first.bottom, second.bottom );
-			};
-
-			// mark area as removed (merged into another)
-			const auto f_remove = []( types::texture::Texture::updated_area_t& area ) -> void {
-				area.right = area.top = 0; // hackish but no actual area would have these coordinates at 0
-			};
-
-			// check if area was marked as removed (to skip)
-			const auto f_is_removed = []( const types::texture::Texture::updated_area_t& area ) -> bool {
-				return area.right == 0 && area.top == 0;
-			};
-
-			for ( auto& updated_area : updated_areas ) {
-				//Log( "Processing texture area " + updated_area.ToString() );
-				// try to merge with existing one
-				auto it = areas.begin();
-				while ( it != areas.end() ) {
-					// if it overlaps then we can merge with existing (TODO: can optimize further by measuring overlap size)
-					if ( f_are_combineable( updated_area, *it ) ) {
-						// extend area to fit both new one and old one
-						f_combine( *it, updated_area );
-						break;
-					}
-					it++;
-				}
-				if ( it == areas.end() ) {
-					// couldn't find any suitable areas, add new one
-					//Log( "Adding texture area " + updated_area.ToString() );
-					areas.push_back(
-						{
-							updated_area.left,
-							updated_area.top,
-							updated_area.right,
-							updated_area.bottom
-						}
-					);
-				}
-			}
-
-			// keep combining until can't combine anymore
-			bool combined = true;
-			do {
-				combined = false;
-				for ( auto it_dst = areas.begin() ; it_dst < areas.end() ; it_dst++ ) {
-					if ( f_is_removed( *it_dst ) ) {
-						continue;
-					}
-					for ( auto it_src = it_dst + 1 ; it_src < areas.end() ; it_src++ ) {
-						if ( f_is_removed( *it_src ) ) {
-							continue;
-						}
-						if ( f_are_combineable( *it_dst, *it_src ) ) {
-							//Log( "Merging texture area " + it_src->ToString() + " into " + it_dst->ToString() );
-							f_combine( *it_dst, *it_src );
-							f_remove( *it_src );
-							combined = true;
-						}
-					}
-				}
-			}
-			while ( combined );
-
-			// reload areas into opengl
-			for ( auto& area : areas ) {
-				if ( f_is_removed( area ) ) {
-					continue;
-				}
-
-				//Log( "Reloading texture area " + area.ToString() );
-
-				const size_t w = area.right - area.left;
-				const size_t h = area.bottom - area.top;
-
-				auto* bitmap = texture->CopyBitmap(
-					area.left,
-					area.top,
-					area.right,
-					area.bottom
-				);
+		else {
 
+			// published areas have own copies of pixels ( already combined ), so they never wait for writer
+			for ( const auto& published_area : published_areas ) {
+				const auto& area = published_area.area;
 				glTexSubImage2D(
 					GL_TEXTURE_2D,
 					0,
 					area.left,
 					area.top,
-					w,
-					h,
+					area.right - area.left,
+					area.bottom - area.top,
 					GL_RGBA,
 					GL_UNSIGNED_BYTE,
-					ptr( bitmap, 0, w * h * 4 )
+					published_area.bitmap.data()
 				);
+			}
+
+			// other areas are read from bitmap after published ones because they are newer
+			if ( !updated_areas.empty() ) {
 
-				free( bitmap );
+				// combine multiple updates into one or fewer
+				const auto areas = types::texture::Texture::CombineAreas( updated_areas );
+
+				// reload areas into opengl
+				const auto bitmap_lock = texture->LockBitmap();
+				for ( auto& area : areas ) {
+
+					//Log( "Reloading texture area " + area.ToString() );
+
+					const size_t w = area.right - area.left;
+					const size_t h = area.bottom - area.top;
+
+					auto* bitmap = texture->CopyBitmap(
+						area.left,
+						area.top,
+						area.right,
+						area.bottom
+					);
+
+					glTexSubImage2D(
+						GL_TEXTURE_2D,
+						0,
+						area.left,
+						area.top,
+						w,
+						h,
+						GL_RGBA,
+						GL_UNSIGNED_BYTE,
+						ptr( bitmap, 0, w * h * 4 )
+					);
+
+					free( bitmap );
+				}
 			}
 		}
-		texture->ClearUpdatedAreas();
 
 		ASSERT( !glGetError(), "Error loading texture" );
 
@@ -479,6 +437,13 @@ void OpenGL::LoadTexture( types::texture::Texture* texture ) {
 }
 
 void OpenGL::UnloadTexture( const types::texture::Texture* texture ) {
+	if ( texture->m_is_paged ) {
+		auto it = m_texture_pages.lower_bound( { (const types::texture::PagedTexture*)texture, 0 } );
+		while ( it != m_texture_pages.end() && it->first.first == texture ) {
+			UnloadTexturePage( it++ );
+		}
+		return;
+	}
 	m_textures_map::iterator it = m_textures.find( texture );
 	if ( it != m_textures.end() ) {
 		//Log("Unloading texture '" + texture->m_name + "'");
@@ -489,20 +454,114 @@ void OpenGL::UnloadTexture( const types::texture::Texture* texture ) {
 }
 
 void OpenGL::EnableTexture( const types::texture::Texture* texture ) {
-	if ( texture ) {
+	if ( texture && !texture->m_is_paged ) {
 		auto it = m_textures.find( texture );
 		ASSERT( it != m_textures.end(), "texture to be enabled ( " + texture->m_name + " ) not found" );
 		glBindTexture( GL_TEXTURE_2D, it->second.obj );
 	}
 	else {
+		// pages of paged textures are enabled separately
 		glBindTexture( GL_TEXTURE_2D, m_no_texture );
 	}
 }
 
+void OpenGL::EnableTexturePage( const types::texture::PagedTexture* texture, const size_t page ) {
+	ASSERT( page < texture->GetPagesCount(), "texture page out of range" );
+
+	const texture_page_key_t key = {
+		texture,
+		page
+	};
+	auto it = m_texture_pages.find( key );
+
+	if ( it == m_texture_pages.end() || it->second.version != texture->GetPageVersion( page ) ) {
+
+		// texture may be changed from other thread meanwhile
+		// if page isn't loaded yet - wait for it to finish, otherwise keep showing outdated page until it's finished
+		auto bitmap_lock = it == m_texture_pages.end()
+			? texture->LockBitmap()
+			: texture->TryLockBitmap();
+
+		if ( bitmap_lock.owns_lock() ) {
+
+			if ( it == m_texture_pages.end() ) {
+				m_texture_pages_lru.push_front( key );
+				it = m_texture_pages.insert(
+					{
+						key,
+						{
+							0,
+							0,
+							m_frame,
+							m_texture_pages_lru.begin()
+						}
+					}
+				).first;
+				glActiveTexture( GL_TEXTURE0 );
+				glGenTextures( 1, &it->second.obj );
+				m_texture_pages_size += texture->GetPageWidth() * texture->GetPageHeight() * 4 * 4 / 3; // with mipmaps
+			}
+
+			if ( !m_texture_page_bitmap ) {
+				NEW( m_texture_page_bitmap, types::texture::Texture, "TexturePage", texture->GetPageWidth(), texture->GetPageHeight() );
+			}
+			else {
+				m_texture_page_bitmap->Resize( texture->GetPageWidth(), texture->GetPageHeight() );
+			}
+			it->second.version = texture->GetPageVersion( page ); // can't change while locked
+			texture->CompositePage( page, m_texture_page_bitmap );
+			bitmap_lock.unlock();
+
+			glBindTexture( GL_TEXTURE_2D, it->second.obj );
+			glPixelStorei( GL_UNPACK_ALIGNMENT, 1 );
+			glTexImage2D(
+				GL_TEXTURE_2D,
+				0,
+				GL_RGBA8,
+				(GLsizei)m_texture_page_bitmap->m_width,
+				(GLsizei)m_texture_page_bitmap->m_height,
+				0,
+				GL_RGBA,
+				GL_UNSIGNED_BYTE,
+				ptr( m_texture_page_bitmap->m_bitmap, 0, m_texture_page_bitmap->m_bitmap_size )
+			);
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+			glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+			glGenerateMipmap( GL_TEXTURE_2D );
+			ASSERT( !glGetError(), "Error loading texture page" );
+		}
+	}
+
+	auto& p = it->second;
+	p.last_used_frame = m_frame;
+	m_texture_pages_lru.splice( m_texture_pages_lru.begin(), m_texture_pages_lru, p.lru_it );
+	glBindTexture( GL_TEXTURE_2D, p.obj );
+
+	// unload least recently used pages if there are too many
+	while ( m_texture_pages_size > TEXTURE_PAGES_BUDGET ) {
+		const auto lru_it = m_texture_pages.find( m_texture_pages_lru.back() );
+		ASSERT( lru_it != m_texture_pages.end(), "texture page not found" );
+		if ( lru_it->second.last_used_frame == m_frame ) {
+			break; // all remaining pages are needed for current frame
+		}
+		UnloadTexturePage( lru_it );
+	}
+}
+
 void OpenGL::DisableTexture() {
 	glBindTexture( GL_TEXTURE_2D, 0 );
 }
 
+void OpenGL::UnloadTexturePage( const std::map< texture_page_key_t, texture_page_t >::iterator& it ) {
+	glActiveTexture( GL_TEXTURE0 );
+	glDeleteTextures( 1, &it->second.obj );
+	m_texture_pages_size -= it->first.first->GetPageWidth() * it->first.first->GetPageHeight() * 4 * 4 / 3;
+	m_texture_pages_lru.erase( it->second.lru_it );
+	m_texture_pages.erase( it );
+}
+
 FBO* OpenGL::CreateFBO() {
 	NEWV( fbo, FBO, m_options.viewport_width, m_options.viewport_height );
 	Log( "Created FBO " + fbo->GetName() );
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <vector>
+#include <list>
+#include <map>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -35,6 +37,10 @@ CLASS( OpenGL, Graphics )
 	// rendering will be split to multiple draw calls if number of instances is larger
 	static constexpr size_t MAX_INSTANCES = 224;
 
+	// pages of paged textures are unloaded ( least recently used first ) when their total size exceeds this
+	// pages that were used in current frame are never unloaded, so it may be exceeded if that many are visible at once
+	static constexpr size_t TEXTURE_PAGES_BUDGET = 128 * 1024 * 1024; // bytes
+
 	static constexpr float VIEWPORT_MULTIPLIER = 1.0f; // larger size for internal viewport // TODO
 
 	OpenGL( const std::string title, const unsigned short window_width, const unsigned short window_height, const bool vsync, const bool fullscreen );
@@ -54,6 +60,7 @@ CLASS( OpenGL, Graphics )
 	void LoadTexture( types::texture::Texture* texture ) override;
 	void UnloadTexture( const types::texture::Texture* texture ) override;
 	void EnableTexture( const types::texture::Texture* texture ) override;
+	void EnableTexturePage( const types::texture::PagedTexture* texture, const size_t page ) override;
 	void DisableTexture() override;
 
 	FBO* CreateFBO();
@@ -100,6 +107,21 @@ private:
 	m_textures_map m_textures = {};
 	GLuint m_no_texture = 0;
 
+	typedef std::pair< const types::texture::PagedTexture*, size_t > texture_page_key_t;
+	struct texture_page_t {
+		GLuint obj = 0;
+		size_t version = 0;
+		size_t last_used_frame = 0;
+		std::list< texture_page_key_t >::iterator lru_it;
+	};
+	std::map< texture_page_key_t, texture_page_t > m_texture_pages = {};
+	std::list< texture_page_key_t > m_texture_pages_lru = {}; // most recently used first
+	size_t m_texture_pages_size = 0; // bytes
+	types::texture::Texture* m_texture_page_bitmap = nullptr; // pages are composited here before loading
+	size_t m_frame = 0;
+
+	void UnloadTexturePage( const std::map< texture_page_key_t, texture_page_t >::iterator& it );
+
 	std::unordered_map< uint8_t, types::Vec2< ssize_t > > m_active_mousedowns = {};
 
 	std::unordered_set< FBO* > m_fbos = {};
@@ -1,5 +1,7 @@
 #include "Mesh.h"
 
+#include <cfloat>
+
 #include "scene/Scene.h"
 #include "scene/Light.h"
 #include "scene/Camera.h"
@@ -17,6 +19,7 @@
 #include "rr/Capture.h"
 #include "types/Matrix44.h"
 #include "types/texture/Texture.h"
+#include "types/texture/PagedTexture.h"
 #include "types/mesh/Mesh.h"
 #include "types/mesh/Data.h"
 #include "engine/Engine.h"
@@ -73,7 +76,15 @@ bool Mesh::DataMeshReloadNeeded() {
 		if ( m_data_mesh_update_counter != mesh_updated_counter ) {
 			//Log( "Data mesh reload needed ( " + std::to_string( m_data_mesh_update_counter ) + " != " + std::to_string( mesh_updated_counter ) + " )" );
 			m_data_mesh_update_counter = mesh_updated_counter;
-			m_data.is_up_to_date = false;
+			const auto updated_ranges = data_mesh->TakeUpdatedRanges();
+			if ( m_data.is_allocated && m_data.is_up_to_date && !updated_ranges.empty() ) {
+				// picking framebuffer stays valid, only changed vertices need to be reloaded
+				m_data.updated_ranges.insert( m_data.updated_ranges.end(), updated_ranges.begin(), updated_ranges.end() );
+			}
+			else {
+				m_data.is_up_to_date = false;
+				m_data.updated_ranges.clear();
+			}
 			return true;
 		}
 	}
@@ -108,11 +119,29 @@ void Mesh::LoadMesh() {
 	const auto* mesh = GetMeshActor()->GetMesh();
 	ASSERT( mesh, "actor mesh not set" );
 
+	const auto updated_ranges = mesh->TakeUpdatedRanges();
+	if ( m_vbo_size == mesh->GetVertexDataSize() && LoadVertexRanges( m_vbo, mesh, updated_ranges ) ) {
+		UpdateTexturePagesBounds( mesh, updated_ranges );
+		return; // surfaces never change on partial updates
+	}
+
+	const auto vertex_data_lock = mesh->LockVertexData();
+
 	glBindBuffer( GL_ARRAY_BUFFER, m_vbo );
 	glBufferData( GL_ARRAY_BUFFER, mesh->GetVertexDataSize(), (GLvoid*)ptr( mesh->GetVertexData(), 0, mesh->GetVertexDataSize() ), GL_STATIC_DRAW );
+	m_vbo_size = mesh->GetVertexDataSize();
 
-	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_ibo );
-	glBufferData( GL_ELEMENT_ARRAY_BUFFER, mesh->GetIndexDataSize(), (GLvoid*)ptr( mesh->GetIndexData(), 0, mesh->GetIndexDataSize() ), GL_STATIC_DRAW );
+	const auto* texture = GetMeshActor()->GetTexture();
+	if ( texture && texture->m_is_paged ) {
+		GroupByTexturePages( mesh, (const types::texture::PagedTexture*)texture );
+	}
+	else {
+		m_texture_pages.texture = nullptr;
+		m_texture_pages.pages.clear();
+		m_texture_pages.vertex_pages.clear();
+		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_ibo );
+		glBufferData( GL_ELEMENT_ARRAY_BUFFER, mesh->GetIndexDataSize(), (GLvoid*)ptr( mesh->GetIndexData(), 0, mesh->GetIndexDataSize() ), GL_STATIC_DRAW );
+	}
 
 	m_ibo_size = mesh->GetIndexCount();
 
@@ -121,12 +150,146 @@ void Mesh::LoadMesh() {
 
 }
 
+void Mesh::GroupByTexturePages( const types::mesh::Mesh* mesh, const types::texture::PagedTexture* texture ) {
+	const auto* vertices = (const types::mesh::coord_t*)mesh->GetVertexData();
+	const auto* indices = (const types::mesh::index_t*)mesh->GetIndexData();
+	const size_t vertex_size = mesh->VERTEX_SIZE;
+	const size_t indices_count = mesh->GetIndexCount();
+
+	// triangles never span cells ( and cells never span pages ), so page is found by centre of triangle
+	std::vector< std::vector< types::mesh::index_t > > page_indices( texture->GetPagesCount() );
+	for ( size_t i = 0 ; i + 2 < indices_count ; i += 3 ) {
+		float tx = 0.0f;
+		float ty = 0.0f;
+		for ( uint8_t j = 0 ; j < 3 ; j++ ) {
+			const auto* v = vertices + indices[ i + j ] * vertex_size;
+			tx += v[ types::mesh::Mesh::VERTEX_COORD_SIZE ];
+			ty += v[ types::mesh::Mesh::VERTEX_COORD_SIZE + 1 ];
+		}
+		const size_t x = std::min< size_t >( std::max( tx / 3.0f, 0.0f ) * texture->m_width, texture->m_width - 1 );
+		const size_t y = std::min< size_t >( std::max( ty / 3.0f, 0.0f ) * texture->m_height, texture->m_height - 1 );
+		auto& group = page_indices[ texture->GetPageAt( x, y ) ];
+		group.insert( group.end(), indices + i, indices + i + 3 );
+	}
+
+	m_texture_pages.texture = texture;
+	m_texture_pages.pages.clear();
+	m_texture_pages.vertex_pages.assign( mesh->GetVertexCount(), NO_PAGE );
+
+	std::vector< types::mesh::index_t > sorted_indices = {};
+	sorted_indices.reserve( indices_count );
+	for ( size_t page = 0 ; page < page_indices.size() ; page++ ) {
+		const auto& group = page_indices[ page ];
+		if ( group.empty() ) {
+			continue;
+		}
+		texture_page_t texture_page = {
+			page,
+			(GLuint)sorted_indices.size(),
+			(GLuint)group.size(),
+			{ FLT_MAX, FLT_MAX, FLT_MAX },
+			{ -FLT_MAX, -FLT_MAX, -FLT_MAX },
+		};
+		for ( const auto index : group ) {
+			const auto* v = vertices + index * vertex_size;
+			texture_page.min = { std::min( texture_page.min.x, v[ 0 ] ), std::min( texture_page.min.y, v[ 1 ] ), std::min( texture_page.min.z, v[ 2 ] ) };
+			texture_page.max = { std::max( texture_page.max.x, v[ 0 ] ), std::max( texture_page.max.y, v[ 1 ] ), std::max( texture_page.max.z, v[ 2 ] ) };
+			m_texture_pages.vertex_pages[ index ] = m_texture_pages.pages.size();
+		}
+		sorted_indices.insert( sorted_indices.end(), group.begin(), group.end() );
+		m_texture_pages.pages.push_back( texture_page );
+	}
+
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_ibo );
+	glBufferData( GL_ELEMENT_ARRAY_BUFFER, sorted_indices.size() * sizeof( types::mesh::index_t ), (GLvoid*)sorted_indices.data(), GL_STATIC_DRAW );
+	glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+}
+
+void Mesh::UpdateTexturePagesBounds( const types::mesh::Mesh* mesh, const types::mesh::Mesh::updated_ranges_t& updated_ranges ) {
+	if ( !m_texture_pages.texture ) {
+		return;
+	}
+	for ( const auto& range : updated_ranges ) {
+		const auto* vertices = (const types::mesh::coord_t*)range.vertex_data.data();
+		for ( size_t index = range.from ; index < range.to ; index++ ) {
+			const auto page_index = m_texture_pages.vertex_pages[ index ];
+			if ( page_index == NO_PAGE ) {
+				continue;
+			}
+			auto& texture_page = m_texture_pages.pages[ page_index ];
+			const auto* v = vertices + ( index - range.from ) * mesh->VERTEX_SIZE;
+			texture_page.min = { std::min( texture_page.min.x, v[ 0 ] ), std::min( texture_page.min.y, v[ 1 ] ), std::min( texture_page.min.z, v[ 2 ] ) };
+			texture_page.max = { std::max( texture_page.max.x, v[ 0 ] ), std::max( texture_page.max.y, v[ 1 ] ), std::max( texture_page.max.z, v[ 2 ] ) };
+		}
+	}
+}
+
+const bool Mesh::IsTexturePageVisible( const texture_page_t& page, const std::vector< types::Matrix44 >& clip_matrices ) const {
+	for ( const auto& matrix : clip_matrices ) {
+		// page is off screen if all corners of its bounds are beyond same side of clip space
+		uint8_t left = 0, right = 0, bottom = 0, top = 0;
+		for ( uint8_t i = 0 ; i < 8 ; i++ ) {
+			const float x = ( i & 1 ) ? page.max.x : page.min.x;
+			const float y = ( i & 2 ) ? page.max.y : page.min.y;
+			const float z = ( i & 4 ) ? page.max.z : page.min.z;
+			const float cx = matrix.m[ 0 ][ 0 ] * x + matrix.m[ 0 ][ 1 ] * y + matrix.m[ 0 ][ 2 ] * z + matrix.m[ 0 ][ 3 ];
+			const float cy = matrix.m[ 1 ][ 0 ] * x + matrix.m[ 1 ][ 1 ] * y + matrix.m[ 1 ][ 2 ] * z + matrix.m[ 1 ][ 3 ];
+			const float cw = matrix.m[ 3 ][ 0 ] * x + matrix.m[ 3 ][ 1 ] * y + matrix.m[ 3 ][ 2 ] * z + matrix.m[ 3 ][ 3 ];
+			left += cx < -cw;
+			right += cx > cw;
+			bottom += cy < -cw;
+			top += cy > cw;
+		}
+		if ( left < 8 && right < 8 && bottom < 8 && top < 8 ) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void Mesh::SetTexturePageTransform( const GLuint uniform, const size_t page ) const {
+	// maps coordinates of whole texture to ones of page
+	const auto* texture = m_texture_pages.texture;
+	glUniform4f(
+		uniform,
+		(float)texture->m_width / texture->GetPageWidth(),
+		(float)texture->m_height / texture->GetPageHeight(),
+		-(float)( page % texture->GetPagesX() ),
+		-(float)( page / texture->GetPagesX() )
+	);
+}
+
+const bool Mesh::LoadVertexRanges( const GLuint vbo, const types::mesh::Mesh* mesh, const types::mesh::Mesh::updated_ranges_t& updated_ranges ) const {
+	if ( updated_ranges.empty() ) {
+		return false;
+	}
+	const size_t vertex_size = mesh->VERTEX_SIZE * sizeof( types::mesh::coord_t );
+	glBindBuffer( GL_ARRAY_BUFFER, vbo );
+	for ( const auto& range : updated_ranges ) {
+		ASSERT( range.from < range.to && range.to <= mesh->GetVertexCount(), "invalid vertex range" );
+		const size_t offset = range.from * vertex_size;
+		const size_t size = ( range.to - range.from ) * vertex_size;
+		ASSERT( range.vertex_data.size() == size, "vertex range data size mismatch" );
+		// copy that was made when range was published, mesh itself may be written meanwhile
+		glBufferSubData( GL_ARRAY_BUFFER, offset, size, (GLvoid*)range.vertex_data.data() );
+	}
+	glBindBuffer( GL_ARRAY_BUFFER, 0 );
+	return true;
+}
+
 void Mesh::LoadTexture() {
 	auto* texture = GetMeshActor()->GetTexture();
 
 	if ( texture ) {
 
 		g_engine->GetGraphics()->LoadTexture( texture );
+
+		if ( texture->m_is_paged && m_texture_pages.texture != texture ) {
+			// texture was set after mesh was loaded
+			const auto* mesh = GetMeshActor()->GetMesh();
+			const auto vertex_data_lock = mesh->LockVertexData();
+			GroupByTexturePages( mesh, (const types::texture::PagedTexture*)texture );
+		}
 	}
 }
 
@@ -149,6 +312,10 @@ scene::actor::Mesh* Mesh::GetMeshActor() const {
 
 void Mesh::PrepareDataMesh() {
 	const auto* data_mesh = GetMeshActor()->GetDataMesh();
+	if ( data_mesh && m_data.is_up_to_date && !m_data.updated_ranges.empty() ) {
+		LoadVertexRanges( m_data.vbo, data_mesh, m_data.updated_ranges );
+		m_data.updated_ranges.clear();
+	}
 	if ( data_mesh && !m_data.is_up_to_date ) {
 		if ( !m_data.is_allocated ) {
 
@@ -167,13 +334,17 @@ void Mesh::PrepareDataMesh() {
 
 		glBindFramebuffer( GL_FRAMEBUFFER, m_data.fbo );
 
-		glBindBuffer( GL_ARRAY_BUFFER, m_data.vbo );
-		glBufferData( GL_ARRAY_BUFFER, data_mesh->GetVertexDataSize(), (GLvoid*)ptr( data_mesh->GetVertexData(), 0, data_mesh->GetVertexDataSize() ), GL_STATIC_DRAW );
-		glBindBuffer( GL_ARRAY_BUFFER, 0 );
+		{
+			const auto vertex_data_lock = data_mesh->LockVertexData();
 
-		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_data.ibo );
-		glBufferData( GL_ELEMENT_ARRAY_BUFFER, data_mesh->GetIndexDataSize(), (GLvoid*)ptr( data_mesh->GetIndexData(), 0, data_mesh->GetIndexDataSize() ), GL_STATIC_DRAW );
-		glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+			glBindBuffer( GL_ARRAY_BUFFER, m_data.vbo );
+			glBufferData( GL_ARRAY_BUFFER, data_mesh->GetVertexDataSize(), (GLvoid*)ptr( data_mesh->GetVertexData(), 0, data_mesh->GetVertexDataSize() ), GL_STATIC_DRAW );
+			glBindBuffer( GL_ARRAY_BUFFER, 0 );
+
+			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, m_data.ibo );
+			glBufferData( GL_ELEMENT_ARRAY_BUFFER, data_mesh->GetIndexDataSize(), (GLvoid*)ptr( data_mesh->GetIndexData(), 0, data_mesh->GetIndexDataSize() ), GL_STATIC_DRAW );
+			glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, 0 );
+		}
 
 		size_t w = g_engine->GetGraphics()->GetViewportWidth();
 		size_t h = g_engine->GetGraphics()->GetViewportHeight();
@@ -206,6 +377,7 @@ void Mesh::PrepareDataMesh() {
 		glBindFramebuffer( GL_FRAMEBUFFER, 0 );
 
 		m_data.is_up_to_date = true;
+		m_data.updated_ranges.clear();
 		if ( !m_data.is_allocated ) {
 			m_data.is_allocated = true;
 		}
@@ -263,6 +435,8 @@ void Mesh::Draw( shader_program::ShaderProgram* shader_program, scene::Camera* c
 
 	g_engine->GetGraphics()->EnableTexture( texture );
 
+	const bool is_paged = texture && texture->m_is_paged && m_texture_pages.texture == texture;
+
 	switch ( shader_program->GetType() ) {
 		case ( shader_program::ShaderProgram::TYPE_SIMPLE2D ) : {
 			auto* sp = (shader_program::Simple2D*)shader_program;
@@ -278,7 +452,17 @@ void Mesh::Draw( shader_program::ShaderProgram* shader_program, scene::Camera* c
 			if ( flags & scene::actor::Actor::RF_USE_2D_POSITION ) {
 				glUniform2fv( sp->uniforms.position, 1, (const GLfloat*)&mesh_actor->GetPosition() );
 			}
-			glDrawElements( GL_TRIANGLES, m_ibo_size, GL_UNSIGNED_INT, (void*)( 0 ) );
+			if ( is_paged ) {
+				for ( const auto& page : m_texture_pages.pages ) {
+					g_engine->GetGraphics()->EnableTexturePage( m_texture_pages.texture, page.page );
+					SetTexturePageTransform( sp->uniforms.tex_transform, page.page );
+					glDrawElements( GL_TRIANGLES, page.ibo_size, GL_UNSIGNED_INT, (void*)( page.ibo_offset * sizeof( types::mesh::index_t ) ) );
+				}
+				glUniform4f( sp->uniforms.tex_transform, 1.0f, 1.0f, 0.0f, 0.0f );
+			}
+			else {
+				glDrawElements( GL_TRIANGLES, m_ibo_size, GL_UNSIGNED_INT, (void*)( 0 ) );
+			}
 			break;
 		}
 		case ( shader_program::ShaderProgram::TYPE_ORTHO ):
@@ -349,48 +533,77 @@ void Mesh::Draw( shader_program::ShaderProgram* shader_program, scene::Camera* c
 					)
 				);
 			}
+			const GLuint instances_uniform = shader_program->GetType() == shader_program::ShaderProgram::TYPE_ORTHO_DATA
+				? sp_data->uniforms.instances
+				: sp->uniforms.instances;
+			const bool is_instanced = !ignore_camera && m_actor->GetType() == scene::actor::Actor::TYPE_INSTANCED_MESH;
+			scene::actor::Instanced::matrices_t matrices = {};
 			if ( ignore_camera || m_actor->GetType() == scene::actor::Actor::TYPE_MESH ) {
-				types::Matrix44 matrix;
 				ASSERT( !capture_request, "non-instanced captures not implemented" );
 				if ( ignore_camera ) {
-					matrix = g_engine->GetUI()->GetWorldUIMatrix();
+					matrices.push_back( g_engine->GetUI()->GetWorldUIMatrix() );
 				}
 				else {
-					matrix = m_actor->GetWorldMatrix();
+					matrices.push_back( m_actor->GetWorldMatrix() );
 				}
-				glUniformMatrix4fv(
-					shader_program->GetType() == shader_program::ShaderProgram::TYPE_ORTHO_DATA
-						? sp_data->uniforms.instances
-						: sp->uniforms.instances, 1, GL_TRUE, (const GLfloat*)( &matrix )
-				);
-				glDrawElements( GL_TRIANGLES, ibo_size, GL_UNSIGNED_INT, (void*)( 0 ) );
 			}
-			else if ( m_actor->GetType() == scene::actor::Actor::TYPE_INSTANCED_MESH ) {
+			else if ( is_instanced ) {
 				auto* instanced = (scene::actor::Instanced*)m_actor;
-				scene::actor::Instanced::matrices_t matrices;
 				if ( capture_request ) {
 					instanced->GenerateInstanceMatrices( &matrices, capture_request->camera );
 				}
 				else {
 					matrices = instanced->GetInstanceMatrices();
 				}
-				const auto sz = matrices.size();
-				GLsizei i = 0;
-				GLsizei c;
-				for ( auto i = 0 ; i < sz ; i += OpenGL::MAX_INSTANCES ) {
-					c = std::min< size_t >( OpenGL::MAX_INSTANCES, sz - i );
-					glUniformMatrix4fv(
-						shader_program->GetType() == shader_program::ShaderProgram::TYPE_ORTHO_DATA
-							? sp_data->uniforms.instances
-							: sp->uniforms.instances, c, GL_TRUE, (const GLfloat*)( matrices.data() + i )
-					);
-					glDrawElementsInstanced( GL_TRIANGLES, ibo_size, GL_UNSIGNED_INT, (void*)( 0 ), c );
-				}
 			}
 			else {
 				THROW( "unknown actor type " + std::to_string( m_actor->GetType() ) );
 			}
 
+			const auto f_draw = [ &matrices, instances_uniform, is_instanced ]( const GLuint draw_ibo_offset, const GLuint draw_ibo_size ) -> void {
+				void* const offset = (void*)( draw_ibo_offset * sizeof( types::mesh::index_t ) );
+				if ( !is_instanced ) {
+					glUniformMatrix4fv( instances_uniform, 1, GL_TRUE, (const GLfloat*)matrices.data() );
+					glDrawElements( GL_TRIANGLES, draw_ibo_size, GL_UNSIGNED_INT, offset );
+				}
+				else {
+					const auto sz = matrices.size();
+					GLsizei c;
+					for ( size_t i = 0 ; i < sz ; i += OpenGL::MAX_INSTANCES ) {
+						c = std::min< size_t >( OpenGL::MAX_INSTANCES, sz - i );
+						glUniformMatrix4fv( instances_uniform, c, GL_TRUE, (const GLfloat*)( matrices.data() + i ) );
+						glDrawElementsInstanced( GL_TRIANGLES, draw_ibo_size, GL_UNSIGNED_INT, offset, c );
+					}
+				}
+			};
+
+			if ( shader_program->GetType() == shader_program::ShaderProgram::TYPE_ORTHO && is_paged ) {
+				// pages that are off screen are neither drawn nor loaded
+				const bool is_culled = !ignore_camera && !( flags & scene::actor::Actor::RF_USE_2D_POSITION );
+				std::vector< types::Matrix44 > clip_matrices = {};
+				if ( is_culled ) {
+					types::Matrix44 camera_matrix = capture_request
+						? capture_request->camera->GetMatrix()
+						: camera->GetMatrix();
+					clip_matrices.reserve( matrices.size() );
+					for ( const auto& matrix : matrices ) {
+						clip_matrices.push_back( camera_matrix * matrix );
+					}
+				}
+				for ( const auto& page : m_texture_pages.pages ) {
+					if ( is_culled && !IsTexturePageVisible( page, clip_matrices ) ) {
+						continue;
+					}
+					g_engine->GetGraphics()->EnableTexturePage( m_texture_pages.texture, page.page );
+					SetTexturePageTransform( sp->uniforms.tex_transform, page.page );
+					f_draw( page.ibo_offset, page.ibo_size );
+				}
+				glUniform4f( sp->uniforms.tex_transform, 1.0f, 1.0f, 0.0f, 0.0f );
+			}
+			else {
+				f_draw( 0, ibo_size );
+			}
+
 			if ( flags & scene::actor::Actor::RF_IGNORE_DEPTH ) {
 				glEnable( GL_DEPTH_TEST );
 			}
@@ -1,13 +1,21 @@
 #pragma once
 
+#include <vector>
+
 #include <GL/glew.h>
 
 #include "Actor.h"
 
 #include "types/mesh/Types.h"
+#include "types/mesh/Mesh.h"
+#include "types/Vec3.h"
 
-namespace types::texture {
+namespace types {
+class Matrix44;
+namespace texture {
 class Texture;
+class PagedTexture;
+}
 }
 
 namespace scene::actor {
@@ -46,6 +54,7 @@ protected:
 	GLuint m_vbo = 0;
 	GLuint m_ibo = 0;
 	GLuint m_ibo_size = 0;
+	size_t m_vbo_size = 0; // in bytes, to know if partial reload is possible
 
 	struct {
 		bool is_allocated = false;
@@ -56,8 +65,35 @@ protected:
 		GLuint ibo = 0;
 		GLuint ibo_size = 0;
 		bool is_up_to_date = false; // reset on window resize or other events when it needs to be reloaded
+		types::mesh::Mesh::updated_ranges_t updated_ranges = {}; // reloaded on next use if nothing else needs reload
 	} m_data = {};
 
+	// triangles that sample from paged texture are grouped by page, and every group is drawn with its own page
+	static constexpr uint32_t NO_PAGE = UINT32_MAX;
+	struct texture_page_t {
+		size_t page;
+		GLuint ibo_offset; // in indices
+		GLuint ibo_size;
+		types::Vec3 min; // bounds of vertices, to skip pages that are off screen
+		types::Vec3 max;
+	};
+	struct {
+		const types::texture::PagedTexture* texture = nullptr; // that triangles are grouped for
+		std::vector< texture_page_t > pages = {};
+		// index in pages for every vertex ( vertices of meshes with paged textures aren't expected to be shared between pages )
+		std::vector< uint32_t > vertex_pages = {};
+	} m_texture_pages = {};
+
+	// reorders and loads indices, vertex data must be locked
+	void GroupByTexturePages( const types::mesh::Mesh* mesh, const types::texture::PagedTexture* texture );
+	// bounds are only extended, so that vertices don't need to be iterated again
+	void UpdateTexturePagesBounds( const types::mesh::Mesh* mesh, const types::mesh::Mesh::updated_ranges_t& updated_ranges );
+	const bool IsTexturePageVisible( const texture_page_t& page, const std::vector< types::Matrix44 >& clip_matrices ) const;
+	void SetTexturePageTransform( const GLuint uniform, const size_t page ) const;
+
+	// returns false if buffer needs full reload instead
+	const bool LoadVertexRanges( const GLuint vbo, const types::mesh::Mesh* mesh, const types::mesh::Mesh::updated_ranges_t& updated_ranges ) const;
+
 	types::mesh::data_t GetDataAt( const size_t x, const size_t y );
 
 };
@@ -20,6 +20,7 @@ uniform vec2 uPosition; \
 uniform mat4 uWorld; \
 uniform mat4 uInstances[" + std::to_string( OpenGL::MAX_INSTANCES ) + "]; \
 uniform uint uFlags; \
+uniform vec4 uTexTransform; \
 out vec2 texpos; \
 out vec4 tintcolor; \
 out vec3 fragpos; \
@@ -37,7 +38,7 @@ void main(void) { \
 		position += vec4( uPosition, 0.0, 0.0 ); \
 	}\
 	gl_Position = position; \
-	texpos = vec2( aTexCoord.xy ); \
+	texpos = aTexCoord.xy * uTexTransform.xy + uTexTransform.zw; \
 	tintcolor = aTintColor; \
 	fragpos = position.xyz; \
 	normal = aNormal; \
@@ -111,6 +112,9 @@ void Orthographic::Initialize() {
 	attributes.normal = GetAttributeLocation( "aNormal" );
 	uniforms.position = GetUniformLocation( "uPosition" );
 	uniforms.texture = GetUniformLocation( "uTexture" );
+	uniforms.tex_transform = GetUniformLocation( "uTexTransform" );
+	// texture coordinates scale and offset, Mesh sets it per page of paged texture and restores it after
+	glUniform4f( uniforms.tex_transform, 1.0f, 1.0f, 0.0f, 0.0f );
 	uniforms.light_pos = GetUniformLocation( "uLightPos" );
 	uniforms.light_color = GetUniformLocation( "uLightColor" );
 	uniforms.world = GetUniformLocation( "uWorld" );
@@ -23,6 +23,7 @@ protected:
 	struct {
 		GLuint position;
 		GLuint texture;
+		GLuint tex_transform;
 		GLuint world;
 		GLuint instances;
 		GLuint light_pos;
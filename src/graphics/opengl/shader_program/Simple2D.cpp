@@ -15,6 +15,7 @@ in vec3 aCoord; \
 in vec2 aTexCoord; \
 uniform uint uFlags; \
 uniform vec2 uPosition; \
+uniform vec4 uTexTransform; \
 out vec2 texpos; \
 out vec3 fragpos; \
 \
@@ -24,7 +25,7 @@ void main(void) { \
 		coord += vec3( uPosition, 0.0 ); \
 	} \
 	gl_Position = vec4( coord, 1.0 ); \
-	texpos = vec2(aTexCoord); \
+	texpos = aTexCoord * uTexTransform.xy + uTexTransform.zw; \
 	fragpos = coord; \
 } \
 \
@@ -75,6 +76,9 @@ void Simple2D::Initialize() {
 	uniforms.tint_color = GetUniformLocation( "uTintColor" );
 	uniforms.position = GetUniformLocation( "uPosition" );
 	uniforms.texture = GetUniformLocation( "uTexture" );
+	uniforms.tex_transform = GetUniformLocation( "uTexTransform" );
+	// identity unless page of paged texture is drawn
+	glUniform4f( uniforms.tex_transform, 1.0f, 1.0f, 0.0f, 0.0f );
 	uniforms.area_limits.min = GetUniformLocation( "uAreaLimitsMin" );
 	uniforms.area_limits.max = GetUniformLocation( "uAreaLimitsMax" );
 };
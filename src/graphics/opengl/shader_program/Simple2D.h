@@ -23,6 +23,7 @@ protected:
 		GLuint tint_color;
 		GLuint position;
 		GLuint texture;
+		GLuint tex_transform;
 		struct {
 			GLuint min;
 			GLuint max;
@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+
+#include "Async.h"
+
+namespace logger {
+
+// file starts with this, then records follow: time_ns (8 bytes), thread index (2), level (1), size (4), text ( in host byte order )
+static const std::string BINARY_LOG_MAGIC = "GLSMAC_LOG_1\n";
+static const size_t BINARY_RECORD_HEADER_SIZE = 8 + 2 + 1 + 4;
+
+static const char* LEVEL_NAMES[] = {
+	"DEBUG",
+	"INFO",
+	"WARNING",
+	"ERROR",
+};
+
+static std::atomic< size_t > s_next_logger_id = 1;
+
+struct thread_ring_t {
+	size_t logger_id = 0;
+	void* ring = nullptr;
+};
+static thread_local thread_ring_t s_thread_ring = {};
+
+Async::Async( const bool is_stdout_enabled, const std::string& binary_log_path )
+	: m_id( s_next_logger_id++ )
+	, m_is_stdout_enabled( is_stdout_enabled ) {
+	if ( !binary_log_path.empty() ) {
+		m_binary_log = fopen( binary_log_path.c_str(), "wb" );
+		if ( m_binary_log ) {
+			fwrite( BINARY_LOG_MAGIC.data(), 1, BINARY_LOG_MAGIC.size(), m_binary_log );
+		}
+		else {
+			printf( "WARNING: failed to open binary log file %s\n", binary_log_path.c_str() );
+		}
+	}
+	m_flusher = std::thread( &Async::FlusherLoop, this );
+}
+
+Async::~Async() {
+	{
+		std::lock_guard< std::mutex > guard( m_flusher_mutex );
+		m_is_stopping = true;
+	}
+	m_flusher_cv.notify_one();
+	m_flusher.join();
+	Drain();
+	if ( m_binary_log ) {
+		fclose( m_binary_log );
+	}
+}
+
+void Async::Log( const std::string& text, const level_t level ) {
+	if ( g_is_muted || g_debug_stats._readonly ) { // don't spam from debug overlay
+		return;
+	}
+	auto* ring = GetThreadRing();
+	const record_header_t header = {
+		m_next_seq.fetch_add( 1, std::memory_order_relaxed ),
+		(uint64_t)std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::system_clock::now().time_since_epoch() ).count(),
+		(uint32_t)std::min( text.size(), MAX_LINE_SIZE ),
+		level
+	};
+	const size_t size = sizeof( header ) + header.size;
+	const size_t tail = ring->tail.load( std::memory_order_relaxed );
+	const size_t head = ring->head.load( std::memory_order_acquire );
+	if ( RING_SIZE - ( tail - head ) < size ) {
+		ring->dropped_count.fetch_add( 1, std::memory_order_relaxed );
+		m_flusher_cv.notify_one();
+		return;
+	}
+	const auto f_write = [ ring ]( const size_t pos, const void* src, const size_t size ) -> void {
+		const size_t offset = pos & ( RING_SIZE - 1 );
+		const size_t first = std::min( size, RING_SIZE - offset );
+		memcpy( ring->data + offset, src, first );
+		memcpy( ring->data, (const uint8_t*)src + first, size - first );
+	};
+	f_write( tail, &header, sizeof( header ) );
+	f_write( tail + sizeof( header ), text.data(), header.size );
+	ring->tail.store( tail + size, std::memory_order_release );
+	if ( tail + size - head > RING_SIZE / 2 ) {
+		// don't wait for next flush, it may be too late
+		m_flusher_cv.notify_one();
+	}
+}
+
+void Async::Flush() {
+	Drain();
+}
+
+const std::string Async::Decode( const std::string& binary_log ) {
+	if ( binary_log.compare( 0, BINARY_LOG_MAGIC.size(), BINARY_LOG_MAGIC ) != 0 ) {
+		THROW( "not a binary log file" );
+	}
+	std::string result = "";
+	size_t pos = BINARY_LOG_MAGIC.size();
+	while ( pos < binary_log.size() ) {
+		if ( binary_log.size() - pos < BINARY_RECORD_HEADER_SIZE ) {
+			result += "(truncated)\n";
+			break;
+		}
+		uint64_t time_ns;
+		uint16_t thread_index;
+		uint8_t level;
+		uint32_t size;
+		const char* ptr = binary_log.data() + pos;
+		memcpy( &time_ns, ptr, sizeof( time_ns ) );
+		ptr += sizeof( time_ns );
+		memcpy( &thread_index, ptr, sizeof( thread_index ) );
+		ptr += sizeof( thread_index );
+		memcpy( &level, ptr, sizeof( level ) );
+		ptr += sizeof( level );
+		memcpy( &size, ptr, sizeof( size ) );
+		pos += BINARY_RECORD_HEADER_SIZE;
+		if ( binary_log.size() - pos < size ) {
+			result += "(truncated)\n";
+			break;
+		}
+		const time_t seconds = time_ns / 1000000000;
+		char time_str[ 32 ];
+		strftime( time_str, sizeof( time_str ), "%Y-%m-%d %H:%M:%S", std::localtime( &seconds ) );
+		char prefix[ 96 ];
+		snprintf(
+			prefix, sizeof( prefix ), "%s.%06u T%u %-7s ",
+			time_str,
+			(unsigned)( time_ns % 1000000000 / 1000 ),
+			(unsigned)thread_index,
+			level < LL_NONE
+				? LEVEL_NAMES[ level ]
+				: "?"
+		);
+		result += prefix + binary_log.substr( pos, size ) + "\n";
+		pos += size;
+	}
+	return result;
+}
+
+Async::ring_t* Async::GetThreadRing() {
+	if ( s_thread_ring.logger_id != m_id ) {
+		std::lock_guard< std::mutex > guard( m_rings_mutex );
+		m_rings.push_back( std::make_unique< ring_t >() );
+		auto* ring = m_rings.back().get();
+		ring->thread_index = m_rings.size() - 1;
+		s_thread_ring.logger_id = m_id;
+		s_thread_ring.ring = ring;
+	}
+	return (ring_t*)s_thread_ring.ring;
+}
+
+void Async::Drain() {
+	std::lock_guard< std::mutex > guard( m_drain_mutex );
+
+	std::vector< ring_t* > rings = {};
+	{
+		std::lock_guard< std::mutex > rings_guard( m_rings_mutex );
+		rings.reserve( m_rings.size() );
+		for ( const auto& ring : m_rings ) {
+			rings.push_back( ring.get() );
+		}
+	}
+
+	m_batch.clear();
+	for ( auto* ring : rings ) {
+		const auto f_read = [ ring ]( const size_t pos, void* dst, const size_t size ) -> void {
+			const size_t offset = pos & ( RING_SIZE - 1 );
+			const size_t first = std::min( size, RING_SIZE - offset );
+			memcpy( dst, ring->data + offset, first );
+			memcpy( (uint8_t*)dst + first, ring->data, size - first );
+		};
+		size_t head = ring->head.load( std::memory_order_relaxed );
+		const size_t tail = ring->tail.load( std::memory_order_acquire );
+		while ( head != tail ) {
+			record_t record = {};
+			record.thread_index = ring->thread_index;
+			f_read( head, &record.header, sizeof( record.header ) );
+			record.text.resize( record.header.size );
+			f_read( head + sizeof( record.header ), &record.text[ 0 ], record.header.size );
+			head += sizeof( record.header ) + record.header.size;
+			m_batch.push_back( std::move( record ) );
+		}
+		ring->head.store( head, std::memory_order_release );
+		const size_t dropped_count = ring->dropped_count.exchange( 0, std::memory_order_relaxed );
+		if ( dropped_count ) {
+			m_batch.push_back(
+				{
+					{
+						m_next_seq.fetch_add( 1, std::memory_order_relaxed ),
+						m_batch.empty()
+							? 0
+							: m_batch.back().header.time_ns,
+						0,
+						LL_WARNING
+					},
+					ring->thread_index,
+					"WARNING: " + std::to_string( dropped_count ) + " log line(s) of thread " + std::to_string( ring->thread_index ) + " were dropped"
+				}
+			);
+		}
+	}
+	if ( m_batch.empty() ) {
+		return;
+	}
+
+	// lines of different threads may still be slightly out of order across batches, it's fine
+	std::sort(
+		m_batch.begin(), m_batch.end(), []( const record_t& a, const record_t& b ) -> bool {
+			return a.header.seq < b.header.seq;
+		}
+	);
+
+	if ( m_is_stdout_enabled ) {
+		std::string out = "";
+		for ( const auto& record : m_batch ) {
+			out += record.text + "\n";
+		}
+		fwrite( out.data(), 1, out.size(), stdout );
+		fflush( stdout );
+	}
+
+	if ( m_binary_log ) {
+		std::string out = "";
+		for ( const auto& record : m_batch ) {
+			const uint8_t level = record.header.level;
+			const uint32_t size = record.text.size();
+			out.append( (const char*)&record.header.time_ns, sizeof( record.header.time_ns ) );
+			out.append( (const char*)&record.thread_index, sizeof( record.thread_index ) );
+			out.append( (const char*)&level, sizeof( level ) );
+			out.append( (const char*)&size, sizeof( size ) );
+			out += record.text;
+		}
+		fwrite( out.data(), 1, out.size(), m_binary_log );
+		fflush( m_binary_log );
+	}
+}
+
+void Async::FlusherLoop() {
+	std::unique_lock< std::mutex > lock( m_flusher_mutex );
+	while ( !m_is_stopping ) {
+		// producers don't lock mutex when notifying, so wakeup may be missed, but then it's only delayed until next interval
+		m_flusher_cv.wait_for( lock, FLUSH_INTERVAL );
+		lock.unlock();
+		Drain();
+		lock.lock();
+	}
+}
+
+}
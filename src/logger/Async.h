@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <vector>
+#include <memory>
+#include <cstdio>
+
+#include "Logger.h"
+
+namespace logger {
+
+// every thread writes lines into its own lock-free ring buffer, background thread prints them and writes them to binary log file
+// so logging thread never waits for other threads or for i/o
+// if thread logs faster than its buffer is flushed - extra lines are dropped ( and number of dropped lines is logged )
+CLASS( Async, Logger )
+
+	// binary log file is not written if path is empty
+	Async( const bool is_stdout_enabled, const std::string& binary_log_path = "" );
+	~Async();
+
+	void Log( const std::string& text, const level_t level ) override;
+	void Flush() override;
+
+	// converts contents of binary log file to text
+	static const std::string Decode( const std::string& binary_log );
+
+private:
+	static const size_t RING_SIZE = 256 * 1024; // per thread, must be power of 2
+	static const size_t MAX_LINE_SIZE = RING_SIZE / 4; // longer lines are truncated
+	static constexpr std::chrono::milliseconds FLUSH_INTERVAL{ 20 };
+
+	struct record_header_t {
+		uint64_t seq; // lines are ordered by this when printed
+		uint64_t time_ns; // since epoch
+		uint32_t size;
+		level_t level;
+	};
+
+	struct ring_t {
+		alignas( 64 ) std::atomic< size_t > head = 0; // written by flusher
+		alignas( 64 ) std::atomic< size_t > tail = 0; // written by owner thread
+		std::atomic< size_t > dropped_count = 0;
+		uint16_t thread_index = 0;
+		uint8_t data[RING_SIZE];
+	};
+
+	struct record_t {
+		record_header_t header;
+		uint16_t thread_index;
+		std::string text;
+	};
+
+	const size_t m_id; // to tell if thread's cached ring belongs to this logger
+	const bool m_is_stdout_enabled;
+	FILE* m_binary_log = nullptr;
+
+	std::atomic< uint64_t > m_next_seq = 0;
+
+	// rings are only added ( once per thread ) and are kept until logger is destroyed
+	std::mutex m_rings_mutex;
+	std::vector< std::unique_ptr< ring_t > > m_rings = {};
+	ring_t* GetThreadRing();
+
+	std::mutex m_drain_mutex; // flusher and Flush() may drain at same time
+	std::vector< record_t > m_batch = {};
+	void Drain();
+
+	std::thread m_flusher;
+	std::mutex m_flusher_mutex;
+	std::condition_variable m_flusher_cv;
+	bool m_is_stopping = false;
+	void FlusherLoop();
+
+};
+
+}
@@ -1,13 +1,34 @@
 #pragma once
 
 #include <string>
+#include <atomic>
 
 #include "common/Module.h"
 
+#include "Types.h"
+
 namespace logger {
 
+// hacky but ok
+extern std::atomic< bool > g_is_muted;
+
 CLASS( Logger, common::Module )
-	virtual void Log( const std::string& text ) = 0;
+	virtual void Log( const std::string& text, const level_t level = LL_INFO ) = 0;
+
+	// blocks until everything logged so far is written
+	virtual void Flush() {}
+
+	// lines of lower levels are skipped
+	void SetLevel( const level_t level ) {
+		m_level.store( level, std::memory_order_relaxed );
+	}
+	const bool IsEnabled( const level_t level ) const {
+		return level >= m_level.load( std::memory_order_relaxed );
+	}
+
+private:
+	std::atomic< level_t > m_level = LL_INFO;
+
 };
 
 }
@@ -6,7 +6,11 @@ namespace logger {
 
 CLASS( Noop, Logger )
 
-	void Log( const std::string& text ) override {}
+	Noop() {
+		SetLevel( LL_NONE ); // so that callers don't even build text
+	}
+
+	void Log( const std::string& text, const level_t level ) override {}
 
 };
 
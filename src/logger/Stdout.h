@@ -1,18 +1,15 @@
 #pragma once
 
 #include <mutex>
-#include <atomic>
 
 #include "Logger.h"
 
 namespace logger {
 
-// hacky but ok
-extern std::atomic< bool > g_is_muted;
-
+// prints every line immediately from thread that logged it, slow but nothing is lost on crash
 CLASS( Stdout, Logger )
 
-	void Log( const std::string& text ) override;
+	void Log( const std::string& text, const level_t level ) override;
 	std::mutex m_log_mutex;
 
 };
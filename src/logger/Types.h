@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+namespace logger {
+
+enum level_t : uint8_t {
+	LL_DEBUG,
+	LL_INFO,
+	LL_WARNING,
+	LL_ERROR,
+	LL_NONE, // for disabling all levels
+};
+
+// levels below this are compiled out ( see LOG() )
+#ifndef LOG_LEVEL_MIN
+#ifdef DEBUG
+#define LOG_LEVEL_MIN logger::LL_DEBUG
+#else
+#define LOG_LEVEL_MIN logger::LL_INFO
+#endif
+#endif
+
+}
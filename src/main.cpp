@@ -23,6 +23,10 @@
 #ifdef DEBUG
 
 #include "logger/Stdout.h"
+#include "logger/Async.h"
+
+#endif
+
 #include "graphics/Null.h"
 #include "loader/font/Null.h"
 #include "loader/texture/Null.h"
@@ -30,8 +34,6 @@
 #include "input/Null.h"
 #include "audio/Null.h"
 
-#endif
-
 #include "resource/ResourceManager.h"
 
 #include "loader/font/FreeType.h"
@@ -57,12 +59,17 @@
 #endif
 
 #include "task/intro/Intro.h"
+#include "task/mapbenchmark/MapBenchmark.h"
+#include "task/mtbenchmark/MTBenchmark.h"
+#include "task/selftests/SelfTests.h"
 #include "task/mainmenu/MainMenu.h"
 
 #include "game/Game.h"
 
 #include "engine/Engine.h"
 
+#include "common/Profiler.h"
+
 #include "version.h"
 
 #include "game/State.h"
@@ -100,6 +107,10 @@ int main( const int argc, const char* argv[] ) {
 	config.Init();
 
 #ifdef DEBUG
+	if ( config.HasDebugFlag( config::Config::DF_LOG_DECODE ) ) {
+		std::cout << logger::Async::Decode( util::FS::ReadFile( config.GetLogDecodeFile() ) );
+		return EXIT_SUCCESS;
+	}
 	if ( config.HasDebugFlag( config::Config::DF_GDB ) ) {
 #ifdef __linux__
 		// automatically start under gdb if possible
@@ -141,15 +152,30 @@ int main( const int argc, const char* argv[] ) {
 
 	int result = EXIT_FAILURE;
 
+	if ( config.HasLaunchFlag( config::Config::LF_PROFILE ) ) {
+		NEW( g_profiler, common::Profiler );
+	}
+
 	// logger needs to be outside of scope to be destroyed last
 
 #ifdef DEBUG
 	logger::Logger* logger;
-	if ( config.HasDebugFlag( config::Config::DF_QUIET ) ) {
+	const bool is_quiet = config.HasDebugFlag( config::Config::DF_QUIET );
+	const bool is_log_file = config.HasDebugFlag( config::Config::DF_LOG_FILE );
+	if ( is_quiet && !is_log_file ) {
 		NEW( logger, logger::Noop );
 	}
 	else {
-		NEW( logger, logger::Stdout );
+		if ( is_log_file ) {
+			NEW( logger, logger::Async, !is_quiet, config.GetLogFile() );
+		}
+		else if ( config.HasDebugFlag( config::Config::DF_LOG_SYNC ) ) {
+			NEW( logger, logger::Stdout );
+		}
+		else {
+			NEW( logger, logger::Async, true );
+		}
+		logger->SetLevel( config.GetLogLevel() );
 	}
 #else
 	NEWV( logger, logger::Noop );
@@ -214,7 +240,105 @@ int main( const int argc, const char* argv[] ) {
 		}
 		else
 #endif
-		{
+		if ( config.HasLaunchFlag( config::Config::LF_MAP_BENCHMARK ) ) {
+
+			// map generation needs real textures but nothing else
+			resource::ResourceManager resource_manager;
+			loader::font::Null font_loader;
+			loader::texture::SDL2 texture_loader;
+			loader::sound::Null sound_loader;
+			input::Null input;
+			graphics::Null graphics;
+			audio::Null audio;
+
+			NEWV( task, task::mapbenchmark::MapBenchmark );
+			scheduler.AddTask( task );
+
+			engine::Engine engine(
+				&config,
+				&error_handler,
+				logger,
+				&resource_manager,
+				&font_loader,
+				&texture_loader,
+				&sound_loader,
+				nullptr,
+				&scheduler,
+				&input,
+				&graphics,
+				&audio,
+				&network,
+				&ui,
+				nullptr
+			);
+
+			result = engine.Run();
+		}
+		else if ( config.HasLaunchFlag( config::Config::LF_MT_BENCHMARK ) ) {
+
+			loader::font::Null font_loader;
+			loader::texture::Null texture_loader;
+			loader::sound::Null sound_loader;
+			input::Null input;
+			graphics::Null graphics;
+			audio::Null audio;
+
+			NEWV( task, task::mtbenchmark::MTBenchmark );
+			scheduler.AddTask( task );
+
+			engine::Engine engine(
+				&config,
+				&error_handler,
+				logger,
+				nullptr,
+				&font_loader,
+				&texture_loader,
+				&sound_loader,
+				nullptr,
+				&scheduler,
+				&input,
+				&graphics,
+				&audio,
+				&network,
+				&ui,
+				nullptr
+			);
+
+			result = engine.Run();
+		}
+		else if ( config.HasLaunchFlag( config::Config::LF_SELF_TESTS ) ) {
+
+			loader::font::Null font_loader;
+			loader::texture::Null texture_loader;
+			loader::sound::Null sound_loader;
+			input::Null input;
+			graphics::Null graphics;
+			audio::Null audio;
+
+			NEWV( task, task::selftests::SelfTests );
+			scheduler.AddTask( task );
+
+			engine::Engine engine(
+				&config,
+				&error_handler,
+				logger,
+				nullptr,
+				&font_loader,
+				&texture_loader,
+				&sound_loader,
+				nullptr,
+				&scheduler,
+				&input,
+				&graphics,
+				&audio,
+				&network,
+				&ui,
+				nullptr
+			);
+
+			result = engine.Run();
+		}
+		else {
 			game::Game game;
 
 			resource::ResourceManager resource_manager;
@@ -315,6 +439,13 @@ int main( const int argc, const char* argv[] ) {
 			result = engine.Run();
 		}
 	}
+
+	if ( g_profiler ) {
+		g_profiler->Dump( config.GetProfileOutput() );
+		DELETE( g_profiler );
+		g_profiler = nullptr;
+	}
+
 	DELETE( logger );
 
 	return result;
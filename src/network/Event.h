@@ -16,11 +16,14 @@ CLASS( Event, common::Class )
 		ET_DISCONNECT,
 		ET_CLIENT_DISCONNECT,
 		ET_PACKET,
+		ET_BACKPRESSURE_ON, // too much unsent data is queued for peer, sender should hold back non-essential packets
+		ET_BACKPRESSURE_OFF, // queue drained below low watermark
 	};
 
 	cid_t cid = 0; // 'client id', linked to network connection (usually to socket fd)
 
 	event_type_t type = ET_NONE;
+	uint64_t queued_at_us = 0; // for latency stats
 	struct {
 		std::string remote_address;
 		std::string packet_data;
@@ -29,6 +32,7 @@ CLASS( Event, common::Class )
 	void operator=( const Event& other ) {
 		cid = other.cid;
 		type = other.type;
+		queued_at_us = other.queued_at_us;
 		data.remote_address = other.data.remote_address;
 		data.packet_data = other.data.packet_data;
 	}
@@ -36,6 +40,7 @@ CLASS( Event, common::Class )
 	void Clear() {
 		cid = 0;
 		type = ET_NONE;
+		queued_at_us = 0;
 		data.remote_address.clear();
 		data.packet_data.clear();
 	}
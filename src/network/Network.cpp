@@ -1,5 +1,7 @@
 #include "Network.h"
 
+#include <chrono>
+
 #include "types/Packet.h"
 
 namespace network {
@@ -19,11 +21,11 @@ common::mt_id_t Network::MT_Disconnect() {
 	return MT_CreateRequest( request );
 }
 
-common::mt_id_t Network::MT_DisconnectClient( const network::cid_t cid ) {
+void Network::MT_DisconnectClient( const network::cid_t cid ) {
 	MT_Request request;
 	request.op = OP_DISCONNECT_CLIENT;
 	request.cid = cid;
-	return MT_CreateRequest( request );
+	MT_CreateRequest( request, false );
 }
 
 common::mt_id_t Network::MT_GetEvents() {
@@ -32,17 +34,18 @@ common::mt_id_t Network::MT_GetEvents() {
 	return MT_CreateRequest( request );
 }
 
-common::mt_id_t Network::MT_SendEvent( const Event& event ) {
+void Network::MT_SendEvent( const Event& event ) {
 	MT_Request request;
 	request.op = OP_SENDEVENT;
 	request.event = event;
-	return MT_CreateRequest( request );
+	request.event.queued_at_us = GetTimeUs();
+	MT_CreateRequest( request, false );
 }
 
-common::mt_id_t Network::MT_SendPacket( const types::Packet* packet, const network::cid_t cid ) {
+void Network::MT_SendPacket( const types::Packet* packet, const network::cid_t cid ) {
 	if ( m_current_connection_mode == CM_NONE ) {
 		// maybe old event, nothing to do
-		return MT_Success();
+		return;
 	}
 	ASSERT(
 		( m_current_connection_mode == CM_SERVER && cid ) ||
@@ -59,7 +62,7 @@ common::mt_id_t Network::MT_SendPacket( const types::Packet* packet, const netwo
 			: ""
 		)
 	);
-	return MT_SendEvent( e );
+	MT_SendEvent( e );
 }
 
 const MT_Response Network::ProcessRequest( const MT_Request& request, MT_CANCELABLE ) {
@@ -80,6 +83,7 @@ const MT_Response Network::ProcessRequest( const MT_Request& request, MT_CANCELA
 			}
 			m_events_in.clear();
 			m_events_out.clear();
+			m_has_events_out = false;
 			switch ( request.connect.mode ) {
 				case CM_SERVER: {
 					auto response = ListenStart();
@@ -126,6 +130,16 @@ const MT_Response Network::ProcessRequest( const MT_Request& request, MT_CANCELA
 			response.result = R_SUCCESS;
 			response.events = m_events_out;
 			m_events_out.clear();
+			m_has_events_out = false;
+			if ( !response.events.empty() ) {
+				const auto now = GetTimeUs();
+				std::lock_guard< std::mutex > guard( m_latency_stats_mutex );
+				for ( const auto& event : response.events ) {
+					if ( event.type == Event::ET_PACKET ) {
+						AddLatency( m_latency_stats.receive, now - event.queued_at_us );
+					}
+				}
+			}
 			return response;
 		}
 		case OP_SENDEVENT: {
@@ -151,6 +165,14 @@ void Network::DestroyResponse( const MT_Response& response ) {
 
 void Network::AddEvent( const Event& event ) {
 	m_events_out.push_back( event );
+	m_events_out.back().queued_at_us = GetTimeUs();
+	if ( !m_has_events_out ) {
+		m_has_events_out = true;
+		auto* const listener = m_events_listener.load();
+		if ( listener ) {
+			listener->T_Wakeup();
+		}
+	}
 }
 
 events_t Network::GetEvents() {
@@ -176,6 +198,7 @@ void Network::InvalidateEventsForDisconnectedClient( const network::cid_t cid )
 		Log( "Invalidated " + std::to_string( m_events_out.size() - events_new.size() ) + " events for cid " + std::to_string( cid ) );
 	}
 	m_events_out = events_new;
+	m_has_events_out = !m_events_out.empty();
 }
 
 const connection_mode_t Network::GetCurrentConnectionMode() const {
@@ -191,6 +214,59 @@ void Network::Iterate() {
 	ProcessEvents();
 }
 
+const bool Network::Wait( const uint64_t max_ns ) {
+	return m_impl.Wait( ( max_ns + 999999 ) / 1000000 );
+}
+
+void Network::Wakeup() {
+	m_impl.Wakeup();
+}
+
+const bool Network::HasEvents() {
+	m_events_listener = common::Thread::GetCurrent();
+	return m_has_events_out;
+}
+
+const Network::latency_stats_t Network::GetLatencyStats() const {
+	std::lock_guard< std::mutex > guard( m_latency_stats_mutex );
+	return m_latency_stats;
+}
+
+const std::string Network::FormatLatencyHistogram( const latency_histogram_t& histogram ) {
+	if ( !histogram.count ) {
+		return "no data";
+	}
+	std::string result = "count=" + std::to_string( histogram.count ) + " avg=" + std::to_string( histogram.total_us / histogram.count ) + "us max=" + std::to_string( histogram.max_us ) + "us";
+	for ( size_t i = 0 ; i < histogram.buckets.size() ; i++ ) {
+		if ( histogram.buckets[ i ] ) {
+			result += " <" + std::to_string( 1 << i ) + "us:" + std::to_string( histogram.buckets[ i ] );
+		}
+	}
+	return result;
+}
+
+const uint64_t Network::GetTimeUs() {
+	return std::chrono::duration_cast< std::chrono::microseconds >( std::chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+void Network::AddSendLatency( const Event& event ) {
+	std::lock_guard< std::mutex > guard( m_latency_stats_mutex );
+	AddLatency( m_latency_stats.send, GetTimeUs() - event.queued_at_us );
+}
+
+void Network::AddLatency( latency_histogram_t& histogram, const uint64_t value_us ) {
+	size_t bucket = 0;
+	while ( bucket < histogram.buckets.size() - 1 && value_us >= ( 1ULL << bucket ) ) {
+		bucket++;
+	}
+	histogram.buckets[ bucket ]++;
+	histogram.count++;
+	histogram.total_us += value_us;
+	if ( value_us > histogram.max_us ) {
+		histogram.max_us = value_us;
+	}
+}
+
 const MT_Response Network::Error( const std::string& errmsg ) const {
 	MT_Response response;
 	response.result = R_ERROR;
@@ -210,12 +286,6 @@ const MT_Response Network::Canceled() const {
 	return response;
 }
 
-common::mt_id_t Network::MT_Success() {
-	MT_Request request;
-	request.op = OP_SUCCESS;
-	return MT_CreateRequest( request );
-}
-
 const fd_t Network::GetFdFromCid( const network::cid_t cid ) const {
 	const auto& it = m_server.cid_to_fd.find( cid );
 	if ( it == m_server.cid_to_fd.end() ) {
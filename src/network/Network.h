@@ -1,5 +1,9 @@
 #pragma once
 
+#include <array>
+#include <deque>
+#include <mutex>
+
 #include "common/MTModule.h"
 
 #include "Types.h"
@@ -16,24 +20,59 @@ CLASS( Network, MTModule )
 
 	common::mt_id_t MT_Connect( const connection_mode_t connect_mode, const std::string& remote_address = "" );
 	common::mt_id_t MT_Disconnect();
-	common::mt_id_t MT_DisconnectClient( const cid_t cid );
+	void MT_DisconnectClient( const cid_t cid );
 
 	common::mt_id_t MT_GetEvents();
-	common::mt_id_t MT_SendEvent( const Event& event );
+	// can be called from any thread, caller's thread is woken up when new events arrive
+	// so there's no need to poll with MT_GetEvents() while there is nothing to get
+	const bool HasEvents();
+	void MT_SendEvent( const Event& event );
 
-	common::mt_id_t MT_SendPacket( const types::Packet* packet, const cid_t cid = 0 );
+	void MT_SendPacket( const types::Packet* packet, const cid_t cid = 0 );
 
 	MT_Response MT_GetResult( common::mt_id_t mt_id );
 
 	void Iterate() override;
+	const bool Wait( const uint64_t max_ns ) override;
+	void Wakeup() override;
+
+	// log2 buckets of microseconds, bucket N counts values below 2^N us ( last one counts everything above too )
+	struct latency_histogram_t {
+		std::array< uint64_t, 24 > buckets = {};
+		uint64_t count = 0;
+		uint64_t total_us = 0;
+		uint64_t max_us = 0;
+	};
+	struct latency_stats_t {
+		latency_histogram_t send = {}; // from MT_SendPacket() to writing to socket
+		latency_histogram_t receive = {}; // from reading from socket to handing event over via MT_GetEvents()
+	};
+	const latency_stats_t GetLatencyStats() const; // can be called from any thread
+	static const std::string FormatLatencyHistogram( const latency_histogram_t& histogram );
 
 protected:
 
 	static const int GLSMAC_PORT = 4888;
 	static const int GLSMAC_MAX_INCOMING_CONNECTIONS = 64;
 
-	// should be sufficient to fit any packet
-	static const int BUFFER_SIZE = 65536;
+	// frame is 32-bit header followed by payload, header is payload size combined with flags ( all zeros means 'bye' )
+	static const uint32_t FRAME_SIZE_MASK = 0x3fffffff;
+	static const uint32_t FRAME_FLAG_COMPRESSED = 1u << 31; // payload is 32-bit uncompressed size followed by util::LZ data
+	static const uint32_t FRAME_FLAG_CONTROL = 1u << 30; // payload is 32-bit capabilities of sender, not forwarded as packet
+
+	// both sides send their capabilities in first frame, features are used only if other side has them
+	enum capability_t : uint32_t {
+		CAP_NONE = 0,
+		CAP_COMPRESSION = 1 << 0,
+	};
+
+	// receive buffer starts with this size and grows for larger packets ( up to configured limit ), shrinks back when empty
+	static const size_t RECEIVE_BUFFER_INITIAL_SIZE = 65536;
+
+	// unsent data per connection, in bytes
+	static const size_t SEND_QUEUE_HIGH_WATERMARK = 4 * 1024 * 1024; // report backpressure above this
+	static const size_t SEND_QUEUE_LOW_WATERMARK = 1024 * 1024; // stop reporting backpressure below this
+	static const size_t SEND_QUEUE_LIMIT = 64 * 1024 * 1024; // disconnect peer above this
 
 	// shared structures to minimize reallocations
 
@@ -57,12 +96,22 @@ protected:
 		fd_t fd = 0;
 		cid_t cid = 0;
 		struct {
-			char* data1 = nullptr;
-			char* data2 = nullptr;
-			char* data = nullptr;
-			char* ptr = nullptr;
-			size_t len = 0;
+			std::vector< char > data = {};
+			size_t start = 0; // first unprocessed byte
+			size_t end = 0; // end of received data
 		} buffer = {};
+		struct {
+			struct message_t {
+				uint32_t size;
+				std::string data;
+			};
+			std::deque< message_t > messages = {};
+			size_t offset = 0; // bytes of first message ( including size ) that were already sent
+			size_t bytes = 0; // total unsent bytes
+			bool is_write_watched = false;
+			bool is_congested = false;
+		} send_queue = {};
+		uint32_t peer_capabilities = CAP_NONE;
 		time_t last_data_at = 0;
 		bool ping_needed = false;
 		bool ping_sent = false;
@@ -101,7 +150,23 @@ protected:
 		const std::string GetErrorMessage( const ec_t ec ) const;
 		int Receive( const fd_t fd, void* buf, const int len ) const;
 		int Send( const fd_t fd, const void* buf, const int len ) const;
+		struct send_buffer_t {
+			const void* data;
+			size_t len;
+		};
+		static const size_t MAX_SEND_BUFFERS = 64;
+		int SendMultiple( const fd_t fd, const send_buffer_t* buffers, const size_t count ) const; // gathered write of up to MAX_SEND_BUFFERS buffers
 		void CloseSocket( const fd_t fd ) const;
+
+		// event-driven waiting ( epoll on linux ), sockets are unwatched automatically on close
+		void WatchSocket( const fd_t fd ) const;
+		void SetWriteWatched( const fd_t fd, const bool is_write_watched ) const; // also wake up when socket becomes writable
+		const bool Wait( const uint32_t timeout_ms ) const; // false if not supported on this platform
+		void Wakeup() const; // can be called from any thread, interrupts Wait()
+
+	private:
+		int m_wait_fd = -1;
+		int m_wakeup_fd = -1;
 	};
 
 	Impl m_impl = {};
@@ -121,7 +186,6 @@ protected:
 	const MT_Response Success() const;
 	const MT_Response Canceled() const;
 
-	common::mt_id_t MT_Success();
 
 	void AddEvent( const Event& event );
 	events_t GetEvents();
@@ -131,10 +195,19 @@ protected:
 
 	const fd_t GetFdFromCid( const cid_t cid ) const;
 
+	static const uint64_t GetTimeUs();
+	void AddSendLatency( const Event& event );
+
 private:
 	connection_mode_t m_current_connection_mode = CM_NONE;
 
+	mutable std::mutex m_latency_stats_mutex;
+	latency_stats_t m_latency_stats = {};
+	void AddLatency( latency_histogram_t& histogram, const uint64_t value_us );
+
 	events_t m_events_out = {}; // from network to other modules
+	std::atomic< bool > m_has_events_out = false;
+	std::atomic< common::Thread* > m_events_listener = nullptr;
 	events_t m_events_in = {}; // from other modules to network
 
 };
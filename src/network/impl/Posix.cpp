@@ -2,18 +2,39 @@
 
 #include <fcntl.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <signal.h>
 #include <thread>
 
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
 namespace network {
 
 Network::Impl::Impl() {
 	signal( SIGPIPE, SIG_IGN );
+#ifdef __linux__
+	m_wait_fd = epoll_create1( EPOLL_CLOEXEC );
+	m_wakeup_fd = eventfd( 0, EFD_NONBLOCK | EFD_CLOEXEC );
+	if ( m_wait_fd != -1 && m_wakeup_fd != -1 ) {
+		WatchSocket( m_wakeup_fd );
+	}
+	else {
+		Log( "WARNING: failed to initialize epoll, falling back to polling" );
+	}
+#endif
 }
 
 Network::Impl::~Impl() {
-
+	if ( m_wakeup_fd != -1 ) {
+		close( m_wakeup_fd );
+	}
+	if ( m_wait_fd != -1 ) {
+		close( m_wait_fd );
+	}
 }
 
 void Network::Impl::Start() {
@@ -57,12 +78,77 @@ int Network::Impl::Receive( const fd_t fd, void* buf, const int len ) const {
 }
 
 int Network::Impl::Send( const fd_t fd, const void* buf, const int len ) const {
-	ASSERT( len <= BUFFER_SIZE, "packet size overflow ( " + std::to_string( len ) + " > " + std::to_string( BUFFER_SIZE ) + "), consider increasing BUFFER_SIZE" );
 	return send( fd, buf, len, MSG_NOSIGNAL );
 }
 
+int Network::Impl::SendMultiple( const fd_t fd, const send_buffer_t* buffers, const size_t count ) const {
+	ASSERT( count <= MAX_SEND_BUFFERS, "too many send buffers ( " + std::to_string( count ) + " > " + std::to_string( MAX_SEND_BUFFERS ) + " )" );
+	iovec iov[MAX_SEND_BUFFERS];
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		iov[ i ].iov_base = (void*)buffers[ i ].data;
+		iov[ i ].iov_len = buffers[ i ].len;
+	}
+	msghdr msg = {};
+	msg.msg_iov = iov;
+	msg.msg_iovlen = count;
+	return sendmsg( fd, &msg, MSG_NOSIGNAL );
+}
+
 void Network::Impl::CloseSocket( const fd_t socket ) const {
-	close( socket );
+	close( socket ); // also removes it from epoll
+}
+
+void Network::Impl::WatchSocket( const fd_t fd ) const {
+#ifdef __linux__
+	if ( m_wait_fd != -1 ) {
+		epoll_event ev = {};
+		ev.events = EPOLLIN;
+		ev.data.fd = fd;
+		epoll_ctl( m_wait_fd, EPOLL_CTL_ADD, fd, &ev );
+	}
+#endif
+}
+
+void Network::Impl::SetWriteWatched( const fd_t fd, const bool is_write_watched ) const {
+#ifdef __linux__
+	if ( m_wait_fd != -1 ) {
+		epoll_event ev = {};
+		ev.events = is_write_watched
+			? EPOLLIN | EPOLLOUT
+			: EPOLLIN;
+		ev.data.fd = fd;
+		epoll_ctl( m_wait_fd, EPOLL_CTL_MOD, fd, &ev );
+	}
+#endif
+}
+
+const bool Network::Impl::Wait( const uint32_t timeout_ms ) const {
+#ifdef __linux__
+	if ( m_wait_fd == -1 || m_wakeup_fd == -1 ) {
+		return false;
+	}
+	epoll_event events[16];
+	const int count = epoll_wait( m_wait_fd, events, 16, timeout_ms );
+	for ( int i = 0 ; i < count ; i++ ) {
+		if ( events[ i ].data.fd == m_wakeup_fd ) {
+			uint64_t value;
+			(void)!read( m_wakeup_fd, &value, sizeof( value ) );
+		}
+		// sockets are read by caller, level-triggered mode makes sure nothing is missed
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Network::Impl::Wakeup() const {
+#ifdef __linux__
+	if ( m_wakeup_fd != -1 ) {
+		const uint64_t value = 1;
+		(void)!write( m_wakeup_fd, &value, sizeof( value ) );
+	}
+#endif
 }
 
 }
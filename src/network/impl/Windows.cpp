@@ -58,4 +58,34 @@ int Network::Impl::Send( const fd_t fd, const void* buf, const int len ) const {
 	return send( fd, (const char*)buf, len, 0 );
 }
 
+int Network::Impl::SendMultiple( const fd_t fd, const send_buffer_t* buffers, const size_t count ) const {
+	ASSERT( count <= MAX_SEND_BUFFERS, "too many send buffers ( " + std::to_string( count ) + " > " + std::to_string( MAX_SEND_BUFFERS ) + " )" );
+	WSABUF bufs[MAX_SEND_BUFFERS];
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		bufs[ i ].buf = (char*)buffers[ i ].data;
+		bufs[ i ].len = (ULONG)buffers[ i ].len;
+	}
+	DWORD sent = 0;
+	if ( WSASend( fd, bufs, (DWORD)count, &sent, 0, nullptr, nullptr ) == SOCKET_ERROR ) {
+		return -1;
+	}
+	return (int)sent;
+}
+
+void Network::Impl::WatchSocket( const fd_t fd ) const {
+	// not supported, network thread polls sockets at fixed rate
+}
+
+void Network::Impl::SetWriteWatched( const fd_t fd, const bool is_write_watched ) const {
+	//
+}
+
+const bool Network::Impl::Wait( const uint32_t timeout_ms ) const {
+	return false;
+}
+
+void Network::Impl::Wakeup() const {
+	//
+}
+
 }
@@ -1,4 +1,6 @@
 #include <thread>
+#include <climits>
+#include <algorithm>
 
 #ifdef _WIN32
 #include <ws2tcpip.h>
@@ -14,13 +16,9 @@
 
 #include "SimpleTCP.h"
 #include "types/Packet.h"
-
-#ifdef DEBUG
-
 #include "engine/Engine.h"
 #include "config/Config.h"
-
-#endif
+#include "util/LZ.h"
 
 namespace network {
 namespace simpletcp {
@@ -33,6 +31,12 @@ SimpleTCP::SimpleTCP()
 }
 
 void SimpleTCP::Start() {
+	m_receive_buffer_limit = g_engine->GetConfig()->GetNetworkBufferLimit();
+	m_compression_threshold = g_engine->GetConfig()->GetNetworkCompressionThreshold();
+	{
+		std::lock_guard< std::mutex > guard( m_compression_stats_mutex );
+		m_compression_stats = {};
+	}
 #ifdef DEBUG
 	m_need_pings = !g_engine->GetConfig()->HasDebugFlag( config::Config::DF_NOPINGS );
 #endif
@@ -40,6 +44,13 @@ void SimpleTCP::Start() {
 }
 
 void SimpleTCP::Stop() {
+	const auto stats = GetLatencyStats();
+	Log( "Send latency: " + FormatLatencyHistogram( stats.send ) );
+	Log( "Receive latency: " + FormatLatencyHistogram( stats.receive ) );
+	const auto compression_stats = GetCompressionStats();
+	if ( compression_stats.packets ) {
+		Log( "Compressed " + std::to_string( compression_stats.packets ) + " packets: " + std::to_string( compression_stats.bytes_before ) + " -> " + std::to_string( compression_stats.bytes_after ) + " bytes" );
+	}
 	switch ( GetCurrentConnectionMode() ) {
 		case CM_CLIENT: {
 			Disconnect();
@@ -55,6 +66,19 @@ void SimpleTCP::Stop() {
 	m_impl.Stop();
 }
 
+void SimpleTCP::SetReceiveBufferLimit( const size_t limit ) {
+	m_receive_buffer_limit = limit;
+}
+
+void SimpleTCP::SetCompressionThreshold( const size_t threshold ) {
+	m_compression_threshold = threshold;
+}
+
+const SimpleTCP::compression_stats_t SimpleTCP::GetCompressionStats() const {
+	std::lock_guard< std::mutex > guard( m_compression_stats_mutex );
+	return m_compression_stats;
+}
+
 MT_Response SimpleTCP::ListenStart() {
 
 	ASSERT( m_server.listening_sockets.empty(), "some connection socket(s) already active" );
@@ -124,6 +148,7 @@ MT_Response SimpleTCP::ListenStart() {
 
 		ASSERT( m_server.listening_sockets.find( socket_data.fd ) == m_server.listening_sockets.end(), "duplicate listening socket id" );
 		m_server.listening_sockets[ socket_data.fd ] = socket_data;
+		m_impl.WatchSocket( socket_data.fd );
 	}
 
 	freeaddrinfo( res );
@@ -247,16 +272,17 @@ MT_Response SimpleTCP::Connect( const std::string& remote_address, MT_CANCELABLE
 	else {
 		return error( "Unsupported IP type: " + remote_address );
 	}
+	freeaddrinfo( p );
 
-	m_client.socket.buffer.len = 0;
-	m_client.socket.buffer.data1 = (char*)malloc( BUFFER_SIZE );
-	m_client.socket.buffer.data2 = (char*)malloc( BUFFER_SIZE );
-	m_client.socket.buffer.data = m_client.socket.buffer.data1;
-	m_client.socket.buffer.ptr = m_client.socket.buffer.data;
+	m_client.socket.buffer = {}; // allocated on first read
+	m_client.socket.peer_capabilities = CAP_NONE; // until received
 	m_client.socket.last_data_at = time( nullptr );
 	m_client.socket.ping_needed = false;
 	m_client.socket.pong_needed = false;
 	m_client.socket.ping_sent = false;
+	m_impl.WatchSocket( m_client.socket.fd );
+
+	SendCapabilities( m_client.socket ); // if it fails - connection will be dropped on next read
 
 	Log( "Connection successful" );
 
@@ -266,10 +292,7 @@ MT_Response SimpleTCP::Connect( const std::string& remote_address, MT_CANCELABLE
 MT_Response SimpleTCP::Disconnect() {
 
 	if ( m_client.socket.fd ) {
-		CloseSocket( m_client.socket.fd, 0, true ); // no need to send event if disconnect was initiated by user
-		free( m_client.socket.buffer.data1 );
-		free( m_client.socket.buffer.data2 );
-		m_client.socket.fd = 0;
+		CloseServerSocket( true ); // no need to send event if disconnect was initiated by user
 	}
 
 	return Success();
@@ -298,7 +321,8 @@ void SimpleTCP::ProcessEvents() {
 	for ( auto& event : events ) {
 		switch ( event.type ) {
 			case Event::ET_PACKET: {
-				Log( "Packet event ( cid = " + std::to_string( event.cid ) + " )" );
+				LOG_DEBUG( "Packet event ( cid = " + std::to_string( event.cid ) + " )" );
+				AddSendLatency( event );
 				if ( event.cid ) { // presence of cid means we are server
 					if ( GetCurrentConnectionMode() != CM_SERVER ) {
 						Log( "WARNING: got non-zero cid in packet while not being server, ignoring" );
@@ -312,18 +336,15 @@ void SimpleTCP::ProcessEvents() {
 					}
 					auto it = m_server.client_sockets.find( fd );
 					if ( it != m_server.client_sockets.end() ) { // if not found it may mean event is old so can be ignored
-						if ( !WriteToSocket( it->second.fd, event.data.packet_data ) ) {
+						if ( !WriteToSocket( it->second, std::move( event.data.packet_data ) ) ) {
 							CloseClientSocket( it->second );
 							m_server.client_sockets.erase( it );
 						}
 					}
 				}
 				else if ( m_client.socket.fd ) {
-					if ( !WriteToSocket( m_client.socket.fd, event.data.packet_data ) ) {
-						CloseSocket( m_client.socket.fd );
-						free( m_client.socket.buffer.data1 );
-						free( m_client.socket.buffer.data2 );
-						m_client.socket.fd = 0;
+					if ( !WriteToSocket( m_client.socket, std::move( event.data.packet_data ) ) ) {
+						CloseServerSocket();
 					}
 				}
 				break;
@@ -381,12 +402,7 @@ void SimpleTCP::Iterate() {
 
 				m_impl.ConfigureSocket( m_server.tmp.newfd );
 
-				remote_socket_data_t data;
-				data.buffer.len = 0;
-				data.buffer.data1 = (char*)malloc( BUFFER_SIZE );
-				data.buffer.data2 = (char*)malloc( BUFFER_SIZE );
-				data.buffer.data = data.buffer.data1;
-				data.buffer.ptr = data.buffer.data;
+				remote_socket_data_t data; // buffer is allocated on first read
 				data.fd = m_server.tmp.newfd;
 
 				data.remote_address = inet_ntoa( ( (struct sockaddr_in*)&m_server.tmp.client_addr )->sin_addr );
@@ -403,6 +419,8 @@ void SimpleTCP::Iterate() {
 
 				ASSERT( m_server.client_sockets.find( data.fd ) == m_server.client_sockets.end(), "client socket already added" );
 				m_server.client_sockets[ data.fd ] = data;
+				m_impl.WatchSocket( data.fd );
+				SendCapabilities( m_server.client_sockets.at( data.fd ) ); // if it fails - connection will be dropped on next read
 
 				Log( "Accepted connection from " + data.remote_address + " (cid " + std::to_string( data.cid ) + ")" );
 
@@ -428,20 +446,30 @@ void SimpleTCP::Iterate() {
 	}
 	if ( m_client.socket.fd ) {
 		if ( !MaybePingDo( m_client.socket ) ) {
-			CloseSocket( m_client.socket.fd );
-			free( m_client.socket.buffer.data1 );
-			free( m_client.socket.buffer.data2 );
-			m_client.socket.fd = 0;
+			CloseServerSocket();
+		}
+	}
+
+	// send what didn't fit into socket buffers before
+	for ( auto it = m_server.client_sockets.begin() ; it != m_server.client_sockets.end() ; ) {
+		if ( !it->second.send_queue.messages.empty() && !FlushSocket( it->second ) ) {
+			CloseClientSocket( it->second );
+			m_server.client_sockets.erase( it++ );
+		}
+		else {
+			++it;
+		}
+	}
+	if ( m_client.socket.fd && !m_client.socket.send_queue.messages.empty() ) {
+		if ( !FlushSocket( m_client.socket ) ) {
+			CloseServerSocket();
 		}
 	}
 
 	// read from connection (client)
 	if ( m_client.socket.fd ) {
 		if ( !ReadFromSocket( m_client.socket ) ) {
-			CloseSocket( m_client.socket.fd );
-			free( m_client.socket.buffer.data1 );
-			free( m_client.socket.buffer.data2 );
-			m_client.socket.fd = 0;
+			CloseServerSocket();
 		}
 	}
 
@@ -458,12 +486,15 @@ void SimpleTCP::Iterate() {
 }
 
 bool SimpleTCP::ReadFromSocket( remote_socket_data_t& socket ) {
+	auto& buffer = socket.buffer;
 
-	// max allowed size to read
-	m_tmp.tmpint = ( BUFFER_SIZE - socket.buffer.len );
+	if ( buffer.end == buffer.data.size() ) {
+		if ( !ReserveReceiveBuffer( socket, buffer.end - buffer.start + 1 ) ) {
+			return false;
+		}
+	}
 
-	//Log( "Reading up to " + std::to_string( m_tmp.tmpint ) + " bytes from " + std::to_string( socket.fd ) + " (buffer=" + std::to_string( (long int) socket.buffer.ptr ) + ", BUFFER_SIZE=" + std::to_string( BUFFER_SIZE ) + " buffer len = " + std::to_string( socket.buffer.len ) + ")" );
-	m_tmp.tmpint2 = m_impl.Receive( socket.fd, socket.buffer.ptr, m_tmp.tmpint );
+	m_tmp.tmpint2 = m_impl.Receive( socket.fd, buffer.data.data() + buffer.end, std::min< size_t >( buffer.data.size() - buffer.end, INT_MAX ) );
 
 	if ( m_tmp.tmpint2 < 0 ) {
 		m_tmp.tmpint = m_impl.GetLastErrorCode();
@@ -478,148 +509,248 @@ bool SimpleTCP::ReadFromSocket( remote_socket_data_t& socket ) {
 			return false;
 		}
 	}
-
-	if ( m_tmp.tmpint2 == 0 ) {
-		// no pending data
-		if ( !MaybePing( socket ) ) {
-			return false;
-		}
+	else if ( m_tmp.tmpint2 == 0 ) {
+		Log( "Connection closed by remote host" );
+		return false;
 	}
-
-	if ( m_tmp.tmpint2 > 0 ) {
-
-		Log( "Read " + std::to_string( m_tmp.tmpint2 ) + " bytes into buffer " + std::to_string( (long long)socket.buffer.ptr ) + " (size=" + std::to_string( socket.buffer.len ) + ")" );
+	else {
+		//Log( "Read " + std::to_string( m_tmp.tmpint2 ) + " bytes (buffer size=" + std::to_string( buffer.end - buffer.start ) + ")" ); // SPAMMY
 
 		socket.last_data_at = m_tmp.now;
 		socket.ping_needed = false;
 		socket.pong_needed = false;
 
-		socket.buffer.len += m_tmp.tmpint2;
-		socket.buffer.ptr += m_tmp.tmpint2;
-
+		buffer.end += m_tmp.tmpint2;
 	}
 
-	{
+	// process all complete packets, there will be no socket event for data that was already read
+	uint32_t header;
+	while ( buffer.end - buffer.start >= sizeof( header ) ) {
+		memcpy( &header, buffer.data.data() + buffer.start, sizeof( header ) );
 
-		if ( socket.buffer.len == 0 ) {
-			return true; // no new data
+		if ( header == 0 ) {
+			// zero length means 'bye'
+			Log( "Connection closed by remote host" );
+			return false;
 		}
 
-		//Log( "Trying to process buffer " + to_string( (long int) socket.buffer.data ) + " ( size=" + to_string( socket.buffer.len ) + " )" );
-		if ( socket.buffer.len < sizeof( m_tmp.tmpint ) ) {
-			//Log( "Buffer " + to_string( (long int) socket.buffer.data ) + " does not contain full size field yet ( " + to_string( socket.buffer.len ) + " < " + to_string( sizeof( m_tmp.tmpint ) ) + " )" );
-			return true;
+		const uint32_t size = header & FRAME_SIZE_MASK;
+		const size_t frame_size = sizeof( header ) + size;
+		if ( buffer.end - buffer.start < frame_size ) {
+			// wait for rest of packet, make sure it will fit
+			if ( !ReserveReceiveBuffer( socket, frame_size ) ) {
+				return false;
+			}
+			break;
 		}
 
-		m_tmp.ptr = socket.buffer.data;
-		memcpy( &m_tmp.tmpint, m_tmp.ptr, sizeof( m_tmp.tmpint ) );
-		m_tmp.tmpint2 = sizeof( m_tmp.tmpint ) + m_tmp.tmpint;
+		const char* payload = buffer.data.data() + buffer.start + sizeof( header );
+		buffer.start += frame_size;
 
-		if ( socket.buffer.len < m_tmp.tmpint2 ) {
-			//Log( "Buffer " + std::to_string( (long int) socket.buffer.data ) + " does not contain all data yet ( " + std::to_string( socket.buffer.len ) + " < " + std::to_string( m_tmp.tmpint2 ) + " )" );
-			return true;
-		}
-		else {
-			//Log( "Buffer " + std::to_string( (long int) socket.buffer.data ) + " contains enough data ( " + std::to_string( socket.buffer.len ) + " >= " + std::to_string( m_tmp.tmpint2 ) + " )" );
+		if ( header & FRAME_FLAG_CONTROL ) {
+			if ( size != sizeof( socket.peer_capabilities ) ) {
+				Log( "Invalid control frame from " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
+				return false;
+			}
+			memcpy( &socket.peer_capabilities, payload, size );
+			Log( "Capabilities of " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + "): " + std::to_string( socket.peer_capabilities ) );
+			continue;
 		}
 
-		//Log( "Processing buffer " + to_string( (long int) m_tmp.ptr ) + " ( size=" + to_string( m_tmp.tmpint2 ) + " )" );
-
-		if ( m_tmp.tmpint == 0 && m_tmp.tmpint2 == sizeof( m_tmp.tmpint ) ) {
-			// zero length means 'bye'
-			Log( "Connection closed by remote host" );
-			return false;
+		m_tmp.event.Clear();
+		m_tmp.event.cid = socket.cid;
+		m_tmp.event.data.remote_address = socket.remote_address;
+		if ( header & FRAME_FLAG_COMPRESSED ) {
+			uint32_t original_size = 0;
+			if ( size >= sizeof( original_size ) ) {
+				memcpy( &original_size, payload, sizeof( original_size ) );
+			}
+			if ( !original_size || original_size > m_receive_buffer_limit ) {
+				Log( "Invalid size of compressed packet from " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + "): " + std::to_string( original_size ) );
+				return false;
+			}
+			m_tmp.event.data.packet_data.resize( original_size );
+			if ( !util::LZ::Decompress( std::string_view( payload + sizeof( original_size ), size - sizeof( original_size ) ), m_tmp.event.data.packet_data.data(), original_size ) ) {
+				Log( "Failed to decompress packet from " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
+				return false;
+			}
 		}
-
-		m_tmp.ptr += sizeof( m_tmp.tmpint );
-
-		{
-			//Log( "Read packet (" + std::to_string( m_tmp.tmpint ) + " bytes)" );
-			m_tmp.event.Clear();
-			m_tmp.event.cid = socket.cid;
-			m_tmp.event.data.remote_address = socket.remote_address;
-			m_tmp.event.data.packet_data = std::string( m_tmp.ptr, m_tmp.tmpint );
-			try {
-				types::Packet p( types::Packet::PT_NONE );
-				p.Unserialize( types::Buffer( m_tmp.event.data.packet_data ) );
-				// quick hack to respond to pings without escalating events outside
-				// TODO: refactor
-				if ( p.type == types::Packet::PT_PING ) {
-					Log( "Ping received" );
-					socket.pong_needed = true;
-				}
-				else if ( p.type == types::Packet::PT_PONG ) {
-					Log( "Pong received" );
-					socket.ping_sent = false;
-				}
-				else {
-					//Log( "Sending event" );
-					m_tmp.event.type = Event::ET_PACKET;
-					AddEvent( m_tmp.event );
-				}
+		else {
+			m_tmp.event.data.packet_data.assign( payload, size );
+		}
+		try {
+			types::Packet p( types::Packet::PT_NONE );
+			p.Unserialize( types::Buffer( m_tmp.event.data.packet_data ) );
+			// quick hack to respond to pings without escalating events outside
+			// TODO: refactor
+			if ( p.type == types::Packet::PT_PING ) {
+				LOG_DEBUG( "Ping received" );
+				socket.pong_needed = true;
 			}
-			catch ( std::runtime_error& err ) {
-				m_tmp.event.type = Event::ET_ERROR;
-				m_tmp.event.data.packet_data = err.what();
+			else if ( p.type == types::Packet::PT_PONG ) {
+				LOG_DEBUG( "Pong received" );
+				socket.ping_sent = false;
+			}
+			else {
+				//Log( "Sending event" );
+				m_tmp.event.type = Event::ET_PACKET;
 				AddEvent( m_tmp.event );
 			}
-
+		}
+		catch ( std::runtime_error& err ) {
+			m_tmp.event.type = Event::ET_ERROR;
+			m_tmp.event.data.packet_data = err.what();
+			AddEvent( m_tmp.event );
 		}
 
-		Log( "Processed " + std::to_string( m_tmp.tmpint2 ) + " bytes" );
-
-		if ( m_tmp.tmpint2 > 0 ) {
-			ASSERT( socket.buffer.len >= m_tmp.tmpint2, "processed more than total" );
-			socket.buffer.len -= m_tmp.tmpint2;
-			if ( socket.buffer.len > 0 ) {
-				if ( socket.buffer.data == socket.buffer.data1 ) {
-					//Log( "SWAP data1 -> data2" );
-					memcpy( socket.buffer.data2, socket.buffer.data + m_tmp.tmpint2, socket.buffer.len );
-					socket.buffer.data = socket.buffer.data2;
-				}
-				else {
-					//Log( "SWAP data2 -> data1" );
-					memcpy( socket.buffer.data1, socket.buffer.data + m_tmp.tmpint2, socket.buffer.len );
-					socket.buffer.data = socket.buffer.data1;
-				}
-			}
-			socket.buffer.ptr = socket.buffer.data + socket.buffer.len;
+		LOG_DEBUG( "Processed " + std::to_string( frame_size ) + " bytes" );
+	}
 
-			//Log( "Buffer size changed to " + to_string( socket.buffer.len ) );
+	if ( buffer.start == buffer.end ) {
+		buffer.start = buffer.end = 0;
+		if ( buffer.data.size() > RECEIVE_BUFFER_INITIAL_SIZE ) {
+			// don't keep memory of large packets
+			buffer.data.resize( RECEIVE_BUFFER_INITIAL_SIZE );
+			buffer.data.shrink_to_fit();
 		}
+	}
 
-		return true;
+	return true;
+}
 
+bool SimpleTCP::ReserveReceiveBuffer( remote_socket_data_t& socket, const size_t size ) {
+	auto& buffer = socket.buffer;
+	if ( buffer.start + size <= buffer.data.size() ) {
+		return true;
+	}
+	if ( size > m_receive_buffer_limit ) {
+		Log( "Packet from " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ") exceeds receive buffer limit ( " + std::to_string( size ) + " > " + std::to_string( m_receive_buffer_limit ) + " )" );
+		return false;
+	}
+	if ( buffer.start ) {
+		// only leftover of partially received packet is moved, and only when there is no space after it
+		memmove( buffer.data.data(), buffer.data.data() + buffer.start, buffer.end - buffer.start );
+		buffer.end -= buffer.start;
+		buffer.start = 0;
 	}
-	THROW( "?" );
-	return false;
+	if ( size > buffer.data.size() ) {
+		buffer.data.resize( std::min( std::max( { size, buffer.data.size() * 2, RECEIVE_BUFFER_INITIAL_SIZE } ), m_receive_buffer_limit ) );
+	}
+	return true;
 }
 
-bool SimpleTCP::WriteToSocket( int fd, const std::string& data ) {
-	//Log( "WriteToSocket( " + to_string( fd ) + " )" ); // SPAMMY
-	m_tmp.tmpint2 = data.size();
-	//Log( "Writing " + to_string( m_tmp.tmpint2 ) + " bytes" );
-	// send size
-	m_tmp.tmpint = m_impl.Send( fd, &m_tmp.tmpint2, sizeof( m_tmp.tmpint2 ) );
-	if ( m_tmp.tmpint <= 0 ) {
-		m_tmp.tmpint = m_impl.GetLastErrorCode();
-		if ( m_impl.IsConnectionIdle( m_tmp.tmpint ) ) {
-			return true; // no data but connection is alive
+bool SimpleTCP::WriteToSocket( remote_socket_data_t& socket, std::string data ) {
+	if ( m_compression_threshold && data.size() >= m_compression_threshold && ( socket.peer_capabilities & CAP_COMPRESSION ) ) {
+		const uint32_t original_size = data.size();
+		std::string compressed( (const char*)&original_size, sizeof( original_size ) );
+		util::LZ::Compress( data, compressed );
+		if ( compressed.size() < data.size() ) {
+			{
+				std::lock_guard< std::mutex > guard( m_compression_stats_mutex );
+				m_compression_stats.packets++;
+				m_compression_stats.bytes_before += data.size();
+				m_compression_stats.bytes_after += compressed.size();
+			}
+			return WriteFrame( socket, FRAME_FLAG_COMPRESSED, std::move( compressed ) );
 		}
-		Log( "Error writing size to socket (errno=" + std::to_string( m_tmp.tmpint ) + " size=" + std::to_string( m_tmp.tmpint ) + " reqsize=" + std::to_string( m_tmp.tmpint2 ) + ")" );
+		// incompressible, send as is
+	}
+	return WriteFrame( socket, 0, std::move( data ) );
+}
 
+bool SimpleTCP::WriteFrame( remote_socket_data_t& socket, const uint32_t flags, std::string data ) {
+	auto& queue = socket.send_queue;
+	const size_t size = sizeof( uint32_t ) + data.size();
+	if ( queue.bytes + size > SEND_QUEUE_LIMIT ) {
+		Log( "Send queue limit exceeded on " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + "), dropping connection" );
 		return false;
 	}
-	// send data
-	m_tmp.tmpint = m_impl.Send( fd, data.data(), data.size() );
-	if ( m_tmp.tmpint2 <= 0 ) {
-		if ( errno == EAGAIN ) {
-			return true; // no data but connection is alive
+	queue.messages.push_back(
+		{
+			(uint32_t)data.size() | flags,
+			std::move( data )
 		}
-		Log( "Error writing data to socket" );
-		return false;
+	);
+	queue.bytes += size;
+	return FlushSocket( socket );
+}
+
+bool SimpleTCP::FlushSocket( remote_socket_data_t& socket ) {
+	auto& queue = socket.send_queue;
+	Impl::send_buffer_t buffers[Impl::MAX_SEND_BUFFERS];
+	while ( !queue.messages.empty() ) {
+
+		// gather as many messages as possible, skipping already sent part
+		size_t count = 0;
+		size_t skip = queue.offset;
+		for ( auto it = queue.messages.begin() ; it != queue.messages.end() && count + 2 <= Impl::MAX_SEND_BUFFERS ; ++it ) {
+			if ( skip < sizeof( it->size ) ) {
+				buffers[ count++ ] = {
+					(const char*)&it->size + skip,
+					sizeof( it->size ) - skip
+				};
+				skip = 0;
+			}
+			else {
+				skip -= sizeof( it->size );
+			}
+			if ( skip < it->data.size() ) {
+				buffers[ count++ ] = {
+					it->data.data() + skip,
+					it->data.size() - skip
+				};
+				skip = 0;
+			}
+			else {
+				skip -= it->data.size();
+			}
+		}
+
+		m_tmp.tmpint = m_impl.SendMultiple( socket.fd, buffers, count );
+		if ( m_tmp.tmpint < 0 ) {
+			m_tmp.tmpint = m_impl.GetLastErrorCode();
+			if ( m_impl.IsConnectionIdle( m_tmp.tmpint ) ) {
+				break; // socket buffer is full, continue when it becomes writable
+			}
+			Log( "Error writing to socket (errno=" + std::to_string( m_tmp.tmpint ) + ")" );
+			return false;
+		}
+		if ( m_tmp.tmpint == 0 ) {
+			break;
+		}
+
+		// drop everything that was sent fully
+		queue.offset += m_tmp.tmpint;
+		queue.bytes -= m_tmp.tmpint;
+		while ( !queue.messages.empty() && queue.offset >= sizeof( uint32_t ) + queue.messages.front().data.size() ) {
+			queue.offset -= sizeof( uint32_t ) + queue.messages.front().data.size();
+			queue.messages.pop_front();
+		}
+	}
+
+	const bool is_write_needed = !queue.messages.empty();
+	if ( is_write_needed != queue.is_write_watched ) {
+		m_impl.SetWriteWatched( socket.fd, is_write_needed );
+		queue.is_write_watched = is_write_needed;
 	}
-	//Log( "Write successful" );
+
+	if ( !queue.is_congested && queue.bytes > SEND_QUEUE_HIGH_WATERMARK ) {
+		Log( "Send queue of " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ") is over high watermark (" + std::to_string( queue.bytes ) + " bytes)" );
+		queue.is_congested = true;
+		m_tmp.event.Clear();
+		m_tmp.event.type = Event::ET_BACKPRESSURE_ON;
+		m_tmp.event.cid = socket.cid;
+		AddEvent( m_tmp.event );
+	}
+	else if ( queue.is_congested && queue.bytes < SEND_QUEUE_LOW_WATERMARK ) {
+		Log( "Send queue of " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ") is below low watermark (" + std::to_string( queue.bytes ) + " bytes)" );
+		queue.is_congested = false;
+		m_tmp.event.Clear();
+		m_tmp.event.type = Event::ET_BACKPRESSURE_OFF;
+		m_tmp.event.cid = socket.cid;
+		AddEvent( m_tmp.event );
+	}
+
 	return true;
 }
 
@@ -633,7 +764,7 @@ bool SimpleTCP::MaybePing( remote_socket_data_t& socket ) {
 	m_tmp.time = m_tmp.now - socket.last_data_at;
 
 	if ( m_tmp.time > SEND_PING_AFTER && !socket.ping_sent ) {
-		Log( "Need ping" );
+		LOG_DEBUG( "Need ping" );
 		socket.ping_needed = true;
 	}
 
@@ -657,27 +788,45 @@ bool SimpleTCP::MaybePingDo( remote_socket_data_t& socket ) {
 	}
 
 	if ( socket.ping_needed && !socket.ping_sent ) {
-		Log( "Sending ping to " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
+		LOG_DEBUG( "Sending ping to " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
 		types::Packet packet( types::Packet::PT_PING );
-		std::string data = packet.Serialize().ToString();
 		socket.ping_sent = true;
-		return WriteToSocket( socket.fd, data );
+		return WriteToSocket( socket, packet.Serialize().ToString() );
 	}
 	if ( socket.pong_needed ) {
-		Log( "Ping received, sending pong to " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
+		LOG_DEBUG( "Ping received, sending pong to " + std::to_string( socket.fd ) + " (cid " + std::to_string( socket.cid ) + ")" );
 		types::Packet packet( types::Packet::PT_PONG );
 		socket.pong_needed = false;
-		std::string data = packet.Serialize().ToString();
-		return WriteToSocket( socket.fd, data );
+		return WriteToSocket( socket, packet.Serialize().ToString() );
 	}
 
 	return true;
 }
 
+bool SimpleTCP::SendCapabilities( remote_socket_data_t& socket ) {
+	const uint32_t capabilities = m_compression_threshold
+		? CAP_COMPRESSION
+		: CAP_NONE;
+	return WriteFrame( socket, FRAME_FLAG_CONTROL, std::string( (const char*)&capabilities, sizeof( capabilities ) ) );
+}
+
+void SimpleTCP::ShutdownSocket( remote_socket_data_t& socket ) {
+	// zero size means 'bye', queue it after everything else and give it last chance to be sent
+	socket.send_queue.messages.push_back(
+		{
+			0,
+			""
+		}
+	);
+	socket.send_queue.bytes += sizeof( uint32_t );
+	FlushSocket( socket );
+	socket.send_queue = {};
+	socket.buffer = {};
+	socket.peer_capabilities = CAP_NONE;
+}
+
 void SimpleTCP::CloseSocket( int fd, cid_t cid, bool skip_event ) {
 	Log( "Closing socket " + std::to_string( fd ) );
-	uint32_t bye = 0;
-	m_impl.Send( fd, &bye, sizeof( bye ) );
 	m_impl.CloseSocket( fd );
 	if ( !skip_event ) {
 		m_tmp.event.Clear();
@@ -692,16 +841,22 @@ void SimpleTCP::CloseSocket( int fd, cid_t cid, bool skip_event ) {
 	}
 }
 
-void SimpleTCP::CloseClientSocket( const remote_socket_data_t& socket ) {
+void SimpleTCP::CloseClientSocket( remote_socket_data_t& socket ) {
 	ASSERT( GetCurrentConnectionMode() == CM_SERVER, "can't close client socket as non-server" );
 	ASSERT( socket.cid != 0, "client socket can't have cid 0" );
 	Log( "Closing connection to " + socket.remote_address + " ( cid " + std::to_string( socket.cid ) + " )" );
+	ShutdownSocket( socket );
 	CloseSocket( socket.fd, socket.cid );
-	free( socket.buffer.data1 );
-	free( socket.buffer.data2 );
 	InvalidateEventsForDisconnectedClient( socket.cid );
 	m_server.cid_to_fd.erase( socket.cid );
 }
 
+void SimpleTCP::CloseServerSocket( const bool skip_event ) {
+	ASSERT( m_client.socket.fd, "server socket not open" );
+	ShutdownSocket( m_client.socket );
+	CloseSocket( m_client.socket.fd, 0, skip_event );
+	m_client.socket.fd = 0;
+}
+
 }
 }
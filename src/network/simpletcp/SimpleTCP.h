@@ -22,6 +22,17 @@ CLASS( SimpleTCP, Network )
 	void Stop() override;
 	void Iterate() override;
 
+	// override values from config, must be called after Start() and before connecting ( capabilities are sent right after connecting )
+	void SetReceiveBufferLimit( const size_t limit );
+	void SetCompressionThreshold( const size_t threshold );
+
+	struct compression_stats_t {
+		size_t packets = 0;
+		size_t bytes_before = 0;
+		size_t bytes_after = 0;
+	};
+	const compression_stats_t GetCompressionStats() const; // can be called from any thread
+
 protected:
 
 	MT_Response ListenStart() override;
@@ -34,11 +45,23 @@ protected:
 private:
 	// true on success, false on error
 	bool ReadFromSocket( remote_socket_data_t& socket );
-	bool WriteToSocket( int fd, const std::string& data );
+	bool ReserveReceiveBuffer( remote_socket_data_t& socket, const size_t size ); // makes sure that size bytes fit after first unprocessed one
+	bool WriteToSocket( remote_socket_data_t& socket, std::string data ); // compresses packet if possible and queues it
+	bool WriteFrame( remote_socket_data_t& socket, const uint32_t flags, std::string data ); // queues framed data and sends as much as possible right away
+	bool SendCapabilities( remote_socket_data_t& socket );
+	bool FlushSocket( remote_socket_data_t& socket ); // sends queued data until socket buffer is full
 	bool MaybePing( remote_socket_data_t& socket );
 	bool MaybePingDo( remote_socket_data_t& socket );
+	void ShutdownSocket( remote_socket_data_t& socket );
 	void CloseSocket( int fd, network::cid_t cid = 0, bool skip_event = false );
-	void CloseClientSocket( const remote_socket_data_t& socket );
+	void CloseClientSocket( remote_socket_data_t& socket );
+	void CloseServerSocket( const bool skip_event = false );
+
+	size_t m_receive_buffer_limit = 0; // per connection, from config
+	size_t m_compression_threshold = 0; // from config, 0 means no compression
+
+	mutable std::mutex m_compression_stats_mutex;
+	compression_stats_t m_compression_stats = {};
 
 #ifdef DEBUG
 	bool m_need_pings = true;
@@ -214,7 +214,7 @@ const types::Buffer Instanced::Serialize() const {
 
 	buf.WriteInt( m_next_instance_id );
 
-	buf.WriteString( m_actor->Serialize().ToString() );
+	buf.WriteString( m_actor->Serialize().ToStringView() );
 
 	return buf;
 }
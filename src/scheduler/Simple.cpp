@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <chrono>
 
 #include "Simple.h"
 
@@ -43,7 +44,12 @@ void Simple::Iterate() {
 	m_tasks_toadd.clear();
 	m_iterating = true;
 	for ( auto it = m_tasks.begin() ; it < m_tasks.end() ; it++ ) {
-		( *it )->Iterate();
+		if ( g_profiler ) {
+			IterateProfiled( *it );
+		}
+		else {
+			( *it )->Iterate();
+		}
 	}
 	m_iterating = false;
 	for ( auto& task : m_tasks_toremove ) {
@@ -84,8 +90,25 @@ void Simple::RemoveTask( common::Task* task ) {
 			task->Stop();
 		}
 		m_tasks.erase( it );
+		m_task_profiles.erase( task );
 		DELETE( task );
 	}
 }
 
+void Simple::IterateProfiled( common::Task* task ) {
+	auto& profile = m_task_profiles[ task ];
+	if ( !profile ) {
+		profile = g_profiler->AddSection( "Task " + task->GetClassName() );
+	}
+	const auto start = std::chrono::high_resolution_clock::now();
+	task->Iterate();
+	const uint64_t ns = std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::high_resolution_clock::now() - start ).count();
+	if ( profile->Add( ns ) ) {
+		common::Profiler::spike_t spike = {};
+		spike.name = profile->GetName();
+		spike.duration_ns = ns;
+		g_profiler->AddSpike( std::move( spike ) );
+	}
+}
+
 }
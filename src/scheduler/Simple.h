@@ -1,9 +1,12 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
 
 #include "Scheduler.h"
 
+#include "common/Profiler.h"
+
 #ifdef DEBUG
 #include "util/Timer.h"
 #endif
@@ -31,6 +34,9 @@ protected:
 	std::vector< common::Task* > m_tasks_toremove = {};
 	bool m_active = false;
 	bool m_iterating = false;
+
+	std::unordered_map< common::Task*, common::Profiler::Section* > m_task_profiles = {};
+	void IterateProfiled( common::Task* task );
 };
 
 }
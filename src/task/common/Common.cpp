@@ -5,6 +5,8 @@
 #include "ui/UI.h"
 #include "ui/FPSCounter.h"
 #include "ui/style/Theme.h"
+#include "ui/event/Types.h"
+#include "common/Profiler.h"
 
 namespace task {
 
@@ -19,11 +21,28 @@ void Common::Start() {
 
 		ui->AddObject( m_fps_counter );
 	}
+
+	if ( g_profiler ) {
+		m_profile_dump_handler = ui->AddGlobalEventHandler(
+			::ui::event::EV_KEY_DOWN, EH() {
+				if ( data->key.code == ::ui::event::K_GRAVE && data->key.modifiers == ::ui::event::KM_CTRL ) {
+					g_profiler->Dump( g_engine->GetConfig()->GetProfileOutput() );
+					return true;
+				}
+				return false;
+			}, ::ui::UI::GH_BEFORE
+		);
+	}
 }
 
 void Common::Stop() {
 	auto* ui = g_engine->GetUI();
 
+	if ( m_profile_dump_handler ) {
+		ui->RemoveGlobalEventHandler( m_profile_dump_handler );
+		m_profile_dump_handler = nullptr;
+	}
+
 	if ( m_fps_counter ) {
 		ui->RemoveObject( m_fps_counter );
 		m_fps_counter = nullptr;
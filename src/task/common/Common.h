@@ -2,6 +2,12 @@
 
 #include "common/Task.h"
 
+namespace ui {
+namespace event {
+class UIEventHandler;
+}
+}
+
 namespace task {
 
 namespace ui {
@@ -21,6 +27,8 @@ protected:
 
 	ui::FPSCounter* m_fps_counter = nullptr;
 
+	const ::ui::event::UIEventHandler* m_profile_dump_handler = nullptr;
+
 };
 
 }
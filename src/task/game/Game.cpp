@@ -917,7 +917,7 @@ void Game::ProcessRequest( const ::game::FrontendRequest* request ) {
 				ASSERT( t, "tile not found" );
 				const auto& ts = tile_data.second;
 				ASSERT( ts, "tile state not found" );
-				auto* tile = m_tm->GetTile( t->coord.x, t->coord.y );
+				auto* tile = m_tm->GetTile( t->GetCoords().x, t->GetCoords().y );
 				ASSERT( tile, "matching tile not found" );
 
 				Log( "Updating tile: " + tile->GetCoords().ToString() );
@@ -1239,7 +1239,7 @@ void Game::Initialize(
 		for ( size_t x = y & 1 ; x < m_map_data.width ; x += 2 ) {
 			auto* tile = m_tm->GetTile( x, y );
 			Log( "Initializing tile: " + tile->GetCoords().ToString() );
-			tile->Update( tiles->at( y * m_map_data.width + x / 2 ), tile_states->at( y * m_map_data.width + x / 2 ) );
+			tile->Update( tiles->at( ( y * m_map_data.width + x ) / 2 ), tile_states->at( y * m_map_data.width + x / 2 ) );
 		}
 	}
 
@@ -228,9 +228,9 @@ const Tile::render_data_t& Tile::GetRenderData() const {
 
 void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile::TileState& ts ) {
 
-	m_is_water = tile.is_water_tile;
+	m_is_water = tile.IsWater();
 
-	::game::map::tile::tile_layer_type_t lt = ( tile.is_water_tile
+	::game::map::tile::tile_layer_type_t lt = ( tile.IsWater()
 		? ::game::map::tile::LAYER_WATER
 		: ::game::map::tile::LAYER_LAND
 	);
@@ -247,22 +247,22 @@ void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile:
 	x( bottom );
 #undef x
 
-	if ( !tile.is_water_tile && ts.is_coastline_corner ) {
-		if ( tile.W->is_water_tile ) {
+	if ( !tile.IsWater() && ts.is_coastline_corner ) {
+		if ( tile.W()->IsWater() ) {
 			selection_coords.left = ts.layers[ ::game::map::tile::LAYER_WATER ].coords.left;
 		}
-		if ( tile.N->is_water_tile ) {
+		if ( tile.N()->IsWater() ) {
 			selection_coords.top = ts.layers[ ::game::map::tile::LAYER_WATER ].coords.top;
 		}
-		if ( tile.E->is_water_tile ) {
+		if ( tile.E()->IsWater() ) {
 			selection_coords.right = ts.layers[ ::game::map::tile::LAYER_WATER ].coords.right;
 		}
-		if ( tile.S->is_water_tile ) {
+		if ( tile.S()->IsWater() ) {
 			selection_coords.bottom = ts.layers[ ::game::map::tile::LAYER_WATER ].coords.bottom;
 		}
 	}
 
-	lt = ( ( tile.is_water_tile || ts.is_coastline_corner )
+	lt = ( ( tile.IsWater() || ts.is_coastline_corner )
 		? ::game::map::tile::LAYER_WATER
 		: ::game::map::tile::LAYER_LAND
 	);
@@ -287,7 +287,7 @@ void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile:
 	};
 
 	std::vector< ::game::map::tile::tile_layer_type_t > layers = {};
-	if ( tile.is_water_tile ) {
+	if ( tile.IsWater() ) {
 		layers.push_back( ::game::map::tile::LAYER_LAND );
 		layers.push_back( ::game::map::tile::LAYER_WATER_SURFACE );
 		layers.push_back( ::game::map::tile::LAYER_WATER_SURFACE_EXTRA ); // TODO: only near coastlines?
@@ -348,8 +348,8 @@ void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile:
 
 	std::vector< std::string > info_lines = {};
 
-	auto e = *tile.elevation.center;
-	if ( tile.is_water_tile ) {
+	auto e = *tile.GetElevationCenter();
+	if ( tile.IsWater() ) {
 		if ( e < ::game::map::tile::ELEVATION_LEVEL_TRENCH ) {
 			info_lines.push_back( "Ocean Trench" );
 		}
@@ -364,7 +364,7 @@ void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile:
 	else {
 		info_lines.push_back( "Elev: " + std::to_string( e ) + "m" );
 		std::string tilestr = "";
-		switch ( tile.rockiness ) {
+		switch ( *tile.GetRockiness() ) {
 			case ::game::map::tile::ROCKINESS_FLAT: {
 				tilestr += "Flat";
 				break;
@@ -379,7 +379,7 @@ void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile:
 			}
 		}
 		tilestr += " & ";
-		switch ( tile.moisture ) {
+		switch ( *tile.GetMoisture() ) {
 			case ::game::map::tile::MOISTURE_ARID: {
 				tilestr += "Arid";
 				break;
@@ -397,18 +397,18 @@ void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile:
 	}
 
 #define FEATURE( _feature, _line ) \
-            if ( tile.features & ::game::map::tile::_feature ) { \
+            if ( *tile.GetFeatures() & ::game::map::tile::_feature ) { \
                 info_lines.push_back( _line ); \
             }
 
-	if ( tile.is_water_tile ) {
+	if ( tile.IsWater() ) {
 		FEATURE( FEATURE_XENOFUNGUS, "Sea Fungus" )
 	}
 	else {
 		FEATURE( FEATURE_XENOFUNGUS, "Xenofungus" )
 	}
 
-	switch ( tile.bonus ) {
+	switch ( *tile.GetBonus() ) {
 		case ::game::map::tile::BONUS_NUTRIENT: {
 			info_lines.push_back( "Nutrient bonus" );
 			break;
@@ -426,7 +426,7 @@ void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile:
 		}
 	}
 
-	if ( tile.is_water_tile ) {
+	if ( tile.IsWater() ) {
 		FEATURE( FEATURE_GEOTHERMAL, "Geothermal" )
 	}
 	else {
@@ -440,11 +440,11 @@ void Tile::Update( const ::game::map::tile::Tile& tile, const ::game::map::tile:
 #undef FEATURE
 
 #define TERRAFORMING( _terraforming, _line ) \
-            if ( tile.terraforming & ::game::map::tile::_terraforming ) { \
+            if ( *tile.GetTerraforming() & ::game::map::tile::_terraforming ) { \
                 info_lines.push_back( _line ); \
             }
 
-	if ( tile.is_water_tile ) {
+	if ( tile.IsWater() ) {
 		TERRAFORMING( TERRAFORMING_FARM, "Kelp Farm" );
 		TERRAFORMING( TERRAFORMING_SOLAR, "Tidal Harness" );
 		TERRAFORMING( TERRAFORMING_MINE, "Mining Platform" );
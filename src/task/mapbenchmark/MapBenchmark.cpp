@@ -0,0 +1,310 @@
+#include <iostream> // results summary should be printed with --quiet too
+#include <chrono>
+#include <algorithm>
+
+#include "MapBenchmark.h"
+
+#include "engine/Engine.h"
+#include "common/JobSystem.h"
+#include "config/Config.h"
+#include "game/settings/Settings.h"
+#include "game/map/Consts.h"
+#include "game/map/tile/Tiles.h"
+#include "game/map/TerrainTexture.h"
+#include "types/texture/Texture.h"
+#include "types/mesh/Render.h"
+#include "types/mesh/Data.h"
+#include "util/random/Random.h"
+#include "util/System.h"
+#include "util/FS.h"
+#include "util/LZ.h"
+#include "util/crc32/CRC32.h"
+
+namespace task {
+namespace mapbenchmark {
+
+static inline uint64_t GetElapsedNs( const std::chrono::steady_clock::time_point& since ) {
+	return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - since ).count();
+}
+
+static inline uint64_t GetThroughput( const size_t bytes, const uint64_t ns ) {
+	return bytes * 1000 / std::max< uint64_t >( ns, 1 ); // MB/s
+}
+
+void MapBenchmark::Start() {
+	const auto* config = g_engine->GetConfig();
+
+	auto sizes = config->GetMapBenchmarkSizes();
+	if ( sizes.empty() ) {
+		for ( auto size = game::settings::MAP_CONFIG_TINY ; size <= game::settings::MAP_CONFIG_HUGE ; size++ ) {
+			sizes.push_back( game::map::s_consts.map_sizes.at( size ) );
+		}
+	}
+
+	// fixed seeds so that results of different builds can be compared with each other
+	for ( const auto& size : sizes ) {
+		for ( util::random::value_t seed = 1 ; seed <= config->GetMapBenchmarkSeeds() ; seed++ ) {
+			m_cases.push_back(
+				{
+					size,
+					seed
+				}
+			);
+		}
+	}
+
+	Log( "Running " + std::to_string( m_cases.size() ) + " map benchmark cases" );
+}
+
+void MapBenchmark::Stop() {
+	m_cases.clear();
+	m_results.clear();
+	m_current_case_index = 0;
+}
+
+void MapBenchmark::Iterate() {
+	if ( m_current_case_index < m_cases.size() ) {
+		const auto& c = m_cases[ m_current_case_index++ ];
+		std::cout << "  " << c.size.ToString() << " seed=" << c.seed << "..." << std::flush;
+		if ( !RunCase( c ) ) {
+			std::cout << " FAILED" << std::endl;
+			g_engine->ShutDown();
+			return;
+		}
+		const auto& result = m_results.back();
+		const auto& snapshot = result.snapshot;
+		std::cout << " generate " << result.generate_ns / 1000000 << "ms, initialize " << result.initialize_ns / 1000000 << "ms"
+			<< ", snapshot " << snapshot.bytes / 1024 << "KB"
+			<< " serialized at " << GetThroughput( snapshot.bytes, snapshot.serialize_ns ) << "MB/s"
+			<< " unserialized at " << GetThroughput( snapshot.bytes, snapshot.unserialize_ns ) << "MB/s"
+			<< " compressed x" << (float)snapshot.bytes / std::max< size_t >( snapshot.compressed_bytes, 1 )
+			<< " at " << GetThroughput( snapshot.bytes, snapshot.compress_ns ) << "MB/s"
+			<< " ( decompressed at " << GetThroughput( snapshot.bytes, snapshot.decompress_ns ) << "MB/s )"
+			<< ", crc32 at " << GetThroughput( snapshot.bytes, snapshot.crc32_ns ) << "MB/s"
+			<< ", crc32c at " << GetThroughput( snapshot.bytes, snapshot.crc32c_ns ) << "MB/s"
+			<< ( util::crc32::CRC32::IsHardwareAccelerated()
+				? " ( hardware )"
+				: " ( software )" )
+			<< ", dump " << result.dump.bytes / 1024 << "KB"
+			<< " serialized at " << GetThroughput( result.dump.bytes, result.dump.serialize_ns ) << "MB/s"
+			<< " unserialized at " << GetThroughput( result.dump.bytes, result.dump.unserialize_ns ) << "MB/s"
+			<< ", " << result.pages.count << " texture pages composited in " << result.pages.composite_ns / 1000000 << "ms"
+			<< std::endl;
+	}
+	else if ( m_current_case_index == m_cases.size() ) {
+		m_current_case_index++;
+		WriteResults();
+		g_engine->ShutDown();
+	}
+}
+
+const bool MapBenchmark::RunCase( const case_t& c ) {
+	util::random::Random random( c.seed );
+	game::settings::MapSettings settings;
+	settings.type = game::settings::MapSettings::MT_RANDOM;
+	settings.size = game::settings::MAP_CONFIG_CUSTOM;
+	settings.custom_size = c.size;
+
+	const common::mt_flag_t canceled = false;
+
+	NEWV( map, game::map::Map, &random );
+	map->EnableProfiling();
+
+	result_t result = {};
+	result.c = c;
+
+	auto started_at = std::chrono::steady_clock::now();
+	auto ec = map->Generate( &settings, MT_C );
+	result.generate_ns = GetElapsedNs( started_at );
+
+	if ( ec == game::map::Map::EC_NONE ) {
+		started_at = std::chrono::steady_clock::now();
+		ec = map->Initialize( MT_C );
+		result.initialize_ns = GetElapsedNs( started_at );
+	}
+
+	result.peak_rss = util::System::GetPeakRSS();
+	result.profile = map->GetProfile();
+
+	if ( ec == game::map::Map::EC_NONE && ( !MeasureSnapshot( map, result ) || !MeasureDump( map, &random, result ) ) ) {
+		ec = game::map::Map::EC_UNKNOWN;
+	}
+	if ( ec == game::map::Map::EC_NONE ) {
+		MeasurePages( map, result );
+	}
+
+	DeleteMap( map );
+
+	if ( ec != game::map::Map::EC_NONE ) {
+		Log( "Map benchmark case failed: " + game::map::Map::GetErrorString( ec ) );
+		return false;
+	}
+
+	m_results.push_back( result );
+	return true;
+}
+
+const bool MapBenchmark::MeasureSnapshot( const game::map::Map* map, result_t& result ) const {
+	auto started_at = std::chrono::steady_clock::now();
+	const auto buf = map->m_tiles->Serialize();
+	result.snapshot.serialize_ns = GetElapsedNs( started_at );
+	const auto snapshot = buf.ToStringView();
+
+	{
+		NEWV( tiles, game::map::tile::Tiles );
+		started_at = std::chrono::steady_clock::now();
+		tiles->Unserialize( buf );
+		result.snapshot.unserialize_ns = GetElapsedNs( started_at );
+		DELETE( tiles );
+	}
+
+	std::vector< std::string > chunks = {};
+	started_at = std::chrono::steady_clock::now();
+	for ( size_t offset = 0 ; offset < snapshot.size() ; offset += SNAPSHOT_CHUNK_SIZE ) {
+		chunks.push_back( "" );
+		util::LZ::Compress( snapshot.substr( offset, SNAPSHOT_CHUNK_SIZE ), chunks.back() );
+	}
+	result.snapshot.compress_ns = GetElapsedNs( started_at );
+
+	std::string decompressed( snapshot.size(), 0 );
+	bool is_valid = true;
+	started_at = std::chrono::steady_clock::now();
+	for ( size_t i = 0 ; i < chunks.size() ; i++ ) {
+		const size_t offset = i * SNAPSHOT_CHUNK_SIZE;
+		is_valid &= util::LZ::Decompress( chunks[ i ], decompressed.data() + offset, std::min( SNAPSHOT_CHUNK_SIZE, snapshot.size() - offset ) );
+	}
+	result.snapshot.decompress_ns = GetElapsedNs( started_at );
+
+	started_at = std::chrono::steady_clock::now();
+	const auto crc32 = util::crc32::CRC32::Calculate( snapshot.data(), snapshot.size() );
+	result.snapshot.crc32_ns = GetElapsedNs( started_at );
+	started_at = std::chrono::steady_clock::now();
+	const auto crc32c = util::crc32::CRC32::CalculateC( snapshot.data(), snapshot.size() );
+	result.snapshot.crc32c_ns = GetElapsedNs( started_at );
+	Log( "Snapshot crc32 = " + std::to_string( crc32 ) + ", crc32c = " + std::to_string( crc32c ) ); // also keeps them from being optimized out
+
+	result.snapshot.bytes = snapshot.size();
+	result.snapshot.compressed_bytes = 0;
+	for ( const auto& chunk : chunks ) {
+		result.snapshot.compressed_bytes += chunk.size();
+	}
+
+	if ( !is_valid || std::string_view( decompressed ) != snapshot ) {
+		Log( "Decompressed snapshot does not match original" );
+		return false;
+	}
+	return true;
+}
+
+const bool MapBenchmark::MeasureDump( const game::map::Map* map, util::random::Random* random, result_t& result ) const {
+	auto started_at = std::chrono::steady_clock::now();
+	const auto buf = map->Serialize();
+	result.dump.serialize_ns = GetElapsedNs( started_at );
+	result.dump.bytes = buf.ToStringView().size();
+
+	NEWV( unserialized, game::map::Map, random );
+	started_at = std::chrono::steady_clock::now();
+	unserialized->Unserialize( buf );
+	result.dump.unserialize_ns = GetElapsedNs( started_at );
+
+	const bool is_valid = unserialized->Serialize().ToStringView() == buf.ToStringView();
+	DeleteMap( unserialized );
+	if ( !is_valid ) {
+		Log( "Unserialized map dump does not match original" );
+		return false;
+	}
+	return true;
+}
+
+void MapBenchmark::MeasurePages( const game::map::Map* map, result_t& result ) const {
+	const auto* texture = map->m_textures.terrain;
+	NEWV( page, types::texture::Texture, "TerrainPage", texture->GetPageWidth(), texture->GetPageHeight() );
+	const auto started_at = std::chrono::steady_clock::now();
+	for ( size_t i = 0 ; i < texture->GetPagesCount() ; i++ ) {
+		texture->CompositePage( i, page );
+	}
+	result.pages.composite_ns = GetElapsedNs( started_at );
+	result.pages.count = texture->GetPagesCount();
+	DELETE( page );
+}
+
+void MapBenchmark::DeleteMap( game::map::Map* map ) {
+	// nobody took ownership of these
+	if ( map->m_textures.terrain ) {
+		DELETE( map->m_textures.terrain );
+	}
+	if ( map->m_meshes.terrain ) {
+		DELETE( map->m_meshes.terrain );
+	}
+	if ( map->m_meshes.terrain_data ) {
+		DELETE( map->m_meshes.terrain_data );
+	}
+	DELETE( map );
+}
+
+void MapBenchmark::WriteResults() const {
+	const auto& path = g_engine->GetConfig()->GetMapBenchmarkOutput();
+
+	std::string json = "{\n";
+	json += "\t\"threads\": " + std::to_string( g_engine->GetJobSystem()->GetWorkersCount() ) + ",\n";
+	json += (std::string)"\t\"crc32c_hardware\": " + ( util::crc32::CRC32::IsHardwareAccelerated()
+		? "true"
+		: "false" ) + ",\n";
+	json += "\t\"results\": [";
+	for ( size_t i = 0 ; i < m_results.size() ; i++ ) {
+		const auto& r = m_results[ i ];
+		json += ( i
+			? ",\n"
+			: "\n" );
+		json += "\t\t{\n";
+		json += "\t\t\t\"width\": " + std::to_string( r.c.size.x ) + ",\n";
+		json += "\t\t\t\"height\": " + std::to_string( r.c.size.y ) + ",\n";
+		json += "\t\t\t\"seed\": " + std::to_string( r.c.seed ) + ",\n";
+		json += "\t\t\t\"generate_ns\": " + std::to_string( r.generate_ns ) + ",\n";
+		json += "\t\t\t\"initialize_ns\": " + std::to_string( r.initialize_ns ) + ",\n";
+		json += "\t\t\t\"copy_from_after_ns\": " + std::to_string( r.profile.copy_from_after_ns ) + ",\n";
+		json += "\t\t\t\"meshes_finalize_ns\": " + std::to_string( r.profile.meshes_finalize_ns ) + ",\n";
+		json += "\t\t\t\"fix_normals_ns\": " + std::to_string( r.profile.fix_normals_ns ) + ",\n";
+		json += "\t\t\t\"peak_rss_bytes\": " + std::to_string( r.peak_rss ) + ",\n"; // of whole process so far, not of this case alone
+		json += "\t\t\t\"snapshot_bytes\": " + std::to_string( r.snapshot.bytes ) + ",\n";
+		json += "\t\t\t\"snapshot_serialize_ns\": " + std::to_string( r.snapshot.serialize_ns ) + ",\n";
+		json += "\t\t\t\"snapshot_unserialize_ns\": " + std::to_string( r.snapshot.unserialize_ns ) + ",\n";
+		json += "\t\t\t\"snapshot_compressed_bytes\": " + std::to_string( r.snapshot.compressed_bytes ) + ",\n";
+		json += "\t\t\t\"snapshot_compress_ns\": " + std::to_string( r.snapshot.compress_ns ) + ",\n";
+		json += "\t\t\t\"snapshot_decompress_ns\": " + std::to_string( r.snapshot.decompress_ns ) + ",\n";
+		json += "\t\t\t\"snapshot_crc32_ns\": " + std::to_string( r.snapshot.crc32_ns ) + ",\n";
+		json += "\t\t\t\"snapshot_crc32c_ns\": " + std::to_string( r.snapshot.crc32c_ns ) + ",\n";
+		json += "\t\t\t\"dump_bytes\": " + std::to_string( r.dump.bytes ) + ",\n";
+		json += "\t\t\t\"dump_serialize_ns\": " + std::to_string( r.dump.serialize_ns ) + ",\n";
+		json += "\t\t\t\"dump_unserialize_ns\": " + std::to_string( r.dump.unserialize_ns ) + ",\n";
+		json += "\t\t\t\"pages_count\": " + std::to_string( r.pages.count ) + ",\n";
+		json += "\t\t\t\"pages_composite_ns\": " + std::to_string( r.pages.composite_ns ) + ",\n";
+		json += "\t\t\t\"passes\": [";
+		for ( size_t p = 0 ; p < r.profile.passes.size() ; p++ ) {
+			const auto& pass = r.profile.passes[ p ];
+			json += ( p
+				? ",\n"
+				: "\n" );
+			json += "\t\t\t\t{\n";
+			json += "\t\t\t\t\t\"wall_ns\": " + std::to_string( pass.wall_ns ) + ",\n";
+			json += "\t\t\t\t\t\"modules\": {";
+			for ( size_t m = 0 ; m < pass.modules_ns.size() ; m++ ) {
+				json += ( m
+					? ", "
+					: " " );
+				json += "\"" + pass.modules_ns[ m ].first + "\": " + std::to_string( pass.modules_ns[ m ].second );
+			}
+			json += " }\n";
+			json += "\t\t\t\t}";
+		}
+		json += "\n\t\t\t]\n";
+		json += "\t\t}";
+	}
+	json += "\n\t]\n}\n";
+
+	util::FS::WriteFile( path, json );
+	std::cout << "Map benchmark results saved to " << path << std::endl;
+}
+
+}
+}
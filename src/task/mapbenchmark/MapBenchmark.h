@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/Task.h"
+
+#include "game/map/Map.h"
+#include "types/Vec2.h"
+#include "util/random/Types.h"
+
+namespace task {
+namespace mapbenchmark {
+
+// generates and initializes maps without rendering and writes timings of every stage to json file
+CLASS( MapBenchmark, common::Task )
+	void Start() override;
+	void Stop() override;
+	void Iterate() override;
+
+private:
+	struct case_t {
+		types::Vec2< size_t > size;
+		util::random::value_t seed;
+	};
+	std::vector< case_t > m_cases = {};
+	size_t m_current_case_index = 0;
+
+	struct result_t {
+		case_t c;
+		uint64_t generate_ns;
+		uint64_t initialize_ns;
+		size_t peak_rss;
+		game::map::Map::profile_t profile;
+		struct {
+			size_t bytes;
+			uint64_t serialize_ns;
+			uint64_t unserialize_ns;
+			size_t compressed_bytes;
+			uint64_t compress_ns;
+			uint64_t decompress_ns;
+			uint64_t crc32_ns; // table-based
+			uint64_t crc32c_ns; // hardware-accelerated if possible
+		} snapshot; // of map as it's sent during download
+		struct {
+			size_t bytes;
+			uint64_t serialize_ns;
+			uint64_t unserialize_ns;
+		} dump; // of whole map, including meshes and operations of terrain texture
+		struct {
+			size_t count;
+			uint64_t composite_ns;
+		} pages; // of terrain texture, composited by renderer when they are needed
+	};
+	std::vector< result_t > m_results = {};
+
+	const size_t SNAPSHOT_CHUNK_SIZE = 65536; // same as download chunks, each is compressed separately
+
+	const bool RunCase( const case_t& c );
+	const bool MeasureSnapshot( const game::map::Map* map, result_t& result ) const;
+	const bool MeasureDump( const game::map::Map* map, util::random::Random* random, result_t& result ) const;
+	void MeasurePages( const game::map::Map* map, result_t& result ) const;
+	static void DeleteMap( game::map::Map* map );
+	void WriteResults() const;
+};
+
+}
+}
@@ -0,0 +1,114 @@
+#include <iostream> // results summary should be printed with --quiet too
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#include "MTBenchmark.h"
+
+#include "engine/Engine.h"
+#include "common/MTModule.h"
+#include "common/Thread.h"
+
+namespace task {
+namespace mtbenchmark {
+
+struct echo_request_t {
+	size_t value;
+};
+struct echo_response_t {
+	size_t value; // request value + 1, so that 0 means no response yet
+};
+typedef common::MTModule< echo_request_t, echo_response_t > MTModule;
+
+// does nothing except answering, so that only transport is measured
+CLASS( Echo, MTModule )
+protected:
+	const echo_response_t ProcessRequest( const echo_request_t& request, MT_CANCELABLE ) override {
+		return { request.value + 1 };
+	}
+	void DestroyRequest( const echo_request_t& request ) override {}
+	void DestroyResponse( const echo_response_t& response ) override {}
+};
+
+static inline uint64_t GetElapsedNs( const std::chrono::steady_clock::time_point& since ) {
+	return std::chrono::duration_cast< std::chrono::nanoseconds >( std::chrono::steady_clock::now() - since ).count();
+}
+
+void MTBenchmark::Iterate() {
+	if ( m_is_finished ) {
+		return;
+	}
+	m_is_finished = true;
+
+	NEWV( echo, Echo );
+	NEWV( thread, common::Thread, "MTBENCHMARK" );
+	thread->SetWakeable( 100 ); // requests wake it up
+	thread->AddModule( echo );
+	thread->T_Start();
+
+	bool is_valid = true;
+
+	Log( "Measuring latency of " + std::to_string( ROUNDTRIPS ) + " round-trips" );
+	std::vector< uint64_t > latencies = {};
+	latencies.reserve( ROUNDTRIPS );
+	auto started_at = std::chrono::steady_clock::now();
+	for ( size_t i = 0 ; i < ROUNDTRIPS ; i++ ) {
+		const auto request_started_at = std::chrono::steady_clock::now();
+		const auto response = echo->MT_WaitResponse( echo->MT_CreateRequest( { i } ) );
+		latencies.push_back( GetElapsedNs( request_started_at ) );
+		is_valid &= response.value == i + 1;
+	}
+	const auto roundtrips_ns = GetElapsedNs( started_at );
+	std::sort( latencies.begin(), latencies.end() );
+
+	Log( "Measuring throughput of " + std::to_string( BATCHES ) + " batches" );
+	std::vector< common::mt_id_t > mt_ids( BATCH_SIZE );
+	started_at = std::chrono::steady_clock::now();
+	for ( size_t b = 0 ; b < BATCHES ; b++ ) {
+		for ( size_t i = 0 ; i < BATCH_SIZE ; i++ ) {
+			mt_ids[ i ] = echo->MT_CreateRequest( { i } );
+		}
+		for ( size_t i = 0 ; i < BATCH_SIZE ; i++ ) {
+			is_valid &= echo->MT_WaitResponse( mt_ids[ i ] ).value == i + 1;
+		}
+	}
+	const auto batches_ns = GetElapsedNs( started_at );
+
+	thread->T_Stop();
+	while ( thread->T_IsRunning() ) {
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+	}
+	DELETE( thread );
+	DELETE( echo );
+
+	if ( !is_valid ) {
+		std::cout << "  FAILED: invalid responses" << std::endl;
+	}
+	else {
+		const size_t requests = BATCHES * BATCH_SIZE;
+		std::cout << "  round-trip latency: avg " << FormatNs( roundtrips_ns / ROUNDTRIPS )
+			<< ", p50 " << FormatNs( GetPercentile( latencies, 0.5f ) )
+			<< ", p99 " << FormatNs( GetPercentile( latencies, 0.99f ) )
+			<< ", max " << FormatNs( latencies.back() )
+			<< std::endl;
+		std::cout << "  throughput: " << requests * 1000000000 / std::max< uint64_t >( batches_ns, 1 ) << " requests/s"
+			<< " ( batches of " << BATCH_SIZE << " )"
+			<< std::endl;
+	}
+
+	g_engine->ShutDown();
+}
+
+const std::string MTBenchmark::FormatNs( const uint64_t ns ) {
+	return ns >= 10000
+		? std::to_string( ns / 1000 ) + "us"
+		: std::to_string( ns ) + "ns";
+}
+
+const uint64_t MTBenchmark::GetPercentile( const std::vector< uint64_t >& sorted_values, const float percentile ) {
+	ASSERT_NOLOG( !sorted_values.empty(), "no values" );
+	return sorted_values[ std::min< size_t >( sorted_values.size() * percentile, sorted_values.size() - 1 ) ];
+}
+
+}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/Task.h"
+
+namespace task {
+namespace mtbenchmark {
+
+// measures round-trip latency and throughput of MT requests between this thread and separate module thread
+CLASS( MTBenchmark, common::Task )
+	void Iterate() override;
+
+private:
+	const size_t ROUNDTRIPS = 100000; // sequential, each waits for previous response
+	const size_t BATCHES = 10000;
+	const size_t BATCH_SIZE = 64; // requests created before waiting for any response
+
+	bool m_is_finished = false;
+
+	static const std::string FormatNs( const uint64_t ns );
+	static const uint64_t GetPercentile( const std::vector< uint64_t >& sorted_values, const float percentile );
+};
+
+}
+}
@@ -0,0 +1,292 @@
+#include <cstring>
+
+#include "Tests.h"
+#include "SelfTests.h"
+
+#include "types/Buffer.h"
+#include "types/Packet.h"
+
+namespace task {
+namespace selftests {
+
+using types::Buffer;
+
+static void WriteValues( Buffer& buf, const long long int seed ) {
+	buf.WriteBool( seed & 1 );
+	buf.WriteInt( seed );
+	buf.WriteInt( -seed * 1000003 );
+	buf.WriteInt( INT64_MIN + seed );
+	buf.WriteFloat( seed * 0.25f );
+	buf.WriteString( "value " + std::to_string( seed ) );
+	buf.WriteString( "" );
+	buf.WriteVec2u(
+		{
+			(uint32_t)seed,
+			UINT32_MAX
+		}
+	);
+	buf.WriteVec2f(
+		{
+			-1.5f,
+			(float)seed
+		}
+	);
+	buf.WriteVec3(
+		{
+			1.0f,
+			-2.0f,
+			(float)seed
+		}
+	);
+	buf.WriteColor( types::Color( 0.1f, 0.2f, 0.3f, 0.4f ) );
+	const std::string data = std::string( "raw\0data", 8 ) + std::to_string( seed ); // with zero byte inside
+	buf.WriteData( data.data(), data.size() );
+}
+
+// returns error or empty string
+static const std::string ReadValues( Buffer& buf, const long long int seed ) {
+#define CHECK( _condition ) \
+    if ( !( _condition ) ) { \
+        return "value mismatch [ " #_condition " ] ( seed " + std::to_string( seed ) + " )"; \
+    }
+	CHECK( buf.ReadBool() == (bool)( seed & 1 ) );
+	CHECK( buf.ReadInt() == seed );
+	CHECK( buf.ReadInt() == -seed * 1000003 );
+	CHECK( buf.ReadInt() == INT64_MIN + seed );
+	CHECK( buf.ReadFloat() == seed * 0.25f );
+	CHECK( buf.ReadString() == "value " + std::to_string( seed ) );
+	CHECK( buf.ReadStringView().empty() );
+	const auto vec2u = buf.ReadVec2u();
+	CHECK( vec2u.x == (uint32_t)seed && vec2u.y == UINT32_MAX );
+	const auto vec2f = buf.ReadVec2f();
+	CHECK( vec2f.x == -1.5f && vec2f.y == (float)seed );
+	const auto vec3 = buf.ReadVec3();
+	CHECK( vec3.x == 1.0f && vec3.y == -2.0f && vec3.z == (float)seed );
+	auto expected_color = types::Color( 0.1f, 0.2f, 0.3f, 0.4f );
+	CHECK( buf.ReadColor() == expected_color );
+	const std::string data = std::string( "raw\0data", 8 ) + std::to_string( seed );
+	auto* read_data = (const char*)buf.ReadData( data.size() );
+	const bool is_data_same = !memcmp( read_data, data.data(), data.size() );
+	free( (void*)read_data );
+	CHECK( is_data_same );
+#undef CHECK
+	return "";
+}
+
+static const bool IsRejected( const std::string& serialized ) {
+	try {
+		Buffer buf( serialized );
+		ReadValues( buf, 0 );
+	}
+	catch ( std::runtime_error& e ) {
+		return true;
+	}
+	return false;
+}
+
+void AddBufferTests( SelfTests* task ) {
+
+	const Buffer::encoding_t encodings[] = {
+		Buffer::E_TAGGED,
+		Buffer::E_COMPACT,
+	};
+
+	for ( const auto encoding : encodings ) {
+		const std::string suffix = encoding == Buffer::E_COMPACT
+			? " (compact)"
+			: " (tagged)";
+
+		task->AddTest(
+			"test if buffer values round-trip" + suffix,
+			ST( encoding ) {
+				for ( long long int seed = 0 ; seed < 1000 ; seed += 37 ) {
+					Buffer buf( encoding );
+					WriteValues( buf, seed );
+					const std::string serialized = buf.ToString();
+					Buffer read_buf( serialized );
+					ST_ASSERT( read_buf.GetEncoding() == encoding, "encoding was not detected" );
+					const auto errmsg = ReadValues( read_buf, seed );
+					if ( !errmsg.empty() ) {
+						ST_FAIL( errmsg );
+					}
+				}
+				ST_OK();
+			}
+		);
+
+		task->AddTest(
+			"test if nested buffers round-trip" + suffix,
+			ST( encoding ) {
+				Buffer buf( encoding );
+				buf.WriteInt( 3 );
+				for ( long long int i = 0 ; i < 3 ; i++ ) {
+					buf.WriteNested(
+						[ i ]( Buffer& b ) {
+							WriteValues( b, i );
+							b.WriteNested(
+								[ i ]( Buffer& b2 ) {
+									WriteValues( b2, i + 100 );
+								}
+							);
+						}
+					);
+				}
+				// same as nested, but built separately
+				Buffer separate( encoding );
+				WriteValues( separate, 200 );
+				buf.WriteString( separate.ToStringView() );
+
+				Buffer read_buf( buf.ToString() );
+				ST_ASSERT( read_buf.ReadInt() == 3 );
+				for ( long long int i = 0 ; i < 3 ; i++ ) {
+					auto nested = read_buf.ReadNested();
+					auto errmsg = ReadValues( nested, i );
+					if ( !errmsg.empty() ) {
+						ST_FAIL( errmsg );
+					}
+					auto nested2 = nested.ReadNested();
+					errmsg = ReadValues( nested2, i + 100 );
+					if ( !errmsg.empty() ) {
+						ST_FAIL( errmsg );
+					}
+				}
+				auto separate_read = read_buf.ReadNested();
+				const auto errmsg = ReadValues( separate_read, 200 );
+				if ( !errmsg.empty() ) {
+					ST_FAIL( errmsg );
+				}
+				ST_OK();
+			}
+		);
+
+		task->AddTest(
+			"test if writing into read view doesn't affect original buffer" + suffix,
+			ST( encoding ) {
+				Buffer buf( encoding );
+				buf.WriteNested(
+					[]( Buffer& b ) {
+						WriteValues( b, 5 );
+					}
+				);
+				const std::string serialized = buf.ToString();
+				Buffer read_buf( serialized );
+				auto view = read_buf.ReadNested();
+				view.WriteInt( 42 );
+				auto errmsg = ReadValues( view, 5 );
+				if ( !errmsg.empty() ) {
+					ST_FAIL( errmsg );
+				}
+				ST_ASSERT( view.ReadInt() == 42 );
+				ST_ASSERT( read_buf.ToString() == serialized, "original buffer was modified" );
+				ST_OK();
+			}
+		);
+	}
+
+	task->AddTest(
+		"test if compact buffer is embedded into tagged one",
+		ST() {
+			Buffer compact( Buffer::E_COMPACT );
+			WriteValues( compact, 7 );
+			Buffer tagged( Buffer::E_TAGGED );
+			tagged.WriteString( compact.ToStringView() );
+			tagged.WriteInt( 8 );
+			Buffer read_buf( tagged.ToString() );
+			ST_ASSERT( read_buf.GetEncoding() == Buffer::E_TAGGED );
+			auto nested = read_buf.ReadNested();
+			ST_ASSERT( nested.GetEncoding() == Buffer::E_COMPACT );
+			auto errmsg = ReadValues( nested, 7 );
+			if ( !errmsg.empty() ) {
+				ST_FAIL( errmsg );
+			}
+			ST_ASSERT( read_buf.ReadInt() == 8 );
+
+			// view has its own crc, it must stay valid after appending
+			nested.WriteInt( 9 );
+			Buffer reread( nested.ToString() );
+			errmsg = ReadValues( reread, 7 );
+			if ( !errmsg.empty() ) {
+				ST_FAIL( errmsg );
+			}
+			ST_ASSERT( reread.ReadInt() == 9 );
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if compact buffer with wrong crc is rejected",
+		ST() {
+			Buffer buf( Buffer::E_COMPACT );
+			WriteValues( buf, 11 );
+			const std::string serialized = buf.ToString();
+			ST_ASSERT( !IsRejected( serialized ), "valid buffer was rejected" );
+			for ( size_t i = 1 ; i < serialized.size() ; i++ ) { // first byte is marker, changing it changes encoding
+				std::string corrupted = serialized;
+				corrupted[ i ] ^= 0x10;
+				ST_ASSERT( IsRejected( corrupted ), "corrupted byte " + std::to_string( i ) + " was not detected" );
+			}
+			ST_ASSERT( IsRejected( serialized.substr( 0, serialized.size() - 1 ) ), "truncated buffer was not detected" );
+			ST_ASSERT( IsRejected( serialized + '\0' ), "extended buffer was not detected" );
+
+			// same for compact buffer embedded into tagged one
+			Buffer tagged( Buffer::E_TAGGED );
+			tagged.WriteString( serialized.substr( 0, serialized.size() - 1 ) + (char)( serialized.back() ^ 1 ) );
+			Buffer read_buf( tagged.ToString() );
+			bool is_rejected = false;
+			try {
+				read_buf.ReadNested();
+			}
+			catch ( std::runtime_error& e ) {
+				is_rejected = true;
+			}
+			ST_ASSERT( is_rejected, "corrupted nested buffer was not detected" );
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if compact buffer crc is kept up to date while writing",
+		ST() {
+			Buffer buf( Buffer::E_COMPACT );
+			const Buffer& const_buf = buf;
+			for ( long long int i = 0 ; i < 20 ; i++ ) {
+				WriteValues( buf, i );
+				const std::string first = std::string( const_buf.ToStringView() );
+				const std::string second = std::string( const_buf.ToStringView() );
+				ST_ASSERT( first == second, "serialized buffer changed between reads" );
+				ST_ASSERT( !IsRejected( first ), "crc is not valid after " + std::to_string( i ) + " writes" );
+				const Buffer copy( buf );
+				ST_ASSERT( copy.ToString() == first, "copy has different data" );
+			}
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if packets with different encodings coexist",
+		ST() {
+			types::Packet tagged_packet( types::Packet::PT_MESSAGE );
+			tagged_packet.encoding = Buffer::E_TAGGED;
+			tagged_packet.data.str = "tagged";
+			types::Packet compact_packet( types::Packet::PT_MESSAGE );
+			compact_packet.encoding = Buffer::E_COMPACT;
+			compact_packet.data.str = "compact";
+
+			const auto tagged_buf = tagged_packet.Serialize();
+			const auto compact_buf = compact_packet.Serialize();
+			ST_ASSERT( tagged_buf.GetEncoding() == Buffer::E_TAGGED );
+			ST_ASSERT( compact_buf.GetEncoding() == Buffer::E_COMPACT );
+
+			types::Packet read_packet( types::Packet::PT_NONE );
+			read_packet.Unserialize( Buffer( tagged_buf.ToString() ) );
+			ST_ASSERT( read_packet.type == types::Packet::PT_MESSAGE && read_packet.data.str == "tagged" );
+			read_packet.Unserialize( Buffer( compact_buf.ToString() ) );
+			ST_ASSERT( read_packet.type == types::Packet::PT_MESSAGE && read_packet.data.str == "compact" );
+			ST_OK();
+		}
+	);
+
+}
+
+}
+}
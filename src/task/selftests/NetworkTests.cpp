@@ -0,0 +1,316 @@
+#include <chrono>
+#include <functional>
+
+#include "Tests.h"
+#include "SelfTests.h"
+
+#include "network/simpletcp/SimpleTCP.h"
+#include "types/Packet.h"
+
+namespace task {
+namespace selftests {
+
+using network::simpletcp::SimpleTCP;
+using network::Event;
+
+// set explicitly so that tests don't depend on config
+static const size_t COMPRESSION_THRESHOLD = 512;
+static const size_t RECEIVE_BUFFER_LIMIT = 64 * 1024 * 1024;
+
+// much bigger than socket buffers, so frames are always sent and received in many parts
+static const size_t LARGE_PACKET_SIZE = 12 * 1024 * 1024;
+
+static const std::chrono::seconds TIMEOUT{ 30 };
+
+// server and client are iterated in same thread and talk over loopback
+struct loopback_t {
+	SimpleTCP* server = nullptr;
+	SimpleTCP* client = nullptr;
+	network::cid_t cid = 0; // of client on server
+};
+
+static const std::string CreateCompressiblePacket( const size_t size ) {
+	std::string result = "";
+	result.reserve( size + 64 );
+	for ( size_t line = 0 ; result.size() < size ; line++ ) {
+		result += "line " + std::to_string( line ) + " of compressible packet\n";
+	}
+	result.resize( size );
+	return result;
+}
+
+static const std::string CreateIncompressiblePacket( const size_t size, uint32_t seed ) {
+	std::string result( size, '\0' );
+	for ( auto& c : result ) {
+		seed = seed * 1664525 + 1013904223; // lcg, to get same data everywhere
+		c = (char)( seed >> 24 );
+	}
+	return result;
+}
+
+// iterates both sides until receiver gets event of given type, unexpected disconnects and errors fail immediately
+static const std::string WaitForEvent( loopback_t& loopback, SimpleTCP* receiver, const Event::event_type_t type, Event* result = nullptr ) {
+	const auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+	while ( std::chrono::steady_clock::now() < deadline ) {
+		loopback.server->Iterate();
+		loopback.client->Iterate();
+		const auto mt_id = receiver->MT_GetEvents();
+		receiver->Iterate();
+		const auto response = receiver->MT_GetResult( mt_id );
+		for ( const auto& event : response.events ) {
+			if ( event.type == type ) {
+				if ( result ) {
+					*result = event;
+				}
+				return "";
+			}
+			switch ( event.type ) {
+				case Event::ET_ERROR: {
+					return "network error: " + event.data.packet_data;
+				}
+				case Event::ET_DISCONNECT:
+				case Event::ET_CLIENT_DISCONNECT: {
+					return "unexpected disconnect ( event " + std::to_string( event.type ) + " )";
+				}
+				default: {
+					// listen, backpressure etc
+				}
+			}
+		}
+	}
+	return "timeout while waiting for event " + std::to_string( type );
+}
+
+static const std::string RoundTrip( loopback_t& loopback, const bool is_to_client, const std::string& message ) {
+	types::Packet packet( types::Packet::PT_MESSAGE );
+	packet.data.str = message;
+	SimpleTCP* receiver;
+	if ( is_to_client ) {
+		loopback.server->MT_SendPacket( &packet, loopback.cid );
+		receiver = loopback.client;
+	}
+	else {
+		loopback.client->MT_SendPacket( &packet );
+		receiver = loopback.server;
+	}
+	Event event;
+	const auto errmsg = WaitForEvent( loopback, receiver, Event::ET_PACKET, &event );
+	if ( !errmsg.empty() ) {
+		return errmsg;
+	}
+	types::Packet received( types::Packet::PT_NONE );
+	received.Unserialize( types::Buffer( event.data.packet_data ) );
+	if ( received.type != types::Packet::PT_MESSAGE || received.data.str != message ) {
+		return "packet mismatch ( size " + std::to_string( message.size() ) + ", received size " + std::to_string( received.data.str.size() ) + " )";
+	}
+	return "";
+}
+
+static const std::string Connect( loopback_t& loopback ) {
+	auto mt_id = loopback.server->MT_Connect( network::CM_SERVER );
+	loopback.server->Iterate();
+	auto response = loopback.server->MT_GetResult( mt_id );
+	if ( response.result != network::R_SUCCESS ) {
+		return "failed to listen ( is other instance running? ): " + response.message;
+	}
+
+	mt_id = loopback.client->MT_Connect( network::CM_CLIENT, "127.0.0.1" );
+	loopback.client->Iterate();
+	response = loopback.client->MT_GetResult( mt_id );
+	if ( response.result != network::R_SUCCESS ) {
+		return "failed to connect: " + response.message;
+	}
+
+	Event event;
+	auto errmsg = WaitForEvent( loopback, loopback.server, Event::ET_CLIENT_CONNECT, &event );
+	if ( !errmsg.empty() ) {
+		return errmsg;
+	}
+	loopback.cid = event.cid;
+
+	// capabilities are sent first, so after receiving any packet from other side it's known what it supports
+	errmsg = RoundTrip( loopback, false, "hello" );
+	if ( !errmsg.empty() ) {
+		return errmsg;
+	}
+	return RoundTrip( loopback, true, "hello" );
+}
+
+// client connection is configured by caller
+static const std::string RunLoopback(
+	const size_t client_compression_threshold,
+	const size_t client_receive_buffer_limit,
+	const std::function< std::string( loopback_t& loopback ) >& test
+) {
+	loopback_t loopback = {};
+	NEW( loopback.server, SimpleTCP );
+	NEW( loopback.client, SimpleTCP );
+	loopback.server->Start();
+	loopback.server->SetCompressionThreshold( COMPRESSION_THRESHOLD );
+	loopback.server->SetReceiveBufferLimit( RECEIVE_BUFFER_LIMIT );
+	loopback.client->Start();
+	loopback.client->SetCompressionThreshold( client_compression_threshold );
+	loopback.client->SetReceiveBufferLimit( client_receive_buffer_limit );
+
+	auto errmsg = Connect( loopback );
+	if ( errmsg.empty() ) {
+		errmsg = test( loopback );
+	}
+
+	if ( loopback.cid ) {
+		// client closes connection first, otherwise server port stays in TIME_WAIT and next test can't listen on it
+		const auto mt_id = loopback.client->MT_Disconnect();
+		const auto disconnect_errmsg = WaitForEvent( loopback, loopback.server, Event::ET_CLIENT_DISCONNECT );
+		loopback.client->MT_GetResult( mt_id );
+		if ( errmsg.empty() ) {
+			errmsg = disconnect_errmsg;
+		}
+	}
+	loopback.client->Stop();
+	loopback.server->Stop();
+	DELETE( loopback.client );
+	DELETE( loopback.server );
+	return errmsg;
+}
+
+void AddNetworkTests( SelfTests* task ) {
+
+	task->AddTest(
+		"test if large packets round-trip over loopback",
+		ST() {
+			const auto errmsg = RunLoopback(
+				COMPRESSION_THRESHOLD, RECEIVE_BUFFER_LIMIT, []( loopback_t& loopback ) -> std::string {
+					const std::string packets[] = {
+						"small",
+						CreateIncompressiblePacket( LARGE_PACKET_SIZE, 1 ),
+						CreateCompressiblePacket( LARGE_PACKET_SIZE ),
+						CreateIncompressiblePacket( LARGE_PACKET_SIZE + 3, 2 ), // not aligned to anything
+					};
+					for ( const auto& packet : packets ) {
+						for ( const auto is_to_client : { true, false } ) {
+							const auto errmsg = RoundTrip( loopback, is_to_client, packet );
+							if ( !errmsg.empty() ) {
+								return errmsg;
+							}
+						}
+					}
+					return "";
+				}
+			);
+			if ( !errmsg.empty() ) {
+				ST_FAIL( errmsg );
+			}
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if packets are compressed when both sides support it",
+		ST() {
+			const auto errmsg = RunLoopback(
+				COMPRESSION_THRESHOLD, RECEIVE_BUFFER_LIMIT, []( loopback_t& loopback ) -> std::string {
+					const auto f_check = [ &loopback ]( const size_t server_packets, const size_t client_packets ) -> std::string {
+						const auto server_stats = loopback.server->GetCompressionStats();
+						const auto client_stats = loopback.client->GetCompressionStats();
+						if ( server_stats.packets != server_packets || client_stats.packets != client_packets ) {
+							return "unexpected number of compressed packets ( server: " + std::to_string( server_stats.packets ) + ", client: " + std::to_string( client_stats.packets ) + " )";
+						}
+						if ( server_stats.bytes_after > server_stats.bytes_before || client_stats.bytes_after > client_stats.bytes_before ) {
+							return "compressed packets are not smaller";
+						}
+						return "";
+					};
+					const auto compressible = CreateCompressiblePacket( LARGE_PACKET_SIZE );
+					const auto incompressible = CreateIncompressiblePacket( LARGE_PACKET_SIZE, 3 );
+					const auto below_threshold = CreateCompressiblePacket( COMPRESSION_THRESHOLD / 2 );
+					const struct {
+						const std::string& packet;
+						const bool is_to_client;
+						const size_t server_packets;
+						const size_t client_packets;
+					} cases[] = {
+						{ compressible,    true,  1, 0 },
+						{ compressible,    false, 1, 1 },
+						{ incompressible,  true,  1, 1 }, // sent as is
+						{ incompressible,  false, 1, 1 },
+						{ below_threshold, true,  1, 1 },
+						{ below_threshold, false, 1, 1 },
+					};
+					for ( const auto& c : cases ) {
+						auto errmsg = RoundTrip( loopback, c.is_to_client, c.packet );
+						if ( errmsg.empty() ) {
+							errmsg = f_check( c.server_packets, c.client_packets );
+						}
+						if ( !errmsg.empty() ) {
+							return errmsg;
+						}
+					}
+					return "";
+				}
+			);
+			if ( !errmsg.empty() ) {
+				ST_FAIL( errmsg );
+			}
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if packets are not compressed when peer doesn't support it",
+		ST() {
+			const auto errmsg = RunLoopback(
+				0, RECEIVE_BUFFER_LIMIT, []( loopback_t& loopback ) -> std::string {
+					const auto compressible = CreateCompressiblePacket( LARGE_PACKET_SIZE );
+					for ( const auto is_to_client : { true, false } ) {
+						const auto errmsg = RoundTrip( loopback, is_to_client, compressible );
+						if ( !errmsg.empty() ) {
+							return errmsg;
+						}
+					}
+					// client didn't advertise compression so server must not use it, client has it disabled itself
+					if ( loopback.server->GetCompressionStats().packets || loopback.client->GetCompressionStats().packets ) {
+						return "packets were compressed without both sides supporting it";
+					}
+					return "";
+				}
+			);
+			if ( !errmsg.empty() ) {
+				ST_FAIL( errmsg );
+			}
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if packets over receive buffer limit cause disconnect",
+		ST() {
+			const auto errmsg = RunLoopback(
+				COMPRESSION_THRESHOLD, 1024 * 1024, []( loopback_t& loopback ) -> std::string {
+					auto errmsg = RoundTrip( loopback, true, CreateIncompressiblePacket( 1024 * 1024 - 1024, 4 ) );
+					if ( !errmsg.empty() ) {
+						return errmsg;
+					}
+					// limit applies to frame as it's received ( compressed one is checked against its original size too )
+					types::Packet packet( types::Packet::PT_MESSAGE );
+					packet.data.str = CreateIncompressiblePacket( LARGE_PACKET_SIZE, 5 );
+					loopback.server->MT_SendPacket( &packet, loopback.cid );
+					errmsg = WaitForEvent( loopback, loopback.client, Event::ET_DISCONNECT );
+					if ( !errmsg.empty() ) {
+						return errmsg;
+					}
+					// client is gone already, server only needs to notice it
+					loopback.cid = 0;
+					return WaitForEvent( loopback, loopback.server, Event::ET_CLIENT_DISCONNECT );
+				}
+			);
+			if ( !errmsg.empty() ) {
+				ST_FAIL( errmsg );
+			}
+			ST_OK();
+		}
+	);
+
+}
+
+}
+}
@@ -0,0 +1,118 @@
+#include "Tests.h"
+#include "SelfTests.h"
+
+#include "util/random/Random.h"
+
+namespace task {
+namespace selftests {
+
+using util::random::Random;
+
+static const size_t VALUES_COUNT = 100;
+
+static const std::vector< uint32_t > GetValues( Random& random, const size_t count = VALUES_COUNT ) {
+	std::vector< uint32_t > result = {};
+	result.reserve( count );
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		result.push_back( random.GetUInt() );
+	}
+	return result;
+}
+
+void AddRandomTests( SelfTests* task ) {
+
+	task->AddTest(
+		"test if counter-based random state survives string round-trip",
+		ST() {
+			Random random( 12345 );
+			random.SetCounterStream( 67890, 3 );
+			GetValues( random ); // move counter away from zero
+			random.Advance( (uint64_t)UINT32_MAX + 5 ); // so that high half of counter is used too
+			const auto state_str = random.GetStateString();
+			const auto expected = GetValues( random );
+
+			Random restored( 1 );
+			restored.SetState( Random::GetStateFromString( state_str ) );
+			ST_ASSERT( restored.IsCounterBased(), "restored random is not counter-based" );
+			ST_ASSERT( restored.GetStateString() == state_str, "state string differs after restoring" );
+			ST_ASSERT( GetValues( restored ) == expected, "restored random produces different values" );
+
+			// sequential states keep their format
+			Random sequential( 555 );
+			const auto sequential_state_str = sequential.GetStateString();
+			const auto sequential_expected = GetValues( sequential );
+			restored.SetState( Random::GetStateFromString( sequential_state_str ) );
+			ST_ASSERT( !restored.IsCounterBased(), "restored random is counter-based" );
+			ST_ASSERT( GetValues( restored ) == sequential_expected, "restored sequential random produces different values" );
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if random forks are deterministic and don't advance parent",
+		ST() {
+			for ( const bool is_counter_based : { false, true } ) {
+				Random parent( 777 );
+				if ( is_counter_based ) {
+					parent.SetCounterStream( 777 );
+				}
+				const auto state_str = parent.GetStateString();
+				auto fork1 = parent.Fork( 1 );
+				auto fork1_again = parent.Fork( 1 );
+				auto fork2 = parent.Fork( 2 );
+				ST_ASSERT( parent.GetStateString() == state_str, "fork advanced parent" );
+				ST_ASSERT( fork1.IsCounterBased() && fork2.IsCounterBased(), "fork is not counter-based" );
+				const auto values1 = GetValues( fork1 );
+				ST_ASSERT( GetValues( fork1_again ) == values1, "same stream id gave different forks" );
+				ST_ASSERT( GetValues( fork2 ) != values1, "different stream ids gave same forks" );
+				ST_ASSERT( GetValues( parent ) != values1, "fork produces same values as parent" );
+			}
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if random advance skips same values as generating them",
+		ST() {
+			for ( const bool is_counter_based : { false, true } ) {
+				Random generated( 4242 );
+				if ( is_counter_based ) {
+					generated.SetCounterStream( 4242, 7 );
+				}
+				auto advanced = generated;
+				GetValues( generated, 1000 );
+				advanced.Advance( 1000 );
+				ST_ASSERT( advanced.GetStateString() == generated.GetStateString(), "states differ after advance" );
+				ST_ASSERT( GetValues( advanced ) == GetValues( generated ), "values differ after advance" );
+			}
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if random fill doesn't depend on batch size",
+		ST() {
+			Random random( 99 );
+			random.SetCounterStream( 99 );
+			auto random2 = random;
+			auto random3 = random;
+			float whole[ VALUES_COUNT ];
+			float parts[ VALUES_COUNT ];
+			random.Fill( whole, VALUES_COUNT, -2.0f, 3.0f );
+			random2.Fill( parts, 37, -2.0f, 3.0f );
+			random2.Fill( parts + 37, VALUES_COUNT - 37, -2.0f, 3.0f );
+			for ( size_t i = 0 ; i < VALUES_COUNT ; i++ ) {
+				ST_ASSERT( whole[ i ] >= -2.0f && whole[ i ] < 3.0f, "value out of range: " + std::to_string( whole[ i ] ) );
+				ST_ASSERT( whole[ i ] == parts[ i ], "value " + std::to_string( i ) + " differs" );
+			}
+			// consumes one value per element
+			random3.Advance( VALUES_COUNT );
+			ST_ASSERT( random3.GetStateString() == random.GetStateString(), "fill consumed unexpected amount of values" );
+			ST_OK();
+		}
+	);
+
+}
+
+}
+}
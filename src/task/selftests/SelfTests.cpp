@@ -0,0 +1,79 @@
+#include <iostream> // not using Log() everywhere because important stuff should be printed with --quiet too
+
+#include "SelfTests.h"
+
+#include "Tests.h"
+#include "engine/Engine.h"
+
+namespace task {
+namespace selftests {
+
+void SelfTests::Start() {
+	Log( "Loading tests" );
+	AddTextureTests( this );
+	AddBufferTests( this );
+	AddNetworkTests( this );
+	AddRandomTests( this );
+}
+
+void SelfTests::Stop() {
+	if ( m_stats.failed == 0 ) {
+		LogTest( "All tests passed." );
+	}
+	else {
+		LogTest( "Testing complete, passed: " + std::to_string( m_stats.passed ) + ", failed: " + std::to_string( m_stats.failed ) );
+	}
+	m_tests.clear();
+	m_stats.passed = 0;
+	m_stats.failed = 0;
+}
+
+void SelfTests::Iterate() {
+	if ( current_test_index < m_tests.size() ) {
+		const auto& it = m_tests[ current_test_index++ ];
+		LogTest( "  " + it.first + "..." );
+		std::string errmsg;
+		try {
+			errmsg = it.second();
+		}
+		catch ( std::runtime_error& e ) {
+			errmsg = (std::string)"exception: " + e.what();
+		}
+		if ( errmsg.empty() ) {
+			m_stats.passed++;
+		}
+		else {
+			m_stats.failed++;
+			LogTest( "    !!! TEST FAILED: " + errmsg );
+		}
+	}
+	else if ( current_test_index == m_tests.size() ) {
+		current_test_index++;
+		g_engine->ShutDown(
+			m_stats.failed == 0
+				? EXIT_SUCCESS
+				: EXIT_FAILURE
+		);
+	}
+}
+
+void SelfTests::AddTest( const std::string& name, const self_test_t test ) {
+	m_tests.push_back(
+		{
+			name,
+			test
+		}
+	);
+}
+
+void SelfTests::LogTest( const std::string& text, bool is_debug ) {
+	if ( is_debug ) {
+		Log( text );
+	}
+	else {
+		std::cout << text << std::endl;
+	}
+}
+
+}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "common/Task.h"
+
+namespace task {
+namespace selftests {
+
+// tests of engine internals that must behave same in every build type ( unlike gse tests that are debug-only )
+typedef std::function< std::string() > self_test_t;
+#define ST( ... ) [ __VA_ARGS__ ]() -> std::string
+
+#define ST_LOG( _text ) { \
+    task->LogTest( _text );\
+}
+
+#define ST_OK() {\
+    return "";\
+}
+
+#define ST_FAIL( _text ) {\
+    return (std::string)__FILE__ + ":" + std::to_string(__LINE__) + ": " + ( _text );\
+}
+
+#define ST_ASSERT( _condition, ... ) {\
+    if ( !( _condition ) ) {\
+        ST_FAIL( (std::string) "assertion failed [ " # _condition " ]: " __VA_ARGS__ );\
+    }\
+}
+
+CLASS( SelfTests, common::Task )
+	void Start() override;
+	void Stop() override;
+	void Iterate() override;
+
+	void AddTest( const std::string& name, const self_test_t test );
+	void LogTest( const std::string& text, bool is_debug = false );
+
+private:
+	size_t current_test_index = 0;
+	std::vector< std::pair< std::string, self_test_t >> m_tests = {};
+
+	struct {
+		size_t passed = 0;
+		size_t failed = 0;
+	} m_stats = {};
+};
+
+}
+}
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace task {
+namespace selftests {
+
+class SelfTests;
+
+void AddTextureTests( SelfTests* task );
+void AddBufferTests( SelfTests* task );
+void AddNetworkTests( SelfTests* task );
+void AddRandomTests( SelfTests* task );
+
+}
+}
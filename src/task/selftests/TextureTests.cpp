@@ -0,0 +1,367 @@
+#include <cstring>
+#include <vector>
+
+#include "Tests.h"
+#include "SelfTests.h"
+
+#include "types/texture/Texture.h"
+#include "util/random/Random.h"
+#include "util/Perlin.h"
+#include "util/crc32/CRC32.h"
+
+namespace task {
+namespace selftests {
+
+using namespace types::texture;
+
+// same as texture.pcx tiles
+static const size_t TILE_SIZE = 56;
+
+// textures are bigger than copied areas so that reading or writing outside of them would be noticed
+static Texture* CreateTestTexture( const std::string& name, uint32_t seed ) {
+	NEWV( texture, Texture, name, TILE_SIZE * 3, TILE_SIZE * 2 );
+	for ( size_t y = 0 ; y < texture->m_height ; y++ ) {
+		for ( size_t x = 0 ; x < texture->m_width ; x++ ) {
+			seed = seed * 1664525 + 1013904223; // lcg, to get same pixels everywhere
+			uint32_t pixel = seed;
+			switch ( seed >> 29 ) {
+				case 0: {
+					pixel &= 0xffffff00; // skipped by AM_MERGE
+					break;
+				}
+				case 1: {
+					pixel &= 0x00ffffff; // transparent, skipped by AM_KEEP_TRANSPARENCY
+					break;
+				}
+				default: {
+				}
+			}
+			texture->SetPixel( x, y, pixel );
+		}
+	}
+	return texture;
+}
+
+static const util::crc32::crc_t GetChecksum( const Texture* texture ) {
+	return util::crc32::CRC32::Calculate( texture->m_bitmap, texture->m_bitmap_size );
+}
+
+// flag, rotation and alpha combinations that map modules pass to Texture::AddFrom() ( via Map::AddTexture(), SetTexture(), GetTexture(), CopyTextureFromLayer() and CopyTextureDeferred() )
+typedef struct {
+	const std::string name;
+	std::vector< add_flag_t > flags;
+	std::vector< rotate_t > rotations;
+	float alpha;
+	util::crc32::crc_t checksum; // of checksums of every flags and rotation combination ( and of rng state after each ), taken from implementation before kernels were added
+} module_usage_t;
+
+static const std::vector< module_usage_t > GetModuleUsages() {
+	const std::vector< rotate_t > all_rotations = {
+		ROTATE_0,
+		ROTATE_90,
+		ROTATE_180,
+		ROTATE_270,
+	};
+	const add_flag_t tile_variant_flags[] = { // see Map::GetTileTextureInfo()
+		AM_RANDOM_MIRROR_X | AM_RANDOM_MIRROR_Y | AM_RANDOM_STRETCH_SHUFFLE,
+		AM_RANDOM_STRETCH,
+	};
+	const add_flag_t rounds[] = {
+		AM_ROUND_LEFT,
+		AM_ROUND_TOP,
+		AM_ROUND_RIGHT,
+		AM_ROUND_BOTTOM,
+	};
+
+	std::vector< module_usage_t > usages = {};
+
+	usages.push_back( { "LandMoisture", {}, all_rotations, 1.0f, 0 } );
+	usages.back().flags.push_back( AM_DEFAULT );
+	usages.back().flags.push_back( AM_RANDOM_STRETCH_SHUFFLE );
+	for ( const auto flags : tile_variant_flags ) {
+		usages.back().flags.push_back( flags );
+	}
+
+	usages.push_back(
+		{
+			"LandSurface moisture blending", {
+				AM_GRADIENT_LEFT | AM_MIRROR_X,
+				AM_GRADIENT_LEFT | AM_GRADIENT_TOP | AM_MIRROR_X | AM_MIRROR_Y,
+				AM_GRADIENT_TOP | AM_MIRROR_Y,
+				AM_GRADIENT_TOP | AM_GRADIENT_RIGHT | AM_MIRROR_X | AM_MIRROR_Y,
+				AM_GRADIENT_RIGHT | AM_MIRROR_X,
+				AM_GRADIENT_RIGHT | AM_GRADIENT_BOTTOM | AM_MIRROR_X | AM_MIRROR_Y,
+				AM_GRADIENT_BOTTOM | AM_MIRROR_Y,
+				AM_GRADIENT_BOTTOM | AM_GRADIENT_LEFT | AM_MIRROR_X | AM_MIRROR_Y,
+			}, { ROTATE_0 }, 0.72f, 0
+		}
+	);
+	for ( auto& flags : usages.back().flags ) {
+		flags |= AM_MERGE | AM_GRADIENT_TIGHTER | AM_RANDOM_STRETCH;
+	}
+
+	usages.push_back(
+		{
+			"LandSurface details", {
+				AM_DEFAULT,
+				AM_MERGE,
+				AM_MERGE | AM_RANDOM_STRETCH | AM_RANDOM_STRETCH_SHRINK | AM_RANDOM_STRETCH_SHIFT,
+				AM_MERGE | AM_RANDOM_STRETCH | AM_RANDOM_STRETCH_SHRINK,
+			}, all_rotations, 1.0f, 0
+		}
+	);
+	for ( const auto flags : tile_variant_flags ) {
+		usages.back().flags.push_back( AM_MERGE | flags );
+	}
+
+	usages.push_back(
+		{
+			"LandSurfacePP", {
+				AM_MERGE,
+				AM_MERGE | AM_KEEP_TRANSPARENCY | AM_MIRROR_X,
+				AM_MERGE | AM_KEEP_TRANSPARENCY | AM_MIRROR_Y,
+			}, { ROTATE_0 }, 1.0f, 0
+		}
+	);
+
+	usages.push_back( { "WaterSurface", { AM_DEFAULT }, all_rotations, 0.4f, 0 } ); // alpha of Coastlines1 water
+
+	usages.push_back( { "WaterSurfacePP", {}, all_rotations, 1.0f, 0 } );
+	for ( const auto flags : tile_variant_flags ) {
+		usages.back().flags.push_back( AM_MERGE | flags | AM_KEEP_TRANSPARENCY | AM_INVERT );
+	}
+
+	usages.push_back( { "Coastlines1 land corners", {}, { ROTATE_0 }, 1.0f, 0 } );
+	for ( size_t rounds_mask = 0 ; rounds_mask < 16 ; rounds_mask++ ) {
+		add_flag_t flags = AM_MERGE | AM_COASTLINE_BORDER;
+		for ( size_t i = 0 ; i < 4 ; i++ ) {
+			if ( rounds_mask & ( 1 << i ) ) {
+				flags |= rounds[ i ];
+			}
+		}
+		usages.back().flags.push_back( flags );
+	}
+
+	usages.push_back( { "Coastlines1 mirrored water corners", {}, { ROTATE_0 }, 1.0f, 0 } );
+	for ( const auto round : rounds ) {
+		for ( const auto mirror : { AM_MIRROR_X | AM_MIRROR_Y, AM_MIRROR_X, AM_MIRROR_Y } ) {
+			usages.back().flags.push_back( AM_MERGE | AM_INVERT | round | mirror );
+		}
+	}
+
+	usages.push_back( { "Coastlines1 default water corners", {}, all_rotations, 1.0f, 0 } );
+	for ( const auto round : rounds ) {
+		usages.back().flags.push_back( AM_MERGE | AM_INVERT | round );
+	}
+
+	usages.push_back( { "Coastlines2", {}, { ROTATE_0 }, 0.37f, 0 } ); // alpha is random perlin base there
+	for ( const auto side : {
+		AM_MIRROR_X | AM_PERLIN_LEFT,
+		AM_MIRROR_Y | AM_PERLIN_TOP,
+		AM_MIRROR_X | AM_PERLIN_RIGHT,
+		AM_MIRROR_Y | AM_PERLIN_BOTTOM,
+	} ) {
+		const bool is_horizontal = side & ( AM_PERLIN_LEFT | AM_PERLIN_RIGHT );
+		for ( size_t cuts_mask = 0 ; cuts_mask < 4 ; cuts_mask++ ) {
+			add_flag_t flags = AM_MERGE | AM_COASTLINE_BORDER | side;
+			if ( cuts_mask & 1 ) {
+				flags |= is_horizontal
+					? AM_PERLIN_CUT_TOP
+					: AM_PERLIN_CUT_LEFT;
+			}
+			if ( cuts_mask & 2 ) {
+				flags |= is_horizontal
+					? AM_PERLIN_CUT_BOTTOM
+					: AM_PERLIN_CUT_RIGHT;
+			}
+			usages.back().flags.push_back( flags );
+		}
+	}
+
+	const util::crc32::crc_t checksums[] = {
+		0x2571ecd5,
+		0xd461cac8,
+		0x8fefe926,
+		0x592add38,
+		0x40216682,
+		0x69ade102,
+		0x95b6e5cc,
+		0xeb8cc1dc,
+		0xb22d06dd,
+		0x266f71de,
+	};
+	ASSERT_NOLOG( usages.size() == sizeof( checksums ) / sizeof( checksums[ 0 ] ), "checksums count mismatch" );
+	for ( size_t i = 0 ; i < usages.size() ; i++ ) {
+		usages[ i ].checksum = checksums[ i ];
+	}
+
+	return usages;
+}
+
+// copies tile-sized area like Map::AddTexture() does, into different place of destination so that both textures are read at unaligned offsets
+static const util::crc32::crc_t AddTileFrom( Texture* dest, const Texture* source, const add_flag_t flags, const rotate_t rotate, const float alpha, const bool is_generic ) {
+	util::random::Random random( 42 );
+	util::Perlin perlin; // default one has fixed permutation
+	if ( is_generic ) {
+		dest->AddFromGeneric( source, flags, TILE_SIZE, 5, TILE_SIZE * 2 - 1, 5 + TILE_SIZE - 1, 33, 21, rotate, alpha, &random, &perlin );
+	}
+	else {
+		dest->AddFrom( source, flags, TILE_SIZE, 5, TILE_SIZE * 2 - 1, 5 + TILE_SIZE - 1, 33, 21, rotate, alpha, &random, &perlin );
+	}
+	// random state must match too, or every texture after this one would differ
+	const auto state = random.GetStateString();
+	return util::crc32::CRC32::Calculate( state.data(), state.size(), GetChecksum( dest ) );
+}
+
+void AddTextureTests( SelfTests* task ) {
+
+	task->AddTest(
+		"test if texture kernels produce same result as generic implementation",
+		ST() {
+			const add_flag_t kernel_flags[] = {
+				AM_MERGE,
+				AM_MIRROR_X,
+				AM_MIRROR_Y,
+				AM_KEEP_TRANSPARENCY,
+			};
+			const size_t kernel_flags_count = sizeof( kernel_flags ) / sizeof( kernel_flags[ 0 ] );
+			const float alphas[] = {
+				1.0f,
+				0.72f,
+				0.5f,
+				0.0f,
+			};
+			// odd size to check row remainders that don't fit into simd registers
+			const size_t sizes[] = {
+				TILE_SIZE,
+				TILE_SIZE - 1,
+				3,
+			};
+			auto* source = CreateTestTexture( "Source", 1 );
+			for ( size_t flags_mask = 0 ; flags_mask < ( 1 << kernel_flags_count ) ; flags_mask++ ) {
+				add_flag_t flags = AM_DEFAULT;
+				for ( size_t i = 0 ; i < kernel_flags_count ; i++ ) {
+					if ( flags_mask & ( 1 << i ) ) {
+						flags |= kernel_flags[ i ];
+					}
+				}
+				for ( rotate_t rotate = ROTATE_0 ; rotate <= ROTATE_270 ; rotate++ ) {
+					for ( const auto alpha : alphas ) {
+						for ( const auto size : sizes ) {
+							auto* kernel_result = CreateTestTexture( "KernelResult", 2 );
+							auto* generic_result = CreateTestTexture( "GenericResult", 2 );
+							kernel_result->AddFrom( source, flags, 17, 5, 17 + size - 1, 5 + size - 1, 33, 21, rotate, alpha );
+							generic_result->AddFromGeneric( source, flags, 17, 5, 17 + size - 1, 5 + size - 1, 33, 21, rotate, alpha, nullptr, nullptr );
+							const bool is_same = !memcmp( kernel_result->m_bitmap, generic_result->m_bitmap, kernel_result->m_bitmap_size );
+							DELETE( kernel_result );
+							DELETE( generic_result );
+							if ( !is_same ) {
+								DELETE( source );
+								ST_FAIL(
+									"result mismatch (flags: " + std::to_string( flags ) +
+										", rotate: " + std::to_string( rotate ) +
+										", alpha: " + std::to_string( alpha ) +
+										", size: " + std::to_string( size ) + ")"
+								);
+							}
+						}
+					}
+				}
+			}
+			// shaped kernels, with every flags combination modules use, in every rotation and with few other alphas
+			std::string errors = "";
+			for ( const auto& usage : GetModuleUsages() ) {
+				for ( const auto flags : usage.flags ) {
+					for ( rotate_t rotate = ROTATE_0 ; rotate <= ROTATE_270 ; rotate++ ) {
+						for ( const auto alpha : { usage.alpha, 1.0f, 0.5f } ) {
+							auto* kernel_result = CreateTestTexture( "KernelResult", 2 );
+							auto* generic_result = CreateTestTexture( "GenericResult", 2 );
+							const bool is_same = AddTileFrom( kernel_result, source, flags, rotate, alpha, false ) == AddTileFrom( generic_result, source, flags, rotate, alpha, true );
+							DELETE( kernel_result );
+							DELETE( generic_result );
+							if ( !is_same ) {
+								char buf[ 128 ];
+								snprintf( buf, sizeof( buf ), "\n      %s: flags: 0x%08x, rotate: %u, alpha: %.2f", usage.name.c_str(), flags, rotate, alpha );
+								errors += buf;
+							}
+						}
+					}
+				}
+			}
+			DELETE( source );
+			ST_ASSERT( errors.empty(), "result mismatch:" + errors );
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if texture output matches golden checksums",
+		ST() {
+			// if any of them changes - map textures will look different
+			auto* source = CreateTestTexture( "Source", 1 );
+			std::string errors = "";
+			for ( const auto& usage : GetModuleUsages() ) {
+				util::crc32::crc_t checksum = 0;
+				for ( const auto flags : usage.flags ) {
+					for ( const auto rotate : usage.rotations ) {
+						auto* result = CreateTestTexture( "Result", 2 );
+						const auto result_checksum = AddTileFrom( result, source, flags, rotate, usage.alpha, false );
+						DELETE( result );
+						checksum = util::crc32::CRC32::Calculate( &result_checksum, sizeof( result_checksum ), checksum );
+					}
+				}
+				if ( checksum != usage.checksum ) {
+					char buf[ 128 ];
+					snprintf( buf, sizeof( buf ), "\n      %s: checksum: 0x%08x, expected: 0x%08x", usage.name.c_str(), checksum, usage.checksum );
+					errors += buf;
+				}
+			}
+			DELETE( source );
+			ST_ASSERT( errors.empty(), "checksum mismatch:" + errors );
+			ST_OK();
+		}
+	);
+
+	task->AddTest(
+		"test if partial texture update publishes copies of updated areas",
+		ST() {
+			auto* texture = CreateTestTexture( "Texture", 3 );
+			const auto update_counter = texture->UpdatedCount();
+			texture->BeginPartialUpdate();
+			texture->Fill( 10, 10, 19, 19, types::Color( 1.0f, 0.0f, 0.0f ) );
+			texture->Update( { 10, 10, 20, 20 } );
+			texture->Fill( 20, 10, 29, 19, types::Color( 0.0f, 1.0f, 0.0f ) );
+			texture->Update( { 20, 10, 30, 20 } );
+			const bool is_published_early = texture->UpdatedCount() != update_counter || !texture->TakePublishedAreas().empty();
+			texture->EndPartialUpdate();
+			const auto published_areas = texture->TakePublishedAreas();
+			const bool is_counter_increased = texture->UpdatedCount() != update_counter;
+			const bool is_combined = published_areas.size() == 1;
+			bool is_same = false;
+			bool is_copy = false;
+			if ( is_combined ) {
+				const auto& area = published_areas[ 0 ].area;
+				const size_t size = ( area.right - area.left ) * ( area.bottom - area.top ) * 4;
+				auto* bitmap = texture->CopyBitmap( area.left, area.top, area.right, area.bottom );
+				is_same = published_areas[ 0 ].bitmap.size() == size && !memcmp( published_areas[ 0 ].bitmap.data(), bitmap, size );
+				free( bitmap );
+				// writer may continue drawing right after publishing
+				texture->Fill( area.left, area.top, area.right - 1, area.bottom - 1, types::Color( 0.0f, 0.0f, 1.0f ) );
+				bitmap = texture->CopyBitmap( area.left, area.top, area.right, area.bottom );
+				is_copy = is_same && memcmp( published_areas[ 0 ].bitmap.data(), bitmap, size ) != 0;
+				free( bitmap );
+			}
+			DELETE( texture );
+			ST_ASSERT( !is_published_early, "areas were published before partial update ended" );
+			ST_ASSERT( is_counter_increased, "update counter wasn't increased" );
+			ST_ASSERT( is_combined, "adjacent areas weren't combined" );
+			ST_ASSERT( is_same, "published pixels differ from texture" );
+			ST_ASSERT( is_copy, "published pixels are not a copy" );
+			ST_OK();
+		}
+	);
+
+}
+
+}
+}
@@ -1,9 +1,31 @@
 #include <cstring>
+#include <algorithm>
 
 #include "Buffer.h"
 
+#include "util/crc32/CRC32.h"
+
 namespace types {
 
+// xor of all bytes, calculated 8 bytes at once
+static inline const Buffer::checksum_t CalculateChecksum( const char* s, const uint32_t sz ) {
+	uint64_t c64 = 0;
+	uint64_t v;
+	uint32_t i = 0;
+	for ( ; i + sizeof( v ) <= sz ; i += sizeof( v ) ) {
+		memcpy( &v, s + i, sizeof( v ) );
+		c64 ^= v;
+	}
+	c64 ^= c64 >> 32;
+	c64 ^= c64 >> 16;
+	c64 ^= c64 >> 8;
+	Buffer::checksum_t c = c64 & 0xff;
+	for ( ; i < sz ; i++ ) {
+		c ^= s[ i ];
+	}
+	return c;
+}
+
 Buffer::Buffer() {
 	allocated_len = 0;
 	lenw = 0;
@@ -13,44 +35,170 @@ Buffer::Buffer() {
 	dr = nullptr;
 }
 
-Buffer::Buffer( const std::string& val ) {
+Buffer::Buffer( const encoding_t encoding )
+	: Buffer() {
+	m_encoding = encoding;
+	if ( m_encoding == E_COMPACT ) {
+		m_has_crc = true;
+		WriteRaw( &COMPACT_MARKER, sizeof( COMPACT_MARKER ) );
+	}
+}
+
+Buffer::Buffer( const std::string& val )
+	: Buffer( std::string_view( val ) ) {
+}
+
+Buffer::Buffer( const std::string_view val ) {
 	allocated_len = val.size();
 	lenw = val.size();
 	lenr = 0;
-	data = (data_t*)malloc( lenw );
-	memcpy( ptr( data, 0, lenw ), val.data(), lenw );
+	if ( allocated_len ) {
+		data = (data_t*)malloc( allocated_len );
+		memcpy( ptr( data, 0, allocated_len ), val.data(), allocated_len );
+	}
+	else {
+		data = nullptr;
+	}
 	dw = data + lenw;
-	dr = data;
+	dr = data + lenr;
+	try {
+		DetectEncoding();
+	}
+	catch ( std::runtime_error& e ) {
+		// destructor won't be called
+		free( data );
+		throw;
+	}
 }
 
 Buffer::~Buffer() {
-	if ( data ) {
+	if ( data && !m_is_view ) {
 		free( data );
 	}
 }
 
 Buffer::Buffer( const Buffer& other ) {
-	allocated_len = other.allocated_len;
+	if ( other.m_is_view ) {
+		// views are cheap to copy, data is owned elsewhere anyway
+		allocated_len = other.allocated_len;
+		lenw = other.lenw;
+		lenr = other.lenr;
+		data = other.data;
+		dw = data + lenw;
+		dr = data + lenr;
+		m_is_view = true;
+		m_encoding = other.m_encoding;
+		m_has_crc = other.m_has_crc;
+		m_crc = other.m_crc;
+		m_crc_len = other.m_crc_len;
+		m_nested_depth = other.m_nested_depth;
+		return;
+	}
+	m_encoding = other.m_encoding;
+	m_has_crc = other.m_has_crc;
+	m_crc = other.m_crc;
+	m_crc_len = other.m_crc_len;
+	m_nested_depth = other.m_nested_depth;
+	allocated_len = other.lenw + GetCompactCRCSize();
 	lenw = other.lenw;
 	lenr = other.lenr;
-	if ( other.data ) {
-		data_t* newptr = (data_t*)malloc( lenw );
-		data = newptr;
-		memcpy( ptr( data, 0, lenw ), ptr( other.data, 0, other.lenw ), lenw );
+	if ( other.data && lenw ) {
+		data = (data_t*)malloc( allocated_len );
+		memcpy( ptr( data, 0, allocated_len ), ptr( other.data, 0, allocated_len ), allocated_len ); // with crc
 	}
 	else {
 		data = nullptr;
+		allocated_len = 0;
 	}
 	dw = data + lenw;
 	dr = data + lenr;
 }
 
-void Buffer::Alloc( uint32_t size ) {
-	const uint32_t new_size = lenw + size;
-	if ( new_size > allocated_len ) {
-		while ( new_size > allocated_len ) {
-			allocated_len += BUFFER_ALLOC_CHUNK;
+Buffer::Buffer( Buffer&& other ) noexcept {
+	allocated_len = other.allocated_len;
+	lenw = other.lenw;
+	lenr = other.lenr;
+	data = other.data;
+	dw = other.dw;
+	dr = other.dr;
+	m_is_view = other.m_is_view;
+	m_encoding = other.m_encoding;
+	m_has_crc = other.m_has_crc;
+	m_crc = other.m_crc;
+	m_crc_len = other.m_crc_len;
+	m_nested_depth = other.m_nested_depth;
+	other.allocated_len = 0;
+	other.lenw = 0;
+	other.lenr = 0;
+	other.data = nullptr;
+	other.dw = nullptr;
+	other.dr = nullptr;
+	other.m_is_view = false;
+}
+
+Buffer& Buffer::operator=( const Buffer& other ) {
+	if ( this != &other ) {
+		*this = Buffer( other );
+	}
+	return *this;
+}
+
+Buffer& Buffer::operator=( Buffer&& other ) noexcept {
+	if ( this != &other ) {
+		if ( data && !m_is_view ) {
+			free( data );
+		}
+		allocated_len = other.allocated_len;
+		lenw = other.lenw;
+		lenr = other.lenr;
+		data = other.data;
+		dw = other.dw;
+		dr = other.dr;
+		m_is_view = other.m_is_view;
+		m_encoding = other.m_encoding;
+		m_has_crc = other.m_has_crc;
+		m_crc = other.m_crc;
+		m_crc_len = other.m_crc_len;
+		m_nested_depth = other.m_nested_depth;
+		other.m_is_view = false;
+		other.allocated_len = 0;
+		other.lenw = 0;
+		other.lenr = 0;
+		other.data = nullptr;
+		other.dw = nullptr;
+		other.dr = nullptr;
+	}
+	return *this;
+}
+
+void Buffer::Reserve( const uint32_t size ) {
+	const uint64_t need_len = (uint64_t)lenw + size + GetCompactCRCSize();
+	if ( need_len > UINT32_MAX ) {
+		THROW( "buffer size overflow ( " + std::to_string( need_len ) + " )" );
+	}
+	if ( m_is_view ) {
+		// about to be written to, needs own copy of data
+		const auto* view_data = data;
+		allocated_len = std::max< uint64_t >( need_len, BUFFER_ALLOC_CHUNK );
+		data = (data_t*)malloc( allocated_len );
+		if ( lenw ) {
+			memcpy( ptr( data, 0, lenw + GetCompactCRCSize() ), view_data, lenw + GetCompactCRCSize() ); // with crc
 		}
+		m_is_view = false;
+		dw = ptr( data, lenw, 0 );
+		dr = ptr( data, lenr, 0 );
+	}
+	else if ( need_len > allocated_len ) {
+		// grow geometrically, otherwise large buffers are copied over and over while being written
+		allocated_len = std::min< uint64_t >(
+			std::max< uint64_t >(
+				{
+					need_len,
+					(uint64_t)allocated_len * 2,
+					BUFFER_ALLOC_CHUNK
+				}
+			), UINT32_MAX
+		);
 		if ( data ) {
 			//Log( "Reallocating " + to_string( allocated_len ) + " bytes" );
 			data = (data_t*)realloc( data, allocated_len );
@@ -62,22 +210,27 @@ void Buffer::Alloc( uint32_t size ) {
 		dw = ptr( data, lenw, 0 );
 		dr = ptr( data, lenr, 0 );
 	}
-	lenw = new_size;
+}
+
+void Buffer::Alloc( uint32_t size ) {
+	Reserve( size );
+	lenw += size;
 }
 
 // note: mostly THROWs instead of ASSERTs, because we need that validation in release mode too to prevent buffer overflows
 void Buffer::WriteImpl( type_t type, const char* s, const uint32_t sz ) {
+	ASSERT( m_encoding == E_TAGGED, "tagged write into compact buffer" );
 	ASSERT( type > T_NONE && type < T_MAX, "invalid buffer write type " + std::to_string( type ) );
 	//Log( "Writing " + to_string( sz ) + " bytes (type=" + to_string( type ) + ")" );
-	checksum_t c = 0;
+	const checksum_t c = CalculateChecksum( s, sz );
 	Alloc( sizeof( type ) + sizeof( sz ) + sz + sizeof( c ) );
 	memcpy( dw, &type, sizeof( type ) );
 	dw += sizeof( type );
 	memcpy( dw, &sz, sizeof( sz ) );
 	dw += sizeof( sz );
-
-	for ( uint32_t i = 0 ; i < sz ; i++ ) {
-		c ^= ( *( dw++ ) = *( s++ ) );
+	if ( sz ) {
+		memcpy( dw, s, sz );
+		dw += sz;
 	}
 
 	//Log( "Writing checksum (" + to_string( c ) + ")" );
@@ -87,8 +240,48 @@ void Buffer::WriteImpl( type_t type, const char* s, const uint32_t sz ) {
 	//Log( "Written successfully" );
 }
 
-char* Buffer::ReadImpl( type_t need_type, char* s, uint32_t* sz, const uint32_t need_sz ) {
+const uint32_t Buffer::BeginNested() {
+	const auto position = lenw;
+	if ( m_encoding == E_COMPACT ) {
+		const uint32_t sz = 0; // will be known at the end
+		m_nested_depth++;
+		WriteRaw( &sz, sizeof( sz ) );
+		WriteRaw( &COMPACT_NESTED_MARKER, sizeof( COMPACT_NESTED_MARKER ) );
+		return position;
+	}
+	const type_t type = T_STRING;
+	const uint32_t sz = 0; // will be known at the end
+	Alloc( sizeof( type ) + sizeof( sz ) );
+	memcpy( dw, &type, sizeof( type ) );
+	dw += sizeof( type );
+	memcpy( dw, &sz, sizeof( sz ) );
+	dw += sizeof( sz );
+	return position;
+}
+
+void Buffer::EndNested( const uint32_t position ) {
+	if ( m_encoding == E_COMPACT ) {
+		const uint32_t data_position = position + sizeof( uint32_t );
+		ASSERT( data_position <= lenw, "nested value position out of range" );
+		const uint32_t sz = lenw - data_position;
+		memcpy( data + position, &sz, sizeof( sz ) );
+		ASSERT( m_nested_depth > 0, "nested value was not started" );
+		m_nested_depth--;
+		UpdateCRC();
+		return;
+	}
+	const uint32_t data_position = position + sizeof( type_t ) + sizeof( uint32_t );
+	ASSERT( data_position <= lenw, "nested value position out of range" );
+	const uint32_t sz = lenw - data_position;
+	memcpy( data + position + sizeof( type_t ), &sz, sizeof( sz ) );
+	const checksum_t c = CalculateChecksum( (const char*)data + data_position, sz );
+	Alloc( sizeof( c ) );
+	*( dw++ ) = c;
+}
+
+const char* Buffer::ReadImpl( type_t need_type, uint32_t* sz, const uint32_t need_sz ) {
 	ASSERT( need_type > T_NONE && need_type < T_MAX, "invalid buffer read type " + std::to_string( need_type ) );
+	ASSERT( m_encoding == E_TAGGED, "tagged read from compact buffer" );
 	type_t type = T_NONE;
 	if ( lenw < lenr + sizeof( type ) + sizeof( *sz ) ) {
 		THROW( "buffer ends prematurely (while reading header)" );
@@ -103,25 +296,20 @@ char* Buffer::ReadImpl( type_t need_type, char* s, uint32_t* sz, const uint32_t
 	if ( need_sz && ( need_sz != *sz ) ) {
 		THROW( "buffer read size mismatch ( " + std::to_string( need_sz ) + " != " + std::to_string( *sz ) + " )" );
 	}
-	checksum_t need_c = 0;
-	lenr += sizeof( type ) + sizeof( *sz ) + *sz + sizeof( need_c );
-	if ( lenw < lenr ) {
+	checksum_t c = 0;
+	const uint64_t new_lenr = (uint64_t)lenr + sizeof( type ) + sizeof( *sz ) + *sz + sizeof( c );
+	if ( lenw < new_lenr ) {
 		THROW( "buffer ends prematurely (while reading data)" );
 	}
+	lenr = new_lenr;
 	//Log( "Reading " + std::to_string( *sz ) + " bytes (type=" + std::to_string( type ) + ")" );
 
-	if ( s == nullptr && *sz > 0 ) {
-		s = (char*)malloc( *sz );
-	}
-
-	char* s_ptr = s;
-
-	for ( uint32_t i = 0 ; i < *sz ; i++ ) {
-		need_c ^= ( *( s_ptr++ ) = *( dr++ ) );
-	}
+	const char* s = (const char*)dr;
+	dr += *sz;
 
 	//Log( "Checking checksum (" + to_string( need_c ) + ")" );
-	checksum_t c = *( dr++ );
+	c = *( dr++ );
+	const checksum_t need_c = CalculateChecksum( s, *sz );
 	if ( need_c != c ) {
 		THROW( "buffer read checksum mismatch ( " + std::to_string( need_c ) + " != " + std::to_string( c ) + " )" );
 	}
@@ -131,60 +319,227 @@ char* Buffer::ReadImpl( type_t need_type, char* s, uint32_t* sz, const uint32_t
 	return s;
 }
 
+void Buffer::WriteRaw( const void* s, const uint32_t sz ) {
+	Alloc( sz );
+	memcpy( dw, s, sz );
+	dw += sz;
+	UpdateCRC();
+}
+
+void Buffer::UpdateCRC() {
+	if ( !m_has_crc || m_nested_depth ) {
+		return;
+	}
+	// streaming, so every byte is only processed once
+	m_crc = util::crc32::CRC32::CalculateC( data + m_crc_len, lenw - m_crc_len, m_crc );
+	m_crc_len = lenw;
+	// space for it is always reserved after written data
+	memcpy( data + lenw, &m_crc, sizeof( m_crc ) );
+}
+
+const char* Buffer::ReadRaw( const uint32_t sz ) {
+	if ( (uint64_t)lenr + sz > lenw ) {
+		THROW( "buffer ends prematurely (while reading " + std::to_string( sz ) + " bytes)" );
+	}
+	const char* s = (const char*)dr;
+	lenr += sz;
+	dr += sz;
+	return s;
+}
+
+void Buffer::WriteVarInt( uint64_t val ) {
+	// 7 bits per byte, highest bit means there are more bytes
+	data_t bytes[ 10 ];
+	uint8_t sz = 0;
+	while ( val >= 0x80 ) {
+		bytes[ sz++ ] = ( val & 0x7f ) | 0x80;
+		val >>= 7;
+	}
+	bytes[ sz++ ] = val;
+	WriteRaw( bytes, sz );
+}
+
+const uint64_t Buffer::ReadVarInt() {
+	uint64_t val = 0;
+	for ( uint8_t shift = 0 ; shift < 70 ; shift += 7 ) {
+		const data_t b = *ReadRaw( 1 );
+		val |= (uint64_t)( b & 0x7f ) << shift;
+		if ( !( b & 0x80 ) ) {
+			return val;
+		}
+	}
+	THROW( "buffer varint is too long" );
+}
+
+const uint32_t Buffer::ReadSize() {
+	uint32_t sz = 0;
+	memcpy( &sz, ReadRaw( sizeof( sz ) ), sizeof( sz ) );
+	if ( (uint64_t)lenr + sz > lenw ) {
+		THROW( "buffer ends prematurely (while reading data)" );
+	}
+	return sz;
+}
+
+void Buffer::DetectEncoding() {
+	if ( !lenw ) {
+		return;
+	}
+	switch ( data[ 0 ] ) {
+		case COMPACT_MARKER: {
+			lenw = GetCompactSize( (const char*)data, lenw );
+			m_has_crc = true;
+			memcpy( &m_crc, data + lenw, sizeof( m_crc ) );
+			m_crc_len = lenw;
+			break;
+		}
+		case COMPACT_NESTED_MARKER: {
+			break;
+		}
+		default: {
+			// tagged values start with type
+			return;
+		}
+	}
+	m_encoding = E_COMPACT;
+	lenr = sizeof( COMPACT_MARKER );
+	dw = data + lenw;
+	dr = data + lenr;
+}
+
+const uint32_t Buffer::GetCompactSize( const char* s, const uint32_t sz ) {
+	util::crc32::crc_t crc = 0;
+	if ( sz < sizeof( COMPACT_MARKER ) + sizeof( crc ) ) {
+		THROW( "compact buffer is too short ( " + std::to_string( sz ) + " )" );
+	}
+	const uint32_t data_sz = sz - sizeof( crc );
+	memcpy( &crc, s + data_sz, sizeof( crc ) );
+	const auto need_crc = util::crc32::CRC32::CalculateC( s, data_sz );
+	if ( crc != need_crc ) {
+		THROW( "compact buffer crc mismatch ( " + std::to_string( need_crc ) + " != " + std::to_string( crc ) + " )" );
+	}
+	return data_sz;
+}
+
+const uint32_t Buffer::GetCompactCRCSize() const {
+	return m_has_crc
+		? sizeof( util::crc32::crc_t )
+		: 0;
+}
+
 void Buffer::WriteBool( const bool val ) {
 	const uint8_t bval = val
 		? 1
 		: 0;
+	if ( m_encoding == E_COMPACT ) {
+		WriteRaw( &bval, sizeof( bval ) );
+		return;
+	}
 	WriteImpl( T_BOOL, (const char*)&bval, sizeof( bval ) );
 }
 
 const bool Buffer::ReadBool() {
-	bool boolval = false;
+	uint8_t bval = 0;
+	if ( m_encoding == E_COMPACT ) {
+		memcpy( &bval, ReadRaw( sizeof( bval ) ), sizeof( bval ) );
+		return bval != 0;
+	}
 	uint32_t sz = 0;
-	ReadImpl( T_BOOL, (char*)&boolval, &sz, sizeof( boolval ) );
-	return boolval;
+	memcpy( &bval, ReadImpl( T_BOOL, &sz, sizeof( bval ) ), sizeof( bval ) );
+	return bval != 0;
 }
 
 void Buffer::WriteInt( const long long int val ) {
+	if ( m_encoding == E_COMPACT ) {
+		// zigzag, so that small negative values are short too
+		WriteVarInt( ( (uint64_t)val << 1 ) ^ (uint64_t)( val >> 63 ) );
+		return;
+	}
 	WriteImpl( T_INT, (const char*)&val, sizeof( val ) );
 }
 
 const long long int Buffer::ReadInt() {
+	if ( m_encoding == E_COMPACT ) {
+		const uint64_t zz = ReadVarInt();
+		return (long long int)( ( zz >> 1 ) ^ ( ~( zz & 1 ) + 1 ) );
+	}
 	long long int val = 0;
 	uint32_t sz = 0;
-	ReadImpl( T_INT, (char*)&val, &sz, sizeof( val ) );
+	memcpy( &val, ReadImpl( T_INT, &sz, sizeof( val ) ), sizeof( val ) );
 	return val;
 }
 
 void Buffer::WriteFloat( const float val ) {
+	if ( m_encoding == E_COMPACT ) {
+		WriteRaw( &val, sizeof( val ) );
+		return;
+	}
 	WriteImpl( T_FLOAT, (const char*)&val, sizeof( val ) );
 }
 
 const float Buffer::ReadFloat() {
 	float val = 0;
+	if ( m_encoding == E_COMPACT ) {
+		memcpy( (void*)&val, ReadRaw( sizeof( val ) ), sizeof( val ) );
+		return val;
+	}
 	uint32_t sz = 0;
-	ReadImpl( T_FLOAT, (char*)&val, &sz, sizeof( val ) );
+	memcpy( &val, ReadImpl( T_FLOAT, &sz, sizeof( val ) ), sizeof( val ) );
 	return val;
 }
 
-void Buffer::WriteString( const std::string& val ) {
+void Buffer::WriteString( const std::string_view val ) {
+	if ( m_encoding == E_COMPACT ) {
+		const uint32_t sz = val.size();
+		Reserve( sizeof( sz ) + sz );
+		WriteRaw( &sz, sizeof( sz ) );
+		WriteRaw( val.data(), sz );
+		return;
+	}
 	WriteImpl( T_STRING, val.data(), val.size() );
 }
 
 const std::string Buffer::ReadString() {
+	return std::string( ReadStringView() );
+}
+
+Buffer Buffer::ReadNested() {
 	uint32_t sz = 0;
-	char* res_data = ReadImpl( T_STRING, nullptr, &sz );
-	if ( sz > 0 ) {
-		std::string result = std::string( res_data, sz );
-		free( res_data );
-		return result;
+	const char* res_data = nullptr;
+	if ( m_encoding == E_COMPACT ) {
+		sz = ReadSize();
+		res_data = ReadRaw( sz );
 	}
 	else {
-		return "";
+		res_data = ReadImpl( T_STRING, &sz );
 	}
+	// nested value may be in any encoding, i.e. compact stream written into tagged one as string
+	Buffer result;
+	result.data = (data_t*)res_data;
+	result.allocated_len = sz;
+	result.lenw = sz;
+	result.dw = result.data + sz;
+	result.dr = result.data;
+	result.m_is_view = true;
+	result.DetectEncoding();
+	return result;
+}
+
+const std::string_view Buffer::ReadStringView() {
+	if ( m_encoding == E_COMPACT ) {
+		const uint32_t sz = ReadSize();
+		return std::string_view( ReadRaw( sz ), sz );
+	}
+	uint32_t sz = 0;
+	const char* res_data = ReadImpl( T_STRING, &sz );
+	return std::string_view( res_data, sz );
 }
 
 void Buffer::WriteVec2u( const Vec2< uint32_t > val ) {
+	if ( m_encoding == E_COMPACT ) {
+		WriteVarInt( val.x );
+		WriteVarInt( val.y );
+		return;
+	}
 	WriteImpl( T_VEC2U, (const char*)&val, sizeof( val ) );
 }
 
@@ -193,12 +548,21 @@ const Vec2< uint32_t > Buffer::ReadVec2u() {
 		0,
 		0
 	};
+	if ( m_encoding == E_COMPACT ) {
+		val.x = ReadVarInt();
+		val.y = ReadVarInt();
+		return val;
+	}
 	uint32_t sz = 0;
-	ReadImpl( T_VEC2U, (char*)&val, &sz, sizeof( val ) );
+	memcpy( (void*)&val, ReadImpl( T_VEC2U, &sz, sizeof( val ) ), sizeof( val ) );
 	return val;
 }
 
 void Buffer::WriteVec2f( const Vec2< float > val ) {
+	if ( m_encoding == E_COMPACT ) {
+		WriteRaw( &val, sizeof( val ) );
+		return;
+	}
 	WriteImpl( T_VEC2F, (const char*)&val, sizeof( val ) );
 }
 
@@ -207,48 +571,100 @@ const Vec2< float > Buffer::ReadVec2f() {
 		0,
 		0
 	};
+	if ( m_encoding == E_COMPACT ) {
+		memcpy( (void*)&val, ReadRaw( sizeof( val ) ), sizeof( val ) );
+		return val;
+	}
 	uint32_t sz = 0;
-	ReadImpl( T_VEC2F, (char*)&val, &sz, sizeof( val ) );
+	memcpy( (void*)&val, ReadImpl( T_VEC2F, &sz, sizeof( val ) ), sizeof( val ) );
 	return val;
 }
 
 void Buffer::WriteVec3( const types::Vec3 val ) {
+	if ( m_encoding == E_COMPACT ) {
+		WriteRaw( &val, sizeof( val ) );
+		return;
+	}
 	WriteImpl( T_VEC3, (const char*)&val, sizeof( val ) );
 }
 
 const types::Vec3 Buffer::ReadVec3() {
 	types::Vec3 val;
+	if ( m_encoding == E_COMPACT ) {
+		memcpy( (void*)&val, ReadRaw( sizeof( val ) ), sizeof( val ) );
+		return val;
+	}
 	uint32_t sz = 0;
-	ReadImpl( T_VEC3, (char*)&val, &sz, sizeof( val ) );
+	memcpy( (void*)&val, ReadImpl( T_VEC3, &sz, sizeof( val ) ), sizeof( val ) );
 	return val;
 }
 
 void Buffer::WriteColor( const Color val ) {
+	if ( m_encoding == E_COMPACT ) {
+		WriteRaw( &val, sizeof( val ) );
+		return;
+	}
 	WriteImpl( T_COLOR, (const char*)&val, sizeof( val ) );
 }
 
 const Color Buffer::ReadColor() {
 	Color val;
+	if ( m_encoding == E_COMPACT ) {
+		memcpy( (void*)&val, ReadRaw( sizeof( val ) ), sizeof( val ) );
+		return val;
+	}
 	uint32_t sz = 0;
-	ReadImpl( T_COLOR, (char*)&val, &sz, sizeof( val ) );
+	memcpy( (void*)&val, ReadImpl( T_COLOR, &sz, sizeof( val ) ), sizeof( val ) );
 	return val;
 }
 
 void Buffer::WriteData( const void* data, const uint32_t len ) {
+	if ( m_encoding == E_COMPACT ) {
+		Reserve( sizeof( len ) + len );
+		WriteRaw( &len, sizeof( len ) );
+		WriteRaw( data, len );
+		return;
+	}
 	WriteImpl( T_DATA, (const char*)data, len );
 }
 
 const void* Buffer::ReadData( const uint32_t len ) {
 	uint32_t sz = 0;
-	const void* val = ReadImpl( T_DATA, nullptr, &sz );
+	const char* src = nullptr;
+	if ( m_encoding == E_COMPACT ) {
+		sz = ReadSize();
+		src = ReadRaw( sz );
+	}
+	else {
+		src = ReadImpl( T_DATA, &sz );
+	}
 	ASSERT( sz == len, "buffer data read size mismatch" );
+	if ( !sz ) {
+		return nullptr;
+	}
+	// caller takes ownership
+	void* val = malloc( sz );
+	memcpy( val, src, sz );
 	return val;
 }
 
+const Buffer::encoding_t Buffer::GetEncoding() const {
+	return m_encoding;
+}
+
 const std::string Buffer::ToString() const {
-	return data
-		? std::string( (const char*)data, lenw )
-		: "";
+	return std::string( ToStringView() );
+}
+
+const std::string_view Buffer::ToStringView() const {
+	if ( !data ) {
+		return std::string_view();
+	}
+	if ( m_has_crc ) {
+		ASSERT( m_crc_len == lenw, "compact buffer crc is not up to date ( unfinished nested value? )" );
+		return std::string_view( (const char*)data, lenw + sizeof( m_crc ) );
+	}
+	return std::string_view( (const char*)data, lenw );
 }
 
 }
@@ -1,10 +1,13 @@
 #pragma once
 
+#include <string_view>
+
 #include "common/Common.h"
 
 #include "types/Vec2.h"
 #include "types/Vec3.h"
 #include "types/Color.h"
+#include "util/crc32/Types.h"
 
 namespace types {
 
@@ -15,11 +18,25 @@ CLASS( Buffer, common::Class )
 	typedef uint8_t data_t;
 	typedef uint8_t checksum_t;
 
+	enum encoding_t : uint8_t {
+		E_TAGGED, // every value has type tag, size and checksum
+		E_COMPACT, // values without tags ( varint integers, raw floats, sized strings ), single crc32 at the end
+	};
+
 	Buffer();
+	explicit Buffer( const encoding_t encoding ); // for writing in given encoding
+	// for reading, encoding is detected from data ( and crc32 of compact data is verified )
 	Buffer( const std::string& strval );
+	Buffer( const std::string_view strval );
 	~Buffer();
 
 	Buffer( const Buffer& other );
+	Buffer( Buffer&& other ) noexcept;
+	Buffer& operator=( const Buffer& other );
+	Buffer& operator=( Buffer&& other ) noexcept;
+
+	// preallocates space for size more bytes, to avoid reallocations when final size is known or can be estimated
+	void Reserve( const uint32_t size );
 
 	data_t* data;
 	data_t* dw;
@@ -34,8 +51,21 @@ CLASS( Buffer, common::Class )
 	const long long int ReadInt();
 	void WriteFloat( const float val );
 	const float ReadFloat();
-	void WriteString( const std::string& val );
+	void WriteString( const std::string_view val );
 	const std::string ReadString();
+	const std::string_view ReadStringView(); // points into buffer, valid until buffer is written to or destroyed
+
+	// nested value is written directly into this buffer ( without building and copying separate buffer first ),
+	// write( buffer ) must write it into passed buffer, result is read same way as WriteString( nested_buffer.ToStringView() )
+	template< class F >
+	void WriteNested( const F& write ) {
+		const auto position = BeginNested();
+		write( *this );
+		EndNested( position );
+	}
+	// reads nested value ( or any string ) in place, returned buffer points into this one and is valid until it is written to or destroyed
+	// writing into returned buffer makes it allocate its own copy
+	Buffer ReadNested();
 	void WriteVec2u( const Vec2< uint32_t > val );
 	const Vec2< uint32_t > ReadVec2u();
 	void WriteVec2f( const Vec2< float > val );
@@ -47,7 +77,11 @@ CLASS( Buffer, common::Class )
 	void WriteData( const void* data, const uint32_t len );
 	const void* ReadData( const uint32_t len );
 
+	const encoding_t GetEncoding() const;
+
+	// compact buffer gets its crc32 appended ( except for nested ones ), it's kept up to date by every write
 	const std::string ToString() const;
+	const std::string_view ToStringView() const; // valid until buffer is written to or destroyed
 
 private:
 
@@ -68,9 +102,32 @@ private:
 	};
 
 	void WriteImpl( const type_t type, const char* s, const uint32_t sz );
-	char* ReadImpl( const type_t need_type, char* s, uint32_t* sz, const uint32_t need_sz = 0 );
+	// validates next value and returns pointer to its data inside buffer
+	const char* ReadImpl( const type_t need_type, uint32_t* sz, const uint32_t need_sz = 0 );
 	void Alloc( uint32_t size );
 
+	const uint32_t BeginNested(); // writes header of nested value, returns its position
+	void EndNested( const uint32_t position ); // fills header size and writes checksum
+
+	bool m_is_view = false; // data is owned by other buffer
+
+	static constexpr data_t COMPACT_MARKER = 0xc5; // first byte of compact data, never a valid type tag
+	static constexpr data_t COMPACT_NESTED_MARKER = 0xc6; // same for nested compact data ( that has no crc32 )
+	encoding_t m_encoding = E_TAGGED;
+	bool m_has_crc = false; // compact buffer that is not nested
+	util::crc32::crc_t m_crc = 0; // of first m_crc_len bytes, always stored right after written data
+	uint32_t m_crc_len = 0;
+	uint32_t m_nested_depth = 0; // sizes of unfinished nested values will change, so crc waits for them
+	void UpdateCRC();
+	void WriteRaw( const void* s, const uint32_t sz );
+	const char* ReadRaw( const uint32_t sz );
+	void WriteVarInt( uint64_t val );
+	const uint64_t ReadVarInt();
+	const uint32_t ReadSize();
+	void DetectEncoding(); // from first byte of data, must be called before reading
+	static const uint32_t GetCompactSize( const char* s, const uint32_t sz ); // verifies crc32, returns size without it
+	const uint32_t GetCompactCRCSize() const; // space needed after written data for crc32
+
 };
 
 }
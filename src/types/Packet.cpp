@@ -8,7 +8,7 @@ Packet::Packet( const packet_type_t type )
 }
 
 const types::Buffer Packet::Serialize() const {
-	types::Buffer buf;
+	types::Buffer buf( encoding );
 
 	buf.WriteInt( type );
 
@@ -57,11 +57,13 @@ const types::Buffer Packet::Serialize() const {
 			break;
 		}
 		case PT_DOWNLOAD_REQUEST: {
-			// no data
+			buf.WriteInt( udata.download.offset ); // offset to start ( or resume ) from
+			buf.WriteInt( udata.download.size ); // window ( max chunks in flight )
 			break;
 		}
 		case PT_DOWNLOAD_RESPONSE: {
 			buf.WriteInt( data.num ); // total size of serialized data
+			buf.WriteInt( udata.download.size ); // chunk size
 			break;
 		}
 		case PT_DOWNLOAD_NEXT_CHUNK_REQUEST: {
@@ -72,7 +74,11 @@ const types::Buffer Packet::Serialize() const {
 		case PT_DOWNLOAD_NEXT_CHUNK_RESPONSE: {
 			buf.WriteInt( udata.download.offset );
 			buf.WriteInt( udata.download.size );
-			buf.WriteString( data.str ); // serialized chunk
+			buf.WriteString( // serialized chunk
+				data.str_view.empty()
+					? data.str
+					: data.str_view
+			);
 			break;
 		}
 		case PT_GAME_EVENTS: {
@@ -141,11 +147,13 @@ void Packet::Unserialize( types::Buffer buf ) {
 			break;
 		}
 		case PT_DOWNLOAD_REQUEST: {
-			// no data
+			udata.download.offset = buf.ReadInt(); // offset to start ( or resume ) from
+			udata.download.size = buf.ReadInt(); // window ( max chunks in flight )
 			break;
 		}
 		case PT_DOWNLOAD_RESPONSE: {
 			data.num = buf.ReadInt(); // total size of serialized data
+			udata.download.size = buf.ReadInt(); // chunk size
 			break;
 		}
 		case PT_DOWNLOAD_NEXT_CHUNK_REQUEST: {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string_view>
 #include <vector>
 
 #include "Serializable.h"
@@ -26,8 +27,8 @@ CLASS( Packet, Serializable )
 		PT_GAME_STATE, // S->C
 		PT_DOWNLOAD_REQUEST, // C->S
 		PT_DOWNLOAD_RESPONSE, // S->C
-		PT_DOWNLOAD_NEXT_CHUNK_REQUEST, // C->S
-		PT_DOWNLOAD_NEXT_CHUNK_RESPONSE, // S->C
+		PT_DOWNLOAD_NEXT_CHUNK_REQUEST, // C->S ( acknowledges everything before offset )
+		PT_DOWNLOAD_NEXT_CHUNK_RESPONSE, // S->C ( sent ahead of acknowledgements, up to window )
 		PT_GAME_EVENTS, // *->*
 	};
 
@@ -35,6 +36,9 @@ CLASS( Packet, Serializable )
 
 	packet_type_t type;
 
+	// encoding of this packet when sent, received ones are detected automatically
+	types::Buffer::encoding_t encoding = types::Buffer::E_COMPACT;
+
 	union {
 		time_t time;
 		struct {
@@ -59,6 +63,7 @@ CLASS( Packet, Serializable )
 		size_t num;
 		std::string str;
 		std::vector< std::string > vec;
+		std::string_view str_view; // sent instead of str if not empty, must stay valid until packet is serialized ( i.e. slice of shared buffer )
 	} data;
 
 	const types::Buffer Serialize() const override;
@@ -1,4 +1,5 @@
 #include <cstring>
+#include <iterator>
 
 #include "Mesh.h"
 
@@ -25,7 +26,7 @@ Mesh::Mesh( const Mesh& other )
 	, m_index_count( other.m_index_count )
 	, m_vertex_i( other.m_vertex_i )
 	, m_surface_i( other.m_surface_i )
-	, m_update_counter( other.m_update_counter )
+	, m_update_counter( other.m_update_counter.load() )
 	, m_is_final( other.m_is_final ) {
 	size_t sz = GetVertexDataSize();
 	m_vertex_data = (uint8_t*)malloc( sz );
@@ -128,11 +129,63 @@ const uint8_t* Mesh::GetIndexData() const {
 }
 
 void Mesh::Update() {
-	m_update_counter++;
+	if ( m_is_partial_update_active ) {
+		return;
+	}
+	m_is_full_update_needed = true;
+	m_update_counter.fetch_add( 1, std::memory_order_release );
+}
+
+void Mesh::BeginPartialUpdate() {
+	m_vertex_data_mutex.lock(); // until EndPartialUpdate()
+	ASSERT( !m_is_partial_update_active, "partial update already active" );
+	m_is_partial_update_active = true;
+}
+
+void Mesh::EndPartialUpdate( const updated_ranges_t& updated_ranges ) {
+	ASSERT( m_is_partial_update_active, "partial update not active" );
+	m_is_partial_update_active = false;
+	if ( !updated_ranges.empty() ) {
+		// nothing is written to vertices now, so it's safe to copy from them
+		const size_t vertex_size = VERTEX_SIZE * sizeof( coord_t );
+		updated_ranges_t published_ranges = {};
+		published_ranges.reserve( updated_ranges.size() );
+		for ( const auto& range : updated_ranges ) {
+			ASSERT( range.from < range.to && range.to <= m_vertex_count, "invalid vertex range" );
+			const auto* from = m_vertex_data + range.from * vertex_size;
+			published_ranges.push_back(
+				{
+					range.from,
+					range.to,
+					std::vector< uint8_t >( from, from + ( range.to - range.from ) * vertex_size )
+				}
+			);
+		}
+		{
+			std::lock_guard< std::mutex > guard( m_updated_ranges_mutex );
+			m_updated_ranges.insert( m_updated_ranges.end(), std::make_move_iterator( published_ranges.begin() ), std::make_move_iterator( published_ranges.end() ) );
+		}
+		m_update_counter.fetch_add( 1, std::memory_order_release );
+	}
+	m_vertex_data_mutex.unlock();
 }
 
 const size_t Mesh::UpdatedCount() const {
-	return m_update_counter;
+	return m_update_counter.load( std::memory_order_acquire );
+}
+
+const Mesh::updated_ranges_t Mesh::TakeUpdatedRanges() const {
+	std::lock_guard< std::mutex > guard( m_updated_ranges_mutex );
+	updated_ranges_t result = {};
+	if ( !m_is_full_update_needed.exchange( false ) ) {
+		result.swap( m_updated_ranges );
+	}
+	m_updated_ranges.clear();
+	return result;
+}
+
+std::unique_lock< std::mutex > Mesh::LockVertexData() const {
+	return std::unique_lock< std::mutex >( m_vertex_data_mutex );
 }
 
 const Mesh::mesh_type_t Mesh::GetType() const {
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <vector>
+#include <mutex>
+#include <atomic>
+
 #include "types/Serializable.h"
 
 #include "Types.h"
@@ -53,8 +57,23 @@ CLASS( Mesh, Serializable )
 	const size_t GetIndexDataSize() const;
 	const uint8_t* GetIndexData() const;
 
+	struct updated_range_t {
+		index_t from;
+		index_t to; // exclusive
+		std::vector< uint8_t > vertex_data = {}; // copy of vertices of range, made when it was published
+	};
+	typedef std::vector< updated_range_t > updated_ranges_t;
+
 	void Update();
+	// changes made between these calls are published at once, and only given vertex ranges will be reloaded by renderer
+	// vertex data stays locked meanwhile, and vertices of ranges are copied when publishing, so renderer never reads vertices that are being written
+	void BeginPartialUpdate();
+	void EndPartialUpdate( const updated_ranges_t& updated_ranges );
 	const size_t UpdatedCount() const;
+	// returns vertex ranges changed since last call, empty result means whole mesh needs reload
+	const updated_ranges_t TakeUpdatedRanges() const;
+	// other threads must hold this while reading vertex data directly, waits until partial update ( if any ) is finished
+	std::unique_lock< std::mutex > LockVertexData() const;
 
 	const mesh_type_t GetType() const;
 
@@ -77,7 +96,15 @@ protected:
 	surface_id_t m_surface_i = 0;
 	uint8_t* m_index_data = nullptr;
 
-	size_t m_update_counter = 0;
+	std::atomic< size_t > m_update_counter = 0; // increased after changes are published, so whoever sees new value sees changes too
+
+private:
+	bool m_is_partial_update_active = false;
+	// consumed by renderer which only has const access
+	mutable std::atomic< bool > m_is_full_update_needed = true;
+	mutable updated_ranges_t m_updated_ranges = {};
+	mutable std::mutex m_updated_ranges_mutex;
+	mutable std::mutex m_vertex_data_mutex; // held by writer during partial update
 };
 
 }
@@ -86,24 +86,22 @@ const types::Vec3 Render::GetVertexNormal( const index_t index ) const {
 
 void Render::CombineNormals( const std::vector< index_t >& indices ) {
 	ASSERT( !indices.empty(), "normals list empty" );
-/*#ifdef DEBUG
-	std::string logstr = "";
-	for ( auto i : indices ) {
-		logstr += std::to_string( i ) + " ";
-	}
-	Log( "Combining normals ( " + logstr + ")" );
-#endif*/
+	CombineNormals( indices.data(), indices.size() );
+}
+
+void Render::CombineNormals( const index_t* indices, const size_t count ) {
+	ASSERT( count, "normals list empty" );
 	types::Vec3 normal = {
 		0.0f,
 		0.0f,
 		0.0f
 	};
-	for ( auto i : indices ) {
-		normal += GetVertexNormal( i );
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		normal += GetVertexNormal( indices[ i ] );
 	}
-	normal /= indices.size();
-	for ( auto i : indices ) {
-		SetVertexNormal( i, normal );
+	normal /= count;
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		SetVertexNormal( indices[ i ], normal );
 	}
 }
 
@@ -113,41 +111,27 @@ void Render::Finalize() {
 
 void Render::UpdateNormals( const std::vector< surface_id_t >& surfaces ) {
 	//Log( "Updating normals for " + std::to_string( surfaces.size() ) + " surface(s)" );
+	for ( surface_id_t surface_id : surfaces ) {
+		UpdateSurfaceNormal( surface_id );
+	}
+	Update();
+}
 
-	const surface_t* surface;
-	types::Vec3* a, * b, * c;
-	types::Vec3 n;
+void Render::UpdateSurfaceNormal( const surface_id_t surface_id ) {
 	const size_t vo = VERTEX_COORD_SIZE + VERTEX_TEXCOORD_SIZE + VERTEX_TINT_SIZE;
 
-	for ( surface_id_t surface_id : surfaces ) {
-		surface = (surface_t*)ptr( m_index_data, surface_id * SURFACE_SIZE * sizeof( index_t ), sizeof( surface_t ) );
-
-		memset( ptr( m_vertex_data, ( surface->v1 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ), 0, sizeof( types::Vec3 ) );
-		memset( ptr( m_vertex_data, ( surface->v2 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ), 0, sizeof( types::Vec3 ) );
-		memset( ptr( m_vertex_data, ( surface->v3 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ), 0, sizeof( types::Vec3 ) );
-
-		a = (Vec3*)ptr( m_vertex_data, surface->v1 * VERTEX_SIZE * sizeof( coord_t ), sizeof( coord_t ) );
-		b = (Vec3*)ptr( m_vertex_data, surface->v2 * VERTEX_SIZE * sizeof( coord_t ), sizeof( coord_t ) );
-		c = (Vec3*)ptr( m_vertex_data, surface->v3 * VERTEX_SIZE * sizeof( coord_t ), sizeof( coord_t ) );
-
-		n = util::Math::Cross( *b - *a, *c - *a );
-
-		*(Vec3*)ptr( m_vertex_data, ( surface->v1 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ) += n;
-		*(Vec3*)ptr( m_vertex_data, ( surface->v2 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ) += n;
-		*(Vec3*)ptr( m_vertex_data, ( surface->v3 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ) += n;
-
-		*(Vec3*)ptr( m_vertex_data, ( surface->v1 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) )
-			=
-			util::Math::Normalize( *(Vec3*)ptr( m_vertex_data, ( surface->v1 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ) );
-		*(Vec3*)ptr( m_vertex_data, ( surface->v2 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) )
-			=
-			util::Math::Normalize( *(Vec3*)ptr( m_vertex_data, ( surface->v2 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ) );
-		*(Vec3*)ptr( m_vertex_data, ( surface->v3 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) )
-			=
-			util::Math::Normalize( *(Vec3*)ptr( m_vertex_data, ( surface->v3 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( types::Vec3 ) ) );
-	}
+	const auto* surface = (surface_t*)ptr( m_index_data, surface_id * SURFACE_SIZE * sizeof( index_t ), sizeof( surface_t ) );
 
-	Update();
+	const auto* a = (Vec3*)ptr( m_vertex_data, surface->v1 * VERTEX_SIZE * sizeof( coord_t ), sizeof( Vec3 ) );
+	const auto* b = (Vec3*)ptr( m_vertex_data, surface->v2 * VERTEX_SIZE * sizeof( coord_t ), sizeof( Vec3 ) );
+	const auto* c = (Vec3*)ptr( m_vertex_data, surface->v3 * VERTEX_SIZE * sizeof( coord_t ), sizeof( Vec3 ) );
+
+	// every vertex of surface gets same normal (previous normal of vertex is discarded)
+	const types::Vec3 n = util::Math::Normalize( util::Math::Cross( *b - *a, *c - *a ) );
+
+	*(Vec3*)ptr( m_vertex_data, ( surface->v1 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( Vec3 ) ) = n;
+	*(Vec3*)ptr( m_vertex_data, ( surface->v2 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( Vec3 ) ) = n;
+	*(Vec3*)ptr( m_vertex_data, ( surface->v3 * VERTEX_SIZE + vo ) * sizeof( coord_t ), sizeof( Vec3 ) ) = n;
 }
 
 void Render::UpdateAllNormals() {
@@ -80,9 +80,12 @@ CLASS( Render, Mesh )
 	const types::Vec3 GetVertexNormal( const index_t index ) const;
 
 	void CombineNormals( const std::vector< index_t >& indices );
+	void CombineNormals( const index_t* indices, const size_t count );
 
 	void Finalize() override;
 	void UpdateNormals( const std::vector< surface_id_t >& surfaces );
+	// doesn't call Update(), so can be called from multiple threads as long as surfaces don't share vertices
+	void UpdateSurfaceNormal( const surface_id_t surface_id );
 	void UpdateAllNormals();
 
 	static Render* Rectangle(
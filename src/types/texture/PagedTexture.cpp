@@ -0,0 +1,87 @@
+#include "PagedTexture.h"
+
+#include <cstring>
+
+namespace types {
+namespace texture {
+
+PagedTexture::PagedTexture( const std::string& name, const size_t width, const size_t height, const size_t page_width, const size_t page_height )
+	: m_page_width( page_width )
+	, m_page_height( page_height )
+	, m_pages_x( ( width + page_width - 1 ) / page_width )
+	, m_pages_y( ( height + page_height - 1 ) / page_height )
+	, m_page_versions( m_pages_x * m_pages_y ) {
+	ASSERT( width > 0 && height > 0, "paged texture is empty" );
+	ASSERT( page_width > 0 && page_height > 0, "page is empty" );
+
+	// not calling Resize() because there is no bitmap to allocate
+	m_name = name;
+	m_width = width;
+	m_height = height;
+	m_aspect_ratio = (float)m_height / m_width;
+	m_is_paged = true;
+}
+
+const size_t PagedTexture::GetPageWidth() const {
+	return m_page_width;
+}
+
+const size_t PagedTexture::GetPageHeight() const {
+	return m_page_height;
+}
+
+const size_t PagedTexture::GetPagesX() const {
+	return m_pages_x;
+}
+
+const size_t PagedTexture::GetPagesY() const {
+	return m_pages_y;
+}
+
+const size_t PagedTexture::GetPagesCount() const {
+	return m_page_versions.size();
+}
+
+const size_t PagedTexture::GetPageAt( const size_t x, const size_t y ) const {
+	ASSERT( x < m_width && y < m_height, "pixel out of range" );
+	return ( y / m_page_height ) * m_pages_x + x / m_page_width;
+}
+
+const size_t PagedTexture::GetPageVersion( const size_t page ) const {
+	ASSERT( page < m_page_versions.size(), "page out of range" );
+	return m_page_versions[ page ].load();
+}
+
+void PagedTexture::CompositePage( const size_t page, Texture* dest ) const {
+	ASSERT( page < m_page_versions.size(), "page out of range" );
+	ASSERT( dest->m_width == m_page_width && dest->m_height == m_page_height, "page size mismatch" );
+
+	memset( ptr( dest->m_bitmap, 0, dest->m_bitmap_size ), 0, dest->m_bitmap_size );
+
+	const size_t x1 = ( page % m_pages_x ) * m_page_width;
+	const size_t y1 = ( page / m_pages_x ) * m_page_height;
+	CompositeArea(
+		x1,
+		y1,
+		std::min( x1 + m_page_width, m_width ) - 1,
+		std::min( y1 + m_page_height, m_height ) - 1,
+		dest,
+		0,
+		0
+	);
+
+	dest->FullUpdate();
+}
+
+void PagedTexture::InvalidateArea( const size_t x1, const size_t y1, const size_t x2, const size_t y2 ) {
+	ASSERT( x1 <= x2 && y1 <= y2, "invalid area" );
+	ASSERT( x2 < m_width && y2 < m_height, "area out of range" );
+	for ( size_t py = y1 / m_page_height ; py <= y2 / m_page_height ; py++ ) {
+		for ( size_t px = x1 / m_page_width ; px <= x2 / m_page_width ; px++ ) {
+			m_page_versions[ py * m_pages_x + px ]++;
+		}
+	}
+}
+
+}
+}
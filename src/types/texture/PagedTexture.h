@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <atomic>
+
+#include "Texture.h"
+
+namespace types {
+namespace texture {
+
+// texture that has no bitmap of its own, it's split into fixed-size pages which are composited on demand
+// renderer keeps only pages it needs, and composites them again when their versions change
+CLASS( PagedTexture, Texture )
+
+	PagedTexture( const std::string& name, const size_t width, const size_t height, const size_t page_width, const size_t page_height );
+
+	const size_t GetPageWidth() const;
+	const size_t GetPageHeight() const;
+	const size_t GetPagesX() const;
+	const size_t GetPagesY() const;
+	const size_t GetPagesCount() const;
+	const size_t GetPageAt( const size_t x, const size_t y ) const;
+
+	// increased every time anything within page changes
+	const size_t GetPageVersion( const size_t page ) const;
+
+	// draws page into dest ( which must be of page size ), parts that are outside of texture stay transparent
+	// writer must not change texture meanwhile, hold LockBitmap() ( or TryLockBitmap() ) while calling it from other thread
+	void CompositePage( const size_t page, Texture* dest ) const;
+
+protected:
+
+	// marks pages that intersect area as outdated
+	void InvalidateArea( const size_t x1, const size_t y1, const size_t x2, const size_t y2 );
+
+	// draws area of texture ( x2 and y2 are inclusive ) to dest at dest_x, dest_y, dest area is already transparent
+	virtual void CompositeArea( const size_t x1, const size_t y1, const size_t x2, const size_t y2, Texture* dest, const size_t dest_x, const size_t dest_y ) const = 0;
+
+private:
+	const size_t m_page_width;
+	const size_t m_page_height;
+	const size_t m_pages_x;
+	const size_t m_pages_y;
+	std::vector< std::atomic< size_t > > m_page_versions;
+
+};
+
+}
+}
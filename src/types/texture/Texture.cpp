@@ -2,6 +2,8 @@
 
 #include <cstring>
 #include <cmath>
+#include <algorithm>
+#include <iterator>
 
 #include "common/ObjectLink.h"
 #include "engine/Engine.h"
@@ -9,6 +11,11 @@
 #include "util/random/Random.h"
 #include "util/Perlin.h"
 
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#define TEXTURE_SSE2
+#include <emmintrin.h>
+#endif
+
 // TODO: refactor, remove map dependency
 #include "game/map/Consts.h"
 
@@ -119,6 +126,680 @@ void Texture::Fill( const size_t x1, const size_t y1, const size_t x2, const siz
 	}
 }
 
+static inline Color::rgba_t MixColors( const Color::rgba_t a, const Color::rgba_t b, const float alpha ) {
+	return
+		(uint8_t)( (float)( a & 0xff ) * alpha + (float)( b & 0xff ) * ( 1.0f - alpha ) ) |
+			(uint8_t)( (float)( a >> 8 & 0xff ) * alpha + (float)( b >> 8 & 0xff ) * ( 1.0f - alpha ) ) << 8 |
+			(uint8_t)( (float)( a >> 16 & 0xff ) * alpha + (float)( b >> 16 & 0xff ) * ( 1.0f - alpha ) ) << 16 |
+			(uint8_t)( (float)( a >> 24 & 0xff ) * alpha + (float)( b >> 24 & 0xff ) * ( 1.0f - alpha ) ) << 24;
+}
+
+// flags that can be handled by specialized kernels (random mirrors are resolved before kernel is selected)
+static constexpr add_flag_t AM_KERNEL_FLAGS = AM_MERGE | AM_MIRROR_X | AM_MIRROR_Y | AM_KEEP_TRANSPARENCY;
+
+typedef void (* add_from_kernel_t)( const Texture* source, Texture* dest, const size_t x1, const size_t y1, const size_t w, const size_t h, const size_t dest_x, const size_t dest_y, const float alpha );
+
+#ifdef TEXTURE_SSE2
+static inline __m128i ReversePixels( const __m128i pixels ) {
+	return _mm_shuffle_epi32( pixels, _MM_SHUFFLE( 0, 1, 2, 3 ) );
+}
+
+// MixColors( c, c, alpha ) for 4 pixels at once, float operations are same as in scalar version so results are identical
+static inline __m128i MixSelf4( const __m128i pixels, const __m128 alpha, const __m128 inv_alpha ) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = _mm_unpacklo_epi8( pixels, zero );
+	const __m128i hi = _mm_unpackhi_epi8( pixels, zero );
+	const auto f_mix = [ &alpha, &inv_alpha ]( const __m128i channels ) -> __m128i {
+		const __m128 c = _mm_cvtepi32_ps( channels );
+		return _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( c, alpha ), _mm_mul_ps( c, inv_alpha ) ) );
+	};
+	return _mm_packus_epi16(
+		_mm_packs_epi32( f_mix( _mm_unpacklo_epi16( lo, zero ) ), f_mix( _mm_unpackhi_epi16( lo, zero ) ) ),
+		_mm_packs_epi32( f_mix( _mm_unpacklo_epi16( hi, zero ) ), f_mix( _mm_unpackhi_epi16( hi, zero ) ) )
+	);
+}
+#endif
+
+/**
+ * Straight (possibly rotated, mirrored, merged or mixed) copy of source area, without any per-pixel decisions except for merge and transparency checks
+ * MIX is alpha < 1.0: without MERGE pixels get alpha of the copy, with MERGE they are mixed like in generic implementation
+ * All flag and rotation checks are resolved at compile time, unrotated and upside-down rows are processed 4 pixels at once with SSE2 (if available)
+ * Must produce exactly same result as generic implementation (it is verified by --self-tests)
+ */
+template< rotate_t ROTATE, bool MIRROR_X, bool MIRROR_Y, bool MERGE, bool KEEP_TRANSPARENCY, bool MIX >
+static void AddFromKernel( const Texture* source, Texture* dest, const size_t x1, const size_t y1, const size_t w, const size_t h, const size_t dest_x, const size_t dest_y, const float alpha ) {
+
+	const ssize_t dw = dest->m_width;
+	const ssize_t sw = source->m_width;
+
+	// check whole areas once instead of every pixel
+	uint32_t* const to_base = (uint32_t*)ptr( dest->m_bitmap, ( dest_y * dw + dest_x ) * sizeof( uint32_t ), ( ( std::max( w, h ) - 1 ) * dw + std::max( w, h ) ) * sizeof( uint32_t ) );
+	const uint32_t* const from_base = (const uint32_t*)ptr( source->m_bitmap, ( y1 * sw + x1 ) * sizeof( uint32_t ), ( ( h - 1 ) * sw + w ) * sizeof( uint32_t ) );
+
+	// destination pixel offset (from to_base) for every source pixel is row_start + x * step
+	constexpr ssize_t step_sign = ( ROTATE == ROTATE_0 || ROTATE == ROTATE_90 )
+		? 1
+		: -1;
+	const ssize_t step = ( ROTATE == ROTATE_0 || ROTATE == ROTATE_180 )
+		? step_sign
+		: step_sign * dw;
+	const ssize_t sstep = MIRROR_X
+		? -1
+		: 1;
+
+	const uint8_t alpha_byte = (uint8_t)floor( alpha * 0xff );
+
+#ifdef TEXTURE_SSE2
+	const __m128i zero_v = _mm_setzero_si128();
+	const __m128i merge_mask_v = _mm_set1_epi32( 0x000000ff );
+	const __m128i alpha_mask_v = _mm_set1_epi32( (int)0xff000000 );
+	const __m128i alpha_byte_v = _mm_set1_epi32( (int)( (uint32_t)alpha_byte << 24 ) );
+	const __m128 alpha_v = _mm_set1_ps( alpha );
+	const __m128 inv_alpha_v = _mm_set1_ps( 1.0f - alpha );
+#endif
+
+	for ( size_t y = 0 ; y < h ; y++ ) {
+
+		ssize_t row_start;
+		switch ( ROTATE ) {
+			case ROTATE_0: {
+				row_start = y * dw;
+				break;
+			}
+			case ROTATE_90: {
+				row_start = h - y - 1;
+				break;
+			}
+			case ROTATE_180: {
+				row_start = ( h - y - 1 ) * dw + w - 1;
+				break;
+			}
+			case ROTATE_270: {
+				row_start = ( w - 1 ) * dw + y;
+				break;
+			}
+		}
+		uint32_t* const to_row = to_base + row_start;
+
+		const uint32_t* const from_row = from_base + ( MIRROR_Y
+			? h - y - 1
+			: y
+		) * sw + ( MIRROR_X
+			? w - 1
+			: 0
+		);
+
+		if ( ROTATE == ROTATE_0 && !MIRROR_X && !MERGE && !KEEP_TRANSPARENCY && !MIX ) {
+			memcpy( to_row, from_row, w * sizeof( uint32_t ) );
+			continue;
+		}
+
+		size_t x = 0;
+
+#ifdef TEXTURE_SSE2
+		if constexpr ( ROTATE == ROTATE_0 || ROTATE == ROTATE_180 ) {
+			// both rows are contiguous, only direction may differ, so keep pixels in order of x inside registers
+			for ( ; x + 4 <= w ; x += 4 ) {
+				const __m128i from = MIRROR_X
+					? ReversePixels( _mm_loadu_si128( (const __m128i*)( from_row - x - 3 ) ) )
+					: _mm_loadu_si128( (const __m128i*)( from_row + x ) );
+				__m128i* const to = (__m128i*)( ROTATE == ROTATE_0
+					? to_row + x
+					: to_row - x - 3
+				);
+				__m128i result;
+				if ( MIX ) {
+					result = MERGE
+						? MixSelf4( from, alpha_v, inv_alpha_v )
+						: _mm_or_si128( _mm_andnot_si128( alpha_mask_v, from ), alpha_byte_v );
+				}
+				else {
+					result = from;
+				}
+				if ( MERGE || KEEP_TRANSPARENCY ) {
+					const __m128i to_pixels = ROTATE == ROTATE_0
+						? _mm_loadu_si128( to )
+						: ReversePixels( _mm_loadu_si128( to ) );
+					__m128i keep = zero_v; // destination pixels that must stay as they are
+					if ( KEEP_TRANSPARENCY ) {
+						keep = _mm_cmpeq_epi32( _mm_and_si128( to_pixels, alpha_mask_v ), zero_v );
+					}
+					if ( MERGE ) {
+						keep = _mm_or_si128( keep, _mm_cmpeq_epi32( _mm_and_si128( from, merge_mask_v ), zero_v ) );
+					}
+					result = _mm_or_si128( _mm_and_si128( keep, to_pixels ), _mm_andnot_si128( keep, result ) );
+				}
+				_mm_storeu_si128(
+					to, ROTATE == ROTATE_0
+						? result
+						: ReversePixels( result )
+				);
+			}
+		}
+#endif
+
+		// remaining pixels, or whole row if it can't be vectorized
+		for ( ; x < w ; x++ ) {
+			uint32_t* const to = to_row + x * step;
+			const uint32_t from = from_row[ x * sstep ];
+			if ( KEEP_TRANSPARENCY && !( (const uint8_t*)to )[ 3 ] ) {
+				continue; // don't overwrite transparent pixels
+			}
+			if ( MERGE && !( from & 0x000000ff ) ) {
+				continue;
+			}
+			if ( MIX ) {
+				if ( MERGE ) {
+					// generic implementation mixes pixel with itself after copying, keep it consistent
+					*to = MixColors( from, from, alpha );
+				}
+				else {
+					*to = from;
+					( (uint8_t*)to )[ 3 ] = alpha_byte;
+				}
+			}
+			else {
+				*to = from;
+			}
+		}
+	}
+}
+
+// picks kernel instantiation for runtime options, in order of AddFromKernel template arguments
+template< rotate_t ROTATE, bool... OPTIONS >
+struct add_from_kernel_selector_t {
+	static add_from_kernel_t Get( const bool* options ) {
+		if constexpr ( sizeof...( OPTIONS ) == 5 ) {
+			return &AddFromKernel< ROTATE, OPTIONS... >;
+		}
+		else {
+			return options[ 0 ]
+				? add_from_kernel_selector_t< ROTATE, OPTIONS..., true >::Get( options + 1 )
+				: add_from_kernel_selector_t< ROTATE, OPTIONS..., false >::Get( options + 1 );
+		}
+	}
+};
+
+static add_from_kernel_t GetAddFromKernel( const add_flag_t flags, const rotate_t rotate, const float alpha ) {
+	if ( flags & ~AM_KERNEL_FLAGS ) {
+		return nullptr;
+	}
+	const bool options[ 5 ] = {
+		( flags & AM_MIRROR_X ) != 0,
+		( flags & AM_MIRROR_Y ) != 0,
+		( flags & AM_MERGE ) != 0,
+		( flags & AM_KEEP_TRANSPARENCY ) != 0,
+		alpha < 1.0f,
+	};
+	switch ( rotate ) {
+		case ROTATE_0:
+			return add_from_kernel_selector_t< ROTATE_0 >::Get( options );
+		case ROTATE_90:
+			return add_from_kernel_selector_t< ROTATE_90 >::Get( options );
+		case ROTATE_180:
+			return add_from_kernel_selector_t< ROTATE_180 >::Get( options );
+		case ROTATE_270:
+			return add_from_kernel_selector_t< ROTATE_270 >::Get( options );
+		default:
+			return nullptr;
+	}
+}
+
+// flags that can be handled by shaped kernels, random shifts and perlin edges are left to generic implementation
+static constexpr add_flag_t AM_SHAPED_KERNEL_FLAGS =
+	AM_KERNEL_FLAGS |
+		AM_INVERT |
+		AM_GRADIENT_LEFT | AM_GRADIENT_TOP | AM_GRADIENT_RIGHT | AM_GRADIENT_BOTTOM | AM_GRADIENT_TIGHTER |
+		AM_ROUND_LEFT | AM_ROUND_TOP | AM_ROUND_RIGHT | AM_ROUND_BOTTOM | AM_COASTLINE_BORDER |
+		AM_RANDOM_STRETCH | AM_RANDOM_STRETCH_SHRINK | AM_RANDOM_STRETCH_SHIFT | AM_RANDOM_STRETCH_SHUFFLE;
+
+typedef void (* add_from_shaped_kernel_t)( const Texture* source, Texture* dest, add_flag_t flags, const size_t x1, const size_t y1, const size_t w, const size_t h, const size_t dest_x, const size_t dest_y, const rotate_t rotate, const float alpha, util::random::Random* rng, util::Perlin* perlin );
+
+#ifdef TEXTURE_SSE2
+// MixColors( a, b, alpha ) for 4 pixels at once, each with it's own alpha
+static inline __m128i MixColors4( const __m128i a, const __m128i b, const __m128 alpha, const __m128 inv_alpha ) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i a_lo = _mm_unpacklo_epi8( a, zero );
+	const __m128i a_hi = _mm_unpackhi_epi8( a, zero );
+	const __m128i b_lo = _mm_unpacklo_epi8( b, zero );
+	const __m128i b_hi = _mm_unpackhi_epi8( b, zero );
+	const auto f_mix = [ &alpha, &inv_alpha ]( const __m128i a_channels, const __m128i b_channels, const __m128 pixel_alpha, const __m128 pixel_inv_alpha ) -> __m128i {
+		return _mm_cvttps_epi32(
+			_mm_add_ps(
+				_mm_mul_ps( _mm_cvtepi32_ps( a_channels ), pixel_alpha ),
+				_mm_mul_ps( _mm_cvtepi32_ps( b_channels ), pixel_inv_alpha )
+			)
+		);
+	};
+#define x( _i, _a, _b, _unpack ) f_mix( \
+        _unpack( _a, zero ), \
+        _unpack( _b, zero ), \
+        _mm_shuffle_ps( alpha, alpha, _MM_SHUFFLE( _i, _i, _i, _i ) ), \
+        _mm_shuffle_ps( inv_alpha, inv_alpha, _MM_SHUFFLE( _i, _i, _i, _i ) ) \
+    )
+	return _mm_packus_epi16(
+		_mm_packs_epi32( x( 0, a_lo, b_lo, _mm_unpacklo_epi16 ), x( 1, a_lo, b_lo, _mm_unpackhi_epi16 ) ),
+		_mm_packs_epi32( x( 2, a_hi, b_hi, _mm_unpacklo_epi16 ), x( 3, a_hi, b_hi, _mm_unpackhi_epi16 ) )
+	);
+#undef x
+}
+#endif
+
+/**
+ * Copy of source area where pixels depend on their position ( gradients, rounded corners with coastline borders ) or source is randomly stretched
+ * Flag checks that don't change between pixels are resolved at compile time or once per call, gradient and distance math is turned into lookups and integer steps
+ * Gradient rows that aren't rotated sideways (or rounded) are blended 4 pixels at once with SSE2 (if available)
+ * Random values are consumed in same order as in generic implementation, so result (and state of rng afterwards) must be exactly same (it is verified by --self-tests)
+ */
+template< bool GRADIENT, bool ROUND, bool STRETCH, bool MERGE, bool KEEP_TRANSPARENCY, bool INVERT >
+static void AddFromShapedKernel( const Texture* source, Texture* dest, add_flag_t flags, const size_t x1, const size_t y1, const size_t w, const size_t h, const size_t dest_x, const size_t dest_y, const rotate_t rotate, const float alpha, util::random::Random* rng, util::Perlin* perlin ) {
+
+#define COASTLINES_BORDER_RND ( (float)( perlin->Noise( x * 4, y * 4, 1.5f ) + 1.0f ) / 2 * game::map::s_consts.coastlines.border_size )
+
+	const ssize_t dw = dest->m_width;
+	const ssize_t sw = source->m_width;
+
+	// check whole areas once instead of every pixel
+	uint32_t* const to_base = (uint32_t*)ptr( dest->m_bitmap, ( dest_y * dw + dest_x ) * sizeof( uint32_t ), ( ( std::max( w, h ) - 1 ) * dw + std::max( w, h ) ) * sizeof( uint32_t ) );
+	const uint32_t* const from_base = (const uint32_t*)ptr( source->m_bitmap, ( y1 * sw + x1 ) * sizeof( uint32_t ), ( ( h - 1 ) * sw + w ) * sizeof( uint32_t ) );
+
+	const bool is_mirror_x = flags & AM_MIRROR_X;
+	const bool is_mirror_y = flags & AM_MIRROR_Y;
+
+	// same center and radius as in generic implementation
+	const size_t cx = floor( w / 2 );
+	const size_t cy = floor( h / 2 );
+	float r = sqrt( pow( (float)cx, 2 ) + pow( (float)cy, 2 ) );
+	if ( ROUND ) {
+		r *= 0.7f;
+	}
+	const bool is_round_left = flags & AM_ROUND_LEFT;
+	const bool is_round_top = flags & AM_ROUND_TOP;
+	const bool is_round_right = flags & AM_ROUND_RIGHT;
+	const bool is_round_bottom = flags & AM_ROUND_BOTTOM;
+	const bool is_coastline_border = ROUND && ( flags & AM_COASTLINE_BORDER );
+	const Color::rgba_t border_color = game::map::s_consts.coastlines.border_color.GetRGBA();
+	const float border_alpha = game::map::s_consts.coastlines.border_alpha;
+	if ( is_coastline_border ) {
+		ASSERT_NOLOG( perlin, "perlin for coastline border not set" );
+	}
+
+	// gradient amount only depends on k = gk + gx * dx + gy * dy ( where it's positive ), see generic implementation for formulas
+	ssize_t gk = 0, gx = 0, gy = 0;
+	size_t gdiv = 1;
+	if ( GRADIENT ) {
+		if ( flags & AM_GRADIENT_LEFT ) {
+			gx = -1;
+			if ( flags & AM_GRADIENT_TOP ) {
+				gy = -1;
+				gk = cx + cy;
+			}
+			else if ( flags & AM_GRADIENT_BOTTOM ) {
+				gy = 1;
+				gk = (ssize_t)cx - cy;
+			}
+			else {
+				gk = cx;
+			}
+		}
+		else if ( flags & AM_GRADIENT_RIGHT ) {
+			gx = 1;
+			if ( flags & AM_GRADIENT_TOP ) {
+				gy = -1;
+				gk = (ssize_t)cy - cx;
+			}
+			else if ( flags & AM_GRADIENT_BOTTOM ) {
+				gy = 1;
+				gk = -(ssize_t)( cx + cy );
+			}
+			else {
+				gk = -(ssize_t)cx;
+			}
+		}
+		else if ( flags & AM_GRADIENT_TOP ) {
+			gy = -1;
+			gk = cy;
+		}
+		else {
+			gy = 1;
+			gk = -(ssize_t)cy;
+		}
+		gdiv = gy == 0
+			? w
+			: ( gx == 0
+				? h
+				: w + h
+			);
+	}
+	// indexed by k + gradient_offset, everything below 1 stays 0
+	const size_t gradient_offset = w + h;
+	float gradient[ GRADIENT
+		? gradient_offset * 2 + 1
+		: 1
+	];
+	if ( GRADIENT ) {
+		const size_t range = ( flags & AM_GRADIENT_TIGHTER )
+			? 1
+			: 2;
+		for ( size_t i = 0 ; i <= gradient_offset ; i++ ) {
+			gradient[ i ] = 0.0f;
+		}
+		for ( size_t k = 1 ; k <= gradient_offset ; k++ ) {
+			float p = (float)k / gdiv * range;
+			if ( alpha < 1.0f ) {
+				p *= alpha;
+			}
+			gradient[ gradient_offset + k ] = p;
+		}
+	}
+
+	// stretch setup, same as in generic implementation
+	std::pair< float, float > srx, sry; // stretch ratio ranges
+	float ssx_start, ssx, ssy; // stretched source
+	if ( STRETCH ) {
+		ASSERT_NOLOG( rng, "no rng provided for random mirror" );
+		if ( flags & AM_RANDOM_STRETCH_SHUFFLE ) {
+			flags |= AM_RANDOM_STRETCH | AM_RANDOM_STRETCH_SHRINK | AM_RANDOM_STRETCH_SHIFT;
+		}
+		const float rmin = game::map::s_consts.tile.random.texture_edge_stretch_min;
+		const float rmax = game::map::s_consts.tile.random.texture_edge_stretch_max;
+		srx = {
+			rng->GetFloat( rmin, rmax ),
+			( flags & AM_RANDOM_STRETCH_SHRINK )
+				? rng->GetFloat( rmin, rmax )
+				: 0.0f
+		};
+		sry = {
+			rng->GetFloat( rmin, rmax ),
+			( flags & AM_RANDOM_STRETCH_SHRINK )
+				? rng->GetFloat( rmin, rmax )
+				: 0.0f
+		};
+		ssx_start = ( srx.first + srx.second ) / 2 * w / 2;
+		ssy = ( sry.first + sry.second ) / 2 * h / 2;
+		if ( flags & AM_RANDOM_STRETCH_SHIFT ) {
+			ssx_start += rng->GetUInt( 0, w - 1 ) * ( 1.0f + srx.second );
+			ssy += rng->GetUInt( 0, h - 1 ) * ( 1.0f + sry.second );
+		}
+		ssx = ssx_start + rng->GetFloat( -srx.first, srx.second );
+		ssy += rng->GetFloat( -sry.first, sry.second );
+	}
+
+	const uint8_t alpha_byte = (uint8_t)floor( alpha * 0xff );
+
+	// destination coordinates are dx = row_dx + x * step_dx, dy = row_dy + x * step_dy
+	ssize_t step_dx = 0, step_dy = 0;
+	switch ( rotate ) {
+		case ROTATE_0: {
+			step_dx = 1;
+			break;
+		}
+		case ROTATE_90: {
+			step_dy = 1;
+			break;
+		}
+		case ROTATE_180: {
+			step_dx = -1;
+			break;
+		}
+		case ROTATE_270: {
+			step_dy = -1;
+			break;
+		}
+	}
+	const ssize_t step = step_dy * dw + step_dx;
+
+#ifdef TEXTURE_SSE2
+	// destination rows are contiguous, only direction may differ
+	const bool is_vectorized = GRADIENT && !ROUND && ( rotate == ROTATE_0 || rotate == ROTATE_180 );
+	const __m128i zero_v = _mm_setzero_si128();
+	const __m128i merge_mask_v = _mm_set1_epi32( 0x000000ff );
+	const __m128i alpha_mask_v = _mm_set1_epi32( (int)0xff000000 );
+	const __m128 one_v = _mm_set1_ps( 1.0f );
+#endif
+
+	for ( size_t y = 0 ; y < h ; y++ ) {
+
+		ssize_t row_dx, row_dy;
+		switch ( rotate ) {
+			case ROTATE_0: {
+				row_dx = 0;
+				row_dy = y;
+				break;
+			}
+			case ROTATE_90: {
+				row_dx = h - y - 1;
+				row_dy = 0;
+				break;
+			}
+			case ROTATE_180: {
+				row_dx = w - 1;
+				row_dy = h - y - 1;
+				break;
+			}
+			case ROTATE_270: {
+				row_dx = y;
+				row_dy = w - 1;
+				break;
+			}
+		}
+		uint32_t* const to_row = to_base + row_dy * dw + row_dx;
+		const ssize_t row_k = gradient_offset + gk + gx * row_dx + gy * row_dy;
+		const ssize_t step_k = gx * step_dx + gy * step_dy;
+
+		// source row doesn't change within destination row
+		ssize_t sy;
+		if ( STRETCH ) {
+			sy = floor( ssy );
+			while ( sy < 0 ) {
+				sy += h;
+			}
+			while ( sy > h - 1 ) {
+				sy -= h - 1;
+			}
+		}
+		else {
+			sy = y;
+		}
+		const uint32_t* const from_row = from_base + ( is_mirror_y
+			? h - 1 - sy
+			: sy
+		) * sw;
+
+		// source pixel for x, also moves stretched source forward
+		const auto f_get_from = [ &ssx, &srx, w, rng, from_row, is_mirror_x ]( const size_t x ) -> uint32_t {
+			ssize_t sx;
+			if ( STRETCH ) {
+				sx = floor( ssx );
+				while ( sx < 0 ) {
+					sx += w;
+				}
+				while ( sx >= w ) {
+					sx -= w;
+				}
+				ssx += rng->GetFloat( 1.0f - srx.first, 1.0f + srx.second );
+			}
+			else {
+				sx = x;
+			}
+			return from_row[ is_mirror_x
+				? w - 1 - sx
+				: sx
+			];
+		};
+
+		size_t x = 0;
+
+#ifdef TEXTURE_SSE2
+		if ( is_vectorized ) {
+			for ( ; x + 4 <= w ; x += 4 ) {
+				// one by one, so that random values are taken in right order
+				const uint32_t from_0 = f_get_from( x );
+				const uint32_t from_1 = f_get_from( x + 1 );
+				const uint32_t from_2 = f_get_from( x + 2 );
+				const uint32_t from_3 = f_get_from( x + 3 );
+				const __m128i from = _mm_setr_epi32( from_0, from_1, from_2, from_3 );
+				__m128i* const to = (__m128i*)( rotate == ROTATE_0
+					? to_row + x
+					: to_row - x - 3
+				);
+				const __m128i to_pixels = rotate == ROTATE_0
+					? _mm_loadu_si128( to )
+					: ReversePixels( _mm_loadu_si128( to ) );
+				const ssize_t k = row_k + x * step_k;
+				const __m128 p = _mm_setr_ps( gradient[ k ], gradient[ k + step_k ], gradient[ k + step_k * 2 ], gradient[ k + step_k * 3 ] );
+				__m128i keep = zero_v; // destination pixels that must stay as they are
+				if ( KEEP_TRANSPARENCY ) {
+					keep = _mm_cmpeq_epi32( _mm_and_si128( to_pixels, alpha_mask_v ), zero_v );
+				}
+				if ( INVERT ) {
+					keep = _mm_xor_si128( keep, _mm_cmpeq_epi32( zero_v, zero_v ) );
+				}
+				if ( MERGE ) {
+					keep = _mm_or_si128( keep, _mm_cmpeq_epi32( _mm_and_si128( from, merge_mask_v ), zero_v ) );
+				}
+				__m128i result = MixColors4( from, to_pixels, p, _mm_sub_ps( one_v, p ) );
+				result = _mm_or_si128( _mm_and_si128( keep, to_pixels ), _mm_andnot_si128( keep, result ) );
+				_mm_storeu_si128(
+					to, rotate == ROTATE_0
+						? result
+						: ReversePixels( result )
+				);
+			}
+		}
+#endif
+
+		// remaining pixels, or whole row if it can't be vectorized
+		for ( ; x < w ; x++ ) {
+			uint32_t* const to = to_row + x * step;
+
+			bool is_pixel_needed = true;
+			Color::rgba_t mix_color = 0;
+
+			if ( ROUND ) {
+				const ssize_t dx = row_dx + x * step_dx;
+				const ssize_t dy = row_dy + x * step_dy;
+				if (
+					( is_round_left && ( dx <= cx ) && ( dy >= cy ) ) ||
+						( is_round_top && ( dx <= cx ) && ( dy <= cy ) ) ||
+						( is_round_right && ( dx >= cx ) && ( dy <= cy ) ) ||
+						( is_round_bottom && ( dx >= cx ) && ( dy >= cy ) )
+					) {
+					// pow( v, 2 ) is exact for these, so this is same as in generic implementation
+					const double ddx = (float)dx - cx;
+					const double ddy = (float)dy - cy;
+					float d = sqrt( ddx * ddx + ddy * ddy );
+					if ( is_coastline_border ) {
+						d = std::min( d, d - (float)sqrt( pow( COASTLINES_BORDER_RND, 2 ) * 2 ) + game::map::s_consts.coastlines.border_size / 2 );
+					}
+					if ( d > r ) {
+						is_pixel_needed = false;
+					}
+					if ( is_coastline_border && d >= r - game::map::s_consts.coastlines.perlin.round_range ) {
+						mix_color = border_color;
+					}
+				}
+			}
+
+			if ( KEEP_TRANSPARENCY && is_pixel_needed && !( (const uint8_t*)to )[ 3 ] ) {
+				is_pixel_needed = false; // don't overwrite transparent pixels
+			}
+			if ( INVERT ) {
+				is_pixel_needed = !is_pixel_needed;
+			}
+
+			if ( !is_pixel_needed ) {
+				if ( STRETCH ) {
+					ssx += rng->GetFloat( 1.0f - srx.first, 1.0f + srx.second );
+				}
+				continue;
+			}
+
+			const uint32_t from = f_get_from( x );
+			if ( MERGE && !( from & 0x000000ff ) ) {
+				continue;
+			}
+
+			uint32_t pixel = mix_color
+				? MixColors( mix_color, from, border_alpha )
+				: from;
+			if ( GRADIENT ) {
+				*to = MixColors( pixel, *to, gradient[ row_k + x * step_k ] );
+			}
+			else if ( alpha < 1.0f ) {
+				if ( MERGE ) {
+					// generic implementation mixes pixel with itself after copying, keep it consistent
+					*to = MixColors( pixel, pixel, alpha );
+				}
+				else {
+					*to = pixel;
+					( (uint8_t*)to )[ 3 ] = alpha_byte;
+				}
+			}
+			else {
+				*to = pixel;
+			}
+		}
+
+		if ( STRETCH ) {
+			ssx = ssx_start + rng->GetFloat( -srx.first, srx.second );
+			ssy += rng->GetFloat( 1.0f - sry.first, 1.0f + sry.second );
+		}
+	}
+
+#undef COASTLINES_BORDER_RND
+}
+
+// picks shaped kernel instantiation for runtime options, in order of AddFromShapedKernel template arguments
+template< bool... OPTIONS >
+struct add_from_shaped_kernel_selector_t {
+	static add_from_shaped_kernel_t Get( const bool* options ) {
+		if constexpr ( sizeof...( OPTIONS ) == 6 ) {
+			return &AddFromShapedKernel< OPTIONS... >;
+		}
+		else {
+			return options[ 0 ]
+				? add_from_shaped_kernel_selector_t< OPTIONS..., true >::Get( options + 1 )
+				: add_from_shaped_kernel_selector_t< OPTIONS..., false >::Get( options + 1 );
+		}
+	}
+};
+
+static add_from_shaped_kernel_t GetAddFromShapedKernel( const add_flag_t flags ) {
+	if ( flags & ~AM_SHAPED_KERNEL_FLAGS ) {
+		return nullptr;
+	}
+	const bool options[ 6 ] = {
+		( flags & ( AM_GRADIENT_LEFT | AM_GRADIENT_TOP | AM_GRADIENT_RIGHT | AM_GRADIENT_BOTTOM ) ) != 0,
+		( flags & ( AM_ROUND_LEFT | AM_ROUND_TOP | AM_ROUND_RIGHT | AM_ROUND_BOTTOM ) ) != 0,
+		( flags & ( AM_RANDOM_STRETCH | AM_RANDOM_STRETCH_SHUFFLE ) ) != 0,
+		( flags & AM_MERGE ) != 0,
+		( flags & AM_KEEP_TRANSPARENCY ) != 0,
+		( flags & AM_INVERT ) != 0,
+	};
+	if ( options[ 1 ] && !options[ 3 ] ) {
+		return nullptr; // not supported, let generic implementation complain
+	}
+	return add_from_shaped_kernel_selector_t<>::Get( options );
+}
+
+// replaces random mirror flags with (maybe) real ones, consumes same random values no matter which implementation is used later
+static void ResolveRandomMirrors( add_flag_t& flags, util::random::Random* rng ) {
+	if ( flags & types::texture::AM_RANDOM_MIRROR_X ) {
+		ASSERT_NOLOG( rng, "no rng provided for random mirror" );
+		if ( rng->IsLucky( 2 ) ) {
+			flags ^= types::texture::AM_MIRROR_X;
+		}
+	}
+	if ( flags & types::texture::AM_RANDOM_MIRROR_Y ) {
+		ASSERT_NOLOG( rng, "no rng provided for random mirror" );
+		if ( rng->IsLucky( 2 ) ) {
+			flags ^= types::texture::AM_MIRROR_Y;
+		}
+	}
+	flags &= ~( types::texture::AM_RANDOM_MIRROR_X | types::texture::AM_RANDOM_MIRROR_Y );
+}
+
 void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags, const size_t x1, const size_t y1, const size_t x2, const size_t y2, const size_t dest_x, const size_t dest_y, const rotate_t rotate, const float alpha, util::random::Random* rng, util::Perlin* perlin ) {
 	ASSERT( x2 >= x1, "invalid source x size ( " + std::to_string( x2 ) + " < " + std::to_string( x1 ) + " )" );
 	ASSERT( y2 >= y1, "invalid source y size ( " + std::to_string( y2 ) + " < " + std::to_string( y1 ) + " )" );
@@ -127,28 +808,56 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 	ASSERT( alpha >= 0, "invalid alpha value ( " + std::to_string( alpha ) + " < 0 )" );
 	ASSERT( alpha <= 1, "invalid alpha value ( " + std::to_string( alpha ) + " > 1 )" );
 
-#define MIX_COLORS( _a, _b, _alpha ) ( \
-        (uint8_t)( (float)( (_a) & 0xff ) * (_alpha) + (float)( (_b) & 0xff ) * ( 1.0f - (_alpha) ) ) | \
-        (uint8_t)( (float)( (_a) >> 8 & 0xff ) * (_alpha) + (float)( (_b) >> 8 & 0xff ) * ( 1.0f - (_alpha) ) ) << 8 | \
-        (uint8_t)( (float)( (_a) >> 16 & 0xff ) * (_alpha) + (float)( (_b) >> 16 & 0xff ) * ( 1.0f - (_alpha) ) ) << 16 | \
-        (uint8_t)( (float)( (_a) >> 24 & 0xff ) * (_alpha) + (float)( (_b) >> 24 & 0xff ) * ( 1.0f - (_alpha) ) ) << 24 \
-    )
-
-#define COASTLINES_BORDER_RND ( (float)( perlin->Noise( x * 4, y * 4, 1.5f ) + 1.0f ) / 2 * game::map::s_consts.coastlines.border_size )
-
 	// +1 because it's inclusive on both sides
 	// TODO: make non-inclusive
 	const size_t w = x2 - x1 + 1;
 	const size_t h = y2 - y1 + 1;
 
-	const void* from;
-	void* to;
-
 	ASSERT( rotate < 4, "invalid rotate value " + std::to_string( rotate ) );
 	if ( rotate > 0 ) {
 		ASSERT( w == h, "rotating supported only for squares for now" );
 	}
 
+	// resolve random mirrors first, everything after that doesn't need to know about them
+	ResolveRandomMirrors( flags, rng );
+
+	const auto kernel = GetAddFromKernel( flags, rotate, alpha );
+	const auto shaped_kernel = kernel
+		? nullptr
+		: GetAddFromShapedKernel( flags );
+	if ( kernel ) {
+		kernel( source, this, x1, y1, w, h, dest_x, dest_y, alpha );
+	}
+	else if ( shaped_kernel ) {
+		shaped_kernel( source, this, flags, x1, y1, w, h, dest_x, dest_y, rotate, alpha, rng, perlin );
+	}
+	else {
+		AddFromGeneric( source, flags, x1, y1, x2, y2, dest_x, dest_y, rotate, alpha, rng, perlin );
+	}
+
+	Update(
+		{
+			dest_x,
+			dest_y,
+			dest_x + w - 1,
+			dest_y + h - 1
+		}
+	);
+}
+
+void Texture::AddFromGeneric( const types::texture::Texture* source, add_flag_t flags, const size_t x1, const size_t y1, const size_t x2, const size_t y2, const size_t dest_x, const size_t dest_y, const rotate_t rotate, const float alpha, util::random::Random* rng, util::Perlin* perlin ) {
+
+#define COASTLINES_BORDER_RND ( (float)( perlin->Noise( x * 4, y * 4, 1.5f ) + 1.0f ) / 2 * game::map::s_consts.coastlines.border_size )
+
+	// no-op if called from AddFrom(), needed when called directly
+	ResolveRandomMirrors( flags, rng );
+
+	const size_t w = x2 - x1 + 1;
+	const size_t h = y2 - y1 + 1;
+
+	const void* from;
+	void* to;
+
 	size_t shiftx, shifty; // for random shifts
 	size_t cx, cy; // center
 	ssize_t sx, sy; // source
@@ -189,20 +898,6 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 		}
 	}
 
-	if ( flags & types::texture::AM_RANDOM_MIRROR_X ) {
-		ASSERT( rng, "no rng provided for random mirror" );
-		if ( rng->IsLucky( 2 ) ) {
-			flags ^= types::texture::AM_MIRROR_X;
-		}
-	}
-
-	if ( flags & types::texture::AM_RANDOM_MIRROR_Y ) {
-		ASSERT( rng, "no rng provided for random mirror" );
-		if ( rng->IsLucky( 2 ) ) {
-			flags ^= types::texture::AM_MIRROR_Y;
-		}
-	}
-
 	if ( flags & types::texture::AM_RANDOM_SHIFT_X ) {
 		ASSERT( rng, "no rng provided for random shift" );
 		shiftx = rng->GetUInt( 0, w - 1 );
@@ -426,8 +1121,8 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 					if ( !perlin_need_pixel && !perlin_need_border && ( flags & types::texture::AM_COASTLINE_BORDER ) ) {
 						if (
 							( perlin_maxx[ y ] && x < perlin_maxx[ y ] + COASTLINES_BORDER_RND ) ||
-								( perlin_maxx[ y - 1 ] && y > 0 && x <= perlin_maxx[ y - 1 ] ) ||
-								( perlin_maxx[ y + 1 ] && y < h - 1 && x <= perlin_maxx[ y + 1 ] )
+								( y > 0 && perlin_maxx[ y - 1 ] && x <= perlin_maxx[ y - 1 ] ) ||
+								( y < h - 1 && perlin_maxx[ y + 1 ] && x <= perlin_maxx[ y + 1 ] )
 							) {
 							perlin_need_border = true;
 						}
@@ -440,8 +1135,8 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 					if ( !perlin_need_pixel && !perlin_need_border && ( flags & types::texture::AM_COASTLINE_BORDER ) ) {
 						if (
 							( perlin_maxy[ x ] && y < perlin_maxy[ x ] + COASTLINES_BORDER_RND ) ||
-								( perlin_maxy[ x - 1 ] && x > 0 && y <= perlin_maxy[ x - 1 ] ) ||
-								( perlin_maxy[ x + 1 ] && x < w - 1 && y <= perlin_maxy[ x + 1 ] )
+								( x > 0 && perlin_maxy[ x - 1 ] && y <= perlin_maxy[ x - 1 ] ) ||
+								( x < w - 1 && perlin_maxy[ x + 1 ] && y <= perlin_maxy[ x + 1 ] )
 							) {
 							perlin_need_border = true;
 						}
@@ -454,8 +1149,8 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 					if ( !perlin_need_pixel && !perlin_need_border && ( flags & types::texture::AM_COASTLINE_BORDER ) ) {
 						if (
 							( perlin_maxx[ y ] && ( w - x ) < perlin_maxx[ y ] + COASTLINES_BORDER_RND ) ||
-								( perlin_maxx[ y - 1 ] && y > 0 && ( w - x ) <= perlin_maxx[ y - 1 ] ) ||
-								( perlin_maxx[ y + 1 ] && y < h - 1 && ( w - x ) <= perlin_maxx[ y + 1 ] )
+								( y > 0 && perlin_maxx[ y - 1 ] && ( w - x ) <= perlin_maxx[ y - 1 ] ) ||
+								( y < h - 1 && perlin_maxx[ y + 1 ] && ( w - x ) <= perlin_maxx[ y + 1 ] )
 							) {
 							perlin_need_border = true;
 						}
@@ -468,8 +1163,8 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 					if ( !perlin_need_pixel && !perlin_need_border && ( flags & types::texture::AM_COASTLINE_BORDER ) ) {
 						if (
 							( perlin_maxy[ x ] && ( h - y ) < perlin_maxy[ x ] + COASTLINES_BORDER_RND ) ||
-								( perlin_maxy[ x - 1 ] && x > 0 && ( h - y ) <= perlin_maxy[ x - 1 ] ) ||
-								( perlin_maxy[ x + 1 ] && x < w - 1 && ( h - y ) <= perlin_maxy[ x + 1 ] )
+								( x > 0 && perlin_maxy[ x - 1 ] && ( h - y ) <= perlin_maxy[ x - 1 ] ) ||
+								( x < w - 1 && perlin_maxy[ x + 1 ] && ( h - y ) <= perlin_maxy[ x + 1 ] )
 							) {
 							perlin_need_border = true;
 						}
@@ -584,7 +1279,7 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 						uint32_t pixel_color;
 						memcpy( &pixel_color, from, m_bpp );
 						if ( mix_color ) {
-							pixel_color = MIX_COLORS( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
+							pixel_color = MixColors( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
 						}
 
 						uint32_t dst_pixel_color;
@@ -645,14 +1340,14 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 							p *= pixel_alpha;
 						}
 
-						pixel_color = MIX_COLORS( pixel_color, dst_pixel_color, p );
+						pixel_color = MixColors( pixel_color, dst_pixel_color, p );
 						memcpy( to, &pixel_color, m_bpp );
 					}
 					else {
 						if ( mix_color ) {
 							uint32_t pixel_color;
 							memcpy( &pixel_color, from, m_bpp );
-							pixel_color = MIX_COLORS( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
+							pixel_color = MixColors( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
 							memcpy( to, &pixel_color, m_bpp );
 						}
 						else {
@@ -666,12 +1361,12 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 								uint32_t pixel_color;
 								memcpy( &pixel_color, from, m_bpp );
 								if ( mix_color ) {
-									pixel_color = MIX_COLORS( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
+									pixel_color = MixColors( mix_color, pixel_color, game::map::s_consts.coastlines.border_alpha );
 								}
 								uint32_t dst_pixel_color;
 								memcpy( &dst_pixel_color, to, m_bpp );
 
-								pixel_color = MIX_COLORS( pixel_color, dst_pixel_color, pixel_alpha );
+								pixel_color = MixColors( pixel_color, dst_pixel_color, pixel_alpha );
 
 								memcpy( to, &pixel_color, m_bpp );
 							}
@@ -711,17 +1406,7 @@ void Texture::AddFrom( const types::texture::Texture* source, add_flag_t flags,
 	// spammy
 	//Log( "Texture processing end" );
 
-#undef MIX_COLORS
 #undef COASTLINES_BORDER_RND
-
-	Update(
-		{
-			dest_x,
-			dest_y,
-			dest_x + w - 1,
-			dest_y + h - 1
-		}
-	);
 }
 
 void Texture::RepaintFrom( const types::texture::Texture* original, const repaint_rules_t& rules ) {
@@ -848,8 +1533,13 @@ Texture* Texture::FromColor( const Color& color ) {
 
 void Texture::Update( const updated_area_t updated_area ) {
 	//Log( "Need texture update [ "+ std::to_string( updated_area.left ) + " " + std::to_string( updated_area.top ) + " " + std::to_string( updated_area.right ) + " " + std::to_string( updated_area.bottom ) + " ]" );
+	std::lock_guard< std::mutex > guard( m_update_mutex );
+	if ( m_is_partial_update_active ) {
+		m_pending_updated_areas.push_back( updated_area );
+		return;
+	}
 	m_updated_areas.push_back( updated_area );
-	m_update_counter++;
+	m_update_counter.fetch_add( 1, std::memory_order_release );
 }
 
 void Texture::FullUpdate() {
@@ -864,8 +1554,50 @@ void Texture::FullUpdate() {
 	);
 }
 
+void Texture::BeginPartialUpdate() {
+	m_bitmap_mutex.lock(); // until EndPartialUpdate()
+	std::lock_guard< std::mutex > guard( m_update_mutex );
+	ASSERT( !m_is_partial_update_active, "partial update already active" );
+	m_is_partial_update_active = true;
+}
+
+void Texture::EndPartialUpdate() {
+	updated_areas_t updated_areas = {};
+	{
+		std::lock_guard< std::mutex > guard( m_update_mutex );
+		ASSERT( m_is_partial_update_active, "partial update not active" );
+		m_is_partial_update_active = false;
+		updated_areas.swap( m_pending_updated_areas );
+	}
+	if ( !updated_areas.empty() ) {
+		// nothing is written to bitmap now, so it's safe to copy from it
+		const size_t bpp = 4;
+		published_areas_t published_areas = {};
+		for ( const auto& area : CombineAreas( updated_areas ) ) {
+			const size_t wbpp = ( area.right - area.left ) * bpp;
+			const size_t h = area.bottom - area.top;
+			published_areas.push_back(
+				{
+					area,
+					std::vector< unsigned char >( wbpp * h )
+				}
+			);
+			auto& bitmap = published_areas.back().bitmap;
+			for ( size_t y = 0 ; y < h ; y++ ) {
+				memcpy( bitmap.data() + y * wbpp, ptr( m_bitmap, ( ( area.top + y ) * m_width + area.left ) * bpp, wbpp ), wbpp );
+			}
+		}
+		{
+			std::lock_guard< std::mutex > guard( m_update_mutex );
+			m_published_areas.insert( m_published_areas.end(), std::make_move_iterator( published_areas.begin() ), std::make_move_iterator( published_areas.end() ) );
+		}
+		m_update_counter.fetch_add( 1, std::memory_order_release );
+	}
+	m_bitmap_mutex.unlock();
+}
+
 const size_t Texture::UpdatedCount() const {
-	return m_update_counter;
+	return m_update_counter.load( std::memory_order_acquire );
 }
 
 const Texture::updated_areas_t& Texture::GetUpdatedAreas() const {
@@ -873,9 +1605,127 @@ const Texture::updated_areas_t& Texture::GetUpdatedAreas() const {
 }
 
 void Texture::ClearUpdatedAreas() {
+	std::lock_guard< std::mutex > guard( m_update_mutex );
 	m_updated_areas.clear();
 }
 
+const Texture::updated_areas_t Texture::TakeUpdatedAreas() {
+	std::lock_guard< std::mutex > guard( m_update_mutex );
+	updated_areas_t result = {};
+	result.swap( m_updated_areas );
+	return result;
+}
+
+const Texture::published_areas_t Texture::TakePublishedAreas() {
+	std::lock_guard< std::mutex > guard( m_update_mutex );
+	published_areas_t result = {};
+	result.swap( m_published_areas );
+	return result;
+}
+
+std::unique_lock< std::mutex > Texture::LockBitmap() const {
+	return std::unique_lock< std::mutex >( m_bitmap_mutex );
+}
+
+std::unique_lock< std::mutex > Texture::TryLockBitmap() const {
+	return std::unique_lock< std::mutex >( m_bitmap_mutex, std::try_to_lock );
+}
+
+const Texture::updated_areas_t Texture::CombineAreas( const updated_areas_t& updated_areas ) {
+
+	updated_areas_t areas = {};
+
+	const uint8_t od = 1; // overlap distance
+
+	const auto f_are_combineable = []( const updated_area_t& first, const updated_area_t& second ) -> bool {
+		return
+			(
+				( first.left + od >= second.left && first.left - od <= second.right ) ||
+					( first.right + od >= second.left && first.right - od <= second.right )
+			) &&
+				(
+					( first.top + od >= second.top && first.top - od <= second.bottom ) ||
+						( first.bottom + od >= second.top && first.bottom - od <= second.bottom )
+				);
+	};
+
+	const auto f_combine = []( updated_area_t& first, const updated_area_t& second ) -> void {
+		//Log( "Merging texture area " + second.ToString() + " into " + first.ToString() );
+		first.left = std::min< size_t >( first.left, second.left );
+		first.top = std::min< size_t >( first.top, second.top );
+		first.right = std::max< size_t >( first.right, second.right );
+		first.bottom = std::max< size_t >( first.bottom, second.bottom );
+	};
+
+	// mark area as removed (merged into another)
+	const auto f_remove = []( updated_area_t& area ) -> void {
+		area.right = area.top = 0; // hackish but no actual area would have these coordinates at 0
+	};
+
+	// check if area was marked as removed (to skip)
+	const auto f_is_removed = []( const updated_area_t& area ) -> bool {
+		return area.right == 0 && area.top == 0;
+	};
+
+	for ( auto& updated_area : updated_areas ) {
+		//Log( "Processing texture area " + updated_area.ToString() );
+		// try to merge with existing one
+		auto it = areas.begin();
+		while ( it != areas.end() ) {
+			// if it overlaps then we can merge with existing (TODO: can optimize further by measuring overlap size)
+			if ( f_are_combineable( updated_area, *it ) ) {
+				// extend area to fit both new one and old one
+				f_combine( *it, updated_area );
+				break;
+			}
+			it++;
+		}
+		if ( it == areas.end() ) {
+			// couldn't find any suitable areas, add new one
+			//Log( "Adding texture area " + updated_area.ToString() );
+			areas.push_back(
+				{
+					updated_area.left,
+					updated_area.top,
+					updated_area.right,
+					updated_area.bottom
+				}
+			);
+		}
+	}
+
+	// keep combining until can't combine anymore
+	bool combined = true;
+	do {
+		combined = false;
+		for ( auto it_dst = areas.begin() ; it_dst < areas.end() ; it_dst++ ) {
+			if ( f_is_removed( *it_dst ) ) {
+				continue;
+			}
+			for ( auto it_src = it_dst + 1 ; it_src < areas.end() ; it_src++ ) {
+				if ( f_is_removed( *it_src ) ) {
+					continue;
+				}
+				if ( f_are_combineable( *it_dst, *it_src ) ) {
+					//Log( "Merging texture area " + it_src->ToString() + " into " + it_dst->ToString() );
+					f_combine( *it_dst, *it_src );
+					f_remove( *it_src );
+					combined = true;
+				}
+			}
+		}
+	}
+	while ( combined );
+
+	updated_areas_t result = {};
+	for ( const auto& area : areas ) {
+		if ( !f_is_removed( area ) ) {
+			result.push_back( area );
+		}
+	}
+	return result;
+}
+
 unsigned char* Texture::CopyBitmap( const size_t x1, const size_t y1, const size_t x2, const size_t y2 ) const {
 
 	ASSERT( x1 < x2, "x1 must be smaller than x2" );
@@ -905,6 +1755,12 @@ unsigned char* Texture::CopyBitmap( const size_t x1, const size_t y1, const size
 
 const types::Buffer Texture::Serialize() const {
 	types::Buffer buf;
+	SerializeTo( buf );
+	return buf;
+}
+
+void Texture::SerializeTo( types::Buffer& buf ) const {
+	buf.Reserve( m_name.size() + m_bitmap_size + 128 ); // bitmap is most of it
 
 	buf.WriteString( m_name );
 	buf.WriteInt( m_width );
@@ -916,8 +1772,6 @@ const types::Buffer Texture::Serialize() const {
 	buf.WriteData( m_bitmap, m_bitmap_size );
 
 	buf.WriteBool( m_is_tiled );
-
-	return buf;
 }
 
 void Texture::Unserialize( types::Buffer buf ) {
@@ -2,6 +2,8 @@
 
 #include <string>
 #include <vector>
+#include <mutex>
+#include <atomic>
 
 #include "types/Serializable.h"
 
@@ -37,6 +39,7 @@ CLASS( Texture, Serializable )
 	size_t m_bitmap_size = 0;
 
 	bool m_is_tiled = false;
+	bool m_is_paged = false; // has no bitmap, pages are composited on demand ( see PagedTexture )
 
 	common::ObjectLink* m_graphics_object = nullptr;
 
@@ -99,9 +102,31 @@ CLASS( Texture, Serializable )
 
 	void Update( const updated_area_t updated_area );
 	void FullUpdate();
+	// areas updated between these calls are published at once, so that renderer doesn't pick up half-drawn ones
+	// bitmap stays locked meanwhile, and pixels of areas are copied when publishing, so renderer never reads pixels that are being written
+	void BeginPartialUpdate();
+	void EndPartialUpdate();
 	const size_t UpdatedCount() const;
 	const updated_areas_t& GetUpdatedAreas() const;
 	void ClearUpdatedAreas();
+	// returns and clears updated areas atomically (safe to call while texture is being updated from other thread)
+	const updated_areas_t TakeUpdatedAreas();
+
+	struct published_area_t {
+		updated_area_t area;
+		std::vector< unsigned char > bitmap; // copy of pixels of area, made when it was published
+	};
+	typedef std::vector< published_area_t > published_areas_t;
+	// returns and clears areas published by EndPartialUpdate() (safe to call while texture is being updated from other thread)
+	const published_areas_t TakePublishedAreas();
+
+	// other threads must hold this while reading bitmap directly, waits until partial update ( if any ) is finished
+	std::unique_lock< std::mutex > LockBitmap() const;
+	// same but doesn't wait, check owns_lock() of result
+	std::unique_lock< std::mutex > TryLockBitmap() const;
+
+	// merges overlapping or touching areas, so that they can be reloaded with fewer calls
+	static const updated_areas_t CombineAreas( const updated_areas_t& updated_areas );
 
 	// allocates and returns copy of bitmap from specified area
 	// don't forget to free() it later
@@ -109,10 +134,19 @@ CLASS( Texture, Serializable )
 	unsigned char* CopyBitmap( const size_t x1, const size_t y1, const size_t x2, const size_t y2 ) const;
 
 	const types::Buffer Serialize() const override;
+	void SerializeTo( types::Buffer& buf ) const; // writes into existing buffer, i.e. as nested value
 	void Unserialize( types::Buffer buf ) override;
 
+	// slow path of AddFrom() that handles every flag combination, pixel by pixel ( public so that self-tests can compare kernels with it )
+	void AddFromGeneric( const types::texture::Texture* source, add_flag_t flags, const size_t x1, const size_t y1, const size_t x2, const size_t y2, const size_t dest_x, const size_t dest_y, const rotate_t rotate, const float alpha, util::random::Random* rng, util::Perlin* perlin );
+
 private:
-	size_t m_update_counter = 0;
+	std::atomic< size_t > m_update_counter = 0; // increased after changes are published, so whoever sees new value sees changes too
+	std::mutex m_update_mutex; // different parts of same texture may be updated from multiple threads (i.e. map tiles)
+	mutable std::mutex m_bitmap_mutex; // held by writer during partial update
+	bool m_is_partial_update_active = false;
+	updated_areas_t m_pending_updated_areas = {};
+	published_areas_t m_published_areas = {};
 };
 
 }
@@ -0,0 +1,163 @@
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+
+#include "LZ.h"
+
+namespace util {
+
+// sequence is token byte ( literals length in high nibble, match length - MIN_MATCH in low nibble ),
+// optional literals length extension, literals, 16-bit offset, optional match length extension
+// lengths of 15 are extended by following bytes until one that is not 255
+// last sequence has only literals
+static const size_t MIN_MATCH = 4;
+static const size_t MAX_OFFSET = 65535;
+static const size_t LAST_LITERALS = 5; // matches never reach end of input
+static const uint8_t HASH_BITS = 14;
+static const uint8_t SKIP_TRIGGER = 6; // search step grows after every 2^SKIP_TRIGGER misses, speeds up incompressible data
+
+static inline void WriteLength( std::string& output, size_t length ) {
+	while ( length >= 255 ) {
+		output.push_back( (char)255 );
+		length -= 255;
+	}
+	output.push_back( (char)length );
+}
+
+static inline void WriteSequence( std::string& output, const char* literals, const size_t literals_length, const size_t offset, const size_t match_length ) {
+	const size_t match_code = match_length
+		? match_length - MIN_MATCH
+		: 0;
+	output.push_back(
+		(char)(
+			( ( literals_length < 15
+				? literals_length
+				: 15 ) << 4 ) |
+				( match_code < 15
+					? match_code
+					: 15 )
+		)
+	);
+	if ( literals_length >= 15 ) {
+		WriteLength( output, literals_length - 15 );
+	}
+	output.append( literals, literals_length );
+	if ( match_length ) {
+		output.push_back( (char)( offset & 0xff ) );
+		output.push_back( (char)( offset >> 8 ) );
+		if ( match_code >= 15 ) {
+			WriteLength( output, match_code - 15 );
+		}
+	}
+}
+
+static inline const bool ReadLength( const uint8_t*& ptr, const uint8_t* end, size_t& length ) {
+	uint8_t b;
+	do {
+		if ( ptr == end ) {
+			return false;
+		}
+		b = *ptr++;
+		length += b;
+	} while ( b == 255 );
+	return true;
+}
+
+void LZ::Compress( const std::string_view& input, std::string& output ) {
+	const auto* src = (const uint8_t*)input.data();
+	const size_t size = input.size();
+
+	output.reserve( output.size() + size + size / 255 + 16 );
+
+	// positions of recently seen 4-byte sequences
+	static thread_local uint32_t s_table[ 1 << HASH_BITS ];
+	memset( s_table, 0, sizeof( s_table ) );
+
+	size_t anchor = 0; // start of pending literals
+	size_t pos = 1; // nothing to match at 0
+	size_t misses = 0;
+	const size_t match_limit = size > LAST_LITERALS
+		? size - LAST_LITERALS
+		: 0;
+	uint32_t seq;
+	while ( pos + MIN_MATCH <= match_limit ) {
+		memcpy( &seq, src + pos, sizeof( seq ) );
+		const uint32_t hash = ( seq * 2654435761u ) >> ( 32 - HASH_BITS );
+		const size_t candidate = s_table[ hash ];
+		s_table[ hash ] = (uint32_t)pos;
+		if ( pos - candidate <= MAX_OFFSET && !memcmp( src + candidate, src + pos, MIN_MATCH ) ) {
+			size_t length = MIN_MATCH;
+			while ( pos + length < match_limit && src[ candidate + length ] == src[ pos + length ] ) {
+				length++;
+			}
+			WriteSequence( output, input.data() + anchor, pos - anchor, pos - candidate, length );
+			pos += length;
+			anchor = pos;
+			misses = 0;
+		}
+		else {
+			pos += 1 + ( misses++ >> SKIP_TRIGGER );
+		}
+	}
+
+	WriteSequence( output, input.data() + anchor, size - anchor, 0, 0 );
+}
+
+const bool LZ::Decompress( const std::string_view& input, char* output, const size_t size ) {
+	const auto* ptr = (const uint8_t*)input.data();
+	const auto* end = ptr + input.size();
+	size_t pos = 0;
+	while ( ptr < end ) {
+		const uint8_t token = *ptr++;
+
+		size_t length = token >> 4;
+		if ( length == 15 && !ReadLength( ptr, end, length ) ) {
+			return false;
+		}
+		if ( length > (size_t)( end - ptr ) || length > size - pos ) {
+			return false;
+		}
+		memcpy( output + pos, ptr, length );
+		ptr += length;
+		pos += length;
+
+		if ( ptr == end ) {
+			break; // last sequence
+		}
+
+		if ( end - ptr < 2 ) {
+			return false;
+		}
+		const size_t offset = ptr[ 0 ] | ( ptr[ 1 ] << 8 );
+		ptr += 2;
+		if ( !offset || offset > pos ) {
+			return false;
+		}
+		length = ( token & 15 );
+		if ( length == 15 && !ReadLength( ptr, end, length ) ) {
+			return false;
+		}
+		length += MIN_MATCH;
+		if ( length > size - pos ) {
+			return false;
+		}
+		const char* match = output + pos - offset;
+		if ( offset >= length ) {
+			memcpy( output + pos, match, length );
+		}
+		else {
+			// overlapping, i.e. repeated pattern - copy it once, then keep doubling what was already copied
+			memcpy( output + pos, match, offset );
+			size_t copied = offset;
+			while ( copied < length ) {
+				const size_t chunk = std::min( copied, length - copied );
+				memcpy( output + pos + copied, match, chunk );
+				copied += chunk;
+			}
+		}
+		pos += length;
+	}
+	return pos == size;
+}
+
+}
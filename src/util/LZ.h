@@ -0,0 +1,21 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "Util.h"
+
+namespace util {
+
+// fast byte-oriented LZ77 codec ( lz4-like block format: literal runs and back-references within 64KB window )
+// intended for network payloads, trades ratio for speed
+CLASS( LZ, Util )
+
+	// appends compressed data to output, output may be larger than input for incompressible data
+	static void Compress( const std::string_view& input, std::string& output );
+	// decompresses exactly size bytes into output, false if data is malformed or doesn't match size
+	static const bool Decompress( const std::string_view& input, char* output, const size_t size );
+
+};
+
+}
@@ -0,0 +1,93 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace util {
+
+MappedFile::MappedFile( const std::string& path ) {
+#ifdef _WIN32
+	m_file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if ( m_file == INVALID_HANDLE_VALUE ) {
+		m_file = nullptr;
+		THROW( "unable to open file \"" + path + "\"" );
+	}
+	LARGE_INTEGER size;
+	if ( !GetFileSizeEx( m_file, &size ) ) {
+		CloseHandle( m_file );
+		THROW( "unable to get size of file \"" + path + "\"" );
+	}
+	m_size = (size_t)size.QuadPart;
+	if ( m_size > 0 ) {
+		m_mapping = CreateFileMappingA( m_file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+		if ( !m_mapping ) {
+			CloseHandle( m_file );
+			THROW( "unable to map file \"" + path + "\"" );
+		}
+		m_data = (const unsigned char*)MapViewOfFile( m_mapping, FILE_MAP_READ, 0, 0, 0 );
+		if ( !m_data ) {
+			CloseHandle( m_mapping );
+			CloseHandle( m_file );
+			THROW( "unable to map file \"" + path + "\"" );
+		}
+	}
+#else
+	m_fd = open( path.c_str(), O_RDONLY );
+	if ( m_fd < 0 ) {
+		THROW( "unable to open file \"" + path + "\"" );
+	}
+	struct stat st = {};
+	if ( fstat( m_fd, &st ) < 0 ) {
+		close( m_fd );
+		THROW( "unable to get size of file \"" + path + "\"" );
+	}
+	m_size = (size_t)st.st_size;
+	if ( m_size > 0 ) {
+		void* data = mmap( nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0 );
+		if ( data == MAP_FAILED ) {
+			close( m_fd );
+			THROW( "unable to map file \"" + path + "\"" );
+		}
+		// whole file is going to be read sequentially
+		madvise( data, m_size, MADV_SEQUENTIAL );
+		m_data = (const unsigned char*)data;
+	}
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+	if ( m_data ) {
+		UnmapViewOfFile( m_data );
+	}
+	if ( m_mapping ) {
+		CloseHandle( m_mapping );
+	}
+	if ( m_file ) {
+		CloseHandle( m_file );
+	}
+#else
+	if ( m_data ) {
+		munmap( (void*)m_data, m_size );
+	}
+	if ( m_fd >= 0 ) {
+		close( m_fd );
+	}
+#endif
+}
+
+const unsigned char* MappedFile::GetData() const {
+	return m_data;
+}
+
+const size_t MappedFile::GetSize() const {
+	return m_size;
+}
+
+}
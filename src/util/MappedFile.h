@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+
+#include "Util.h"
+
+namespace util {
+
+// read-only view of whole file contents, mapped into memory instead of being read
+CLASS( MappedFile, Util )
+
+	MappedFile( const std::string& path );
+	~MappedFile();
+
+	const unsigned char* GetData() const;
+	const size_t GetSize() const;
+
+private:
+	const unsigned char* m_data = nullptr;
+	size_t m_size = 0;
+
+#ifdef _WIN32
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#else
+	int m_fd = -1;
+#endif
+
+};
+
+}
@@ -275,7 +275,9 @@ Perlin::Perlin() {
 }
 
 // Generate a new permutation vector based on the value of seed
-Perlin::Perlin( unsigned int seed ) {
+Perlin::Perlin( unsigned int seed )
+	: m_is_seeded( true )
+	, m_seed( seed ) {
 	p.resize( 256 );
 
 	// Fill p with values from 0 to 255
@@ -291,6 +293,15 @@ Perlin::Perlin( unsigned int seed ) {
 	p.insert( p.end(), p.begin(), p.end() );
 }
 
+const bool Perlin::IsSeeded() const {
+	return m_is_seeded;
+}
+
+const unsigned int Perlin::GetSeed() const {
+	ASSERT( m_is_seeded, "perlin is not seeded" );
+	return m_seed;
+}
+
 float Perlin::Noise( float x, float y, float z ) {
 
 	// Find the unit cube that contains the point
@@ -341,6 +352,61 @@ float Perlin::Noise( float x, float y, float z, size_t passes ) {
 	return res;
 }
 
+void Perlin::Noise( const float* xs, const float* ys, const size_t count, const size_t passes, float* results ) {
+
+	// gradient coefficients for x and y, equivalent to Grad() with z == 0
+	static constexpr float s_grad_x[ 16 ] = { 1, -1, 1, -1, 1, -1, 1, -1, 0, 0, 0, 0, 1, 0, -1, 0 };
+	static constexpr float s_grad_y[ 16 ] = { 1, 1, -1, -1, 0, 0, 0, 0, 1, -1, 1, -1, 1, -1, 1, -1 };
+
+	const int* const perm = p.data();
+
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		results[ i ] = 0.0f;
+	}
+
+	// process octave by octave so that inner loop is simple and doesn't depend on previous points
+	float scale = 1.0f;
+	for ( size_t pass = 0 ; pass < passes ; pass++ ) {
+
+		// multi-level noise uses pass index as z, it's always integer so relative z is 0 and z - 1 face doesn't contribute to result
+		const int Z = (int)pass & 255;
+
+		for ( size_t i = 0 ; i < count ; i++ ) {
+			float x = xs[ i ] * scale;
+			float y = ys[ i ] * scale;
+
+			const float fx = floor( x );
+			const float fy = floor( y );
+			const int X = (int)fx & 255;
+			const int Y = (int)fy & 255;
+			x -= fx;
+			y -= fy;
+
+			const float u = Fade( x );
+			const float v = Fade( y );
+
+			const int A = perm[ X ] + Y;
+			const int B = perm[ X + 1 ] + Y;
+			const int AA = perm[ perm[ A ] + Z ] & 15;
+			const int AB = perm[ perm[ A + 1 ] + Z ] & 15;
+			const int BA = perm[ perm[ B ] + Z ] & 15;
+			const int BB = perm[ perm[ B + 1 ] + Z ] & 15;
+
+			results[ i ] += Lerp(
+				v,
+				Lerp( u, s_grad_x[ AA ] * x + s_grad_y[ AA ] * y, s_grad_x[ BA ] * ( x - 1 ) + s_grad_y[ BA ] * y ),
+				Lerp( u, s_grad_x[ AB ] * x + s_grad_y[ AB ] * ( y - 1 ), s_grad_x[ BB ] * ( x - 1 ) + s_grad_y[ BB ] * ( y - 1 ) )
+			);
+		}
+
+		scale /= 2;
+	}
+
+	for ( size_t i = 0 ; i < count ; i++ ) {
+		results[ i ] = std::max( -1.0f, std::min( 1.0f, results[ i ] ) );
+	}
+}
+
 float Perlin::Fade( float t ) {
 	return t * t * t * ( t * ( t * 6 - 15 ) + 10 );
 }
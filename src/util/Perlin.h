@@ -13,14 +13,24 @@ CLASS( Perlin, Util )
 	Perlin();
 	Perlin( unsigned int seed );
 
+	// only seeded noise can be recreated later ( default one uses reference permutation )
+	const bool IsSeeded() const;
+	const unsigned int GetSeed() const;
+
 	// Get a noise value, for 2D images z can have any value
 	float Noise( float x, float y, float z );
 
 	// multi-level noise
 	float Noise( float x, float y, float z, size_t passes );
 
+	// multi-level noise for many points at once, results are identical to calling Noise( xs[ i ], ys[ i ], any z, passes ) for every point
+	void Noise( const float* xs, const float* ys, const size_t count, const size_t passes, float* results );
+
 private:
 
+	bool m_is_seeded = false;
+	unsigned int m_seed = 0;
+
 	// The permutation vector
 	std::vector< int > p;
 
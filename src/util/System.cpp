@@ -14,10 +14,37 @@
 
 #include <algorithm>
 
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
 #include "System.h"
 
 namespace util {
 
+const size_t System::GetPeakRSS() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters = {};
+	if ( !GetProcessMemoryInfo( GetCurrentProcess(), &counters, sizeof( counters ) ) ) {
+		return 0;
+	}
+	return counters.PeakWorkingSetSize;
+#else
+	struct rusage usage = {};
+	if ( getrusage( RUSAGE_SELF, &usage ) ) {
+		return 0;
+	}
+#ifdef __APPLE__
+	return usage.ru_maxrss; // bytes on macos
+#else
+	return usage.ru_maxrss * 1024; // kilobytes on linux
+#endif
+#endif
+}
+
 #ifdef DEBUG
 
 // from https://stackoverflow.com/questions/3596781/how-to-detect-if-the-current-process-is-being-run-by-gdb
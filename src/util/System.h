@@ -9,6 +9,9 @@ namespace util {
 
 CLASS( System, Util )
 
+	// peak resident memory of current process, in bytes (0 if unsupported)
+	static const size_t GetPeakRSS();
+
 #ifdef DEBUG
 
 	static bool AreWeUnderGDB();
@@ -1,10 +1,173 @@
+#include <cstring>
+
 #include "CRC32.h"
 
+#if defined( __GNUC__ ) && defined( __x86_64__ )
+#define CRC32_HW_SSE42
+#include <nmmintrin.h>
+#elif defined( __GNUC__ ) && defined( __aarch64__ ) && !defined( __AARCH64EB__ ) // 8-byte loads below assume little-endian
+#define CRC32_HW_ARMV8
+#include <arm_acle.h>
+#ifdef __linux__
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#endif
+#endif
+
 namespace util {
 namespace crc32 {
 
-const crc_t CRC32::CalculateFromBuffer( const types::Buffer& buf ) {
-	return 0;
+static const crc_t POLYNOMIAL = 0xEDB88320;
+static const crc_t POLYNOMIAL_C = 0x82F63B78;
+
+// slice-by-8 lookup tables, generated on first use
+// table[ 0 ] is classic bytewise table, table[ n ] advances crc of byte by n more zero bytes
+template< crc_t polynomial >
+struct tables_t {
+	crc_t values[ 8 ][ 256 ];
+	tables_t() {
+		for ( crc_t i = 0 ; i < 256 ; i++ ) {
+			crc_t c = i;
+			for ( uint8_t k = 0 ; k < 8 ; k++ ) {
+				c = ( c & 1 )
+					? polynomial ^ ( c >> 1 )
+					: c >> 1;
+			}
+			values[ 0 ][ i ] = c;
+		}
+		for ( crc_t i = 0 ; i < 256 ; i++ ) {
+			for ( uint8_t t = 1 ; t < 8 ; t++ ) {
+				values[ t ][ i ] = ( values[ t - 1 ][ i ] >> 8 ) ^ values[ 0 ][ values[ t - 1 ][ i ] & 0xff ];
+			}
+		}
+	}
+};
+
+template< crc_t polynomial >
+static const tables_t< polynomial >& GetTables() {
+	static const tables_t< polynomial > s_tables;
+	return s_tables;
+}
+
+// works with inverted crc, 8 bytes per step
+template< crc_t polynomial >
+static crc_t CalculateSoftware( const uint8_t* bytes, size_t size, crc_t crc ) {
+	const auto& t = GetTables< polynomial >().values;
+	while ( size && ( (uintptr_t)bytes & 7 ) ) {
+		crc = t[ 0 ][ ( crc ^ *( bytes++ ) ) & 0xff ] ^ ( crc >> 8 );
+		size--;
+	}
+	uint32_t lo, hi;
+	while ( size >= 8 ) {
+		// assembled as little-endian so that result is same on any host, compiles to plain load on little-endian ones
+		lo = bytes[ 0 ] | ( bytes[ 1 ] << 8 ) | ( bytes[ 2 ] << 16 ) | ( (uint32_t)bytes[ 3 ] << 24 );
+		hi = bytes[ 4 ] | ( bytes[ 5 ] << 8 ) | ( bytes[ 6 ] << 16 ) | ( (uint32_t)bytes[ 7 ] << 24 );
+		lo ^= crc;
+		crc =
+			t[ 7 ][ lo & 0xff ] ^ t[ 6 ][ ( lo >> 8 ) & 0xff ] ^ t[ 5 ][ ( lo >> 16 ) & 0xff ] ^ t[ 4 ][ lo >> 24 ] ^
+				t[ 3 ][ hi & 0xff ] ^ t[ 2 ][ ( hi >> 8 ) & 0xff ] ^ t[ 1 ][ ( hi >> 16 ) & 0xff ] ^ t[ 0 ][ hi >> 24 ];
+		bytes += 8;
+		size -= 8;
+	}
+	while ( size-- ) {
+		crc = t[ 0 ][ ( crc ^ *( bytes++ ) ) & 0xff ] ^ ( crc >> 8 );
+	}
+	return crc;
+}
+
+#if defined( CRC32_HW_SSE42 )
+
+__attribute__(( target( "sse4.2" ) ))
+static crc_t CalculateHardware( const uint8_t* bytes, size_t size, crc_t crc ) {
+	while ( size && ( (uintptr_t)bytes & 7 ) ) {
+		crc = _mm_crc32_u8( crc, *( bytes++ ) );
+		size--;
+	}
+	uint64_t crc64 = crc;
+	uint64_t v;
+	while ( size >= 8 ) {
+		memcpy( &v, bytes, sizeof( v ) );
+		crc64 = _mm_crc32_u64( crc64, v );
+		bytes += 8;
+		size -= 8;
+	}
+	crc = crc64;
+	while ( size-- ) {
+		crc = _mm_crc32_u8( crc, *( bytes++ ) );
+	}
+	return crc;
+}
+
+static const bool HasHardware() {
+	return __builtin_cpu_supports( "sse4.2" );
+}
+
+#elif defined( CRC32_HW_ARMV8 )
+
+__attribute__(( target( "arch=armv8-a+crc" ) ))
+static crc_t CalculateHardware( const uint8_t* bytes, size_t size, crc_t crc ) {
+	while ( size && ( (uintptr_t)bytes & 7 ) ) {
+		crc = __crc32cb( crc, *( bytes++ ) );
+		size--;
+	}
+	uint64_t v;
+	while ( size >= 8 ) {
+		memcpy( &v, bytes, sizeof( v ) );
+		crc = __crc32cd( crc, v );
+		bytes += 8;
+		size -= 8;
+	}
+	while ( size-- ) {
+		crc = __crc32cb( crc, *( bytes++ ) );
+	}
+	return crc;
+}
+
+static const bool HasHardware() {
+#ifdef __linux__
+	return getauxval( AT_HWCAP ) & HWCAP_CRC32;
+#else
+	return true; // crc is mandatory since armv8.1 and present in all apple cpus
+#endif
+}
+
+#else
+
+static const bool HasHardware() {
+	return false;
+}
+
+#endif
+
+typedef crc_t (* calculate_func_t)( const uint8_t* bytes, size_t size, crc_t crc );
+
+// picked once, results are same either way
+static const calculate_func_t GetCalculateC() {
+	static const calculate_func_t s_func =
+#if defined( CRC32_HW_SSE42 ) || defined( CRC32_HW_ARMV8 )
+		HasHardware()
+			? &CalculateHardware
+			:
+#endif
+			&CalculateSoftware< POLYNOMIAL_C >;
+	return s_func;
+}
+
+const crc_t CRC32::Calculate( const void* data, const size_t size, const crc_t crc ) {
+	return CalculateSoftware< POLYNOMIAL >( (const uint8_t*)data, size, crc ^ 0xFFFFFFFF ) ^ 0xFFFFFFFF;
+}
+
+const crc_t CRC32::CalculateC( const void* data, const size_t size, const crc_t crc ) {
+	return GetCalculateC()( (const uint8_t*)data, size, crc ^ 0xFFFFFFFF ) ^ 0xFFFFFFFF;
+}
+
+const bool CRC32::IsHardwareAccelerated() {
+	return GetCalculateC() != &CalculateSoftware< POLYNOMIAL_C >;
+}
+
+const crc_t CRC32::CalculateFromBuffer( const types::Buffer& buf, const crc_t crc ) {
+	const auto data = buf.ToStringView();
+	return CalculateC( data.data(), data.size(), crc );
 }
 
 }
@@ -8,9 +8,18 @@
 namespace util {
 namespace crc32 {
 
+// all functions are streaming: pass result of previous call as crc to continue calculation over multiple chunks
 CLASS( CRC32, Util )
 
-	static const crc_t CalculateFromBuffer( const types::Buffer& buf );
+	// crc32c of serialized buffer
+	static const crc_t CalculateFromBuffer( const types::Buffer& buf, const crc_t crc = 0 );
+
+	// standard crc32 ( reflected 0xEDB88320 ), used by file formats
+	static const crc_t Calculate( const void* data, const size_t size, const crc_t crc = 0 );
+
+	// crc32c ( reflected 0x82F63B78 ), uses cpu instructions if available so prefer it for anything not stored in files
+	static const crc_t CalculateC( const void* data, const size_t size, const crc_t crc = 0 );
+	static const bool IsHardwareAccelerated();
 
 };
 
@@ -20,6 +20,9 @@ Random::Random( const value_t seed ) {
 #define rot32( x, k ) (((x)<<(k))|((x)>>(32-(k))))
 
 const value_t Random::Generate() {
+	if ( m_state.mode == M_COUNTER ) {
+		return GenerateAt( m_counter_state.key, m_counter_state.counter++ );
+	}
 	value_t e = m_state.a - rot32( m_state.b, 27 );
 	m_state.a = m_state.b ^ rot32( m_state.c, 17 );
 	m_state.b = m_state.c + m_state.d;
@@ -30,13 +33,84 @@ const value_t Random::Generate() {
 
 #undef rot32
 
+#define swap32( x ) (((x)>>32)|((x)<<32))
+
+const value_t Random::GenerateAt( const uint64_t key, const uint64_t counter ) {
+	uint64_t x, y, z;
+	y = x = counter * key;
+	z = y + key;
+	x = x * x + y;
+	x = swap32( x );
+	x = x * x + z;
+	x = swap32( x );
+	x = x * x + y;
+	x = swap32( x );
+	return ( x * x + z ) >> 32;
+}
+
+#undef swap32
+
+// splitmix64 finalizer
+static uint64_t mix64( uint64_t x ) {
+	x ^= x >> 30;
+	x *= 0xbf58476d1ce4e5b9ULL;
+	x ^= x >> 27;
+	x *= 0x94d049bb133111ebULL;
+	x ^= x >> 31;
+	return x;
+}
+
+const uint64_t Random::DeriveKey( const uint64_t base, const value_t stream_id ) {
+	// squares needs keys with well mixed bits, odd keys are also recommended
+	return mix64( base + ( (uint64_t)stream_id + 1 ) * 0x9e3779b97f4a7c15ULL ) | 1;
+}
+
 void Random::SetSeed( const value_t seed ) {
 	//Log( "Setting seed " + std::to_string( seed ) );
+	m_state.mode = M_SEQUENTIAL;
 	m_state.a = 0xf1ea5eed, m_state.b = m_state.c = m_state.d = seed;
+	Warmup();
+	Log( "State set to " + GetStateString() );
+}
+
+void Random::SetCounterStream( const value_t seed, const value_t stream_id ) {
+	m_state.mode = M_COUNTER;
+	m_counter_state.key = DeriveKey( mix64( seed ), stream_id );
+	m_counter_state.counter = 0;
+}
+
+const bool Random::IsCounterBased() const {
+	return m_state.mode == M_COUNTER;
+}
+
+Random Random::Fork( const value_t stream_id ) const {
+	Random forked( *this );
+	forked.m_state.mode = M_COUNTER;
+	forked.m_counter_state.key = DeriveKey(
+		m_state.mode == M_COUNTER
+			? m_counter_state.key
+			: mix64( ( (uint64_t)m_state.a << 32 ) | m_state.b ) ^ ( ( (uint64_t)m_state.c << 32 ) | m_state.d ),
+		stream_id
+	);
+	forked.m_counter_state.counter = 0;
+	return forked;
+}
+
+void Random::Advance( const uint64_t count ) {
+	if ( m_state.mode == M_COUNTER ) {
+		m_counter_state.counter += count;
+	}
+	else {
+		for ( uint64_t i = 0 ; i < count ; i++ ) {
+			(void)Generate();
+		}
+	}
+}
+
+void Random::Warmup() {
 	for ( value_t i = 0 ; i < 20 ; ++i ) {
 		(void)Generate();
 	}
-	Log( "State set to " + GetStateString() );
 }
 
 const value_t Random::NewSeed() {
@@ -92,6 +166,26 @@ const bool Random::IsLucky( const value_t difficulty ) {
 	return value == 0;
 }
 
+void Random::Fill( float* out, const size_t count, const float min, const float max ) {
+	ASSERT( max >= min, "Fill min larger than max" );
+
+	const float scale = ( max - min ) / (float)( 1 << 24 );
+	if ( m_state.mode == M_COUNTER ) {
+		// no dependency between iterations, so compiler is free to unroll and vectorize it
+		const uint64_t key = m_counter_state.key;
+		const uint64_t counter = m_counter_state.counter;
+		for ( size_t i = 0 ; i < count ; i++ ) {
+			out[ i ] = min + (float)( GenerateAt( key, counter + i ) >> 8 ) * scale;
+		}
+		m_counter_state.counter += count;
+	}
+	else {
+		for ( size_t i = 0 ; i < count ; i++ ) {
+			out[ i ] = min + (float)( Generate() >> 8 ) * scale;
+		}
+	}
+}
+
 template< class ValueType >
 void Random::Shuffle( std::vector< ValueType >& vector ) {
 	std::mt19937 g( GetUInt() );
@@ -99,19 +193,41 @@ void Random::Shuffle( std::vector< ValueType >& vector ) {
 }
 
 const state_t Random::GetState() {
+	if ( m_state.mode == M_COUNTER ) {
+		return {
+			(value_t)m_counter_state.key,
+			(value_t)( m_counter_state.key >> 32 ),
+			(value_t)m_counter_state.counter,
+			(value_t)( m_counter_state.counter >> 32 ),
+			M_COUNTER
+		};
+	}
 	return m_state;
 }
 
 void Random::SetState( const state_t& state ) {
-	m_state.a = state.a;
-	m_state.b = state.b;
-	m_state.c = state.c;
-	m_state.d = state.d;
+	m_state.mode = state.mode;
+	if ( state.mode == M_COUNTER ) {
+		m_counter_state.key = ( (uint64_t)state.b << 32 ) | state.a;
+		m_counter_state.counter = ( (uint64_t)state.d << 32 ) | state.c;
+	}
+	else {
+		m_state.a = state.a;
+		m_state.b = state.b;
+		m_state.c = state.c;
+		m_state.d = state.d;
+	}
 	Log( "State set to " + GetStateString() );
 }
 
 const std::string Random::GetStateString() {
-	return std::to_string( m_state.a ) + s_state_divisor + std::to_string( m_state.b ) + s_state_divisor + std::to_string( m_state.c ) + s_state_divisor + std::to_string( m_state.d );
+	const auto state = GetState();
+	// sequential states keep old 4-value format, counter states have mode appended
+	return std::to_string( state.a ) + s_state_divisor + std::to_string( state.b ) + s_state_divisor + std::to_string( state.c ) + s_state_divisor + std::to_string( state.d ) +
+		( state.mode == M_COUNTER
+			? s_state_divisor + std::to_string( state.mode )
+			: ""
+		);
 }
 
 const state_t Random::GetStateFromString( std::string value ) {
@@ -134,12 +250,28 @@ const state_t Random::GetStateFromString( std::string value ) {
 	f_trynext( &state.a );
 	f_trynext( &state.b );
 	f_trynext( &state.c );
-	try {
-		state.d = std::stoul( value );
+	value_t mode = M_SEQUENTIAL;
+	if ( value.find( s_state_divisor ) != std::string::npos ) {
+		f_trynext( &state.d );
+		try {
+			mode = std::stoul( value );
+		}
+		catch ( std::invalid_argument& e ) {
+			THROW( s_invalid_state_format );
+		}
+		if ( mode != M_SEQUENTIAL && mode != M_COUNTER ) {
+			THROW( s_invalid_state_format );
+		}
 	}
-	catch ( std::invalid_argument& e ) {
-		THROW( s_invalid_state_format );
+	else {
+		try {
+			state.d = std::stoul( value );
+		}
+		catch ( std::invalid_argument& e ) {
+			THROW( s_invalid_state_format );
+		}
 	}
+	state.mode = (random_mode_t)mode;
 	return state;
 }
 
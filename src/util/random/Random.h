@@ -9,6 +9,11 @@
  * Jenkins Small Fast 32-bit
  *   (can't use 64-bit for compatibility reasons, GLSMAC may run on 32-bit systems that connect to 64-bit host, etc)
  *   (can't use builtin C++ random classes because we need to be able to save and restore rng states)
+ *
+ * Optionally Squares (Widynski, 2020) counter-based generator
+ *   (every value depends only on key and position, so streams can be forked and jumped without generating anything,
+ *   which allows processing things in parallel without results depending on order or thread count)
+ *   (uses 64-bit integer math, which is emulated but still deterministic on 32-bit systems)
  */
 
 #include "Types.h"
@@ -23,6 +28,18 @@ CLASS( Random, Util )
 	void SetSeed( const value_t seed );
 	static const value_t NewSeed();
 
+	// switch to counter-based sequence derived from seed and stream id (i.e. one stream per tile)
+	// cheap and quiet ( no warmup ), can be called very often
+	void SetCounterStream( const value_t seed, const value_t stream_id = 0 );
+	const bool IsCounterBased() const;
+
+	// independent counter-based generator derived from current key (or current state in sequential mode) and stream id, doesn't advance this one
+	// same state and stream id always give same fork, regardless of when or in which thread it's called
+	Random Fork( const value_t stream_id ) const;
+
+	// skip values as if they were generated, O(1) in counter mode, linear in sequential mode
+	void Advance( const uint64_t count );
+
 	static constexpr char s_state_divisor = ':';
 
 	const bool GetBool();
@@ -32,6 +49,10 @@ CLASS( Random, Util )
 
 	const bool IsLucky( const value_t difficulty = 2 ); // 2 means 50/50 chance
 
+	// fills buffer with uniform values in [min, max), consumes one value per element
+	// uses plain 24-bit mantissa mapping, so results differ from calling GetFloat() count times
+	void Fill( float* out, const size_t count, const float min = 0.0f, const float max = 1.0f );
+
 	template< class ValueType >
 	void Shuffle( std::vector< ValueType >& vector );
 
@@ -45,7 +66,16 @@ private:
 
 	state_t m_state = {};
 
+	// only used in counter mode
+	struct {
+		uint64_t key;
+		uint64_t counter;
+	} m_counter_state = {};
+
 	const value_t Generate();
+	static const value_t GenerateAt( const uint64_t key, const uint64_t counter );
+	static const uint64_t DeriveKey( const uint64_t base, const value_t stream_id );
+	void Warmup();
 };
 
 }
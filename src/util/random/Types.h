@@ -7,11 +7,17 @@ namespace random {
 
 typedef uint32_t value_t;
 
+enum random_mode_t : uint8_t {
+	M_SEQUENTIAL = 0, // Jenkins Small Fast, state is a:b:c:d
+	M_COUNTER = 1, // counter-based, state is key_lo:key_hi:counter_lo:counter_hi
+};
+
 struct state_t {
 	value_t a;
 	value_t b;
 	value_t c;
 	value_t d;
+	random_mode_t mode = M_SEQUENTIAL;
 };
 
 }